@@ -0,0 +1,219 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * access_benchmark.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "access_benchmark.h"
+#include "tinyTPU_access.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef __linux__
+#define NEWLINE "\n"
+#else
+#define NEWLINE "\n\r"
+#endif
+
+typedef enum benchmark_pattern {
+	SEQUENTIAL = 0,
+	STRIDED,
+	RANDOM,
+	PATTERNS
+} benchmark_pattern_t;
+
+static const char *pattern_names[PATTERNS] = {"sequential", "strided", "random"};
+
+static uint32_t addresses[BENCHMARK_MAX_OPERATIONS];
+static tpu_vector_t vectors[BENCHMARK_MAX_OPERATIONS];
+static uint64_t samples[BENCHMARK_MAX_REPEATS];
+
+static void fill_addresses(benchmark_pattern_t pattern, uint32_t size, uint32_t operations) {
+	srand(BENCHMARK_SEED);
+	for(uint32_t i = 0; i < operations; ++i) {
+		switch(pattern) {
+			case SEQUENTIAL:
+				addresses[i] = i % size;
+				break;
+			case STRIDED:
+				// Walks the buffer in columns of BENCHMARK_STRIDE
+				addresses[i] = (i*BENCHMARK_STRIDE + i*BENCHMARK_STRIDE/size) % size;
+				break;
+			default:
+				addresses[i] = rand() % size;
+				break;
+		}
+	}
+}
+
+static int compare_samples(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * Sorts the recorded repeats and stores their statistics per operation.
+ */
+static void evaluate(benchmark_config_t *config, benchmark_result_t *result) {
+	uint32_t repeats = config->repeats;
+	qsort(samples, repeats, sizeof(uint64_t), compare_samples);
+
+	// Nearest rank
+	uint32_t p99 = (99*repeats + 99)/100;
+	result->operations = config->operations;
+	result->repeats = repeats;
+	result->min_ns = (double)samples[0]/config->operations;
+	result->median_ns = (double)samples[(repeats-1)/2]/config->operations;
+	result->p99_ns = (double)samples[p99 ? p99-1 : 0]/config->operations;
+}
+
+static uint64_t run_weights(benchmark_config_t *config) {
+	uint64_t start = config->clock();
+	for(uint32_t i = 0; i < config->operations; ++i) {
+		write_weight_vector(&vectors[i], addresses[i]);
+	}
+	return config->clock() - start;
+}
+
+static uint64_t run_inputs(benchmark_config_t *config) {
+	uint64_t start = config->clock();
+	for(uint32_t i = 0; i < config->operations; ++i) {
+		write_input_vector(&vectors[i], addresses[i]);
+	}
+	return config->clock() - start;
+}
+
+static uint64_t run_outputs(benchmark_config_t *config) {
+	uint64_t start = config->clock();
+	for(uint32_t i = 0; i < config->operations; ++i) {
+		read_output_vector(&vectors[i], addresses[i]);
+	}
+	return config->clock() - start;
+}
+
+static uint64_t run_instructions(benchmark_config_t *config) {
+	instruction_t nop;
+	set_instruction(&nop, TPU_OP_NOP, 0, 0, 0);
+
+	if(!config->drain_fifo) {
+		uint64_t start = config->clock();
+		for(uint32_t i = 0; i < config->operations; ++i) {
+			write_instruction(&nop);
+		}
+		return config->clock() - start;
+	}
+
+	// Only the writes are timed, the FIFO is drained in between, so it never overflows
+	uint64_t time = 0;
+	uint32_t first_count;
+	read_instruction_count(&first_count);
+	for(uint32_t i = 0; i < config->operations; i += TPU_INSTRUCTION_FIFO_DEPTH) {
+		uint32_t length = config->operations - i < TPU_INSTRUCTION_FIFO_DEPTH ? config->operations - i : TPU_INSTRUCTION_FIFO_DEPTH;
+
+		uint64_t start = config->clock();
+		for(uint32_t j = 0; j < length; ++j) {
+			write_instruction(&nop);
+		}
+		time += config->clock() - start;
+
+		uint32_t count;
+		do {
+			read_instruction_count(&count);
+		} while(count - first_count != i + length);
+	}
+	return time;
+}
+
+static void run(benchmark_config_t *config, uint64_t (*function)(benchmark_config_t*), benchmark_result_t *result) {
+	for(uint32_t i = 0; i < config->warmup; ++i) {
+		function(config);
+	}
+	for(uint32_t i = 0; i < config->repeats; ++i) {
+		samples[i] = function(config);
+	}
+	evaluate(config, result);
+}
+
+/**
+ * Runs all benchmarks and stores their results, returns the number of results (BENCHMARK_RESULTS).
+ * Buffer contents are overwritten, the instruction FIFO receives NOPs.
+ */
+uint32_t benchmark_access(benchmark_config_t *config, benchmark_result_t *results) {
+	struct {
+		const char *name;
+		uint64_t (*function)(benchmark_config_t*);
+		uint32_t size;
+	} functions[] = {
+		{"write_weight_vector", run_weights, WEIGHT_BUFFER_SIZE},
+		{"write_input_vector", run_inputs, UNIFIED_BUFFER_SIZE},
+		{"read_output_vector", run_outputs, UNIFIED_BUFFER_SIZE}
+	};
+	uint32_t count = 0;
+
+	if(config->operations > BENCHMARK_MAX_OPERATIONS) config->operations = BENCHMARK_MAX_OPERATIONS;
+	if(config->operations == 0) config->operations = 1;
+	if(config->repeats > BENCHMARK_MAX_REPEATS) config->repeats = BENCHMARK_MAX_REPEATS;
+	if(config->repeats == 0) config->repeats = 1;
+
+	srand(BENCHMARK_SEED);
+	for(uint32_t i = 0; i < config->operations; ++i) {
+		for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+			vectors[i].byte_vector[j] = rand();
+		}
+	}
+
+	for(uint32_t f = 0; f < sizeof(functions)/sizeof(functions[0]); ++f) {
+		for(uint32_t p = 0; p < PATTERNS; ++p) {
+			fill_addresses(p, functions[f].size, config->operations);
+			results[count].function = functions[f].name;
+			results[count].pattern = pattern_names[p];
+			results[count].bytes_per_operation = TPU_VECTOR_SIZE;
+			run(config, functions[f].function, &results[count]);
+			count++;
+		}
+	}
+
+	results[count].function = "write_instruction";
+	results[count].pattern = "nop";
+	results[count].bytes_per_operation = TPU_INSTRUCTION_SIZE;
+	run(config, run_instructions, &results[count]);
+	count++;
+
+	return count;
+}
+
+/**
+ * Prints the results as CSV, bandwidth is taken from the median.
+ */
+void benchmark_print(benchmark_result_t *results, uint32_t count) {
+	printf("function,pattern,operations,repeats,min_ns,median_ns,p99_ns,mbytes_per_s" NEWLINE);
+	for(uint32_t i = 0; i < count; ++i) {
+		benchmark_result_t *result = &results[i];
+		printf("%s,%s,%u,%u,%.2f,%.2f,%.2f,%.2f" NEWLINE, result->function, result->pattern, result->operations, result->repeats,
+				result->min_ns, result->median_ns, result->p99_ns,
+				result->median_ns > 0 ? result->bytes_per_operation*1000.0/result->median_ns : 0.0);
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * access_benchmark.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_ACCESS_BENCHMARK_H_
+#define SRC_ACCESS_BENCHMARK_H_
+
+#include <stdint.h>
+
+/*
+ * Benchmarks of the access layer.
+ *
+ * Each access function is called with sequential, strided and random addresses, write_instruction with NOPs.
+ * A repeat times the given number of operations, the first repeats are warmup and not recorded.
+ * Reported are the nanoseconds per operation of the fastest, the median and the 99th percentile repeat.
+ */
+#define BENCHMARK_MAX_OPERATIONS	4096
+#define BENCHMARK_MAX_REPEATS		1024
+// Vectors between two strided accesses
+#define BENCHMARK_STRIDE			64
+#define BENCHMARK_SEED				176
+#define BENCHMARK_RESULTS			10
+
+typedef struct benchmark_config {
+	// Monotonic time in nanoseconds
+	uint64_t (*clock)(void);
+	uint32_t warmup;
+	uint32_t repeats;
+	uint32_t operations;
+	// The instruction FIFO is drained between writes, only for the hardware
+	uint8_t drain_fifo;
+} benchmark_config_t;
+
+typedef struct benchmark_result {
+	const char *function;
+	const char *pattern;
+	uint32_t operations;
+	uint32_t repeats;
+	uint32_t bytes_per_operation;
+	double min_ns;
+	double median_ns;
+	double p99_ns;
+} benchmark_result_t;
+
+uint32_t benchmark_access(benchmark_config_t *config, benchmark_result_t *results);
+
+void benchmark_print(benchmark_result_t *results, uint32_t count);
+
+#endif /* SRC_ACCESS_BENCHMARK_H_ */
@@ -28,10 +28,32 @@
 
 #include "access_test.h"
 #include "tinyTPU_access.h"
+#include "tinyTPU_parser.h"
+#include "tinyTPU_queue.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 
 #define SEED 176
+// Records of the parser test, more than a batch of the parser each
+#define PARSER_VECTORS (TPU_PARSER_BATCH_VECTORS + 44)
+#define PARSER_INSTRUCTIONS (TPU_PARSER_BATCH_INSTRUCTIONS + 88)
+#define PARSER_RESULTS 3
+// Bytes fed to the parser at once, so numbers and records are split
+#define PARSER_BLOCK 7
+
+typedef struct parsed_program {
+	tpu_vector_t weights[PARSER_VECTORS];
+	tpu_vector_t inputs[PARSER_VECTORS];
+	instruction_t instructions[PARSER_INSTRUCTIONS];
+	tpu_bundle_result_t results[PARSER_RESULTS];
+	uint32_t weight_count;
+	uint32_t input_count;
+	uint32_t instruction_count;
+	uint32_t result_count;
+	uint32_t section_count;
+} parsed_program_t;
 
 void test_unified_access(void) {
 	tpu_vector_t vector;
@@ -66,3 +88,247 @@ void test_unified_access(void) {
 
 	printf("Unified buffer test was successful!\n\r");
 }
+
+void test_unified_block_access(void) {
+	static tpu_vector_t vectors[UNIFIED_BUFFER_SIZE];
+
+	srand(SEED);
+	for(uint32_t address = 0; address < UNIFIED_BUFFER_SIZE; ++address) {
+		for(int32_t i = 0; i < sizeof(vectors[address].byte_vector); ++i) {
+			vectors[address].byte_vector[i] = rand();
+		}
+	}
+
+	if(write_input_block(vectors, 0, UNIFIED_BUFFER_SIZE)) {
+		printf("Bad address on block write!\n\r");
+		return;
+	}
+
+	if(write_input_block(vectors, 1, UNIFIED_BUFFER_SIZE) != EFAULT) {
+		printf("Block write out of bounds wasn't detected!\n\r");
+		return;
+	}
+
+	if(read_output_block(vectors, 0, UNIFIED_BUFFER_SIZE)) {
+		printf("Bad address on block read!\n\r");
+		return;
+	}
+
+	srand(SEED);
+	for(uint32_t address = 0; address < UNIFIED_BUFFER_SIZE; ++address) {
+		for(int32_t i = 0; i < sizeof(vectors[address].byte_vector); ++i) {
+			uint8_t value = rand();
+			if(value != vectors[address].byte_vector[i]) {
+				printf("Read wrong value at address 0x%08x! Value was 0x%02x but should be 0x%02x.\n\r", address, vectors[address].byte_vector[i], value);
+				return;
+			}
+		}
+	}
+
+	printf("Unified buffer block test was successful!\n\r");
+}
+
+void test_instruction_queue(void) {
+	static tpu_queue_t queue;
+	instruction_t nops[100];
+
+	for(uint32_t i = 0; i < 100; ++i) {
+		set_instruction(&nops[i], TPU_OP_NOP, 0, 0, 0);
+	}
+
+	if(tpu_queue_init(&queue, TPU_MAPPED_BASE)) {
+		printf("Bad address on instruction count!\n\r");
+		return;
+	}
+	uint32_t first_count = queue.retired;
+
+	// More instructions than the ring can hold
+	for(uint32_t i = 0; i < 4*TPU_QUEUE_SIZE/100; ++i) {
+		uint32_t pushed = 0;
+		while(pushed < 100) {
+			pushed += tpu_queue_push(&queue, &nops[pushed], 100-pushed);
+		}
+	}
+	tpu_queue_flush(&queue);
+
+	uint32_t count;
+	do {
+		read_instruction_count(&count);
+	} while(count != queue.submitted && count - first_count < 4*TPU_QUEUE_SIZE/100*100);
+
+	if(count - first_count != 4*TPU_QUEUE_SIZE/100*100) {
+		printf("Instruction count is %u but should be %u!\n\r", count - first_count, 4*TPU_QUEUE_SIZE/100*100);
+		return;
+	}
+
+	printf("Instruction queue test was successful!\n\r");
+}
+
+static int32_t parsed_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	parsed_program_t *parsed = (parsed_program_t*)context;
+	if(address != parsed->weight_count || count > PARSER_VECTORS - address) return EFAULT;
+	memcpy(&parsed->weights[address], vectors, count*sizeof(tpu_vector_t));
+	parsed->weight_count += count;
+	return 0;
+}
+
+static int32_t parsed_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	parsed_program_t *parsed = (parsed_program_t*)context;
+	if(address != parsed->input_count || count > PARSER_VECTORS - address) return EFAULT;
+	memcpy(&parsed->inputs[address], vectors, count*sizeof(tpu_vector_t));
+	parsed->input_count += count;
+	return 0;
+}
+
+static int32_t parsed_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	parsed_program_t *parsed = (parsed_program_t*)context;
+	if(count > PARSER_INSTRUCTIONS - parsed->instruction_count) return EFAULT;
+	memcpy(&parsed->instructions[parsed->instruction_count], instructions, count*sizeof(instruction_t));
+	parsed->instruction_count += count;
+	return 0;
+}
+
+static int32_t parsed_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	parsed_program_t *parsed = (parsed_program_t*)context;
+	if(count > PARSER_RESULTS - parsed->result_count) return EFAULT;
+	memcpy(&parsed->results[parsed->result_count], results, count*sizeof(tpu_bundle_result_t));
+	parsed->result_count += count;
+	return 0;
+}
+
+static int32_t parsed_section_end(void *context, tpu_section_type_t type) {
+	(void)type;
+	((parsed_program_t*)context)->section_count++;
+	return 0;
+}
+
+/**
+ * Prints a vector section of transfer_complete_model.py. Elements are written as signed decimal, hexadecimal and octal numbers in turn.
+ */
+static uint32_t print_vectors(char *text, uint32_t size, const char *keyword, tpu_vector_t *vectors) {
+	uint32_t length = snprintf(text, size, "%s[\n", keyword);
+
+	for(uint32_t v = 0; v < PARSER_VECTORS; ++v) {
+		length += snprintf(text + length, size - length, "[");
+		for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+			uint8_t value = vectors[v].byte_vector[i];
+			const char *separator = i + 1 < TPU_VECTOR_SIZE ? ", " : "";
+			switch((v + i) % 3) {
+				case 0:
+					length += snprintf(text + length, size - length, "%d%s", (int8_t)value, separator);
+					break;
+				case 1:
+					length += snprintf(text + length, size - length, "0x%X%s", value, separator);
+					break;
+				default:
+					length += snprintf(text + length, size - length, "%#o%s", value, separator);
+			}
+		}
+		length += snprintf(text + length, size - length, "]\r\n");
+	}
+
+	return length + snprintf(text + length, size - length, "]\n");
+}
+
+void test_parser_round_trip(void) {
+	// Up to 6 characters per element
+	static char text[2*PARSER_VECTORS*(6*TPU_VECTOR_SIZE + 8) + 40*PARSER_INSTRUCTIONS + 1024];
+	static parsed_program_t program;
+	static parsed_program_t parsed;
+	static tpu_parser_t parser;
+	tpu_bundle_handler_t handler;
+
+	printf("Testing round trip of the parser...\n\r");
+
+	srand(SEED);
+	for(uint32_t v = 0; v < PARSER_VECTORS; ++v) {
+		for(uint32_t i = 0; i < sizeof(program.weights[v].byte_vector); ++i) {
+			program.weights[v].byte_vector[i] = rand();
+			program.inputs[v].byte_vector[i] = rand();
+		}
+	}
+	for(uint32_t i = 0; i < PARSER_INSTRUCTIONS; ++i) {
+		if(i % 2) {
+			set_instruction(&program.instructions[i], TPU_OP_MATRIX_MULTIPLY | TPU_MULTIPLY_SIGNED, rand(), rand() & 0xFFFF, rand() & 0xFFFFFF);
+		} else {
+			set_weight_instruction(&program.instructions[i], TPU_OP_READ_WEIGHTS, rand(), (uint64_t)rand() << 8 | (rand() & 0xFF));
+		}
+	}
+	for(uint32_t r = 0; r < PARSER_RESULTS; ++r) {
+		program.results[r].address = rand() % UNIFIED_BUFFER_SIZE;
+		program.results[r].length = rand() % TPU_VECTOR_SIZE + 1;
+		program.results[r].append = r % 2;
+	}
+
+	uint32_t size = sizeof(text);
+	uint32_t length = print_vectors(text, size, "weights:", program.weights);
+	length += print_vectors(text + length, size - length, "inputs:", program.inputs);
+	length += snprintf(text + length, size - length, "instructions:[\n");
+	for(uint32_t i = 0; i < PARSER_INSTRUCTIONS; ++i) {
+		instruction_t *instruction = &program.instructions[i];
+		if(i % 2) {
+			length += snprintf(text + length, size - length, "[%u,%u,0x%x,%u]\n", instruction->op_code, get_calc_length(instruction), get_acc_address(instruction), get_buf_address(instruction));
+		} else {
+			length += snprintf(text + length, size - length, "[%u, %u, 0x%llx]\n", instruction->op_code, get_calc_length(instruction), (unsigned long long)get_weight_address(instruction));
+		}
+	}
+	length += snprintf(text + length, size - length, "]\nresults:[\n");
+	for(uint32_t r = 0; r < PARSER_RESULTS; ++r) {
+		length += snprintf(text + length, size - length, "[%u,%u,%u]\n", program.results[r].address, program.results[r].length, program.results[r].append);
+	}
+	length += snprintf(text + length, size - length, "]\n");
+	if(length >= size) {
+		printf("Parser test program doesn't fit into %u bytes!\n\r", size);
+		return;
+	}
+
+	memset(&parsed, 0, sizeof(parsed));
+	tpu_bundle_default_handler(&handler);
+	handler.context = &parsed;
+	handler.weights = parsed_weights;
+	handler.inputs = parsed_inputs;
+	handler.instructions = parsed_instructions;
+	handler.results = parsed_results;
+	handler.section_end = parsed_section_end;
+	tpu_parser_init(&parser, &handler);
+
+	int32_t error = 0;
+	for(uint32_t offset = 0; offset < length && !error; offset += PARSER_BLOCK) {
+		error = tpu_parser_feed(&parser, text + offset, length - offset < PARSER_BLOCK ? length - offset : PARSER_BLOCK);
+	}
+	if(!error) error = tpu_parser_finish(&parser);
+	if(error) {
+		printf("Parser failed in line %u with error code %d!\n\r", parser.line, error);
+		return;
+	}
+
+	if(parsed.weight_count != PARSER_VECTORS || parsed.input_count != PARSER_VECTORS || parsed.instruction_count != PARSER_INSTRUCTIONS
+		|| parsed.result_count != PARSER_RESULTS || parsed.section_count != 4) {
+		printf("Parser read %u weights, %u inputs, %u instructions, %u results and %u sections!\n\r",
+			parsed.weight_count, parsed.input_count, parsed.instruction_count, parsed.result_count, parsed.section_count);
+		return;
+	}
+
+	for(uint32_t v = 0; v < PARSER_VECTORS; ++v) {
+		if(memcmp(program.weights[v].byte_vector, parsed.weights[v].byte_vector, TPU_VECTOR_SIZE)
+			|| memcmp(program.inputs[v].byte_vector, parsed.inputs[v].byte_vector, TPU_VECTOR_SIZE)) {
+			printf("Parser read a wrong vector at address 0x%08x!\n\r", v);
+			return;
+		}
+	}
+
+	// The padding of instruction_t isn't written by the parser
+	for(uint32_t i = 0; i < PARSER_INSTRUCTIONS; ++i) {
+		if(memcmp(&program.instructions[i], &parsed.instructions[i], TPU_INSTRUCTION_SIZE)) {
+			printf("Parser read a wrong instruction %u!\n\r", i);
+			return;
+		}
+	}
+
+	if(memcmp(program.results, parsed.results, sizeof(program.results))) {
+		printf("Parser read wrong results!\n\r");
+		return;
+	}
+
+	printf("Parser round trip test was successful!\n\r");
+}
@@ -31,4 +31,10 @@
 
 void test_unified_access(void);
 
+void test_unified_block_access(void);
+
+void test_instruction_queue(void);
+
+void test_parser_round_trip(void);
+
 #endif /* SRC_ACCESS_TEST_H_ */
@@ -0,0 +1,178 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * benchmark_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "access_benchmark.h"
+#include "tinyTPU_access.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#define BENCHMARK_WARMUP		10
+#define BENCHMARK_REPEATS		200
+#define BENCHMARK_OPERATIONS	1024
+
+#ifdef BENCHMARK
+#ifdef __linux__
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+// Covers all address windows of the AXI slave
+#define BENCHMARK_MAP_SIZE (TPU_INSTRUCTION_OFFSET + 0x10000)
+// Allowed slowdown of the median against a baseline in percent
+#define BENCHMARK_TOLERANCE 10
+
+static uint64_t monotonic_clock(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec*1000000000ULL + time.tv_nsec;
+}
+
+/**
+ * Maps the AXI slave or memory, which stands in for it, to TPU_BASE, so the access layer runs unchanged.
+ */
+static int map_tpu(uint8_t hardware) {
+	void *address;
+	if(hardware) {
+		int file = open("/dev/mem", O_RDWR | O_SYNC);
+		if(file < 0) return -1;
+		address = mmap((void*)TPU_BASE, BENCHMARK_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED_NOREPLACE, file, TPU_BASE);
+		close(file);
+	} else {
+		address = mmap((void*)TPU_BASE, BENCHMARK_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	}
+	return address == (void*)TPU_BASE ? 0 : -1;
+}
+
+/**
+ * Compares the medians with a CSV of an earlier run, returns the number of regressions.
+ */
+static uint32_t compare_baseline(const char *file_name, benchmark_result_t *results, uint32_t count, uint32_t tolerance) {
+	FILE *file = fopen(file_name, "r");
+	if(file == NULL) {
+		printf("Error opening baseline %s!\n", file_name);
+		return 1;
+	}
+
+	char line[256];
+	uint32_t regressions = 0;
+	while(fgets(line, sizeof(line), file) != NULL) {
+		char function[64], pattern[64];
+		double median_ns;
+		if(sscanf(line, "%63[^,],%63[^,],%*u,%*u,%*f,%lf", function, pattern, &median_ns) != 3) continue;
+
+		for(uint32_t i = 0; i < count; ++i) {
+			if(strcmp(results[i].function, function) || strcmp(results[i].pattern, pattern)) continue;
+			if(results[i].median_ns > median_ns*(100 + tolerance)/100) {
+				printf("Regression of %s (%s): %.2f ns instead of %.2f ns!\n", function, pattern, results[i].median_ns, median_ns);
+				regressions++;
+			}
+		}
+	}
+
+	fclose(file);
+	return regressions;
+}
+
+/**
+ * Benchmarks the access layer against memory, which stands in for the TPU, or with -m against the hardware through /dev/mem.
+ * Results are printed as CSV. With -b, the medians are compared with a CSV of an earlier run.
+ */
+int main(int argc, char *argv[]) {
+	benchmark_config_t config = {monotonic_clock, BENCHMARK_WARMUP, BENCHMARK_REPEATS, BENCHMARK_OPERATIONS, 0};
+	const char *baseline = NULL;
+	uint32_t tolerance = BENCHMARK_TOLERANCE;
+	int option;
+
+	while((option = getopt(argc, argv, "mw:r:n:b:t:")) != -1) {
+		switch(option) {
+			case 'm':
+				config.drain_fifo = 1;
+				break;
+			case 'w':
+				config.warmup = strtoul(optarg, NULL, 0);
+				break;
+			case 'r':
+				config.repeats = strtoul(optarg, NULL, 0);
+				break;
+			case 'n':
+				config.operations = strtoul(optarg, NULL, 0);
+				break;
+			case 'b':
+				baseline = optarg;
+				break;
+			case 't':
+				tolerance = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				printf("Usage: %s [-m] [-w warmup] [-r repeats] [-n operations] [-b baseline file] [-t tolerance]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if(map_tpu(config.drain_fifo)) {
+		printf("Error mapping the TPU to 0x%08x!\n", TPU_BASE);
+		return 1;
+	}
+
+	static benchmark_result_t results[BENCHMARK_RESULTS];
+	uint32_t count = benchmark_access(&config, results);
+	benchmark_print(results, count);
+
+	if(baseline != NULL && compare_baseline(baseline, results, count, tolerance)) return 1;
+	return 0;
+}
+#else
+#include "platform.h"
+#include "xtime_l.h"
+
+static uint64_t global_clock(void) {
+	XTime time;
+	XTime_GetTime(&time);
+	return (time/COUNTS_PER_SECOND)*1000000000ULL + (time%COUNTS_PER_SECOND)*1000000000ULL/COUNTS_PER_SECOND;
+}
+
+int main(void) {
+	init_platform();
+
+	benchmark_config_t config = {global_clock, BENCHMARK_WARMUP, BENCHMARK_REPEATS, BENCHMARK_OPERATIONS, 1};
+	static benchmark_result_t results[BENCHMARK_RESULTS];
+	uint32_t count = benchmark_access(&config, results);
+	benchmark_print(results, count);
+
+	cleanup_platform();
+	return 0;
+}
+#endif
+#endif
@@ -0,0 +1,273 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * compiler_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_compiler.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#define INSTRUCTION_FILE_NAME "instructions.txt"
+#define KERNEL_PREFIX "kernel"
+#define KERNEL_SUFFIX ".csv"
+#define MAX_LAYERS 64
+
+#ifdef COMPILER
+static double now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec*1e-9;
+}
+
+/**
+ * Reads the size of a kernel from its CSV file. The weights are read, if the kernel isn't dense.
+ */
+static int32_t read_kernel(const char *path, tpu_compiler_layer_t *layer, uint8_t dense) {
+	FILE *file = fopen(path, "r");
+	if(file == NULL) return EIO;
+
+	int8_t *kernel = NULL;
+	uint32_t size = 0;
+	layer->rows = 0;
+	layer->columns = 0;
+	layer->kernel = NULL;
+
+	char line[65536];
+	while(fgets(line, sizeof(line), file) != NULL) {
+		if(line[0] == '\n' || line[0] == '\r') continue;
+
+		if(layer->rows == 0) {
+			layer->columns = 1;
+			for(char *c = line; *c; ++c) {
+				if(*c == ',') layer->columns++;
+			}
+		}
+
+		if(!dense) {
+			if((layer->rows + 1)*layer->columns > size) {
+				uint32_t new_size = size ? 2*size : layer->columns*64;
+				int8_t *resized = realloc(kernel, new_size);
+				if(resized == NULL) {
+					free(kernel);
+					fclose(file);
+					return ENOMEM;
+				}
+				kernel = resized;
+				size = new_size;
+			}
+
+			char *position = line;
+			for(uint32_t c = 0; c < layer->columns; ++c) {
+				kernel[layer->rows*layer->columns + c] = (int8_t)strtol(position, &position, 0);
+				while(*position == ',' || *position == ' ') position++;
+			}
+		}
+		layer->rows++;
+	}
+
+	fclose(file);
+	layer->kernel = kernel;
+	return layer->rows ? 0 : EINVAL;
+}
+
+/**
+ * Matches kernel<number>.csv like transfer_instructions.py.
+ */
+static int is_kernel(const char *name) {
+	size_t length = strlen(name);
+	size_t prefix = strlen(KERNEL_PREFIX);
+	size_t suffix = strlen(KERNEL_SUFFIX);
+
+	if(length <= prefix + suffix) return 0;
+	if(strncmp(name, KERNEL_PREFIX, prefix) || strcmp(name + length - suffix, KERNEL_SUFFIX)) return 0;
+	for(size_t i = prefix; i < length - suffix; ++i) {
+		if(name[i] < '0' || name[i] > '9') return 0;
+	}
+	return 1;
+}
+
+static int compare_names(const void *a, const void *b) {
+	return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+/**
+ * Collects the kernel files of the current directory in the order of transfer_instructions.py.
+ */
+static uint32_t find_kernels(char **names) {
+	DIR *directory = opendir(".");
+	if(directory == NULL) return 0;
+
+	uint32_t count = 0;
+	struct dirent *entry;
+	while((entry = readdir(directory)) != NULL && count < MAX_LAYERS) {
+		if(is_kernel(entry->d_name)) names[count++] = strdup(entry->d_name);
+	}
+	closedir(directory);
+
+	qsort(names, count, sizeof(char*), compare_names);
+	return count;
+}
+
+static void write_instruction_text(FILE *file, instruction_t *instruction) {
+	uint8_t op_code = instruction->op_code;
+
+	if(op_code != TPU_OP_SYNCHRONIZE && !(op_code & (TPU_OP_ACTIVATE | TPU_OP_MATRIX_MULTIPLY)) && (op_code & TPU_OP_READ_WEIGHTS)) {
+		fprintf(file, "[%u,%u,%llu]\n", op_code, get_calc_length(instruction), (unsigned long long)get_weight_address(instruction));
+	} else if(op_code == TPU_OP_SYNCHRONIZE || op_code == TPU_OP_NOP || op_code == TPU_OP_HALT) {
+		fprintf(file, "[%u,0,0]\n", op_code);
+	} else {
+		fprintf(file, "[%u,%u,%u,%u]\n", op_code, get_calc_length(instruction), get_acc_address(instruction), get_buf_address(instruction));
+	}
+}
+
+/**
+ * Compiles the kernels into instructions.txt, which replaces the output of transfer_instructions.py.
+ */
+int main(int argc, char *argv[]) {
+	tpu_compiler_config_t config;
+	tpu_compiler_default_config(&config);
+
+	uint8_t activation = TPU_SIGMOID;
+	uint8_t dense = 0;
+	const char *output_name = INSTRUCTION_FILE_NAME;
+
+	int option;
+	while((option = getopt(argc, argv, "g:b:a:o:ud")) != -1) {
+		switch(option) {
+			case 'g':
+				config.group_size = strtoul(optarg, NULL, 0);
+				break;
+			case 'b':
+				config.batches = strtoul(optarg, NULL, 0);
+				break;
+			case 'a':
+				activation = strtoul(optarg, NULL, 0);
+				break;
+			case 'o':
+				output_name = optarg;
+				break;
+			case 'u':
+				config.is_signed = 0;
+				break;
+			case 'd':
+				dense = 1;
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+
+	if(optind >= argc) {
+		printf("Usage: %s [-g group size] [-b batches] [-a activation] [-o output file] [-u] [-d] <TPU width> [kernel files]\n", argv[0]);
+		printf("Without kernel files, the files kernel<number>.csv of the current directory are used.\n");
+		printf("All-zero tiles are skipped like transfer_weights.py does, -d expects the dense layout.\n");
+		return 1;
+	}
+
+	config.matrix_width = strtoul(argv[optind++], NULL, 0);
+
+	char *names[MAX_LAYERS];
+	uint32_t layer_count = 0;
+	if(optind < argc) {
+		while(optind < argc && layer_count < MAX_LAYERS) {
+			names[layer_count++] = strdup(argv[optind++]);
+		}
+	} else {
+		layer_count = find_kernels(names);
+	}
+
+	if(layer_count == 0) {
+		printf("No kernels found!\n");
+		return 1;
+	}
+
+	tpu_compiler_layer_t layers[MAX_LAYERS];
+	for(uint32_t l = 0; l < layer_count; ++l) {
+		if(read_kernel(names[l], &layers[l], dense)) {
+			printf("Error reading kernel %s!\n", names[l]);
+			return 1;
+		}
+		layers[l].activation = activation;
+		printf("Layer %u: %s with %u rows and %u columns\n", l, names[l], layers[l].rows, layers[l].columns);
+		free(names[l]);
+	}
+
+	tpu_program_t program;
+	program.capacity = tpu_compiler_max_instructions(&config, layers, layer_count);
+	program.instructions = malloc(program.capacity*sizeof(instruction_t));
+	if(program.instructions == NULL) {
+		printf("Not enough memory for the instructions!\n");
+		return 1;
+	}
+
+	double start = now();
+	int32_t error = tpu_compiler_compile(&config, layers, layer_count, &program);
+	double time = now() - start;
+
+	for(uint32_t l = 0; l < layer_count; ++l) {
+		free((void*)layers[l].kernel);
+	}
+
+	if(error) {
+		printf("Error compiling the kernels with error code %d!\n", error);
+		free(program.instructions);
+		return 1;
+	}
+
+	FILE *file = fopen(output_name, "w");
+	if(file == NULL) {
+		printf("Error creating file %s!\n", output_name);
+		free(program.instructions);
+		return 1;
+	}
+
+	fprintf(file, "instructions:[\n");
+	for(uint32_t i = 0; i < program.count; ++i) {
+		write_instruction_text(file, &program.instructions[i]);
+	}
+	fprintf(file, "]\n");
+	fclose(file);
+
+	printf("Compiled %u instructions in %f milliseconds, group size %u\n", program.count, time*1e3, program.group_size);
+	printf("Simulated cycles: %llu\n", (unsigned long long)program.cycles);
+	printf("Weight buffer rows: %u, unified buffer rows: %u\n", program.weight_rows, program.buffer_rows);
+	printf("Accumulators: %u\n", program.accumulators);
+	for(uint32_t b = 0; b < config.batches; ++b) {
+		printf("Batch %u: inputs at address %u, results at address %u with length %u\n", b, b*program.input_rows, program.output_address + b*program.output_length, program.output_length);
+	}
+
+	free(program.instructions);
+	return 0;
+}
+#endif
@@ -0,0 +1,238 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * compiler_test.c
+ *
+ *  Created on: 17.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "compiler_test.h"
+#include "tinyTPU_access.h"
+#include "tinyTPU_compiler.h"
+#include "tinyTPU_model.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SEED 176
+#define BATCHES 2
+// Batches of the test against the reference
+#define MAX_BATCHES 3
+#define LAYERS 2
+// Dense weight rows of the layers
+#define WEIGHT_ROWS (15*TPU_VECTOR_SIZE)
+#define MAX_KERNEL (4*TPU_VECTOR_SIZE*3*TPU_VECTOR_SIZE)
+#define MAX_FEATURES (4*TPU_VECTOR_SIZE)
+
+// The models are too big for the stack
+static tpu_model_t models[2];
+static int8_t kernels[LAYERS][MAX_KERNEL];
+static tpu_vector_t weights[WEIGHT_ROWS];
+static tpu_vector_t inputs[MAX_BATCHES*MAX_FEATURES];
+
+// Used row tiles of every column tile as bit mask. The second column tile of the first layer has no used tiles at all.
+static const uint8_t used_tiles[LAYERS][3] = {{0x9, 0x0, 0x6}, {0x5}};
+
+static void fill_kernels(tpu_compiler_layer_t *layers) {
+	srand(SEED);
+	for(uint32_t l = 0; l < LAYERS; ++l) {
+		for(uint32_t r = 0; r < layers[l].rows; ++r) {
+			for(uint32_t c = 0; c < layers[l].columns; ++c) {
+				uint8_t used = used_tiles[l][c/TPU_VECTOR_SIZE] & (1 << (r/TPU_VECTOR_SIZE));
+				kernels[l][r*layers[l].columns + c] = used ? (int8_t)rand() : 0;
+			}
+		}
+		layers[l].kernel = kernels[l];
+	}
+}
+
+/**
+ * Writes the weights in the dense layout of transfer_weights.py and returns the number of weight rows.
+ */
+static uint32_t write_dense_weights(tpu_compiler_layer_t *layers) {
+	uint32_t address = 0;
+
+	for(uint32_t l = 0; l < LAYERS; ++l) {
+		uint32_t padded_rows = (layers[l].rows + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE;
+		for(uint32_t column_tile = 0; column_tile*TPU_VECTOR_SIZE < layers[l].columns; ++column_tile) {
+			for(uint32_t r = 0; r < padded_rows; ++r) {
+				tpu_vector_t *vector = &weights[address++];
+				memset(vector, 0, sizeof(tpu_vector_t));
+				for(uint32_t i = 0; i < TPU_VECTOR_SIZE && r < layers[l].rows && column_tile*TPU_VECTOR_SIZE + i < layers[l].columns; ++i) {
+					vector->byte_vector[i] = kernels[l][r*layers[l].columns + column_tile*TPU_VECTOR_SIZE + i];
+				}
+			}
+		}
+	}
+
+	return address;
+}
+
+/**
+ * Compiles the layers and runs the program on the model with random inputs.
+ */
+static int run_program(const char *name, tpu_model_t *model, tpu_compiler_layer_t *layers, uint32_t batches, tpu_program_t *program) {
+	tpu_compiler_config_t config;
+
+	tpu_compiler_default_config(&config);
+	config.batches = batches;
+
+	program->capacity = tpu_compiler_max_instructions(&config, layers, LAYERS);
+	program->instructions = malloc(program->capacity*sizeof(instruction_t));
+	if(program->instructions == NULL) {
+		printf("Not enough memory for the %s program!\n\r", name);
+		return 0;
+	}
+
+	if(tpu_compiler_compile(&config, layers, LAYERS, program)) {
+		printf("Compiler failed on the %s layers!\n\r", name);
+		return 0;
+	}
+
+	// The weights of the sparse program leave out the all-zero tiles
+	uint32_t weight_rows = program->weight_rows;
+	if(layers[0].kernel && tpu_compiler_weights(&config, layers, LAYERS, weights)) {
+		printf("Compiler failed to write the %s weights!\n\r", name);
+		return 0;
+	}
+	if(layers[0].kernel == NULL && write_dense_weights(layers) != weight_rows) {
+		printf("The %s program doesn't use the dense weight rows!\n\r", name);
+		return 0;
+	}
+
+	tpu_model_init(model);
+	for(uint32_t address = 0; address < weight_rows; ++address) {
+		tpu_model_write_weight_vector(model, &weights[address], address);
+	}
+
+	srand(SEED);
+	for(uint32_t address = 0; address < batches*program->input_rows; ++address) {
+		for(uint32_t i = 0; i < sizeof(inputs[address].byte_vector); ++i) {
+			inputs[address].byte_vector[i] = rand();
+		}
+		tpu_model_write_input_vector(model, &inputs[address], address);
+	}
+
+	if(tpu_model_execute_program(model, program->instructions, program->count)) {
+		printf("Model failed on the %s program!\n\r", name);
+		return 0;
+	}
+
+	return 1;
+}
+
+void test_compiler_sparse(void) {
+	tpu_compiler_layer_t layers[LAYERS] = {
+		{4*TPU_VECTOR_SIZE-3, 3*TPU_VECTOR_SIZE-2, TPU_RELU, NULL},
+		{3*TPU_VECTOR_SIZE-2, TPU_VECTOR_SIZE, TPU_SIGMOID, NULL}
+	};
+	tpu_program_t dense = {NULL};
+	tpu_program_t sparse = {NULL};
+
+	printf("Testing all-zero tiles of the compiler...\n\r");
+
+	// The dense program gets the same kernels without skipping
+	fill_kernels(layers);
+	for(uint32_t l = 0; l < LAYERS; ++l) {
+		layers[l].kernel = NULL;
+	}
+	int passed = run_program("dense", &models[0], layers, BATCHES, &dense);
+
+	fill_kernels(layers);
+	passed = passed && run_program("sparse", &models[1], layers, BATCHES, &sparse);
+
+	if(passed && sparse.weight_rows >= dense.weight_rows) {
+		printf("Sparse program didn't skip any tiles!\n\r");
+		passed = 0;
+	}
+
+	for(uint32_t address = 0; passed && address < UNIFIED_BUFFER_SIZE; ++address) {
+		if(memcmp(&models[0].unified_buffer[address], &models[1].unified_buffer[address], sizeof(tpu_vector_t))) {
+			printf("Sparse program wrote a wrong unified buffer vector at address 0x%08x!\n\r", address);
+			passed = 0;
+		}
+	}
+
+	free(dense.instructions);
+	free(sparse.instructions);
+	if(!passed) return;
+
+	printf("Compiler all-zero tile test was successful!\n\r");
+}
+
+/**
+ * Calculates the layers for every sample on the host and compares the outputs with the outputs of the program.
+ * Inputs of sample s of batch b are at b*input_rows + tile*matrix_width + s, outputs at output_address + b*output_length + tile*matrix_width + s.
+ */
+static int check_reference(tpu_model_t *model, tpu_compiler_layer_t *layers, uint32_t batches, tpu_program_t *program) {
+	int8_t features[2][MAX_FEATURES];
+
+	for(uint32_t b = 0; b < batches; ++b) {
+		for(uint32_t s = 0; s < TPU_VECTOR_SIZE; ++s) {
+			for(uint32_t r = 0; r < layers[0].rows; ++r) {
+				features[0][r] = inputs[b*program->input_rows + r/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE + s].byte_vector[r % TPU_VECTOR_SIZE];
+			}
+
+			for(uint32_t l = 0; l < LAYERS; ++l) {
+				for(uint32_t c = 0; c < layers[l].columns; ++c) {
+					uint32_t accumulator = 0;
+					for(uint32_t r = 0; r < layers[l].rows; ++r) {
+						accumulator += (uint32_t)(features[l % 2][r]*kernels[l][r*layers[l].columns + c]);
+					}
+					features[(l+1) % 2][c] = tpu_model_activate(accumulator, layers[l].activation, 1);
+				}
+			}
+
+			for(uint32_t c = 0; c < layers[LAYERS-1].columns; ++c) {
+				uint32_t address = program->output_address + b*program->output_length + c/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE + s;
+				if((int8_t)model->unified_buffer[address].byte_vector[c % TPU_VECTOR_SIZE] != features[LAYERS % 2][c]) {
+					printf("Compiled program calculated a wrong output %u of sample %u in batch %u!\n\r", c, s, b);
+					return 0;
+				}
+			}
+		}
+	}
+
+	return 1;
+}
+
+void test_compiler_batches(void) {
+	tpu_compiler_layer_t layers[LAYERS] = {
+		{4*TPU_VECTOR_SIZE-3, 3*TPU_VECTOR_SIZE-2, TPU_RELU, NULL},
+		{3*TPU_VECTOR_SIZE-2, TPU_VECTOR_SIZE-1, TPU_RELU, NULL}
+	};
+	int passed = 1;
+
+	printf("Testing batches of the compiler...\n\r");
+
+	fill_kernels(layers);
+	for(uint32_t batches = 1; batches <= MAX_BATCHES && passed; ++batches) {
+		tpu_program_t program = {NULL};
+		passed = run_program("batched", &models[0], layers, batches, &program) && check_reference(&models[0], layers, batches, &program);
+		free(program.instructions);
+	}
+	if(!passed) return;
+
+	printf("Compiler batch test was successful!\n\r");
+}
@@ -0,0 +1,37 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * compiler_test.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_COMPILER_TEST_H_
+#define SRC_COMPILER_TEST_H_
+
+void test_compiler_sparse(void);
+
+void test_compiler_batches(void);
+
+#endif /* SRC_COMPILER_TEST_H_ */
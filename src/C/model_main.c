@@ -0,0 +1,246 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * model_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_model.h"
+#include "tinyTPU_bundle.h"
+#include "tinyTPU_parser.h"
+#include "tinyTPU_trace.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+#define RESULT_FILE_NAME "results.csv"
+
+#ifdef MODEL
+typedef struct model_context {
+	tpu_model_t *model;
+	FILE *result_file;
+	uint32_t instruction_count;
+} model_context_t;
+
+static void store_result(tpu_model_t *model, FILE *result_file, uint32_t address, uint32_t length, char append) {
+	if(!append) {
+		fseek(result_file, 0, SEEK_SET);
+	}
+
+	tpu_vector_t vector;
+	for(uint32_t j = 0; j < length; j++) {
+		if(tpu_model_read_output_vector(model, &vector, address+j)) {
+			printf("Bad address!\n");
+			continue;
+		}
+		for(uint32_t k = 0; k < TPU_VECTOR_SIZE; ++k) {
+			fprintf(result_file, k ? ",%d" : "%d", vector.byte_vector[k]);
+		}
+		fprintf(result_file, "\n");
+	}
+}
+
+static int32_t model_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	for(uint32_t i = 0; i < count; ++i) {
+		if(tpu_model_write_weight_vector(((model_context_t*)context)->model, &vectors[i], address+i)) return EFAULT;
+	}
+	return 0;
+}
+
+static int32_t model_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	for(uint32_t i = 0; i < count; ++i) {
+		if(tpu_model_write_input_vector(((model_context_t*)context)->model, &vectors[i], address+i)) return EFAULT;
+	}
+	return 0;
+}
+
+static int32_t model_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	model_context_t *model_context = (model_context_t*)context;
+	model_context->instruction_count += count;
+	return tpu_model_execute_program(model_context->model, instructions, count);
+}
+
+static int32_t model_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	model_context_t *model_context = (model_context_t*)context;
+	for(uint32_t i = 0; i < count; ++i) {
+		store_result(model_context->model, model_context->result_file, results[i].address, results[i].length, results[i].append);
+	}
+	return 0;
+}
+
+static int32_t model_section_end(void *context, tpu_section_type_t type) {
+	model_context_t *model_context = (model_context_t*)context;
+	if(type == TPU_SECTION_INSTRUCTIONS) {
+		printf("Calculations finished after %u instructions.\n", model_context->instruction_count);
+		model_context->instruction_count = 0;
+	} else if(type == TPU_SECTION_RESULTS) {
+		fflush(model_context->result_file);
+		if(ftruncate(fileno(model_context->result_file), ftell(model_context->result_file))) {
+			printf("Error truncating file!\n");
+		}
+	}
+	return 0;
+}
+
+static int32_t read_file(void *source, void *buffer, uint32_t size, uint32_t *bytes_read) {
+	*bytes_read = fread(buffer, 1, size, (FILE*)source);
+	return ferror((FILE*)source) ? EIO : 0;
+}
+
+static uint64_t monotonic_clock(void *context) {
+	(void)context;
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec*1000000000ULL + time.tv_nsec;
+}
+
+static int32_t write_trace(void *context, const char *data, uint32_t length) {
+	return fwrite(data, 1, length, (FILE*)context) == length ? 0 : EIO;
+}
+
+static int is_bundle(FILE *file) {
+	uint32_t magic;
+	int bundle = fread(&magic, sizeof(magic), 1, file) == 1 && magic == TPU_BUNDLE_MAGIC;
+	rewind(file);
+	return bundle;
+}
+
+/**
+ * Runs a program file of transfer_complete_model.py or a bundle of transfer_bundle.py on the functional model.
+ * Results are written to results.csv in the same format as sd_main.c.
+ * With -t, stages are traced at the granularity of -g (layer, tile or class) and written as Chrome trace JSON.
+ */
+int main(int argc, char *argv[]) {
+	const char *trace_file_name = NULL;
+	tpu_trace_granularity_t granularity = TPU_TRACE_LAYER;
+	int option;
+
+	while((option = getopt(argc, argv, "t:g:")) != -1) {
+		switch(option) {
+			case 't':
+				trace_file_name = optarg;
+				break;
+			case 'g':
+				if(!strcmp(optarg, "layer")) granularity = TPU_TRACE_LAYER;
+				else if(!strcmp(optarg, "tile")) granularity = TPU_TRACE_TILE;
+				else if(!strcmp(optarg, "class")) granularity = TPU_TRACE_CLASS;
+				else {
+					printf("Unknown granularity %s!\n", optarg);
+					return 1;
+				}
+				break;
+			default:
+				printf("Usage: %s [-t trace file] [-g layer|tile|class] <program file> [result file]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if(optind >= argc) {
+		printf("Usage: %s [-t trace file] [-g layer|tile|class] <program file> [result file]\n", argv[0]);
+		return 1;
+	}
+
+	const char *program_file_name = argv[optind];
+	const char *result_file_name = optind+1 < argc ? argv[optind+1] : RESULT_FILE_NAME;
+
+	FILE *file = fopen(program_file_name, "r");
+	if(file == NULL) {
+		printf("Error opening file %s!\n", program_file_name);
+		return 1;
+	}
+
+	FILE *result_file = fopen(result_file_name, "w+");
+	if(result_file == NULL) {
+		printf("Error creating file %s!\n", result_file_name);
+		fclose(file);
+		return 1;
+	}
+
+	tpu_model_t *model = malloc(sizeof(tpu_model_t));
+	tpu_parser_t *parser = malloc(sizeof(tpu_parser_t));
+	tpu_trace_t *trace = malloc(sizeof(tpu_trace_t));
+	if(model == NULL || parser == NULL || trace == NULL) {
+		printf("Not enough memory for the model!\n");
+		return 1;
+	}
+	tpu_model_init(model);
+
+	model_context_t context = {model, result_file, 0};
+	tpu_bundle_handler_t handler = {
+		.context = &context,
+		.weights = model_weights,
+		.inputs = model_inputs,
+		.instructions = model_instructions,
+		.results = model_results,
+		.section_end = model_section_end
+	};
+
+	// The model calculates the instructions, before they return, so the trace doesn't need fences
+	tpu_bundle_handler_t trace_handler;
+	tpu_bundle_handler_t *program_handler = &handler;
+	if(trace_file_name != NULL) {
+		tpu_trace_init(trace, granularity, monotonic_clock, NULL, NULL);
+		tpu_trace_begin(trace, &handler, NULL, NULL, NULL);
+		tpu_trace_handler(trace, &trace_handler);
+		program_handler = &trace_handler;
+	}
+
+	int32_t error;
+	if(is_bundle(file)) {
+		error = tpu_bundle_map_file(program_file_name, program_handler);
+		if(error) {
+			printf("Error loading bundle with error code %d!\n", error);
+		}
+	} else {
+		tpu_parser_init(parser, program_handler);
+		error = tpu_parser_stream(parser, read_file, file);
+		if(error) {
+			printf("Error in line %u with error code %d!\n", parser->line, error);
+		}
+	}
+
+	if(trace_file_name != NULL) {
+		FILE *trace_file = fopen(trace_file_name, "w");
+		if(trace_file == NULL || tpu_trace_write(trace, write_trace, trace_file)) {
+			printf("Error writing trace %s!\n", trace_file_name);
+		} else {
+			printf("Traced %u events, %u dropped.\n", trace->event_count, trace->dropped);
+		}
+		if(trace_file != NULL) fclose(trace_file);
+	}
+
+	free(trace);
+	free(parser);
+	free(model);
+	fclose(result_file);
+	fclose(file);
+
+	return error ? 1 : 0;
+}
+#endif
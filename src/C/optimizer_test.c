@@ -0,0 +1,242 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * optimizer_test.c
+ *
+ *  Created on: 17.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "optimizer_test.h"
+#include "tinyTPU_access.h"
+#include "tinyTPU_model.h"
+#include "tinyTPU_optimizer.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SEED 176
+#define MAX_INSTRUCTIONS 64
+// Vectors of the weight and unified buffer, which are filled with random values
+#define FILLED_VECTORS 1024
+#define FILLED_BIASES 4
+
+#define SIGNED_MULTIPLY (TPU_OP_MATRIX_MULTIPLY | TPU_MULTIPLY_SIGNED)
+#define SIGNED_ACCUMULATE (TPU_OP_MATRIX_MULTIPLY | TPU_MULTIPLY_SIGNED | TPU_MULTIPLY_ACCUMULATE)
+#define SIGNED_WEIGHTS (TPU_OP_READ_WEIGHTS | TPU_WEIGHTS_SIGNED)
+#define SIGNED_SIGMOID (TPU_OP_ACTIVATE | TPU_ACTIVATION_SIGNED | TPU_SIGMOID)
+#define BIASED_RELU (TPU_OP_ACTIVATE | TPU_ACTIVATION_SIGNED | TPU_ACTIVATION_BIAS | TPU_RELU)
+
+// The models are too big for the stack
+static tpu_model_t models[2];
+
+static void fill_model(tpu_model_t *model) {
+	tpu_vector_t vector;
+	int32_t biases[TPU_VECTOR_SIZE];
+
+	tpu_model_init(model);
+
+	srand(SEED);
+	for(uint32_t address = 0; address < FILLED_VECTORS; ++address) {
+		for(uint32_t i = 0; i < sizeof(vector.byte_vector); ++i) {
+			vector.byte_vector[i] = rand();
+		}
+		tpu_model_write_weight_vector(model, &vector, address);
+
+		for(uint32_t i = 0; i < sizeof(vector.byte_vector); ++i) {
+			vector.byte_vector[i] = rand();
+		}
+		tpu_model_write_input_vector(model, &vector, address);
+	}
+
+	for(uint32_t address = 0; address < FILLED_BIASES; ++address) {
+		for(int32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+			biases[i] = (rand() & 0xFFFF) - 0x8000;
+		}
+		tpu_model_write_bias(model, biases, address);
+	}
+}
+
+/**
+ * Optimizes the program and runs both versions on the model. The unified buffer and the accumulators have to match.
+ */
+static int check_equivalence(const char *name, instruction_t *program, uint32_t count, tpu_optimizer_stats_t *stats) {
+	instruction_t optimized[MAX_INSTRUCTIONS];
+	uint32_t optimized_count = count;
+
+	memcpy(optimized, program, count*sizeof(instruction_t));
+	if(tpu_optimizer_run(optimized, &optimized_count, stats)) {
+		printf("Optimizer failed on the %s program!\n\r", name);
+		return 0;
+	}
+
+	fill_model(&models[0]);
+	fill_model(&models[1]);
+	if(tpu_model_execute_program(&models[0], program, count) || tpu_model_execute_program(&models[1], optimized, optimized_count)) {
+		printf("Model failed on the %s program!\n\r", name);
+		return 0;
+	}
+
+	for(uint32_t address = 0; address < UNIFIED_BUFFER_SIZE; ++address) {
+		if(memcmp(&models[0].unified_buffer[address], &models[1].unified_buffer[address], sizeof(tpu_vector_t))) {
+			printf("Optimized %s program wrote a wrong unified buffer vector at address 0x%08x!\n\r", name, address);
+			return 0;
+		}
+	}
+
+	for(uint32_t address = 0; address < TPU_REGISTER_DEPTH; ++address) {
+		if(memcmp(models[0].accumulators[address], models[1].accumulators[address], sizeof(models[0].accumulators[address]))) {
+			printf("Optimized %s program left a wrong accumulator at address 0x%08x!\n\r", name, address);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+void test_optimizer_merge(void) {
+	instruction_t program[MAX_INSTRUCTIONS];
+	tpu_optimizer_stats_t stats;
+	uint32_t count = 0;
+
+	printf("Testing optimizer merges.\n\r");
+
+	// Two weight tiles and their multiplies continue each other at the tile boundary
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 0);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_ACCUMULATE, TPU_VECTOR_SIZE, 0, 0);
+	set_instruction(&program[count++], SIGNED_ACCUMULATE, TPU_VECTOR_SIZE, 0, TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_SIGMOID, 7, 0, 600);
+	set_instruction(&program[count++], SIGNED_SIGMOID, TPU_VECTOR_SIZE-7, 7, 607);
+
+	// Multiplies, which end within a tile, can't be merged, because the next one starts with the next weights
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 2*TPU_VECTOR_SIZE);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 3*TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, 10, 20, 100);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, 10, 20, 110);
+
+	// Biased activations only merge with the same bias vector
+	set_bias_instruction(&program[count++], BIASED_RELU, 5, 20, 620, 1);
+	set_bias_instruction(&program[count++], BIASED_RELU, 5, 25, 625, 2);
+	set_bias_instruction(&program[count++], BIASED_RELU, 2, 25, 630, 2);
+	set_bias_instruction(&program[count++], BIASED_RELU, 3, 27, 632, 2);
+
+	if(!check_equivalence("merge", program, count, &stats)) return;
+	if(stats.merged < 4) {
+		printf("Optimizer merged %u instructions but should merge at least 4!\n\r", stats.merged);
+		return;
+	}
+
+	printf("Optimizer merge test was successful!\n\r");
+}
+
+void test_optimizer_reload(void) {
+	instruction_t program[MAX_INSTRUCTIONS];
+	tpu_optimizer_stats_t stats;
+	uint32_t count = 0;
+
+	printf("Testing optimizer weight reloads.\n\r");
+
+	// The weights are still in the preweights, so the second load can be dropped
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 0);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, TPU_VECTOR_SIZE, 0, 0);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 0);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, TPU_VECTOR_SIZE, TPU_VECTOR_SIZE, 200);
+
+	// The same tile twice for the first tiles of a multiply, the second load is still queued and has to stay
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 5*TPU_VECTOR_SIZE);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 5*TPU_VECTOR_SIZE);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 6*TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_ACCUMULATE, 3*TPU_VECTOR_SIZE, 2*TPU_VECTOR_SIZE, 300);
+	// Without a load, the last tile stays in the weights
+	set_instruction(&program[count++], SIGNED_MULTIPLY, TPU_VECTOR_SIZE, 3*TPU_VECTOR_SIZE, 400);
+
+	// Loads of more than one tile aren't in the preweights completely and have to stay
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, 2*TPU_VECTOR_SIZE, 7*TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_ACCUMULATE, 2*TPU_VECTOR_SIZE, 4*TPU_VECTOR_SIZE, 500);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, 2*TPU_VECTOR_SIZE, 7*TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_ACCUMULATE, 2*TPU_VECTOR_SIZE, 5*TPU_VECTOR_SIZE, 530);
+
+	// Unsigned loads of the same weights change the preweights
+	set_weight_instruction(&program[count++], TPU_OP_READ_WEIGHTS, TPU_VECTOR_SIZE, 7*TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, TPU_VECTOR_SIZE, 6*TPU_VECTOR_SIZE, 560);
+
+	set_instruction(&program[count++], SIGNED_SIGMOID, 7*TPU_VECTOR_SIZE, 0, 700);
+
+	if(!check_equivalence("reload", program, count, &stats)) return;
+	if(stats.dropped != 1) {
+		printf("Optimizer dropped %u instructions but should drop 1!\n\r", stats.dropped);
+		return;
+	}
+
+	printf("Optimizer reload test was successful!\n\r");
+}
+
+/**
+ * Builds multiplies into two accumulator ranges and their activations behind a last multiply, which the activations
+ * can be moved past, if it doesn't touch their accumulators or unified buffer.
+ */
+static uint32_t build_reorder(instruction_t *program, uint16_t acc_address, uint16_t last_acc_address, uint32_t last_buf_address) {
+	uint32_t count = 0;
+
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 0);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, TPU_VECTOR_SIZE, 100, 0);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, TPU_VECTOR_SIZE, acc_address, TPU_VECTOR_SIZE);
+	set_weight_instruction(&program[count++], SIGNED_WEIGHTS, TPU_VECTOR_SIZE, 2*TPU_VECTOR_SIZE);
+	set_instruction(&program[count++], SIGNED_MULTIPLY, TPU_VECTOR_SIZE, last_acc_address, last_buf_address);
+	set_instruction(&program[count++], SIGNED_SIGMOID, TPU_VECTOR_SIZE, 100, 800);
+	set_instruction(&program[count++], SIGNED_SIGMOID, TPU_VECTOR_SIZE, acc_address, 820);
+
+	return count;
+}
+
+void test_optimizer_reorder(void) {
+	instruction_t program[MAX_INSTRUCTIONS];
+	tpu_optimizer_stats_t stats;
+	uint32_t count;
+
+	printf("Testing optimizer reordering.\n\r");
+
+	// Independent multiply
+	count = build_reorder(program, 200, 300, 2*TPU_VECTOR_SIZE);
+	if(!check_equivalence("independent reorder", program, count, &stats)) return;
+	if(stats.moved == 0) {
+		printf("Optimizer didn't move the activations past an independent multiply!\n\r");
+		return;
+	}
+
+	// Overwrites accumulators of the activation
+	count = build_reorder(program, 200, 205, 2*TPU_VECTOR_SIZE);
+	if(!check_equivalence("accumulator reorder", program, count, &stats)) return;
+
+	// Overwrites accumulators of the activation after they wrapped around
+	count = build_reorder(program, TPU_REGISTER_DEPTH-7, 2, 2*TPU_VECTOR_SIZE);
+	if(!check_equivalence("wrapped accumulator reorder", program, count, &stats)) return;
+
+	// Reads the unified buffer of the activation
+	count = build_reorder(program, 200, 300, 820);
+	if(!check_equivalence("unified buffer reorder", program, count, &stats)) return;
+
+	printf("Optimizer reorder test was successful!\n\r");
+}
@@ -0,0 +1,234 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * parser_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_parser.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define WEIGHTS "weights:["
+#define INPUTS "inputs:["
+#define INSTRUCTIONS "instructions:["
+#define RESULTS "results:["
+#define END "]"
+
+// Minimum time of every measurement in seconds
+#define MINIMUM_TIME 1.0
+
+#ifdef PARSER
+typedef struct counter {
+	uint64_t vectors;
+	uint64_t instructions;
+	uint64_t results;
+	// Keeps the compiler from removing the parsing
+	uint64_t checksum;
+} counter_t;
+
+static int32_t count_vectors(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	counter_t *counter = (counter_t*)context;
+	counter->vectors += count;
+	for(uint32_t i = 0; i < count; ++i) counter->checksum += vectors[i].byte_vector[0] + address;
+	return 0;
+}
+
+static int32_t count_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	counter_t *counter = (counter_t*)context;
+	counter->instructions += count;
+	for(uint32_t i = 0; i < count; ++i) counter->checksum += instructions[i].op_code;
+	return 0;
+}
+
+static int32_t count_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	(void)results;
+	((counter_t*)context)->results += count;
+	return 0;
+}
+
+static double now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec*1e-9;
+}
+
+/**
+ * Equivalent of f_gets on a file in memory.
+ */
+static char *get_line(char *message, uint32_t size, const char **text, const char *end) {
+	uint32_t i = 0;
+	if(*text >= end) return NULL;
+	while(*text < end && i < size-1) {
+		char c = *(*text)++;
+		message[i++] = c;
+		if(c == '\n') break;
+	}
+	message[i] = '\0';
+	return message;
+}
+
+/**
+ * The line based parsing of the former sd_main.c, as a reference.
+ */
+static void parse_lines(const char *text, uint32_t size, counter_t *counter) {
+	const char *end = text + size;
+	char message[1024];
+	char *pos;
+	uint32_t section = 0;
+
+	while(get_line(message, sizeof(message), &text, end) == message) {
+		if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
+		if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
+
+		if(section == 0) {
+			if(strncmp(WEIGHTS, message, sizeof(WEIGHTS)) == 0 || strncmp(INPUTS, message, sizeof(INPUTS)) == 0) section = TPU_SECTION_WEIGHTS;
+			if(strncmp(INSTRUCTIONS, message, sizeof(INSTRUCTIONS)) == 0) section = TPU_SECTION_INSTRUCTIONS;
+			if(strncmp(RESULTS, message, sizeof(RESULTS)) == 0) section = TPU_SECTION_RESULTS;
+			continue;
+		}
+		if(strncmp(END, message, sizeof(END)) == 0) {
+			section = 0;
+			continue;
+		}
+
+		uint32_t i = 0;
+		char *str = strtok(message, "[,]");
+		if(section == TPU_SECTION_WEIGHTS) {
+			tpu_vector_t vector;
+			while(str != NULL) {
+				if(i < TPU_VECTOR_SIZE) vector.byte_vector[i++] = atoi(str);
+				str = strtok(NULL, "[,]");
+			}
+			count_vectors(counter, &vector, 0, 1);
+		} else {
+			uint64_t fields[4];
+			while(str != NULL) {
+				if(i < 4) fields[i++] = strtoull(str, NULL, 0);
+				str = strtok(NULL, "[,]");
+			}
+			if(section == TPU_SECTION_INSTRUCTIONS) {
+				instruction_t instruction;
+				if(i <= 3) {
+					set_weight_instruction(&instruction, fields[0], fields[1], fields[2]);
+				} else {
+					set_instruction(&instruction, fields[0], fields[1], fields[2], fields[3]);
+				}
+				count_instructions(counter, &instruction, 1);
+			} else {
+				counter->results++;
+			}
+		}
+	}
+}
+
+static int32_t parse_blocks(tpu_parser_t *parser, const char *text, uint32_t size) {
+	for(uint32_t offset = 0; offset < size; offset += TPU_PARSER_BUFFER_SIZE) {
+		uint32_t length = size - offset;
+		if(length > TPU_PARSER_BUFFER_SIZE) length = TPU_PARSER_BUFFER_SIZE;
+
+		// Copy like a block read of f_read
+		memcpy(parser->buffer, text + offset, length);
+		int32_t error = tpu_parser_feed(parser, parser->buffer, length);
+		if(error) return error;
+	}
+	return tpu_parser_finish(parser);
+}
+
+static void print_result(const char *name, uint32_t size, uint32_t iterations, double time, counter_t *counter) {
+	printf("%-12s %10.2f MB/s   %llu vectors, %llu instructions, %llu results\n", name,
+			(double)size*iterations/time/1e6,
+			(unsigned long long)(counter->vectors/iterations),
+			(unsigned long long)(counter->instructions/iterations),
+			(unsigned long long)(counter->results/iterations));
+}
+
+/**
+ * Measures the parsing throughput of a program file in memory, without the time for reading the file.
+ */
+int main(int argc, char *argv[]) {
+	if(argc < 2) {
+		printf("Usage: %s <program file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE *file = fopen(argv[1], "rb");
+	if(file == NULL) {
+		printf("Error opening file %s!\n", argv[1]);
+		return 1;
+	}
+	fseek(file, 0, SEEK_END);
+	uint32_t size = ftell(file);
+	rewind(file);
+
+	char *text = malloc(size);
+	tpu_parser_t *parser = malloc(sizeof(tpu_parser_t));
+	if(text == NULL || parser == NULL || fread(text, 1, size, file) != size) {
+		printf("Error reading file %s!\n", argv[1]);
+		return 1;
+	}
+	fclose(file);
+
+	counter_t counter;
+	tpu_bundle_handler_t handler = {
+		.context = &counter,
+		.weights = count_vectors,
+		.inputs = count_vectors,
+		.instructions = count_instructions,
+		.results = count_results,
+		.section_end = NULL
+	};
+
+	uint32_t iterations;
+	double start, time;
+
+	memset(&counter, 0, sizeof(counter));
+	start = now();
+	for(iterations = 0; (time = now() - start) < MINIMUM_TIME; ++iterations) {
+		parse_lines(text, size, &counter);
+	}
+	print_result("line based", size, iterations, time, &counter);
+
+	memset(&counter, 0, sizeof(counter));
+	start = now();
+	for(iterations = 0; (time = now() - start) < MINIMUM_TIME; ++iterations) {
+		tpu_parser_init(parser, &handler);
+		int32_t error = parse_blocks(parser, text, size);
+		if(error) {
+			printf("Error in line %u with error code %d!\n", parser->line, error);
+			return 1;
+		}
+	}
+	print_result("single pass", size, iterations, time, &counter);
+
+	free(parser);
+	free(text);
+
+	return 0;
+}
+#endif
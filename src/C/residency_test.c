@@ -0,0 +1,218 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * residency_test.c
+ *
+ *  Created on: 17.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "residency_test.h"
+#include "tinyTPU_access.h"
+#include "tinyTPU_model.h"
+#include "tinyTPU_residency.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Two programs don't fit into the weight buffer together, every group of the programs reads three tiles
+#define PROGRAM_TILES ((2*TPU_RESIDENCY_SLOTS/3)/3*3)
+#define GROUPS (PROGRAM_TILES/3)
+#define MAX_INSTRUCTIONS (3*GROUPS)
+#define INPUT_VECTORS (3*TPU_VECTOR_SIZE)
+#define OUTPUT_GROUPS 64
+
+#define SIGNED_MULTIPLY (TPU_OP_MATRIX_MULTIPLY | TPU_MULTIPLY_SIGNED)
+#define SIGNED_WEIGHTS (TPU_OP_READ_WEIGHTS | TPU_WEIGHTS_SIGNED)
+#define SIGNED_RELU (TPU_OP_ACTIVATE | TPU_ACTIVATION_SIGNED | TPU_RELU)
+
+// The models are too big for the stack, the first one is behind the cache
+static tpu_model_t models[2];
+static tpu_residency_t residency;
+static tpu_vector_t weights[PROGRAM_TILES*TPU_VECTOR_SIZE];
+static tpu_vector_t inputs[INPUT_VECTORS];
+static instruction_t program[MAX_INSTRUCTIONS];
+// Instructions, which were rewritten by the cache, a read_weights is split into two pieces at most
+static instruction_t emitted[2*MAX_INSTRUCTIONS];
+static uint32_t emitted_count;
+
+static int32_t sink_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	for(uint32_t i = 0; i < count; ++i) {
+		tpu_model_write_weight_vector((tpu_model_t*)context, &vectors[i], address + i);
+	}
+	return 0;
+}
+
+static int32_t sink_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	for(uint32_t i = 0; i < count; ++i) {
+		tpu_model_write_input_vector((tpu_model_t*)context, &vectors[i], address + i);
+	}
+	return 0;
+}
+
+static int32_t sink_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	if(emitted_count + count > 2*MAX_INSTRUCTIONS) return ENOMEM;
+	memcpy(&emitted[emitted_count], instructions, count*sizeof(instruction_t));
+	emitted_count += count;
+	return tpu_model_execute_program((tpu_model_t*)context, instructions, count);
+}
+
+/**
+ * Fills the weights and the instructions of a program with random tiles. The second tile is a copy of the first one.
+ */
+static void build_program(uint32_t seed) {
+	srand(seed);
+	for(uint32_t row = 0; row < PROGRAM_TILES*TPU_VECTOR_SIZE; ++row) {
+		for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+			weights[row].byte_vector[i] = row/TPU_VECTOR_SIZE == 1 ? weights[row - TPU_VECTOR_SIZE].byte_vector[i] : rand();
+		}
+	}
+	for(uint32_t row = 0; row < INPUT_VECTORS; ++row) {
+		for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+			inputs[row].byte_vector[i] = rand();
+		}
+	}
+
+	for(uint32_t g = 0; g < GROUPS; ++g) {
+		set_weight_instruction(&program[3*g], SIGNED_WEIGHTS, 3*TPU_VECTOR_SIZE, 3*g*TPU_VECTOR_SIZE);
+		set_instruction(&program[3*g+1], SIGNED_MULTIPLY, 3*TPU_VECTOR_SIZE, 0, 0);
+		set_instruction(&program[3*g+2], SIGNED_RELU, TPU_VECTOR_SIZE, 0, INPUT_VECTORS + (g % OUTPUT_GROUPS)*TPU_VECTOR_SIZE);
+	}
+}
+
+/**
+ * Checks, that every read_weights of the program reads the same rows from the resident tiles, as it read from the program.
+ */
+static int check_remapped(void) {
+	uint32_t e = 0;
+
+	for(uint32_t i = 0; i < MAX_INSTRUCTIONS; ++i) {
+		if(program[i].op_code != SIGNED_WEIGHTS) {
+			if(e >= emitted_count || memcmp(&program[i], &emitted[e++], sizeof(instruction_t))) {
+				printf("Residency cache changed instruction %u!\n\r", i);
+				return 0;
+			}
+			continue;
+		}
+
+		uint32_t address = (uint32_t)get_weight_address(&program[i]);
+		uint32_t length = get_calc_length(&program[i]);
+		for(uint32_t read = 0; read < length; ++e) {
+			if(e >= emitted_count || emitted[e].op_code != SIGNED_WEIGHTS || get_calc_length(&emitted[e]) > length - read) {
+				printf("Residency cache split read_weights %u wrongly!\n\r", i);
+				return 0;
+			}
+
+			uint32_t resident = (uint32_t)get_weight_address(&emitted[e]);
+			for(uint32_t row = 0; row < get_calc_length(&emitted[e]); ++row, ++read) {
+				if(memcmp(models[0].weight_buffer[resident + row].byte_vector, weights[address + read].byte_vector, TPU_VECTOR_SIZE)) {
+					printf("Read_weights %u reads a wrong row at address 0x%08x!\n\r", i, resident + row);
+					return 0;
+				}
+			}
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * Passes the program through the cache into the first model and runs it on a fresh second model. The outputs have to match.
+ */
+static int run_program(uint32_t seed) {
+	tpu_bundle_handler_t sink;
+	tpu_bundle_handler_t cache;
+
+	build_program(seed);
+
+	tpu_bundle_default_handler(&sink);
+	sink.context = &models[0];
+	sink.weights = sink_weights;
+	sink.inputs = sink_inputs;
+	sink.instructions = sink_instructions;
+	emitted_count = 0;
+
+	tpu_residency_begin(&residency, &sink);
+	tpu_residency_handler(&residency, &cache);
+	if(cache.weights(cache.context, weights, 0, PROGRAM_TILES*TPU_VECTOR_SIZE)
+		|| cache.section_end(cache.context, TPU_SECTION_WEIGHTS)
+		|| cache.inputs(cache.context, inputs, 0, INPUT_VECTORS)
+		|| cache.instructions(cache.context, program, MAX_INSTRUCTIONS)) {
+		printf("Residency cache failed on program %u!\n\r", seed);
+		return 0;
+	}
+
+	tpu_model_init(&models[1]);
+	sink_weights(&models[1], weights, 0, PROGRAM_TILES*TPU_VECTOR_SIZE);
+	sink_inputs(&models[1], inputs, 0, INPUT_VECTORS);
+	if(tpu_model_execute_program(&models[1], program, MAX_INSTRUCTIONS)) {
+		printf("Model failed on program %u!\n\r", seed);
+		return 0;
+	}
+
+	if(!check_remapped()) return 0;
+
+	for(uint32_t address = INPUT_VECTORS; address < INPUT_VECTORS + OUTPUT_GROUPS*TPU_VECTOR_SIZE; ++address) {
+		if(memcmp(&models[0].unified_buffer[address], &models[1].unified_buffer[address], sizeof(tpu_vector_t))) {
+			printf("Cached program %u wrote a wrong unified buffer vector at address 0x%08x!\n\r", seed, address);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+void test_residency_eviction(void) {
+	printf("Testing eviction of the residency cache...\n\r");
+
+	if(tpu_residency_init(&residency)) {
+		printf("Not enough memory for the residency cache!\n\r");
+		return;
+	}
+	tpu_model_init(&models[0]);
+
+	int passed = run_program(1);
+	if(passed && (residency.uploaded != PROGRAM_TILES-1 || residency.reused != 1 || residency.evicted)) {
+		printf("First program wrote %u tiles, reused %u tiles and evicted %u tiles!\n\r", residency.uploaded, residency.reused, residency.evicted);
+		passed = 0;
+	}
+
+	// The second program evicts the tiles of the first one, which are written again by the third one
+	passed = passed && run_program(2);
+	if(passed && residency.evicted == 0) {
+		printf("Second program didn't evict any tiles!\n\r");
+		passed = 0;
+	}
+
+	passed = passed && run_program(1);
+	if(passed && (residency.evicted == 0 || residency.reused <= 1 || residency.split == 0)) {
+		printf("Third program reused %u tiles, evicted %u tiles and split %u read_weights!\n\r", residency.reused, residency.evicted, residency.split);
+		passed = 0;
+	}
+
+	tpu_residency_free(&residency);
+	if(!passed) return;
+
+	printf("Residency cache eviction test was successful!\n\r");
+}
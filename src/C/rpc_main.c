@@ -29,6 +29,7 @@
 
 
 #include "tinyTPU_access.h"
+#include "tinyTPU_fence.h"
 #include "platform.h"
 #include "xil_exception.h"
 #include "xscugic.h"
@@ -50,7 +51,7 @@
 #ifdef RPC
 static XScuGic INTCInst;
 
-volatile char synchronize_happened;
+static tpu_fences_t fences;
 
 int setup_interrupt(void);
 void synchronize_isr(void* vp);
@@ -58,7 +59,9 @@ void synchronize_isr(void* vp);
 int main(void) {
 	init_platform();
 
-	synchronize_happened = 0;
+	uint32_t synchronize_count;
+	read_synchronize_count(&synchronize_count);
+	tpu_fence_init(&fences, synchronize_count);
 	if(setup_interrupt() != XST_SUCCESS) printf("Coulnd't configure interrupts!\n\r");
 
 	char message[1024];
@@ -135,7 +138,7 @@ int main(void) {
 			char done = 0;
 			while(!done) {
 				int32_t i = 0;
-				for(; i < sizeof(instructions); ++i) {
+				for(; i < sizeof(instructions)/sizeof(instruction_t); ++i) {
 					scanf("%s", message);
 
 					if(strncmp(END, message, sizeof(END)) == 0) {
@@ -166,7 +169,7 @@ int main(void) {
 								break;
 							case 2:
 								acc_addr = strtoul(str, NULL, 0);
-								weight_addr = strtoul(str, NULL, 0);
+								weight_addr = strtoull(str, NULL, 0);
 								break;
 							case 3:
 								buffer_addr = strtoul(str, NULL, 0);
@@ -200,12 +203,12 @@ int main(void) {
 					printf("Added instruction 0x%04x%08x%08x\n\r", instructions[i].upper_word, instructions[i].middle_word, instructions[i].lower_word);
 				}
 
+				tpu_fence_scan(&fences, instructions, i);
 				for(uint32_t x = 0; x < i; ++x) {
 					write_instruction(&instructions[x]);
 				}
 			}
-			while(!synchronize_happened);
-			synchronize_happened = 0;
+			tpu_fence_wait(&fences, fences.issued, NULL, NULL);
 			printf("Calculations finished.\n\r");
 			uint32_t cycles;
 			if(read_runtime(&cycles)) {
@@ -237,7 +240,7 @@ int setup_interrupt(void) {
 	// set priority of IRQ_F2P[0:0] to 0x00 and trigger for rising edge 0x3.
 	XScuGic_SetPriorityTriggerType(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID, 0x00, 0x3);
 	// connect the interrupt service routine to the interrupt controller
-	result = XScuGic_Connect(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID, (Xil_ExceptionHandler) synchronize_isr, (void*) &INTCInst);
+	result = XScuGic_Connect(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID, (Xil_ExceptionHandler) synchronize_isr, (void*) &fences);
 	if(result != XST_SUCCESS) return result;
 	// enable interrupt
 	XScuGic_Enable(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID);
@@ -253,7 +256,9 @@ int setup_interrupt(void) {
 }
 
 void synchronize_isr(void *vp) {
-	synchronize_happened = 1;
+	uint32_t synchronize_count;
+	read_synchronize_count(&synchronize_count);
+	tpu_fence_signal((tpu_fences_t*)vp, synchronize_count);
 }
 
 #endif
@@ -27,41 +27,221 @@
  */
 
 #include "tinyTPU_access.h"
+#include "tinyTPU_bundle.h"
+#include "tinyTPU_parser.h"
+#include "tinyTPU_queue.h"
+#include "tinyTPU_fence.h"
+#include "tinyTPU_pipeline.h"
+#include "tinyTPU_residency.h"
+#include "tinyTPU_trace.h"
+#include "tinyTPU_result.h"
 #include "platform.h"
 #include "xil_exception.h"
 #include "xscugic.h"
 #include "xparameters.h"
 #include "xparameters_ps.h"
+#include "xtime_l.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <ff.h>
 
-#define WEIGHTS "weights:["
-#define INPUTS "inputs:["
-#define INSTRUCTIONS "instructions:["
-#define RESULTS "results:["
-#define END "]"
-
+#define PIPELINE_COMMAND "pipeline"
+#define PROFILE_COMMAND "profile"
+#define FORMAT_COMMAND "format"
 #define RESULT_FILE_NAME "results.csv"
+// Records of all other formats
+#define RESULT_BINARY_FILE_NAME "results.bin"
+#define TRACE_FILE_NAME "trace.json"
 
 #define INTC_TPU_SYNCHRONIZE_ID	XPS_FPGA0_INT_ID
 
 
 #ifdef SD
 static XScuGic INTCInst;
-
-volatile char synchronize_happened;
+// Too large for the stack
+static tpu_parser_t parser;
+static tpu_queue_t queue;
+
+static tpu_fences_t fences;
+static tpu_pipeline_t pipeline;
+// Weights stay resident between files
+static tpu_residency_t residency;
+// Double buffered execution of batched programs, toggled by PIPELINE_COMMAND
+static char pipelined;
+// Stage timing of every file, written to TRACE_FILE_NAME, cycled through off, layer, tile and class by PROFILE_COMMAND
+static tpu_trace_t trace;
+static char profiled;
+static tpu_trace_granularity_t granularity;
+// Result records, CSV until FORMAT_COMMAND picks another format
+static tpu_result_t result_stage;
+// Opened by the first results of a file and kept open until the file is done
+static FIL result_file;
+static char result_file_open;
 
 int setup_interrupt(void);
 void synchronize_isr(void* vp);
 
+static int32_t open_result_file(FIL *result_file, const char *name) {
+	FRESULT result;
+	FILINFO info;
+	if(f_stat(name, &info) == FR_OK) {
+		result = f_open(result_file, name, FA_WRITE);
+	} else {
+		result = f_open(result_file, name, FA_WRITE | FA_CREATE_ALWAYS);
+	}
+
+	if(result) {
+		printf("Error creating file!\n\r");
+		return EIO;
+	}
+
+	if(f_lseek(result_file, result_file->fsize)) {
+		printf("Error jumping to end of file!\n\r");
+	}
+	return 0;
+}
+
+static void close_result_file(FIL *result_file) {
+	if(f_truncate(result_file)) {
+		printf("Error truncating file!\n\r");
+	}
+	if(f_close(result_file)) {
+		printf("Error closing file!\n\r");
+	}
+}
+
+static int32_t read_results(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	return read_output_block(vectors, address, count);
+}
+
+static int32_t rewind_result_file(void *context) {
+	if(f_lseek((FIL*)context, 0)) {
+		printf("Error jumping to start of file!\n\r");
+		return EIO;
+	}
+	return 0;
+}
+
+static void drain_queue(void *context) {
+	tpu_queue_drain((tpu_queue_t*)context);
+}
+
+static void wait_for_calculations(void) {
+	tpu_fence_wait(&fences, fences.issued, drain_queue, &queue);
+	printf("Calculations finished.\n\r");
+	uint32_t cycles;
+	if(read_runtime(&cycles)) {
+		printf("Bad address!\n\r");
+	} else {
+		printf("Calculations took %d cycles/%f nanoseconds to complete.\n\r", cycles, cycles*TPU_CLOCK_CYCLE);
+	}
+	tpu_perf_counters_t counters;
+	if(!read_perf_counters(&counters)) {
+		printf("Busy cycles: weights %lu, matrix %lu, activation %lu. Stalled %lu cycles, %lu for synchronize. Instruction FIFO empty for %lu cycles.\n\r",
+			(unsigned long)counters.weight_busy, (unsigned long)counters.matrix_busy, (unsigned long)counters.activation_busy,
+			(unsigned long)counters.stall, (unsigned long)counters.resource_stall, (unsigned long)counters.fifo_empty);
+	}
+}
+
+static uint64_t global_clock(void *context) {
+	XTime time;
+	XTime_GetTime(&time);
+	// Split to avoid an overflow of the multiplication
+	return (time/COUNTS_PER_SECOND)*1000000000ULL + (time%COUNTS_PER_SECOND)*1000000000ULL/COUNTS_PER_SECOND;
+}
+
+static int32_t write_file(void *context, const char *data, uint32_t length) {
+	UINT bytes_written;
+	if(f_write((FIL*)context, data, length, &bytes_written) != FR_OK || bytes_written != length) return EIO;
+	return 0;
+}
+
+static void store_trace(void) {
+	FIL trace_file;
+	if(f_open(&trace_file, TRACE_FILE_NAME, FA_WRITE | FA_CREATE_ALWAYS)) {
+		printf("Error creating trace file!\n\r");
+		return;
+	}
+
+	if(tpu_trace_write(&trace, write_file, &trace_file)) {
+		printf("Error writing trace file!\n\r");
+	} else {
+		printf("Traced %d events, %d dropped.\n\r", trace.event_count, trace.dropped);
+	}
+
+	if(f_close(&trace_file)) {
+		printf("Error closing file!\n\r");
+	}
+}
+
+static int32_t read_file(void *source, void *buffer, uint32_t size) {
+	UINT bytes_read;
+	if(f_read((FIL*)source, buffer, size, &bytes_read) != FR_OK || bytes_read != size) return EIO;
+	return 0;
+}
+
+static int32_t read_text(void *source, void *buffer, uint32_t size, uint32_t *bytes_read) {
+	UINT count;
+	if(f_read((FIL*)source, buffer, size, &count) != FR_OK) return EIO;
+	*bytes_read = count;
+	return 0;
+}
+
+static int32_t bundle_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	if(!result_file_open) {
+		if(open_result_file(&result_file, result_stage.format == TPU_RESULT_CSV ? RESULT_FILE_NAME : RESULT_BINARY_FILE_NAME)) return EIO;
+		tpu_result_begin(&result_stage, write_file, rewind_result_file, &result_file);
+		result_file_open = 1;
+	}
+
+	int32_t error = tpu_result_store(&result_stage, results, count);
+	if(error) printf("Error storing results with error code %d!\n\r", error);
+	return error;
+}
+
+static int32_t queue_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	tpu_fence_scan(&fences, instructions, count);
+	while(count) {
+		uint32_t pushed = tpu_queue_push(&queue, instructions, count);
+		instructions += pushed;
+		count -= pushed;
+	}
+	return 0;
+}
+
+static int32_t bundle_section_end(void *context, tpu_section_type_t type) {
+	if(type == TPU_SECTION_INSTRUCTIONS) {
+		wait_for_calculations();
+	}
+	return 0;
+}
+
+/**
+ * Checks for the magic number of a binary bundle, the file is rewinded afterwards.
+ */
+static char is_bundle(FIL *file) {
+	tpu_bundle_header_t header;
+	char bundle = read_file(file, &header, sizeof(header)) == 0 && header.magic == TPU_BUNDLE_MAGIC;
+	if(f_lseek(file, 0)) {
+		printf("Error jumping to start!\n\r");
+	}
+	return bundle;
+}
+
 int main(void) {
 	init_platform();
 
-	synchronize_happened = 0;
+	uint32_t synchronize_count;
+	read_synchronize_count(&synchronize_count);
+	tpu_fence_init(&fences, synchronize_count);
 	if(setup_interrupt() != XST_SUCCESS) printf("Coulnd't configure interrupts!\n\r");
+	if(tpu_queue_init(&queue, TPU_MAPPED_BASE)) printf("Couldn't read the instruction count!\n\r");
+	uint8_t cached = !tpu_residency_init(&residency);
+	if(!cached) printf("Not enough memory for the residency cache, weights are written as they are!\n\r");
+	tpu_result_init(&result_stage, TPU_RESULT_CSV, 0, 1, 0, read_results, NULL);
 
 	char message[1024];
 
@@ -80,6 +260,42 @@ int main(void) {
 		scanf("%s", message);
 		printf("File name was: %s\n\r", message);
 
+		if(!strcmp(message, PIPELINE_COMMAND)) {
+			pipelined = !pipelined;
+			printf("Pipelined execution %s.\n\r", pipelined ? "enabled" : "disabled");
+			continue;
+		}
+
+		if(!strcmp(message, PROFILE_COMMAND)) {
+			static const char *names[] = {"layer", "tile", "class"};
+			if(!profiled) {
+				profiled = 1;
+				granularity = TPU_TRACE_LAYER;
+			} else if(granularity == TPU_TRACE_CLASS) {
+				profiled = 0;
+			} else {
+				granularity++;
+			}
+			if(profiled) printf("Profiling stages per %s.\n\r", names[granularity]);
+			else printf("Profiling disabled.\n\r");
+			continue;
+		}
+
+		if(!strcmp(message, FORMAT_COMMAND)) {
+			tpu_result_format_t format;
+			uint32_t columns, top_k, is_signed;
+			printf("Enter result format (csv, raw, float, class or top), columns (0 for all), k of top and signedness:\n\r");
+			if(scanf("%15s %u %u %u", message, &columns, &top_k, &is_signed) != 4
+					|| tpu_result_parse_format(message, &format)
+					|| tpu_result_init(&result_stage, format, columns, top_k, is_signed, read_results, NULL)) {
+				printf("Invalid result format, storing results as csv.\n\r");
+				tpu_result_init(&result_stage, TPU_RESULT_CSV, 0, 1, 0, read_results, NULL);
+			} else {
+				printf("Storing results as %s.\n\r", message);
+			}
+			continue;
+		}
+
 		result = f_open(&file, message, FA_READ);
 
 		if(result) {
@@ -93,279 +309,65 @@ int main(void) {
 			continue;
 		}
 
-		while(1) {
-			if(f_gets(message, sizeof(message), &file) != message) {
-				break; // End of file
-			}
-			char *pos;
-			if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-			if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-
-			printf("Message was: %s\n\r", message);
-
-			if(strncmp(WEIGHTS, message, sizeof(WEIGHTS)) == 0) {
-				uint32_t weight_addr = 0;
-				if(f_gets(message, sizeof(message), &file) != message) {
-					printf("Error reading line!\n\r");
-				}
-				if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-				if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-				while(strncmp(END, message, sizeof(END)) != 0) {
-					tpu_vector_t vector;
-
-					uint32_t i = 0;
-					char *str = strtok(message, "[,]");
-					while(str != NULL) {
-						if(i >= TPU_VECTOR_SIZE) {
-							printf("Vector out of bounds!\n\r");
-						}
-						vector.byte_vector[i++] = atoi(str);
-						//printf("Added %hhd\n\r", vector.byte_vector[i-1]);
-						str = strtok(NULL, "[,]");
-					}
-
-					if(i < TPU_VECTOR_SIZE) {
-						printf("Vector to small!\n\r");
-					}
-
-					if(write_weight_vector(&vector, weight_addr++)) {
-						printf("Bad address!\n\r");
-					} /*else {
-						printf("Wrote 0x%04x%08x%08x%08x to 0x%08x\n\r", vector.transfer_vector[3], vector.transfer_vector[2], vector.transfer_vector[1], vector.transfer_vector[0], weight_addr-1);
-					}*/
-
-					if(f_gets(message, sizeof(message), &file) != message) {
-						printf("Error reading line!\n\r");
-					}
-					if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-					if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-				}
-			}
+		tpu_bundle_handler_t sink;
+		tpu_bundle_default_handler(&sink);
+		sink.instructions = queue_instructions;
+		sink.results = bundle_results;
+		sink.section_end = bundle_section_end;
+
+		// Stages are traced after the weight addresses were rewritten
+		tpu_bundle_handler_t traced;
+		if(profiled) {
+			tpu_trace_init(&trace, granularity, global_clock, NULL, read_runtime);
+			tpu_trace_begin(&trace, &sink, &fences, drain_queue, &queue);
+			tpu_trace_handler(&trace, &traced);
+		}
+
+		tpu_bundle_handler_t cache = profiled ? traced : sink;
+		if(cached) {
+			tpu_residency_begin(&residency, profiled ? &traced : &sink);
+			tpu_residency_handler(&residency, &cache);
+		}
+
+		tpu_bundle_handler_t handler = cache;
+		if(pipelined) {
+			tpu_pipeline_init(&pipeline, &cache, &fences, drain_queue, &queue);
+			tpu_pipeline_handler(&pipeline, &handler);
+		}
 
-			if(strncmp(INPUTS, message, sizeof(INPUTS)) == 0) {
-				uint32_t input_addr = 0;
-				if(f_gets(message, sizeof(message), &file) != message) {
-					printf("Error reading line!\n\r");
-				}
-				if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-				if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-				while(strncmp(END, message, sizeof(END)) != 0) {
-					tpu_vector_t vector;
-
-					uint32_t i = 0;
-					char *str = strtok(message, "[,]");
-					while(str != NULL) {
-						if(i >= TPU_VECTOR_SIZE) {
-							printf("Vector out of bounds!\n\r");
-						}
-						vector.byte_vector[i++] = atoi(str);
-						//printf("Added 0x%02x\n\r", vector.byte_vector[i-1]);
-						str = strtok(NULL, "[,]");
-					}
-					if(i < TPU_VECTOR_SIZE-1) {
-						printf("Vector to small!\n\r");
-					}
-
-					if(write_input_vector(&vector, input_addr++)) {
-						printf("Bad address!\n\r");
-					} /*else {
-						printf("Wrote to 0x%08x\n\r", input_addr-1);
-					}*/
-
-					if(f_gets(message, sizeof(message), &file) != message) {
-						printf("Error reading line!\n\r");
-					}
-					if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-					if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-				}
+		if(is_bundle(&file)) {
+			int32_t error = tpu_bundle_stream(read_file, &file, &handler);
+			if(error) {
+				printf("Error loading bundle with error code %d!\n\r", error);
 			}
+		} else {
+			tpu_parser_init(&parser, &handler);
+			int32_t error = tpu_parser_stream(&parser, read_text, &file);
+			if(error) {
+				printf("Error in line %d with error code %d!\n\r", parser.line, error);
+			}
+		}
 
-			if(strncmp(RESULTS, message, sizeof(RESULTS)) == 0) {
-				if(f_gets(message, sizeof(message), &file) != message) {
-					printf("Error reading line!\n\r");
-				}
-				if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-				if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-
-				FIL result_file;
-
-				FILINFO info;
-				if(f_stat(RESULT_FILE_NAME, &info) == FR_OK) {
-					result = f_open(&result_file, RESULT_FILE_NAME, FA_WRITE);
-				} else {
-					result = f_open(&result_file, RESULT_FILE_NAME, FA_WRITE | FA_CREATE_ALWAYS);
-				}
-
-				if(result) {
-					printf("Error creating file!\n\r");
-				}
-
-				if(f_lseek(&result_file, result_file.fsize)) {
-					printf("Error jumping to end of file!\n\r");
-				}
-
-				while(strncmp(END, message, sizeof(END)) != 0) {
-					uint32_t i = 0;
-
-					uint32_t address;
-					uint32_t length;
-					char append;
-
-					char *str = strtok(message, "[,]");
-					while(str != NULL) {
-						if(i >= 3) {
-							printf("Out of bounds!\n\r");
-						}
-
-						switch(i) {
-							case 0:
-								address = strtoul(str, NULL, 0);
-								break;
-							case 1:
-								length = strtoul(str, NULL, 0);
-								break;
-							case 2:
-								append = strtoul(str, NULL, 0);
-						}
-
-						i++;
-						str = strtok(NULL, "[,]");
-					}
-
-					if(!append) {
-						if(f_lseek(&result_file, 0)) {
-							printf("Error jumping to start of file!\n\r");
-						}
-					}
-
-					tpu_vector_t vector;
-					for(uint32_t j = 0; j < length; j++) {
-						if(read_output_vector(&vector, address+j)) {
-							printf("Bad address!\n\r");
-						} else {
-							f_printf(&result_file, "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n"	, vector.byte_vector[0]
-																									, vector.byte_vector[1]
-																									, vector.byte_vector[2]
-																									, vector.byte_vector[3]
-																									, vector.byte_vector[4]
-																									, vector.byte_vector[5]
-																									, vector.byte_vector[6]
-																									, vector.byte_vector[7]
-																									, vector.byte_vector[8]
-																									, vector.byte_vector[9]
-																									, vector.byte_vector[10]
-																									, vector.byte_vector[11]
-																									, vector.byte_vector[12]
-																									, vector.byte_vector[13]
-							);
-						}
-					}
-
-
-					if(f_gets(message, sizeof(message), &file) != message) {
-						printf("Error reading line!\n\r");
-					}
-					if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-					if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-				}
-				if(f_truncate(&result_file)) {
-					printf("Error truncating file!\n\r");
-				}
-				if(f_close(&result_file)) {
-					printf("Error closing file!\n\r");
-				}
+		if(pipelined) {
+			int32_t error = tpu_pipeline_finish(&pipeline);
+			if(error) {
+				printf("Error completing batches with error code %d!\n\r", error);
 			}
+			printf("Calculated %d batches, %s.\n\r", pipeline.batches, pipeline.enabled ? "double buffered" : "batches didn't fit into half of the unified buffer");
+		}
 
-			if(strncmp(INSTRUCTIONS, message, sizeof(INSTRUCTIONS)) == 0) {
-				instruction_t instructions[512];
-				char done = 0;
-				while(!done) {
-					int32_t i = 0;
-					for(; i < sizeof(instructions); ++i) {
-						if(f_gets(message, sizeof(message), &file) != message) {
-							printf("Error reading line!\n\r");
-						}
-						if ((pos=strchr(message, '\n')) != NULL) *pos = '\0';
-						if ((pos=strchr(message, '\r')) != NULL) *pos = '\0';
-
-						if(strncmp(END, message, sizeof(END)) == 0) {
-							done = 1;
-							break;
-						}
-
-						uint32_t j = 0;
-
-						uint8_t op_code;
-						uint32_t calc_length;
-						uint16_t acc_addr;
-						uint32_t buffer_addr;
-						uint64_t weight_addr;
-
-						char *str = strtok(message, "[,]");
-						while(str != NULL) {
-							if(j >= 4) {
-								printf("Out of bounds!\n\r");
-							}
-
-							switch(j) {
-								case 0:
-									op_code = strtoul(str, NULL, 0);
-									break;
-								case 1:
-									calc_length = strtoul(str, NULL, 0);
-									break;
-								case 2:
-									acc_addr = strtoul(str, NULL, 0);
-									weight_addr = strtoul(str, NULL, 0);
-									break;
-								case 3:
-									buffer_addr = strtoul(str, NULL, 0);
-									break;
-							}
-
-							j++;
-							str = strtok(NULL, "[,]");
-						}
-
-						instructions[i].op_code = op_code;
-						instructions[i].calc_length[0] = calc_length;
-						instructions[i].calc_length[1] = calc_length >> 8;
-						instructions[i].calc_length[2] = calc_length >> 16;
-						instructions[i].calc_length[3] = calc_length >> 24;
-
-						if(j <= 3) {
-							instructions[i].weight_address[0] = weight_addr;
-							instructions[i].weight_address[1] = weight_addr >> 8;
-							instructions[i].weight_address[2] = weight_addr >> 16;
-							instructions[i].weight_address[3] = weight_addr >> 24;
-							instructions[i].weight_address[4] = weight_addr >> 32;
-						} else {
-							instructions[i].acc_address[0] = acc_addr;
-							instructions[i].acc_address[1] = acc_addr >> 8;
-							instructions[i].buf_address[0] = buffer_addr;
-							instructions[i].buf_address[1] = buffer_addr >> 8;
-							instructions[i].buf_address[2] = buffer_addr >> 16;
-						}
-
-						printf("Added instruction 0x%04x%08x%08x\n\r", instructions[i].upper_word, instructions[i].middle_word, instructions[i].lower_word);
-					}
-
-					for(uint32_t x = 0; x < i; ++x) {
-						write_instruction(&instructions[x]);
-					}
-				}
-				while(!synchronize_happened);
-				synchronize_happened = 0;
-				printf("Calculations finished.\n\r");
-				uint32_t cycles;
-				if(read_runtime(&cycles)) {
-					printf("Bad address!\n\r");
-				} else {
-					printf("Calculations took %d cycles/%f nanoseconds to complete.\n\r", cycles, cycles*TPU_CLOCK_CYCLE);
-				}
+		if(cached) printf("Weights: %d tiles written, %d tiles resident, %d tiles evicted.\n\r", residency.uploaded, residency.reused, residency.evicted);
 
+		if(result_file_open) {
+			if(tpu_result_flush(&result_stage)) {
+				printf("Error writing results!\n\r");
 			}
+			close_result_file(&result_file);
+			result_file_open = 0;
 		}
+
+		if(profiled) store_trace();
+
 		result = f_close(&file);
 		if(result) {
 			printf("Error closing file!\n\r");
@@ -393,7 +395,7 @@ int setup_interrupt(void) {
 	// set priority of IRQ_F2P[0:0] to 0x00 and trigger for rising edge 0x3.
 	XScuGic_SetPriorityTriggerType(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID, 0x00, 0x3);
 	// connect the interrupt service routine to the interrupt controller
-	result = XScuGic_Connect(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID, (Xil_ExceptionHandler) synchronize_isr, (void*) &INTCInst);
+	result = XScuGic_Connect(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID, (Xil_ExceptionHandler) synchronize_isr, (void*) &fences);
 	if(result != XST_SUCCESS) return result;
 	// enable interrupt
 	XScuGic_Enable(intc_instance_ptr, INTC_TPU_SYNCHRONIZE_ID);
@@ -409,7 +411,9 @@ int setup_interrupt(void) {
 }
 
 void synchronize_isr(void *vp) {
-	synchronize_happened = 1;
+	uint32_t synchronize_count;
+	read_synchronize_count(&synchronize_count);
+	tpu_fence_signal((tpu_fences_t*)vp, synchronize_count);
 }
 
 #endif
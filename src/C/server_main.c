@@ -0,0 +1,541 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * server_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_batcher.h"
+#include "tinyTPU_compiler.h"
+#include "tinyTPU_device.h"
+#include "tinyTPU_model.h"
+#include "tinyTPU_shard.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define SOCKET_NAME "/tmp/tinyTPU.sock"
+// Microseconds a sample waits for other samples by default
+#define DEFAULT_LATENCY 1000
+#define MAX_LAYERS 64
+#define MAX_CLIENTS 64
+#define MAX_DEVICES TPU_SHARD_DEVICES
+#define HEADER_SIZE sizeof(uint32_t)
+
+#ifdef SERVER
+/*
+ * Inference server on a Unix domain socket.
+ *
+ * A request is the number of features as uint32_t followed by the features as int8_t, the response is the number of
+ * outputs as uint32_t followed by the outputs as int8_t. Requests with the wrong number of features get an empty response.
+ * Clients may send several requests without waiting, responses are sent in the same order.
+ * Sockets don't block. Responses are queued per client and sent, when the client reads them. Clients with a full
+ * queue aren't read from, until they took their responses.
+ */
+typedef struct client {
+	int socket;
+	// Incremented for every new connection in the slot, so outputs of closed connections are dropped
+	uint32_t generation;
+	uint32_t filled;
+	uint8_t *buffer;
+	// Responses, which weren't sent yet
+	uint32_t output_filled;
+	uint32_t output_size;
+	uint8_t *output;
+} client_t;
+
+typedef struct server {
+	uint32_t features;
+	uint32_t buffer_size;
+	client_t clients[MAX_CLIENTS];
+	tpu_batcher_t batcher;
+} server_t;
+
+static volatile sig_atomic_t running = 1;
+
+static void stop(int signal) {
+	(void)signal;
+	running = 0;
+}
+
+static uint64_t now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec*1000000 + time.tv_nsec/1000;
+}
+
+/**
+ * Reads a kernel CSV file into the layout of transfer_weights.py behind the weights of the layers before.
+ * All rows need the same number of columns.
+ */
+static int32_t read_kernel(const char *path, tpu_compiler_layer_t *layer, tpu_vector_t **weights, uint32_t *weight_rows) {
+	FILE *file = fopen(path, "r");
+	if(file == NULL) return EIO;
+
+	int8_t *values = NULL;
+	uint32_t size = 0;
+	int32_t error = 0;
+	layer->rows = 0;
+	layer->columns = 0;
+	// The weights are stored dense
+	layer->kernel = NULL;
+
+	char line[65536];
+	while(!error && fgets(line, sizeof(line), file) != NULL) {
+		uint32_t count = 0;
+		char *position = line;
+		for(;;) {
+			char *end;
+			long value = strtol(position, &end, 0);
+			if(end == position) break;
+
+			uint32_t index = layer->rows*layer->columns + count++;
+			if(index >= size) {
+				uint32_t new_size = size ? 2*size : 1024;
+				int8_t *resized = realloc(values, new_size);
+				if(resized == NULL) {
+					error = ENOMEM;
+					break;
+				}
+				values = resized;
+				size = new_size;
+			}
+			values[index] = (int8_t)value;
+
+			position = end;
+			while(*position == ',' || *position == ' ') position++;
+		}
+		// Lines without values are skipped
+		if(error || count == 0) continue;
+
+		if(layer->rows == 0) {
+			layer->columns = count;
+		} else if(count != layer->columns) {
+			error = EINVAL;
+			break;
+		}
+		layer->rows++;
+	}
+	fclose(file);
+
+	if(!error && layer->rows == 0) error = EINVAL;
+	if(error) {
+		free(values);
+		return error;
+	}
+
+	uint32_t rows = (layer->rows + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE;
+	uint32_t tiles = (layer->columns + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE;
+	tpu_vector_t *resized = realloc(*weights, (*weight_rows + tiles*rows)*sizeof(tpu_vector_t));
+	if(resized == NULL) {
+		free(values);
+		return ENOMEM;
+	}
+	*weights = resized;
+
+	tpu_vector_t *layer_weights = *weights + *weight_rows;
+	memset(layer_weights, 0, tiles*rows*sizeof(tpu_vector_t));
+	for(uint32_t r = 0; r < layer->rows; ++r) {
+		for(uint32_t c = 0; c < layer->columns; ++c) {
+			layer_weights[(c/TPU_VECTOR_SIZE)*rows + r].byte_vector[c%TPU_VECTOR_SIZE] = values[r*layer->columns + c];
+		}
+	}
+	*weight_rows += tiles*rows;
+
+	free(values);
+	return 0;
+}
+
+static void close_client(client_t *client) {
+	close(client->socket);
+	client->socket = -1;
+	client->filled = 0;
+	client->output_filled = 0;
+	client->generation++;
+}
+
+/**
+ * Sends queued responses, as far as the socket takes them without blocking.
+ */
+static void send_output(client_t *client) {
+	uint32_t position = 0;
+
+	while(position < client->output_filled) {
+		ssize_t length = send(client->socket, client->output + position, client->output_filled - position, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if(length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) break;
+		if(length <= 0) {
+			close_client(client);
+			return;
+		}
+		position += length;
+	}
+
+	memmove(client->output, client->output + position, client->output_filled - position);
+	client->output_filled -= position;
+}
+
+static void send_response(client_t *client, int8_t *outputs, uint32_t count) {
+	uint32_t size = HEADER_SIZE + count;
+
+	if(client->output_size - client->output_filled < size) {
+		uint32_t new_size = client->output_size ? client->output_size : 1024;
+		while(new_size - client->output_filled < size) new_size *= 2;
+		uint8_t *resized = realloc(client->output, new_size);
+		if(resized == NULL) {
+			close_client(client);
+			return;
+		}
+		client->output = resized;
+		client->output_size = new_size;
+	}
+
+	uint32_t header = count;
+	memcpy(client->output + client->output_filled, &header, HEADER_SIZE);
+	if(count) memcpy(client->output + client->output_filled + HEADER_SIZE, outputs, count);
+	client->output_filled += size;
+
+	send_output(client);
+}
+
+static void *make_tag(uint32_t index, uint32_t generation) {
+	return (void*)(uintptr_t)((uintptr_t)generation*MAX_CLIENTS + index);
+}
+
+/**
+ * Sends the outputs of a sample to its client, if the client is still connected.
+ */
+static void sample_done(void *context, void *tag, int8_t *outputs, uint32_t output_count) {
+	server_t *server = (server_t*)context;
+	uint32_t index = (uintptr_t)tag%MAX_CLIENTS;
+	uint32_t generation = (uintptr_t)tag/MAX_CLIENTS;
+	client_t *client = &server->clients[index];
+
+	if(client->socket >= 0 && client->generation == generation) send_response(client, outputs, output_count);
+}
+
+static int32_t run_shard(void *context, tpu_vector_t *inputs, tpu_vector_t *outputs) {
+	return tpu_shard_run((tpu_shard_t*)context, inputs, outputs);
+}
+
+static int32_t submit(server_t *server) {
+	int32_t error = tpu_batcher_submit(&server->batcher);
+	if(error) printf("Error calculating a batch with error code %d!\n", error);
+	return error;
+}
+
+/**
+ * Adds all complete requests of a client to the batcher.
+ */
+static int32_t handle_requests(server_t *server, uint32_t index) {
+	client_t *client = &server->clients[index];
+	uint32_t position = 0;
+
+	while(client->socket >= 0 && client->filled - position >= HEADER_SIZE) {
+		uint32_t features;
+		memcpy(&features, client->buffer + position, HEADER_SIZE);
+
+		if(features != server->features) {
+			// The request doesn't fit the model, the features are skipped as far as they fit into the buffer
+			if(features > server->buffer_size - HEADER_SIZE) {
+				close_client(client);
+				return 0;
+			}
+			if(client->filled - position - HEADER_SIZE < features) break;
+			send_response(client, NULL, 0);
+			position += HEADER_SIZE + features;
+			continue;
+		}
+		if(client->filled - position - HEADER_SIZE < features) break;
+
+		void *tag = make_tag(index, client->generation);
+		int8_t *sample = (int8_t*)client->buffer + position + HEADER_SIZE;
+		if(tpu_batcher_add(&server->batcher, sample, tag, now()) == EAGAIN) {
+			int32_t error = submit(server);
+			if(error) return error;
+			tpu_batcher_add(&server->batcher, sample, tag, now());
+		}
+		position += HEADER_SIZE + features;
+
+		if(tpu_batcher_ready(&server->batcher, now())) {
+			int32_t error = submit(server);
+			if(error) return error;
+		}
+	}
+
+	if(client->socket >= 0) {
+		memmove(client->buffer, client->buffer + position, client->filled - position);
+		client->filled -= position;
+	}
+	return 0;
+}
+
+static int open_socket(const char *name) {
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(listener < 0) return -1;
+
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, name, sizeof(address.sun_path) - 1);
+	unlink(name);
+
+	if(bind(listener, (struct sockaddr*)&address, sizeof(address)) || listen(listener, MAX_CLIENTS)) {
+		close(listener);
+		return -1;
+	}
+	return listener;
+}
+
+static void accept_client(server_t *server, int listener) {
+	int socket = accept(listener, NULL, NULL);
+	if(socket < 0) return;
+
+	int flags = fcntl(socket, F_GETFL, 0);
+	if(flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK)) {
+		close(socket);
+		return;
+	}
+
+	for(uint32_t i = 0; i < MAX_CLIENTS; ++i) {
+		if(server->clients[i].socket < 0) {
+			server->clients[i].socket = socket;
+			server->clients[i].filled = 0;
+			server->clients[i].output_filled = 0;
+			return;
+		}
+	}
+
+	// No free slot
+	close(socket);
+}
+
+/**
+ * Serves the model of the kernels, which is calculated on stand-in devices.
+ */
+int main(int argc, char *argv[]) {
+	const char *socket_name = SOCKET_NAME;
+	uint64_t latency = DEFAULT_LATENCY;
+	uint8_t activation = TPU_SIGMOID;
+	uint32_t device_count = 1;
+
+	int option;
+	while((option = getopt(argc, argv, "s:l:a:n:")) != -1) {
+		switch(option) {
+			case 's':
+				socket_name = optarg;
+				break;
+			case 'l':
+				latency = strtoull(optarg, NULL, 0);
+				break;
+			case 'a':
+				activation = strtoul(optarg, NULL, 0);
+				break;
+			case 'n':
+				device_count = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+
+	if(optind >= argc || device_count == 0 || device_count > MAX_DEVICES) {
+		printf("Usage: %s [-s socket] [-l latency in microseconds] [-a activation] [-n devices] <kernel files>\n", argv[0]);
+		printf("More than one device shards a single layer across the devices.\n");
+		return 1;
+	}
+
+	tpu_compiler_layer_t layers[MAX_LAYERS];
+	tpu_vector_t *weights = NULL;
+	uint32_t weight_rows = 0;
+	uint32_t layer_count = 0;
+	while(optind < argc && layer_count < MAX_LAYERS) {
+		const char *name = argv[optind++];
+		if(read_kernel(name, &layers[layer_count], &weights, &weight_rows)) {
+			printf("Error reading kernel %s!\n", name);
+			return 1;
+		}
+		layers[layer_count++].activation = activation;
+	}
+
+	if(device_count > 1 && layer_count > 1) {
+		printf("Only a single layer can be sharded!\n");
+		return 1;
+	}
+
+	tpu_model_t *models = malloc(device_count*sizeof(tpu_model_t));
+	tpu_device_t devices[MAX_DEVICES];
+	if(models == NULL) {
+		printf("Not enough memory for the devices!\n");
+		return 1;
+	}
+	for(uint32_t d = 0; d < device_count; ++d) {
+		tpu_device_init_model(&devices[d], &models[d]);
+	}
+
+	// The backend is either a compiled program on one device or the layer sharded across all devices
+	tpu_compiler_config_t config;
+	tpu_program_t program = {0};
+	tpu_program_backend_t program_backend = {&devices[0], &program};
+	tpu_shard_t shard;
+	tpu_batcher_backend_t backend;
+	void *backend_context;
+	int32_t error;
+
+	if(device_count > 1) {
+		error = tpu_shard_init(&shard, devices, device_count);
+		if(!error) error = tpu_shard_load(&shard, weights, layers[0].rows, layers[0].columns, activation, 1, 1);
+		backend = run_shard;
+		backend_context = &shard;
+	} else {
+		tpu_compiler_default_config(&config);
+		program.capacity = tpu_compiler_max_instructions(&config, layers, layer_count);
+		program.instructions = malloc(program.capacity*sizeof(instruction_t));
+		error = program.instructions == NULL ? ENOMEM : tpu_compiler_compile(&config, layers, layer_count, &program);
+		if(!error) error = tpu_device_write_weights(&devices[0], weights, 0, weight_rows);
+		backend = tpu_batcher_run_program;
+		backend_context = &program_backend;
+	}
+	free(weights);
+
+	if(error) {
+		printf("Error loading the model with error code %d!\n", error);
+		return 1;
+	}
+
+	server_t *server = malloc(sizeof(server_t));
+	if(server == NULL) {
+		printf("Not enough memory for the server!\n");
+		return 1;
+	}
+	server->features = layers[0].rows;
+	server->buffer_size = 16*(HEADER_SIZE + server->features);
+	for(uint32_t i = 0; i < MAX_CLIENTS; ++i) {
+		server->clients[i].socket = -1;
+		server->clients[i].generation = 0;
+		server->clients[i].filled = 0;
+		server->clients[i].output_filled = 0;
+		server->clients[i].output_size = 0;
+		server->clients[i].output = NULL;
+		server->clients[i].buffer = malloc(server->buffer_size);
+		if(server->clients[i].buffer == NULL) {
+			printf("Not enough memory for the clients!\n");
+			return 1;
+		}
+	}
+
+	error = tpu_batcher_init(&server->batcher, server->features, layers[layer_count-1].columns, latency, backend, backend_context, sample_done, server);
+	if(error) {
+		printf("Error initializing the batcher with error code %d!\n", error);
+		return 1;
+	}
+
+	int listener = open_socket(socket_name);
+	if(listener < 0) {
+		printf("Error opening socket %s!\n", socket_name);
+		return 1;
+	}
+
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+	printf("Serving %u features to %u outputs on %s\n", server->features, server->batcher.output_count, socket_name);
+
+	struct pollfd descriptors[MAX_CLIENTS + 1];
+	uint32_t indices[MAX_CLIENTS];
+	while(running && !error) {
+		uint32_t count = 0;
+		descriptors[count].fd = listener;
+		descriptors[count++].events = POLLIN;
+		for(uint32_t i = 0; i < MAX_CLIENTS; ++i) {
+			client_t *client = &server->clients[i];
+			if(client->socket < 0) continue;
+			indices[count-1] = i;
+			descriptors[count].fd = client->socket;
+			// Clients, which don't take their responses, aren't read from
+			descriptors[count].events = client->output_filled >= server->buffer_size ? 0 : POLLIN;
+			if(client->output_filled) descriptors[count].events |= POLLOUT;
+			count++;
+		}
+
+		// Wait until the deadline of the batch at most
+		uint64_t timeout = tpu_batcher_timeout(&server->batcher, now());
+		int ready = poll(descriptors, count, timeout == UINT64_MAX ? -1 : (int)((timeout + 999)/1000));
+		if(ready < 0 && errno != EINTR) break;
+
+		if(ready > 0) {
+			if(descriptors[0].revents & POLLIN) accept_client(server, listener);
+
+			for(uint32_t d = 1; d < count && !error; ++d) {
+				if(!descriptors[d].revents) continue;
+
+				client_t *client = &server->clients[indices[d-1]];
+				if(descriptors[d].revents & POLLOUT) send_output(client);
+				if(client->socket < 0 || !(descriptors[d].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+				ssize_t length = recv(client->socket, client->buffer + client->filled, server->buffer_size - client->filled, 0);
+				if(length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+				if(length <= 0) {
+					close_client(client);
+					continue;
+				}
+				client->filled += length;
+				error = handle_requests(server, indices[d-1]);
+			}
+		}
+
+		if(!error && tpu_batcher_ready(&server->batcher, now())) error = submit(server);
+	}
+
+	if(!error) error = submit(server);
+
+	uint64_t batches = server->batcher.batches;
+	printf("Served %llu samples in %llu batches, %.2f samples per batch (%.1f%% of the rows)\n", (unsigned long long)server->batcher.samples, (unsigned long long)batches,
+			batches ? (double)server->batcher.samples/batches : 0.0, batches ? 100.0*server->batcher.samples/(batches*TPU_BATCHER_SLOTS) : 0.0);
+
+	close(listener);
+	unlink(socket_name);
+	for(uint32_t i = 0; i < MAX_CLIENTS; ++i) {
+		if(server->clients[i].socket >= 0) close(server->clients[i].socket);
+		free(server->clients[i].buffer);
+		free(server->clients[i].output);
+	}
+	tpu_batcher_free(&server->batcher);
+	if(device_count > 1) tpu_shard_free(&shard);
+	free(program.instructions);
+	free(server);
+	free(models);
+
+	return error ? 1 : 0;
+}
+#endif
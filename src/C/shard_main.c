@@ -0,0 +1,220 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * shard_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_device.h"
+#include "tinyTPU_model.h"
+#include "tinyTPU_shard.h"
+#include "tinyTPU_sim.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef SHARD
+/**
+ * Reads a kernel CSV file into the layout of transfer_weights.py.
+ */
+static tpu_vector_t *read_kernel(const char *path, uint32_t *rows, uint32_t *columns) {
+	FILE *file = fopen(path, "r");
+	if(file == NULL) return NULL;
+
+	tpu_vector_t *weights = NULL;
+	uint32_t size = 0;
+	*rows = 0;
+	*columns = 0;
+
+	// Rows are stored one after another first and reordered into column tiles, when the size is known
+	int8_t *values = NULL;
+	char line[65536];
+	while(fgets(line, sizeof(line), file) != NULL) {
+		if(line[0] == '\n' || line[0] == '\r') continue;
+
+		uint32_t count = 0;
+		char *position = line;
+		for(;;) {
+			char *end;
+			long value = strtol(position, &end, 0);
+			if(end == position) break;
+
+			if(*rows == 0) {
+				values = realloc(values, ++size);
+			} else if(count >= *columns) {
+				break;
+			} else if((*rows)*(*columns) + count >= size) {
+				size *= 2;
+				values = realloc(values, size);
+			}
+			if(values == NULL) break;
+			values[(*rows)*(*columns) + count++] = (int8_t)value;
+
+			position = end;
+			while(*position == ',' || *position == ' ') position++;
+		}
+		if(values == NULL || count == 0) break;
+
+		if(*rows == 0) *columns = count;
+		(*rows)++;
+	}
+	fclose(file);
+
+	if(values == NULL || *rows == 0) {
+		free(values);
+		return NULL;
+	}
+
+	uint32_t padded_rows = (*rows + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE;
+	uint32_t tiles = (*columns + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE;
+	weights = calloc(tiles*padded_rows, sizeof(tpu_vector_t));
+	if(weights != NULL) {
+		for(uint32_t r = 0; r < *rows; ++r) {
+			for(uint32_t c = 0; c < *columns; ++c) {
+				weights[(c/TPU_VECTOR_SIZE)*padded_rows + r].byte_vector[c%TPU_VECTOR_SIZE] = values[r*(*columns) + c];
+			}
+		}
+	}
+
+	free(values);
+	return weights;
+}
+
+/**
+ * Simulated cycles of the slowest device, which is the runtime, if the devices calculate at the same time.
+ */
+static uint64_t simulate(tpu_shard_t *shard) {
+	tpu_sim_config_t config;
+	tpu_sim_default_config(&config);
+
+	uint64_t cycles = 0;
+	for(uint32_t d = 0; d < shard->device_count; ++d) {
+		tpu_sim_result_t result;
+		if(shard->slices[d].columns == 0) continue;
+		tpu_sim_run(&config, shard->slices[d].program.instructions, shard->slices[d].program.count, &result, NULL);
+		if(result.cycles > cycles) cycles = result.cycles;
+	}
+	return cycles;
+}
+
+/**
+ * Runs a layer sharded across stand-in devices and compares the outputs with a single device.
+ */
+int main(int argc, char *argv[]) {
+	uint8_t activation = TPU_SIGMOID;
+	uint32_t batches = 1;
+
+	int option;
+	while((option = getopt(argc, argv, "a:b:")) != -1) {
+		switch(option) {
+			case 'a':
+				activation = strtoul(optarg, NULL, 0);
+				break;
+			case 'b':
+				batches = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+
+	if(optind + 2 > argc) {
+		printf("Usage: %s [-a activation] [-b batches] <devices> <kernel file>\n", argv[0]);
+		return 1;
+	}
+
+	uint32_t device_count = strtoul(argv[optind], NULL, 0);
+	const char *name = argv[optind+1];
+
+	uint32_t rows, columns;
+	tpu_vector_t *weights = read_kernel(name, &rows, &columns);
+	if(weights == NULL) {
+		printf("Error reading kernel %s!\n", name);
+		return 1;
+	}
+
+	uint32_t padded_rows = (rows + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE;
+	uint32_t output_rows = (columns + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE;
+	tpu_vector_t *inputs = calloc(batches*padded_rows, sizeof(tpu_vector_t));
+	tpu_vector_t *outputs = calloc(batches*output_rows, sizeof(tpu_vector_t));
+	tpu_vector_t *reference = calloc(batches*output_rows, sizeof(tpu_vector_t));
+	tpu_model_t *models = malloc((device_count + 1)*sizeof(tpu_model_t));
+	tpu_device_t *devices = malloc((device_count + 1)*sizeof(tpu_device_t));
+	if(inputs == NULL || outputs == NULL || reference == NULL || models == NULL || devices == NULL) {
+		printf("Not enough memory!\n");
+		return 1;
+	}
+
+	srand(1);
+	for(uint32_t i = 0; i < batches*padded_rows; ++i) {
+		for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+			inputs[i].byte_vector[j] = rand();
+		}
+	}
+
+	for(uint32_t d = 0; d <= device_count; ++d) {
+		tpu_device_init_model(&devices[d], &models[d]);
+	}
+
+	// The last device calculates the reference
+	tpu_shard_t single, shard;
+	int32_t error = tpu_shard_init(&single, &devices[device_count], 1);
+	if(!error) error = tpu_shard_load(&single, weights, rows, columns, activation, 1, batches);
+	if(!error) error = tpu_shard_run(&single, inputs, reference);
+	if(!error) error = tpu_shard_init(&shard, devices, device_count);
+	if(!error) error = tpu_shard_load(&shard, weights, rows, columns, activation, 1, batches);
+	if(!error) error = tpu_shard_run(&shard, inputs, outputs);
+	if(error) {
+		printf("Error running the layer with error code %d!\n", error);
+		return 1;
+	}
+
+	for(uint32_t d = 0; d < device_count; ++d) {
+		printf("Device %u: columns %u to %u, %u instructions\n", d, shard.slices[d].first_column*TPU_VECTOR_SIZE, (shard.slices[d].first_column + shard.slices[d].columns)*TPU_VECTOR_SIZE, shard.slices[d].program.count);
+	}
+
+	uint64_t single_cycles = simulate(&single);
+	uint64_t shard_cycles = simulate(&shard);
+	printf("Simulated cycles: %llu on one device, %llu on %u devices (%.2fx)\n", (unsigned long long)single_cycles, (unsigned long long)shard_cycles, device_count, (double)single_cycles/shard_cycles);
+
+	int same = memcmp(outputs, reference, batches*output_rows*sizeof(tpu_vector_t)) == 0;
+	printf("Outputs %s the single device!\n", same ? "match" : "don't match");
+
+	tpu_shard_free(&single);
+	tpu_shard_free(&shard);
+	free(weights);
+	free(inputs);
+	free(outputs);
+	free(reference);
+	free(models);
+	free(devices);
+
+	return same ? 0 : 1;
+}
+#endif
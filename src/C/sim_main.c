@@ -0,0 +1,184 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * sim_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_sim.h"
+#include "tinyTPU_bundle.h"
+#include "tinyTPU_parser.h"
+#include "tinyTPU_optimizer.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef SIM
+static const char *UNIT_NAMES[TPU_SIM_UNITS] = {
+	"weight",
+	"matrix",
+	"activation"
+};
+
+typedef struct sim_context {
+	tpu_sim_config_t config;
+	instruction_t *instructions;
+	uint32_t count;
+	uint32_t size;
+	uint32_t block;
+	uint8_t optimize;
+	uint64_t total_runtime;
+} sim_context_t;
+
+static void print_result(uint32_t block, uint32_t count, tpu_sim_result_t *result) {
+	printf("Block %u: %u instructions, %u synchronize\n", block, count, result->synchronize_count);
+	printf("  predicted runtime: %u cycles/%f nanoseconds\n", result->runtime_cycles, result->runtime_cycles*TPU_CLOCK_CYCLE);
+	printf("  simulated cycles:  %llu\n", (unsigned long long)result->cycles);
+	printf("  %-12s %12s %12s\n", "unit", "busy", "stall");
+	for(uint32_t u = 0; u < TPU_SIM_UNITS; ++u) {
+		printf("  %-12s %12llu %12llu\n", UNIT_NAMES[u], (unsigned long long)result->busy_cycles[u], (unsigned long long)result->stall_cycles[u]);
+	}
+	printf("  %-12s %12s %12llu\n", "fifo empty", "", (unsigned long long)result->starve_cycles);
+	printf("  %-12s %12s %12llu\n", "look-ahead", "", (unsigned long long)result->look_ahead_cycles);
+}
+
+static int32_t sim_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	sim_context_t *sim = (sim_context_t*)context;
+
+	if(sim->count + count > sim->size) {
+		while(sim->count + count > sim->size) sim->size *= 2;
+		sim->instructions = realloc(sim->instructions, sim->size*sizeof(instruction_t));
+		if(sim->instructions == NULL) return ENOMEM;
+	}
+
+	memcpy(&sim->instructions[sim->count], instructions, count*sizeof(instruction_t));
+	sim->count += count;
+	return 0;
+}
+
+static int32_t sim_section_end(void *context, tpu_section_type_t type) {
+	sim_context_t *sim = (sim_context_t*)context;
+	if(type != TPU_SECTION_INSTRUCTIONS) return 0;
+
+	if(sim->optimize) {
+		tpu_optimizer_stats_t stats;
+		int32_t error = tpu_optimizer_run(sim->instructions, &sim->count, &stats);
+		if(error) return error;
+
+		printf("Block %u optimized: %u -> %u instructions, %u dropped, %u merged, %u activations moved\n", sim->block, stats.count_before, stats.count_after, stats.dropped, stats.merged, stats.moved);
+		printf("  estimated cycles: %llu -> %llu (%lld)\n", (unsigned long long)stats.cycles_before, (unsigned long long)stats.cycles_after, (long long)stats.cycles_after - (long long)stats.cycles_before);
+	}
+
+	tpu_sim_result_t result;
+	tpu_sim_run(&sim->config, sim->instructions, sim->count, &result, NULL);
+	print_result(sim->block++, sim->count, &result);
+	sim->total_runtime += result.runtime_cycles;
+	sim->count = 0;
+	return 0;
+}
+
+static int32_t read_file(void *source, void *buffer, uint32_t size, uint32_t *bytes_read) {
+	*bytes_read = fread(buffer, 1, size, (FILE*)source);
+	return ferror((FILE*)source) ? EIO : 0;
+}
+
+/**
+ * Predicts the runtime of every instruction block in a program file of transfer_complete_model.py,
+ * in an instruction file of transfer_instructions.py or in a bundle of transfer_bundle.py.
+ */
+int main(int argc, char *argv[]) {
+	sim_context_t sim;
+	tpu_sim_default_config(&sim.config);
+	sim.optimize = 0;
+
+	int option;
+	while((option = getopt(argc, argv, "O")) != -1) {
+		if(option == 'O') {
+			sim.optimize = 1;
+		} else {
+			optind = argc;
+		}
+	}
+
+	if(optind >= argc) {
+		printf("Usage: %s [-O] <program file> [host cycles per instruction]\n", argv[0]);
+		printf("With -O, every instruction block is optimized before it is simulated.\n");
+		return 1;
+	}
+
+	const char *name = argv[optind++];
+	if(optind < argc) {
+		sim.config.host_interval = strtoul(argv[optind], NULL, 0);
+	}
+	sim.size = 512;
+	sim.count = 0;
+	sim.block = 0;
+	sim.total_runtime = 0;
+	sim.instructions = malloc(sim.size*sizeof(instruction_t));
+
+	FILE *file = fopen(name, "r");
+	if(file == NULL) {
+		printf("Error opening file %s!\n", name);
+		return 1;
+	}
+
+	tpu_bundle_handler_t handler = {
+		.context = &sim,
+		.weights = NULL,
+		.inputs = NULL,
+		.instructions = sim_instructions,
+		.results = NULL,
+		.section_end = sim_section_end
+	};
+
+	int32_t error;
+	uint32_t magic;
+	if(fread(&magic, sizeof(magic), 1, file) == 1 && magic == TPU_BUNDLE_MAGIC) {
+		error = tpu_bundle_map_file(name, &handler);
+	} else {
+		rewind(file);
+		tpu_parser_t *parser = malloc(sizeof(tpu_parser_t));
+		tpu_parser_init(parser, &handler);
+		error = tpu_parser_stream(parser, read_file, file);
+		if(error) {
+			printf("Error in line %u!\n", parser->line);
+		}
+		free(parser);
+	}
+	if(error) {
+		printf("Error reading program with error code %d!\n", error);
+	}
+
+	printf("Total predicted runtime: %llu cycles/%f nanoseconds\n", (unsigned long long)sim.total_runtime, sim.total_runtime*TPU_CLOCK_CYCLE);
+
+	free(sim.instructions);
+	fclose(file);
+
+	return error ? 1 : 0;
+}
+#endif
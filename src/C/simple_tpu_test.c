@@ -28,6 +28,7 @@
 
 #include "simple_tpu_test.h"
 #include "tinyTPU_access.h"
+#include "tinyTPU_fence.h"
 #include <stdio.h>
 #include "xil_exception.h"
 #include "xscugic.h"
@@ -36,10 +37,12 @@
 
 static XScuGic INTCInst;
 
-volatile char synchronizeHappened;
+static tpu_fences_t fences;
 #ifdef TEST
 void test_simple_net(void) {
-	synchronizeHappened = FALSE;
+	uint32_t synchronize_count;
+	read_synchronize_count(&synchronize_count);
+	tpu_fence_init(&fences, synchronize_count);
 	if(setup_interrupt() != XST_SUCCESS) {
 		printf("Error initializing interrupts.\n\r");
 	}
@@ -127,9 +130,10 @@ void test_simple_net(void) {
 	instruction.buf_address[1] = 0;
 	instruction.buf_address[2] = 0;
 
+	tpu_fence_t fence = tpu_fence_issue(&fences);
 	write_instruction(&instruction);
 
-	while(!synchronizeHappened);
+	tpu_fence_wait(&fences, fence, NULL, NULL);
 
 	tpu_vector_t result;
 
@@ -163,7 +167,7 @@ int setup_interrupt(void) {
 	XScuGic_SetPriorityTriggerType(intc_instance_ptr, INTC_TPU_DEVICE_ID, 0xA0, 0x3);
 
 	// connect the interrupt service routine to the interrupt controller
-	result = XScuGic_Connect(intc_instance_ptr, INTC_TPU_DEVICE_ID, (Xil_ExceptionHandler) synchronize_isr, (void*) &INTCInst);
+	result = XScuGic_Connect(intc_instance_ptr, INTC_TPU_DEVICE_ID, (Xil_ExceptionHandler) synchronize_isr, (void*) &fences);
 
 	if(result != XST_SUCCESS) return result;
 
@@ -181,6 +185,8 @@ int setup_interrupt(void) {
 }
 
 void synchronize_isr(void *vp) {
-	synchronizeHappened = TRUE;
+	uint32_t synchronize_count;
+	read_synchronize_count(&synchronize_count);
+	tpu_fence_signal((tpu_fences_t*)vp, synchronize_count);
 }
 #endif
@@ -28,6 +28,9 @@
 
 #include "type_test.h"
 #include "access_test.h"
+#include "compiler_test.h"
+#include "optimizer_test.h"
+#include "residency_test.h"
 #include "simple_tpu_test.h"
 #include "platform.h"
 
@@ -37,6 +40,15 @@ int main(void) {
 	test_vector_type();
 	test_instruction_type();
 	test_unified_access();
+	test_unified_block_access();
+	test_instruction_queue();
+	test_parser_round_trip();
+	test_optimizer_merge();
+	test_optimizer_reload();
+	test_optimizer_reorder();
+	test_compiler_sparse();
+	test_compiler_batches();
+	test_residency_eviction();
 	test_simple_net();
 	cleanup_platform();
 	return 0;
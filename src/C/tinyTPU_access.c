@@ -28,16 +28,16 @@
 
 #include "tinyTPU_access.h"
 #include <errno.h>
-#include <math.h>
+
+#ifdef __linux__
+uintptr_t tpu_base = TPU_BASE;
+#endif
 
 int32_t write_weight_vector(tpu_vector_t *weight_vector, uint32_t weight_address) {
 	if(weight_address >= WEIGHT_BUFFER_SIZE) return EFAULT;
 
-	weight_address <<= (uint32_t)(ceil(log2(TPU_VECTOR_SIZE)));
-
-	for(uint32_t i = 0; i < TPU_VECTOR_SIZE; i+=sizeof(uint32_t)) {
-		WRITE_32(TPU_WEIGHT_BUFFER_BASE+weight_address+i, weight_vector->transfer_vector[i/sizeof(uint32_t)]);
-	}
+	volatile uint32_t *destination = (volatile uint32_t *) (TPU_WEIGHT_BUFFER_BASE + (weight_address << TPU_VECTOR_SHIFT));
+	TPU_COPY_VECTOR(destination, weight_vector->transfer_vector);
 
 	return 0;
 }
@@ -45,11 +45,8 @@ int32_t write_weight_vector(tpu_vector_t *weight_vector, uint32_t weight_address
 int32_t write_input_vector(tpu_vector_t *input_vector, uint32_t buffer_address) {
 	if(buffer_address >= UNIFIED_BUFFER_SIZE) return EFAULT;
 
-	buffer_address <<= (uint32_t)(ceil(log2(TPU_VECTOR_SIZE)));
-
-	for(uint32_t i = 0; i < TPU_VECTOR_SIZE; i+=sizeof(uint32_t)) {
-		WRITE_32(TPU_UNIFIED_BUFFER_BASE+buffer_address+i, input_vector->transfer_vector[i/sizeof(uint32_t)]);
-	}
+	volatile uint32_t *destination = (volatile uint32_t *) (TPU_UNIFIED_BUFFER_BASE + (buffer_address << TPU_VECTOR_SHIFT));
+	TPU_COPY_VECTOR(destination, input_vector->transfer_vector);
 
 	return 0;
 }
@@ -57,25 +54,250 @@ int32_t write_input_vector(tpu_vector_t *input_vector, uint32_t buffer_address)
 int32_t read_output_vector(tpu_vector_t *output_vector, uint32_t buffer_address) {
 	if(buffer_address >= UNIFIED_BUFFER_SIZE) return EFAULT;
 
-	buffer_address <<= (uint32_t)(ceil(log2(TPU_VECTOR_SIZE)));
+	volatile uint32_t *source = (volatile uint32_t *) (TPU_UNIFIED_BUFFER_BASE + (buffer_address << TPU_VECTOR_SHIFT));
+	TPU_COPY_VECTOR(output_vector->transfer_vector, source);
+
+	return 0;
+}
+
+/**
+ * Copies count vectors into a buffer window, one 32 Bit store per word, unrolled for the width.
+ */
+void copy_to_tpu(uintptr_t base, tpu_vector_t *vectors, uint32_t count) {
+	volatile uint32_t *destination = (volatile uint32_t *) base;
+
+	for(uint32_t k = 0; k < count; ++k) {
+		uint32_t *source = vectors[k].transfer_vector;
+		TPU_COPY_VECTOR(destination, source);
+		destination += (1 << TPU_VECTOR_SHIFT)/sizeof(uint32_t);
+	}
+}
+
+void copy_from_tpu(uintptr_t base, tpu_vector_t *vectors, uint32_t count) {
+	volatile uint32_t *source = (volatile uint32_t *) base;
 
-	for(uint32_t i = 0; i < TPU_VECTOR_SIZE; i+=sizeof(uint32_t)) {
-		output_vector->transfer_vector[i/sizeof(uint32_t)] = READ_32(TPU_UNIFIED_BUFFER_BASE+buffer_address+i);
+	for(uint32_t k = 0; k < count; ++k) {
+		uint32_t *destination = vectors[k].transfer_vector;
+		TPU_COPY_VECTOR(destination, source);
+		source += (1 << TPU_VECTOR_SHIFT)/sizeof(uint32_t);
 	}
+}
+
+int32_t write_weight_block_at(uintptr_t base, tpu_vector_t *weight_vectors, uint32_t first_address, uint32_t count) {
+	if(first_address >= WEIGHT_BUFFER_SIZE || count > WEIGHT_BUFFER_SIZE - first_address) return EFAULT;
+
+	copy_to_tpu(base + TPU_WEIGHT_BUFFER_OFFSET + (first_address << TPU_VECTOR_SHIFT), weight_vectors, count);
 
 	return 0;
 }
 
-int32_t write_instruction(instruction_t *instruction) {
-	WRITE_32(TPU_INSTRUCTION_BASE+TPU_LOWER_WORD_OFFSET, instruction->lower_word);
-	WRITE_32(TPU_INSTRUCTION_BASE+TPU_MIDDLE_WORD_OFFSET, instruction->middle_word);
-	WRITE_16(TPU_INSTRUCTION_BASE+TPU_UPPER_WORD_OFFSET, instruction->upper_word);
+int32_t write_input_block_at(uintptr_t base, tpu_vector_t *input_vectors, uint32_t first_address, uint32_t count) {
+	if(first_address >= UNIFIED_BUFFER_SIZE || count > UNIFIED_BUFFER_SIZE - first_address) return EFAULT;
+
+	copy_to_tpu(base + TPU_UNIFIED_BUFFER_OFFSET + (first_address << TPU_VECTOR_SHIFT), input_vectors, count);
 
 	return 0;
 }
 
-int32_t read_runtime(uint32_t* runtime_cycles) {
-	*runtime_cycles = READ_32(TPU_INSTRUCTION_BASE);
+int32_t read_output_block_at(uintptr_t base, tpu_vector_t *output_vectors, uint32_t first_address, uint32_t count) {
+	if(first_address >= UNIFIED_BUFFER_SIZE || count > UNIFIED_BUFFER_SIZE - first_address) return EFAULT;
+
+	copy_from_tpu(base + TPU_UNIFIED_BUFFER_OFFSET + (first_address << TPU_VECTOR_SHIFT), output_vectors, count);
+
+	return 0;
+}
+
+/**
+ * Writes count bias vectors to the bias buffer, starting at first_address. Biased activations add the bias of every
+ * column to the accumulators of the column before the activation.
+ */
+int32_t write_bias_block_at(uintptr_t base, int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count) {
+	if(first_address >= BIAS_BUFFER_SIZE || count > BIAS_BUFFER_SIZE - first_address) return EFAULT;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		volatile uint32_t *destination = (volatile uint32_t *) (base + TPU_BIAS_BUFFER_OFFSET + ((first_address + i) << TPU_BIAS_VECTOR_SHIFT));
+		for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+			destination[j] = (uint32_t)bias_vectors[i][j];
+		}
+	}
+
+	return 0;
+}
+
+int32_t read_bias_block_at(uintptr_t base, int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count) {
+	if(first_address >= BIAS_BUFFER_SIZE || count > BIAS_BUFFER_SIZE - first_address) return EFAULT;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		volatile uint32_t *source = (volatile uint32_t *) (base + TPU_BIAS_BUFFER_OFFSET + ((first_address + i) << TPU_BIAS_VECTOR_SHIFT));
+		for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+			bias_vectors[i][j] = (int32_t)source[j];
+		}
+	}
+
+	return 0;
+}
+
+int32_t write_instruction_at(uintptr_t base, instruction_t *instruction) {
+	WRITE_32(base+TPU_INSTRUCTION_OFFSET+TPU_LOWER_WORD_OFFSET, instruction->lower_word);
+	WRITE_32(base+TPU_INSTRUCTION_OFFSET+TPU_MIDDLE_WORD_OFFSET, instruction->middle_word);
+	WRITE_16(base+TPU_INSTRUCTION_OFFSET+TPU_UPPER_WORD_OFFSET, instruction->upper_word);
+
+	return 0;
+}
+
+int32_t read_runtime_at(uintptr_t base, uint32_t* runtime_cycles) {
+	*runtime_cycles = READ_32(base+TPU_INSTRUCTION_OFFSET+TPU_RUNTIME_OFFSET);
+
+	return 0;
+}
+
+/**
+ * Reads the number of instructions the TPU took from the instruction FIFO. The counter wraps around.
+ */
+int32_t read_instruction_count_at(uintptr_t base, uint32_t *instruction_count) {
+	*instruction_count = READ_32(base+TPU_INSTRUCTION_OFFSET+TPU_INSTRUCTION_COUNT_OFFSET);
+
+	return 0;
+}
+
+/**
+ * Reads the number of synchronize instructions the TPU finished. The counter wraps around.
+ */
+int32_t read_synchronize_count_at(uintptr_t base, uint32_t *synchronize_count) {
+	*synchronize_count = READ_32(base+TPU_INSTRUCTION_OFFSET+TPU_SYNCHRONIZE_COUNT_OFFSET);
 
 	return 0;
 }
+
+/**
+ * Reads the performance counters of the last calculation. Busy units with a full FIFO point to the slowest unit,
+ * an empty FIFO with idle units to the host.
+ */
+int32_t read_perf_counters_at(uintptr_t base, tpu_perf_counters_t *counters) {
+	uint32_t *words = (uint32_t*)counters;
+	for(uint32_t i = 0; i < TPU_PERF_COUNTER_COUNT; ++i) {
+		words[i] = READ_32(base+TPU_INSTRUCTION_OFFSET+TPU_PERF_COUNTER_OFFSET+i*sizeof(uint32_t));
+	}
+
+	return 0;
+}
+
+int32_t write_weight_block(tpu_vector_t *weight_vectors, uint32_t first_address, uint32_t count) {
+	return write_weight_block_at(TPU_MAPPED_BASE, weight_vectors, first_address, count);
+}
+
+int32_t write_input_block(tpu_vector_t *input_vectors, uint32_t first_address, uint32_t count) {
+	return write_input_block_at(TPU_MAPPED_BASE, input_vectors, first_address, count);
+}
+
+int32_t read_output_block(tpu_vector_t *output_vectors, uint32_t first_address, uint32_t count) {
+	return read_output_block_at(TPU_MAPPED_BASE, output_vectors, first_address, count);
+}
+
+int32_t write_bias_block(int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count) {
+	return write_bias_block_at(TPU_MAPPED_BASE, bias_vectors, first_address, count);
+}
+
+int32_t read_bias_block(int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count) {
+	return read_bias_block_at(TPU_MAPPED_BASE, bias_vectors, first_address, count);
+}
+
+int32_t write_instruction(instruction_t *instruction) {
+	return write_instruction_at(TPU_MAPPED_BASE, instruction);
+}
+
+int32_t read_runtime(uint32_t* runtime_cycles) {
+	return read_runtime_at(TPU_MAPPED_BASE, runtime_cycles);
+}
+
+int32_t read_instruction_count(uint32_t *instruction_count) {
+	return read_instruction_count_at(TPU_MAPPED_BASE, instruction_count);
+}
+
+int32_t read_synchronize_count(uint32_t *synchronize_count) {
+	return read_synchronize_count_at(TPU_MAPPED_BASE, synchronize_count);
+}
+
+int32_t read_perf_counters(tpu_perf_counters_t *counters) {
+	return read_perf_counters_at(TPU_MAPPED_BASE, counters);
+}
+
+void set_instruction(instruction_t *instruction, uint8_t op_code, uint32_t calc_length, uint16_t acc_address, uint32_t buf_address) {
+	instruction->op_code = op_code;
+	instruction->calc_length[0] = calc_length;
+	instruction->calc_length[1] = calc_length >> 8;
+	instruction->calc_length[2] = calc_length >> 16;
+	instruction->calc_length[3] = calc_length >> 24;
+	instruction->acc_address[0] = acc_address;
+	instruction->acc_address[1] = acc_address >> 8;
+	instruction->buf_address[0] = buf_address;
+	instruction->buf_address[1] = buf_address >> 8;
+	instruction->buf_address[2] = buf_address >> 16;
+}
+
+/**
+ * Sets an instruction like set_instruction. Biased activations get the address of their bias vector in the upper half of the length.
+ */
+void set_bias_instruction(instruction_t *instruction, uint8_t op_code, uint32_t calc_length, uint16_t acc_address, uint32_t buf_address, uint16_t bias_address) {
+	if(op_code != TPU_OP_SYNCHRONIZE && (op_code & TPU_OP_ACTIVATE) && (op_code & TPU_ACTIVATION_BIAS)) {
+		calc_length = (calc_length & TPU_BIAS_LENGTH_MASK) | (uint32_t)bias_address << TPU_BIAS_ADDRESS_SHIFT;
+	}
+	set_instruction(instruction, op_code, calc_length, acc_address, buf_address);
+}
+
+void set_weight_instruction(instruction_t *instruction, uint8_t op_code, uint32_t calc_length, uint64_t weight_address) {
+	instruction->op_code = op_code;
+	instruction->calc_length[0] = calc_length;
+	instruction->calc_length[1] = calc_length >> 8;
+	instruction->calc_length[2] = calc_length >> 16;
+	instruction->calc_length[3] = calc_length >> 24;
+	instruction->weight_address[0] = weight_address;
+	instruction->weight_address[1] = weight_address >> 8;
+	instruction->weight_address[2] = weight_address >> 16;
+	instruction->weight_address[3] = weight_address >> 24;
+	instruction->weight_address[4] = weight_address >> 32;
+}
+
+/**
+ * Returns the length of the instruction, without the bias address of biased activations.
+ */
+uint32_t get_calc_length(instruction_t *instruction) {
+	uint32_t calc_length = (uint32_t)instruction->calc_length[0]
+		| (uint32_t)instruction->calc_length[1] << 8
+		| (uint32_t)instruction->calc_length[2] << 16
+		| (uint32_t)instruction->calc_length[3] << 24;
+
+	if(instruction->op_code != TPU_OP_SYNCHRONIZE && (instruction->op_code & TPU_OP_ACTIVATE) && (instruction->op_code & TPU_ACTIVATION_BIAS)) {
+		return calc_length & TPU_BIAS_LENGTH_MASK;
+	}
+	return calc_length;
+}
+
+uint16_t get_acc_address(instruction_t *instruction) {
+	return (uint16_t)(instruction->acc_address[0]
+		| instruction->acc_address[1] << 8);
+}
+
+/**
+ * Returns the address of the bias vector of biased activations, 0 for all other instructions.
+ */
+uint16_t get_bias_address(instruction_t *instruction) {
+	if(instruction->op_code == TPU_OP_SYNCHRONIZE || !(instruction->op_code & TPU_OP_ACTIVATE) || !(instruction->op_code & TPU_ACTIVATION_BIAS)) return 0;
+
+	return (uint16_t)(instruction->calc_length[2]
+		| instruction->calc_length[3] << 8);
+}
+
+uint32_t get_buf_address(instruction_t *instruction) {
+	return (uint32_t)instruction->buf_address[0]
+		| (uint32_t)instruction->buf_address[1] << 8
+		| (uint32_t)instruction->buf_address[2] << 16;
+}
+
+uint64_t get_weight_address(instruction_t *instruction) {
+	return (uint64_t)instruction->weight_address[0]
+		| (uint64_t)instruction->weight_address[1] << 8
+		| (uint64_t)instruction->weight_address[2] << 16
+		| (uint64_t)instruction->weight_address[3] << 24
+		| (uint64_t)instruction->weight_address[4] << 32;
+}
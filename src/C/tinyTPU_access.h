@@ -32,30 +32,169 @@
 #include <stdint.h>
 
 #define TPU_BASE 				(0x43C00000)
-#define TPU_WEIGHT_BUFFER_BASE  (TPU_BASE)
-#define TPU_UNIFIED_BUFFER_BASE (TPU_BASE + 0x80000)
-#define TPU_INSTRUCTION_BASE    (TPU_BASE + 0x90000)
+#ifdef __linux__
+// Userspace mapping of the AXI slave, TPU_BASE until tinyTPU_uio.h selects another one
+extern uintptr_t tpu_base;
+#define TPU_MAPPED_BASE			tpu_base
+#else
+#define TPU_MAPPED_BASE			TPU_BASE
+#endif
+#define TPU_WEIGHT_BUFFER_BASE  (TPU_MAPPED_BASE + TPU_WEIGHT_BUFFER_OFFSET)
+#define TPU_UNIFIED_BUFFER_BASE (TPU_MAPPED_BASE + TPU_UNIFIED_BUFFER_OFFSET)
+#define TPU_INSTRUCTION_BASE    (TPU_MAPPED_BASE + TPU_INSTRUCTION_OFFSET)
+#define TPU_BIAS_BUFFER_BASE    (TPU_MAPPED_BASE + TPU_BIAS_BUFFER_OFFSET)
+
+/*
+ * Generics of TPU.vhdl, which can be overridden by the build (e.g. -DTPU_VECTOR_SIZE=16),
+ * to use bitstreams with another MATRIX_WIDTH, WEIGHT_BUFFER_DEPTH, UNIFIED_BUFFER_DEPTH or BIAS_BUFFER_DEPTH.
+ * Everything below is derived from them at compile time.
+ */
+#ifndef TPU_VECTOR_SIZE
+#define TPU_VECTOR_SIZE 14
+#endif
+#ifndef WEIGHT_BUFFER_SIZE
+#define WEIGHT_BUFFER_SIZE 32768
+#endif
+#ifndef UNIFIED_BUFFER_SIZE
+#define UNIFIED_BUFFER_SIZE 4096
+#endif
+// Bias vectors, one bias per column
+#ifndef BIAS_BUFFER_SIZE
+#define BIAS_BUFFER_SIZE 512
+#endif
+
+#if (WEIGHT_BUFFER_SIZE & (WEIGHT_BUFFER_SIZE-1)) || (UNIFIED_BUFFER_SIZE & (UNIFIED_BUFFER_SIZE-1))
+#error "Buffer sizes have to be powers of two!"
+#endif
+
+// 32 Bit words transferred per vector
+#define TPU_VECTOR_WORDS ((TPU_VECTOR_SIZE+3)/4)
+// For byte padding
+#define TPU_VECTOR_PADDING (TPU_VECTOR_WORDS*4)
+
+// Address shift of one vector - ceil(log2(TPU_VECTOR_SIZE))
+#if TPU_VECTOR_SIZE <= 4
+#define TPU_VECTOR_SHIFT 2
+#elif TPU_VECTOR_SIZE <= 8
+#define TPU_VECTOR_SHIFT 3
+#elif TPU_VECTOR_SIZE <= 16
+#define TPU_VECTOR_SHIFT 4
+#elif TPU_VECTOR_SIZE <= 32
+#define TPU_VECTOR_SHIFT 5
+#elif TPU_VECTOR_SIZE <= 64
+#define TPU_VECTOR_SHIFT 6
+#else
+#error "TPU_VECTOR_SIZE is not supported!"
+#endif
+// Address shift of one bias vector - a 32 Bit word per column
+#define TPU_BIAS_VECTOR_SHIFT (TPU_VECTOR_SHIFT + 2)
+
+// Address windows of a tinyTPU_v1_0 AXI slave, the buffers and the instruction space follow one another
+#define TPU_WEIGHT_BUFFER_OFFSET	0x00000
+#define TPU_UNIFIED_BUFFER_OFFSET	(WEIGHT_BUFFER_SIZE << TPU_VECTOR_SHIFT)
+#define TPU_INSTRUCTION_OFFSET		((WEIGHT_BUFFER_SIZE + UNIFIED_BUFFER_SIZE) << TPU_VECTOR_SHIFT)
+// The upper half of the instruction space holds the bias vectors, one 32 Bit bias per word
+#define TPU_BIAS_BUFFER_OFFSET		(TPU_INSTRUCTION_OFFSET + ((UNIFIED_BUFFER_SIZE/2) << TPU_VECTOR_SHIFT))
+
+#if (BIAS_BUFFER_SIZE << TPU_BIAS_VECTOR_SHIFT) > ((UNIFIED_BUFFER_SIZE/2) << TPU_VECTOR_SHIFT)
+#error "BIAS_BUFFER_SIZE doesn't fit into the upper half of the instruction space!"
+#endif
 
 #define TPU_LOWER_WORD_OFFSET  0x4
 #define TPU_MIDDLE_WORD_OFFSET 0x8
 #define TPU_UPPER_WORD_OFFSET  0xC
+// Size of an encoded instruction (lower and middle word, upper halfword), instruction_t is padded in memory
+#define TPU_INSTRUCTION_SIZE	10
 
-#define TPU_VECTOR_SIZE 14
-// For byte padding
-#define TPU_VECTOR_PADDING (TPU_VECTOR_SIZE+2)
+// Read offsets of the instruction space
+#define TPU_RUNTIME_OFFSET				0x0
+#define TPU_INSTRUCTION_COUNT_OFFSET	0x4
+#define TPU_SYNCHRONIZE_COUNT_OFFSET	0x8
+// Performance counters of the last calculation (PERFORMANCE_COUNTER.vhdl)
+#define TPU_PERF_COUNTER_OFFSET			0x10
+#define TPU_PERF_COUNTER_COUNT			9
 
-#define WEIGHT_BUFFER_SIZE 32768
-#define UNIFIED_BUFFER_SIZE 4096
+// Depth of INSTRUCTION_FIFO in TPU.vhdl
+#define TPU_INSTRUCTION_FIFO_DEPTH 32
+
+/*
+ * Copies the words of a single vector, unrolled for the common widths.
+ */
+#if TPU_VECTOR_WORDS == 2
+#define TPU_COPY_VECTOR(destination, source) do {	\
+	(destination)[0] = (source)[0];					\
+	(destination)[1] = (source)[1];					\
+} while(0)
+#elif TPU_VECTOR_WORDS == 4
+#define TPU_COPY_VECTOR(destination, source) do {	\
+	(destination)[0] = (source)[0];					\
+	(destination)[1] = (source)[1];					\
+	(destination)[2] = (source)[2];					\
+	(destination)[3] = (source)[3];					\
+} while(0)
+#elif TPU_VECTOR_WORDS == 8
+#define TPU_COPY_VECTOR(destination, source) do {	\
+	(destination)[0] = (source)[0];					\
+	(destination)[1] = (source)[1];					\
+	(destination)[2] = (source)[2];					\
+	(destination)[3] = (source)[3];					\
+	(destination)[4] = (source)[4];					\
+	(destination)[5] = (source)[5];					\
+	(destination)[6] = (source)[6];					\
+	(destination)[7] = (source)[7];					\
+} while(0)
+#else
+#define TPU_COPY_VECTOR(destination, source) do {	\
+	for(uint32_t word = 0; word < TPU_VECTOR_WORDS; ++word) {	\
+		(destination)[word] = (source)[word];		\
+	}												\
+} while(0)
+#endif
 
 #define TPU_CLOCK_CYCLE 5.625f
 
+// OP-Codes (see doc/TPU_ISA.md)
+#define TPU_OP_NOP				0x00
+#define TPU_OP_HALT				0x02
+#define TPU_OP_READ_WEIGHTS		0x08
+#define TPU_OP_MATRIX_MULTIPLY	0x20
+#define TPU_OP_ACTIVATE			0x80
+#define TPU_OP_SYNCHRONIZE		0xFF
+
+// OP-Code flags
+#define TPU_WEIGHTS_SIGNED		0x01
+#define TPU_MULTIPLY_SIGNED		0x01
+#define TPU_MULTIPLY_ACCUMULATE	0x02
+#define TPU_ACTIVATION_SIGNED	0x10
+#define TPU_ACTIVATION_BIAS		0x40
+#define TPU_ACTIVATION_MASK		0x0F
+
+// Biased activations split the length into the length (lower half) and the address of the bias vector (upper half)
+#define TPU_BIAS_ADDRESS_SHIFT	16
+#define TPU_BIAS_LENGTH_MASK	0xFFFF
+
+// Activation functions (ACTIVATION_TYPE in TPU_pack.vhdl)
+// ReLU and CReLU use bits [31:8] of the accumulators, the other functions the Q4.4 (signed) or Qu3.5 (unsigned) range
+// of the sigmoid. ReLU6, ELU, SELU and softplus return that range, sigmoid, tanh and softsign return fractions.
+#define TPU_NO_ACTIVATION	0x0
+#define TPU_RELU			0x1
+#define TPU_RELU6			0x2
+#define TPU_CRELU			0x3
+#define TPU_ELU				0x4
+#define TPU_SELU			0x5
+#define TPU_SOFTPLUS		0x6
+#define TPU_SOFTSIGN		0x7
+#define TPU_DROPOUT			0x8
+#define TPU_SIGMOID			0x9
+#define TPU_TANH			0xA
+
 #define WRITE_32(addr, data)(*(volatile uint32_t *) (addr) = (data));
 #define WRITE_16(addr, data)(*(volatile uint16_t *) (addr) = (data));
 #define READ_32(addr)(*(volatile uint32_t *) (addr));
 
 typedef union tpu_vector {
 	uint8_t byte_vector[TPU_VECTOR_SIZE];
-	uint32_t transfer_vector[TPU_VECTOR_PADDING/sizeof(uint32_t)];
+	uint32_t transfer_vector[TPU_VECTOR_WORDS];
 } tpu_vector_t;
 
 /**
@@ -82,14 +221,94 @@ typedef union __attribute__((__packed__)) instruction {
 	};
 } instruction_t;
 
+/**
+ * Performance counters in the order of the registers. They count from the first instruction until the synchronize, like the runtime.
+ */
+typedef struct tpu_perf_counters {
+	// Cycles the control units are busy
+	uint32_t weight_busy;
+	uint32_t matrix_busy;
+	uint32_t activation_busy;
+	// Cycles CONTROL_COORDINATOR holds an instruction, because its unit is busy
+	uint32_t stall;
+	// Cycles a synchronize waits for the resources of the units
+	uint32_t resource_stall;
+	// Dispatched instructions per unit
+	uint32_t weight_instructions;
+	uint32_t matrix_instructions;
+	uint32_t activation_instructions;
+	// Cycles the instruction FIFO is empty
+	uint32_t fifo_empty;
+} tpu_perf_counters_t;
+
 int32_t write_weight_vector(tpu_vector_t *weight_vector, uint32_t weight_address);
 
 int32_t write_input_vector(tpu_vector_t *input_vector, uint32_t buffer_address);
 
 int32_t read_output_vector(tpu_vector_t *output_vector, uint32_t buffer_address);
 
+int32_t write_weight_block(tpu_vector_t *weight_vectors, uint32_t first_address, uint32_t count);
+
+int32_t write_input_block(tpu_vector_t *input_vectors, uint32_t first_address, uint32_t count);
+
+int32_t read_output_block(tpu_vector_t *output_vectors, uint32_t first_address, uint32_t count);
+
+int32_t write_bias_block(int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count);
+
+int32_t read_bias_block(int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count);
+
 int32_t write_instruction(instruction_t *instruction);
 
 int32_t read_runtime(uint32_t* runtime_cycles);
 
+int32_t read_instruction_count(uint32_t *instruction_count);
+
+int32_t read_synchronize_count(uint32_t *synchronize_count);
+
+int32_t read_perf_counters(tpu_perf_counters_t *counters);
+
+/*
+ * The functions above access the instance at TPU_MAPPED_BASE. The functions below access the AXI slave at base,
+ * so tinyTPU_device.h can address several instances with them.
+ */
+void copy_to_tpu(uintptr_t base, tpu_vector_t *vectors, uint32_t count);
+
+void copy_from_tpu(uintptr_t base, tpu_vector_t *vectors, uint32_t count);
+
+int32_t write_weight_block_at(uintptr_t base, tpu_vector_t *weight_vectors, uint32_t first_address, uint32_t count);
+
+int32_t write_input_block_at(uintptr_t base, tpu_vector_t *input_vectors, uint32_t first_address, uint32_t count);
+
+int32_t read_output_block_at(uintptr_t base, tpu_vector_t *output_vectors, uint32_t first_address, uint32_t count);
+
+int32_t write_bias_block_at(uintptr_t base, int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count);
+
+int32_t read_bias_block_at(uintptr_t base, int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count);
+
+int32_t write_instruction_at(uintptr_t base, instruction_t *instruction);
+
+int32_t read_runtime_at(uintptr_t base, uint32_t* runtime_cycles);
+
+int32_t read_instruction_count_at(uintptr_t base, uint32_t *instruction_count);
+
+int32_t read_synchronize_count_at(uintptr_t base, uint32_t *synchronize_count);
+
+int32_t read_perf_counters_at(uintptr_t base, tpu_perf_counters_t *counters);
+
+void set_instruction(instruction_t *instruction, uint8_t op_code, uint32_t calc_length, uint16_t acc_address, uint32_t buf_address);
+
+void set_bias_instruction(instruction_t *instruction, uint8_t op_code, uint32_t calc_length, uint16_t acc_address, uint32_t buf_address, uint16_t bias_address);
+
+void set_weight_instruction(instruction_t *instruction, uint8_t op_code, uint32_t calc_length, uint64_t weight_address);
+
+uint32_t get_calc_length(instruction_t *instruction);
+
+uint16_t get_acc_address(instruction_t *instruction);
+
+uint16_t get_bias_address(instruction_t *instruction);
+
+uint32_t get_buf_address(instruction_t *instruction);
+
+uint64_t get_weight_address(instruction_t *instruction);
+
 #endif /* SRC_TINYTPU_ACCESS_H_ */
@@ -0,0 +1,146 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_batcher.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_batcher.h"
+#include "tinyTPU_quantize.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t padded(uint32_t size) {
+	return (size + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE;
+}
+
+int32_t tpu_batcher_init(tpu_batcher_t *batcher, uint32_t features, uint32_t output_count, uint64_t latency, tpu_batcher_backend_t backend, void *backend_context, tpu_batcher_done_t done, void *done_context) {
+	if(features == 0 || output_count == 0) return EINVAL;
+
+	batcher->features = features;
+	batcher->output_count = output_count;
+	batcher->latency = latency;
+	batcher->backend = backend;
+	batcher->backend_context = backend_context;
+	batcher->done = done;
+	batcher->done_context = done_context;
+	batcher->count = 0;
+	batcher->deadline = 0;
+	batcher->samples = 0;
+	batcher->batches = 0;
+
+	batcher->inputs = calloc(padded(features), sizeof(tpu_vector_t));
+	batcher->outputs = calloc(padded(output_count), sizeof(tpu_vector_t));
+	batcher->sample_outputs = malloc(output_count);
+	if(batcher->inputs == NULL || batcher->outputs == NULL || batcher->sample_outputs == NULL) {
+		tpu_batcher_free(batcher);
+		return ENOMEM;
+	}
+
+	return 0;
+}
+
+void tpu_batcher_free(tpu_batcher_t *batcher) {
+	free(batcher->inputs);
+	free(batcher->outputs);
+	free(batcher->sample_outputs);
+	batcher->inputs = NULL;
+	batcher->outputs = NULL;
+	batcher->sample_outputs = NULL;
+}
+
+/**
+ * Adds a sample to the next free slot. The tag is passed to the done callback with the outputs of the sample.
+ * Returns EAGAIN, if the batch is full and has to be submitted first.
+ */
+int32_t tpu_batcher_add(tpu_batcher_t *batcher, int8_t *sample, void *tag, uint64_t now) {
+	if(batcher->count == TPU_BATCHER_SLOTS) return EAGAIN;
+
+	uint32_t slot = batcher->count++;
+	if(slot == 0) batcher->deadline = now + batcher->latency;
+	batcher->tags[slot] = tag;
+
+	// Vector slot of every tile holds the features of the sample
+	tpu_tile_sample(sample, batcher->features, slot, batcher->inputs);
+
+	batcher->samples++;
+	return 0;
+}
+
+/**
+ * Checks, if the batch has to be submitted, because it is full or the oldest sample reached its deadline.
+ */
+uint8_t tpu_batcher_ready(tpu_batcher_t *batcher, uint64_t now) {
+	return batcher->count == TPU_BATCHER_SLOTS || (batcher->count && now >= batcher->deadline);
+}
+
+/**
+ * Time until the batch has to be submitted, UINT64_MAX if it is empty.
+ */
+uint64_t tpu_batcher_timeout(tpu_batcher_t *batcher, uint64_t now) {
+	if(batcher->count == 0) return UINT64_MAX;
+	if(batcher->count == TPU_BATCHER_SLOTS || now >= batcher->deadline) return 0;
+	return batcher->deadline - now;
+}
+
+/**
+ * Calculates the batch and passes the outputs to the done callback. Empty slots are calculated with the inputs
+ * of older batches, but their outputs are ignored.
+ */
+int32_t tpu_batcher_submit(tpu_batcher_t *batcher) {
+	if(batcher->count == 0) return 0;
+
+	int32_t error = batcher->backend(batcher->backend_context, batcher->inputs, batcher->outputs);
+	uint32_t count = batcher->count;
+	batcher->count = 0;
+	batcher->batches++;
+	if(error) return error;
+
+	for(uint32_t slot = 0; slot < count; ++slot) {
+		for(uint32_t c = 0; c < batcher->output_count; ++c) {
+			batcher->sample_outputs[c] = batcher->outputs[c - c%TPU_VECTOR_SIZE + slot].byte_vector[c%TPU_VECTOR_SIZE];
+		}
+		batcher->done(batcher->done_context, batcher->tags[slot], batcher->sample_outputs, batcher->output_count);
+	}
+
+	return 0;
+}
+
+/**
+ * Backend, which writes the inputs, runs the program and reads the outputs of the program.
+ */
+int32_t tpu_batcher_run_program(void *context, tpu_vector_t *inputs, tpu_vector_t *outputs) {
+	tpu_program_backend_t *backend = (tpu_program_backend_t*)context;
+	tpu_program_t *program = backend->program;
+
+	int32_t error = tpu_device_write_inputs(backend->device, inputs, 0, program->input_rows);
+	if(error) return error;
+
+	tpu_fence_t fence = tpu_device_write_instructions(backend->device, program->instructions, program->count);
+	tpu_device_wait(backend->device, fence);
+
+	return tpu_device_read_outputs(backend->device, outputs, program->output_address, program->output_length);
+}
@@ -0,0 +1,94 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_batcher.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_BATCHER_H_
+#define SRC_TINYTPU_BATCHER_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_compiler.h"
+#include "tinyTPU_device.h"
+#include <stdint.h>
+
+/*
+ * Dynamic batching of single samples.
+ *
+ * A matrix multiply streams TPU_VECTOR_SIZE samples through the array, one per vector. Single requests leave all but one
+ * vector of every tile empty. The batcher collects samples into the slots of a batch in the layout of transfer_complete_model.py,
+ * until all slots are used or the deadline of the oldest sample passed. The batch is calculated by the backend and the
+ * outputs of every slot are passed to the done callback.
+ *
+ * Backends calculate a batch from its input vectors into its output vectors, e.g. tpu_batcher_run_program or tpu_shard_run.
+ */
+#define TPU_BATCHER_SLOTS TPU_VECTOR_SIZE
+
+typedef int32_t (*tpu_batcher_backend_t)(void *context, tpu_vector_t *inputs, tpu_vector_t *outputs);
+// Called for every sample of a calculated batch with its outputs
+typedef void (*tpu_batcher_done_t)(void *context, void *tag, int8_t *outputs, uint32_t output_count);
+
+typedef struct tpu_batcher {
+	uint32_t features;
+	uint32_t output_count;
+	// Time a sample waits for other samples at most
+	uint64_t latency;
+	tpu_batcher_backend_t backend;
+	void *backend_context;
+	tpu_batcher_done_t done;
+	void *done_context;
+	// Batch, which is collected
+	uint32_t count;
+	uint64_t deadline;
+	void *tags[TPU_BATCHER_SLOTS];
+	tpu_vector_t *inputs;
+	tpu_vector_t *outputs;
+	int8_t *sample_outputs;
+	// Statistics
+	uint64_t samples;
+	uint64_t batches;
+} tpu_batcher_t;
+
+// Backend, which calculates a compiled program on a device, which holds the weights of the program
+typedef struct tpu_program_backend {
+	tpu_device_t *device;
+	tpu_program_t *program;
+} tpu_program_backend_t;
+
+int32_t tpu_batcher_init(tpu_batcher_t *batcher, uint32_t features, uint32_t output_count, uint64_t latency, tpu_batcher_backend_t backend, void *backend_context, tpu_batcher_done_t done, void *done_context);
+
+void tpu_batcher_free(tpu_batcher_t *batcher);
+
+int32_t tpu_batcher_add(tpu_batcher_t *batcher, int8_t *sample, void *tag, uint64_t now);
+
+uint8_t tpu_batcher_ready(tpu_batcher_t *batcher, uint64_t now);
+
+uint64_t tpu_batcher_timeout(tpu_batcher_t *batcher, uint64_t now);
+
+int32_t tpu_batcher_submit(tpu_batcher_t *batcher);
+
+int32_t tpu_batcher_run_program(void *context, tpu_vector_t *inputs, tpu_vector_t *outputs);
+
+#endif /* SRC_TINYTPU_BATCHER_H_ */
@@ -0,0 +1,294 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_bundle.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_bundle.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+typedef union chunk {
+	tpu_vector_t vectors[TPU_BUNDLE_CHUNK_SIZE/sizeof(tpu_vector_t)];
+	instruction_t instructions[TPU_BUNDLE_CHUNK_SIZE/sizeof(instruction_t)];
+	tpu_bundle_result_t results[TPU_BUNDLE_CHUNK_SIZE/sizeof(tpu_bundle_result_t)];
+	uint8_t bytes[TPU_BUNDLE_CHUNK_SIZE];
+} chunk_t;
+
+static int32_t default_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	(void)context;
+	return write_weight_block(vectors, address, count);
+}
+
+static int32_t default_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	(void)context;
+	return write_input_block(vectors, address, count);
+}
+
+static int32_t default_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	(void)context;
+	for(uint32_t i = 0; i < count; ++i) {
+		if(write_instruction(&instructions[i])) return EFAULT;
+	}
+	return 0;
+}
+
+/**
+ * Size of a single record of the section, 0 for unknown sections, which are skipped.
+ */
+static uint32_t record_size(tpu_bundle_section_t *section) {
+	switch(section->type) {
+		case TPU_SECTION_WEIGHTS:
+		case TPU_SECTION_INPUTS:
+			return sizeof(tpu_vector_t);
+		case TPU_SECTION_INSTRUCTIONS:
+			return TPU_INSTRUCTION_SIZE;
+		case TPU_SECTION_RESULTS:
+			return sizeof(tpu_bundle_result_t);
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Records of a section, which fit into one chunk.
+ */
+static uint32_t chunk_records(tpu_bundle_section_t *section) {
+	if(section->type == TPU_SECTION_INSTRUCTIONS) return sizeof(chunk_t)/sizeof(instruction_t);
+	return sizeof(chunk_t)/record_size(section);
+}
+
+/**
+ * Expands encoded instructions to instruction_t. Works in place, because the last instruction is expanded first.
+ */
+static void unpack_instructions(instruction_t *instructions, const uint8_t *encoded, uint32_t count) {
+	for(uint32_t i = count; i > 0; --i) {
+		memmove(&instructions[i-1], &encoded[(i-1)*TPU_INSTRUCTION_SIZE], TPU_INSTRUCTION_SIZE);
+	}
+}
+
+static int32_t check_section(tpu_bundle_section_t *section) {
+	uint32_t size = record_size(section);
+	if(size == 0) return 0;
+	if(section->offset % TPU_BUNDLE_ALIGNMENT) return EINVAL;
+	if((uint64_t)section->count*size != section->size) return EINVAL;
+	return 0;
+}
+
+/**
+ * Passes count records of a section, starting with record first, to the handler.
+ */
+static int32_t handle(tpu_bundle_handler_t *handler, tpu_bundle_section_t *section, void *data, uint32_t first, uint32_t count) {
+	switch(section->type) {
+		case TPU_SECTION_WEIGHTS:
+			if(handler->weights == NULL) return 0;
+			return handler->weights(handler->context, (tpu_vector_t*)data, section->address+first, count);
+		case TPU_SECTION_INPUTS:
+			if(handler->inputs == NULL) return 0;
+			return handler->inputs(handler->context, (tpu_vector_t*)data, section->address+first, count);
+		case TPU_SECTION_INSTRUCTIONS:
+			if(handler->instructions == NULL) return 0;
+			return handler->instructions(handler->context, (instruction_t*)data, count);
+		case TPU_SECTION_RESULTS:
+			if(handler->results == NULL) return 0;
+			return handler->results(handler->context, (tpu_bundle_result_t*)data, count);
+		default:
+			return 0;
+	}
+}
+
+static int32_t end_section(tpu_bundle_handler_t *handler, tpu_bundle_section_t *section) {
+	if(record_size(section) == 0 || handler->section_end == NULL) return 0;
+	return handler->section_end(handler->context, (tpu_section_type_t)section->type);
+}
+
+void tpu_bundle_default_handler(tpu_bundle_handler_t *handler) {
+	handler->context = NULL;
+	handler->weights = default_weights;
+	handler->inputs = default_inputs;
+	handler->instructions = default_instructions;
+	handler->results = NULL;
+	handler->section_end = NULL;
+}
+
+int32_t tpu_bundle_check_header(tpu_bundle_header_t *header) {
+	if(header->magic != TPU_BUNDLE_MAGIC) return EINVAL;
+	if(header->version != TPU_BUNDLE_VERSION) return EINVAL;
+	if(header->vector_size != TPU_VECTOR_SIZE) return EINVAL;
+	if(header->section_offset < sizeof(tpu_bundle_header_t)) return EINVAL;
+	return 0;
+}
+
+/**
+ * Reads the bundle sequentially, so sections have to be stored in table order.
+ */
+int32_t tpu_bundle_stream(tpu_bundle_read_t read, void *source, tpu_bundle_handler_t *handler) {
+	chunk_t chunk;
+	tpu_bundle_header_t header;
+	int32_t error;
+
+	if(read(source, &header, sizeof(header))) return EIO;
+	if((error = tpu_bundle_check_header(&header))) return error;
+
+	// Skip everything until the section table
+	uint64_t position = sizeof(header);
+	while(position < header.section_offset) {
+		uint32_t size = header.section_offset - position;
+		if(size > sizeof(chunk)) size = sizeof(chunk);
+		if(read(source, chunk.bytes, size)) return EIO;
+		position += size;
+	}
+
+	tpu_bundle_section_t *sections = malloc(header.section_count*sizeof(tpu_bundle_section_t));
+	if(sections == NULL && header.section_count) return ENOMEM;
+
+	if(read(source, sections, header.section_count*sizeof(tpu_bundle_section_t))) {
+		free(sections);
+		return EIO;
+	}
+	position += header.section_count*sizeof(tpu_bundle_section_t);
+
+	for(uint32_t s = 0; s < header.section_count && !error; ++s) {
+		tpu_bundle_section_t *section = &sections[s];
+
+		if((error = check_section(section))) break;
+		if(section->offset < position) {
+			error = EINVAL;
+			break;
+		}
+
+		// Alignment gap
+		while(position < section->offset && !error) {
+			uint32_t size = section->offset - position;
+			if(size > sizeof(chunk)) size = sizeof(chunk);
+			if(read(source, chunk.bytes, size)) error = EIO;
+			position += size;
+		}
+
+		uint32_t record = record_size(section);
+		if(record == 0) {
+			// Unknown section, skip the data
+			uint32_t remaining = section->size;
+			while(remaining && !error) {
+				uint32_t size = remaining > sizeof(chunk) ? sizeof(chunk) : remaining;
+				if(read(source, chunk.bytes, size)) error = EIO;
+				remaining -= size;
+			}
+			position += section->size;
+			continue;
+		}
+
+		uint32_t records_per_chunk = chunk_records(section);
+		for(uint32_t first = 0; first < section->count && !error; first += records_per_chunk) {
+			uint32_t count = section->count - first;
+			if(count > records_per_chunk) count = records_per_chunk;
+
+			if(read(source, chunk.bytes, count*record)) {
+				error = EIO;
+			} else {
+				if(section->type == TPU_SECTION_INSTRUCTIONS) {
+					unpack_instructions(chunk.instructions, chunk.bytes, count);
+				}
+				error = handle(handler, section, chunk.bytes, first, count);
+			}
+		}
+		position += section->size;
+
+		if(!error) error = end_section(handler, section);
+	}
+
+	free(sections);
+	return error;
+}
+
+/**
+ * Handles a bundle, which is completely in memory. Vectors and results are passed to the handler in place.
+ */
+int32_t tpu_bundle_map(const void *data, size_t size, tpu_bundle_handler_t *handler) {
+	const uint8_t *bytes = (const uint8_t*)data;
+	tpu_bundle_header_t header;
+	int32_t error;
+
+	if(size < sizeof(header)) return EINVAL;
+	header = *(const tpu_bundle_header_t*)bytes;
+	if((error = tpu_bundle_check_header(&header))) return error;
+	if((uint64_t)header.section_offset + (uint64_t)header.section_count*sizeof(tpu_bundle_section_t) > size) return EINVAL;
+
+	const tpu_bundle_section_t *sections = (const tpu_bundle_section_t*)(bytes + header.section_offset);
+	for(uint32_t s = 0; s < header.section_count; ++s) {
+		tpu_bundle_section_t section = sections[s];
+
+		if((error = check_section(&section))) return error;
+		if((uint64_t)section.offset + section.size > size) return EINVAL;
+		if(record_size(&section) == 0) continue;
+
+		if(section.type == TPU_SECTION_INSTRUCTIONS) {
+			chunk_t chunk;
+			uint32_t records_per_chunk = chunk_records(&section);
+			for(uint32_t first = 0; first < section.count; first += records_per_chunk) {
+				uint32_t count = section.count - first;
+				if(count > records_per_chunk) count = records_per_chunk;
+
+				unpack_instructions(chunk.instructions, bytes + section.offset + first*TPU_INSTRUCTION_SIZE, count);
+				if((error = handle(handler, &section, chunk.instructions, first, count))) return error;
+			}
+		} else if(section.count) {
+			if((error = handle(handler, &section, (void*)(bytes + section.offset), 0, section.count))) return error;
+		}
+		if((error = end_section(handler, &section))) return error;
+	}
+
+	return 0;
+}
+
+#ifdef __linux__
+int32_t tpu_bundle_map_file(const char *path, tpu_bundle_handler_t *handler) {
+	int file = open(path, O_RDONLY);
+	if(file < 0) return EIO;
+
+	struct stat info;
+	if(fstat(file, &info) || info.st_size == 0) {
+		close(file);
+		return EIO;
+	}
+
+	void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if(data == MAP_FAILED) return EIO;
+
+	int32_t error = tpu_bundle_map(data, info.st_size, handler);
+
+	munmap(data, info.st_size);
+	return error;
+}
+#endif
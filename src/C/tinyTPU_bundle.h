@@ -0,0 +1,116 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_bundle.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_BUNDLE_H_
+#define SRC_TINYTPU_BUNDLE_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Binary program bundle, written by transfer_bundle.py.
+ *
+ * All fields are little endian. The header is followed by the section table.
+ * Sections are executed in table order and their data is stored in the same order,
+ * each aligned to TPU_BUNDLE_ALIGNMENT bytes:
+ * - weights and inputs hold padded vectors in the transfer format (TPU_VECTOR_PADDING bytes each),
+ *   which can be copied into the buffer windows as they are
+ * - instructions hold the encoded 10 byte instructions
+ * - results hold result descriptors (address, length, append)
+ */
+#define TPU_BUNDLE_MAGIC		0x55505474 // "tTPU"
+#define TPU_BUNDLE_VERSION		1
+#define TPU_BUNDLE_ALIGNMENT	16
+
+// Vectors or instructions, which are handled at once when streaming
+#define TPU_BUNDLE_CHUNK_SIZE	4096
+
+typedef enum tpu_section_type {
+	TPU_SECTION_WEIGHTS = 1,
+	TPU_SECTION_INPUTS = 2,
+	TPU_SECTION_INSTRUCTIONS = 3,
+	TPU_SECTION_RESULTS = 4
+} tpu_section_type_t;
+
+typedef struct __attribute__((__packed__)) tpu_bundle_header {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t vector_size;
+	uint32_t section_count;
+	uint32_t section_offset;
+} tpu_bundle_header_t;
+
+typedef struct __attribute__((__packed__)) tpu_bundle_section {
+	uint32_t type;
+	// First weight or unified buffer address, unused for instructions and results
+	uint32_t address;
+	// Number of vectors, instructions or result descriptors
+	uint32_t count;
+	uint32_t offset;
+	uint32_t size;
+	uint32_t flags;
+} tpu_bundle_section_t;
+
+typedef struct __attribute__((__packed__)) tpu_bundle_result {
+	uint32_t address;
+	uint32_t length;
+	uint32_t append;
+} tpu_bundle_result_t;
+
+/**
+ * Callbacks for the sections of a bundle. Handlers, which are NULL, are skipped.
+ */
+typedef struct tpu_bundle_handler {
+	void *context;
+	int32_t (*weights)(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count);
+	int32_t (*inputs)(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count);
+	int32_t (*instructions)(void *context, instruction_t *instructions, uint32_t count);
+	int32_t (*results)(void *context, tpu_bundle_result_t *results, uint32_t count);
+	// Called after all data of a section was handled
+	int32_t (*section_end)(void *context, tpu_section_type_t type);
+} tpu_bundle_handler_t;
+
+/**
+ * Reads exactly size bytes from a sequential source (e.g. f_read of FatFs), returns 0 on success.
+ */
+typedef int32_t (*tpu_bundle_read_t)(void *source, void *buffer, uint32_t size);
+
+void tpu_bundle_default_handler(tpu_bundle_handler_t *handler);
+
+int32_t tpu_bundle_check_header(tpu_bundle_header_t *header);
+
+int32_t tpu_bundle_stream(tpu_bundle_read_t read, void *source, tpu_bundle_handler_t *handler);
+
+int32_t tpu_bundle_map(const void *data, size_t size, tpu_bundle_handler_t *handler);
+
+#ifdef __linux__
+int32_t tpu_bundle_map_file(const char *path, tpu_bundle_handler_t *handler);
+#endif
+
+#endif /* SRC_TINYTPU_BUNDLE_H_ */
@@ -0,0 +1,508 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_compiler.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_compiler.h"
+#include "tinyTPU_sim.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Allocation state of the accumulators in units of matrix_width registers
+typedef struct accumulator_ring {
+	uint32_t slots;
+	uint32_t head;
+	// Allocation of the group before, which may still be activated
+	uint32_t start;
+	uint32_t count;
+	// Highest number of slots, which were allocated at the same time
+	uint32_t used;
+} accumulator_ring_t;
+
+static uint32_t tile_count(uint32_t size, uint32_t width) {
+	return (size + width - 1)/width;
+}
+
+static int is_activation(instruction_t *instruction) {
+	return instruction->op_code != TPU_OP_SYNCHRONIZE && (instruction->op_code & TPU_OP_ACTIVATE);
+}
+
+static int is_multiply(instruction_t *instruction) {
+	return instruction->op_code != TPU_OP_SYNCHRONIZE && !(instruction->op_code & TPU_OP_ACTIVATE) && (instruction->op_code & TPU_OP_MATRIX_MULTIPLY);
+}
+
+static int overlaps(uint32_t a, uint32_t a_length, uint32_t b, uint32_t b_length) {
+	return a < b + b_length && b < a + a_length;
+}
+
+/**
+ * Allocates the slots of a group after the group before. The allocation wraps around, if the end of the accumulators is reached,
+ * so the slots, which were activated the longest time ago, are reused first.
+ */
+static int32_t allocate_accumulators(accumulator_ring_t *ring, uint32_t count, uint32_t *start) {
+	if(count > ring->slots) return EINVAL;
+
+	uint32_t slot = ring->head + count <= ring->slots ? ring->head : 0;
+	// The group before may still be activated
+	if(ring->count && overlaps(slot, count, ring->start, ring->count)) return EINVAL;
+
+	if(ring->count + count > ring->used) ring->used = ring->count + count;
+	ring->start = slot;
+	ring->count = count;
+	ring->head = slot + count;
+
+	*start = slot;
+	return 0;
+}
+
+static int32_t emit(tpu_program_t *program, uint8_t op_code, uint32_t calc_length, uint16_t acc_address, uint32_t buf_address) {
+	if(program->count == program->capacity) return ENOMEM;
+	set_instruction(&program->instructions[program->count++], op_code, calc_length, acc_address, buf_address);
+	return 0;
+}
+
+static int32_t emit_weights(tpu_program_t *program, uint8_t op_code, uint32_t calc_length, uint64_t weight_address) {
+	if(program->count == program->capacity) return ENOMEM;
+	set_weight_instruction(&program->instructions[program->count++], op_code, calc_length, weight_address);
+	return 0;
+}
+
+/**
+ * Checks, if a tile of the kernel has non-zero weights. Tiles of layers without a kernel are always used.
+ */
+static int is_used(tpu_compiler_config_t *config, tpu_compiler_layer_t *layer, uint32_t row_tile, uint32_t column_tile) {
+	uint32_t width = config->matrix_width;
+	if(layer->kernel == NULL) return 1;
+
+	for(uint32_t r = row_tile*width; r < (row_tile+1)*width && r < layer->rows; ++r) {
+		for(uint32_t c = column_tile*width; c < (column_tile+1)*width && c < layer->columns; ++c) {
+			if(layer->kernel[r*layer->columns + c]) return 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Emits the multiplies of a single output column tile like transfer_instructions.py. The first used tile initializes
+ * the accumulators, every run of consecutive used tiles accumulates with a single pair. A column tile without
+ * used tiles keeps its first tile. The weight address is advanced behind the weights of the column tile.
+ */
+static int32_t schedule_column(tpu_compiler_config_t *config, tpu_program_t *program, tpu_compiler_layer_t *layer, uint32_t column_tile, uint64_t *weight_address, uint16_t acc_address, uint32_t input_address) {
+	uint32_t width = config->matrix_width;
+	uint32_t row_tiles = tile_count(layer->rows, width);
+	uint8_t read_op = TPU_OP_READ_WEIGHTS | (config->is_signed ? TPU_WEIGHTS_SIGNED : 0);
+	uint8_t multiply_op = TPU_OP_MATRIX_MULTIPLY | (config->is_signed ? TPU_MULTIPLY_SIGNED : 0);
+	uint8_t first = 1;
+	int32_t error = 0;
+
+	uint8_t empty = 1;
+	for(uint32_t t = 0; t < row_tiles && empty; ++t) {
+		if(is_used(config, layer, t, column_tile)) empty = 0;
+	}
+
+	uint32_t t = 0;
+	while(t < row_tiles && !error) {
+		if(!empty && !is_used(config, layer, t, column_tile)) {
+			t++;
+			continue;
+		}
+
+		uint32_t end = t + 1;
+		while(!empty && end < row_tiles && is_used(config, layer, end, column_tile)) end++;
+
+		uint32_t start = t*width;
+		uint32_t length = (end - t)*width;
+		if(first) {
+			error = emit_weights(program, read_op, width, *weight_address);
+			if(!error) error = emit(program, multiply_op, width, acc_address, input_address + start);
+			*weight_address += width;
+			start += width;
+			length -= width;
+			first = 0;
+		}
+		if(!error && length) {
+			error = emit_weights(program, read_op, length, *weight_address);
+			if(!error) error = emit(program, multiply_op | TPU_MULTIPLY_ACCUMULATE, length, acc_address, input_address + start);
+			*weight_address += length;
+		}
+
+		if(empty) break;
+		t = end;
+	}
+
+	return error;
+}
+
+/**
+ * Emits the program with a fixed group size.
+ */
+static int32_t schedule(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count, uint32_t group_size, tpu_program_t *program) {
+	uint32_t width = config->matrix_width;
+	uint32_t batches = config->batches;
+	uint64_t weight_address = 0;
+	uint32_t input_address = 0;
+	uint32_t input_rows = tile_count(layers[0].rows, width)*width;
+	uint32_t buffer_rows = batches*input_rows;
+
+	accumulator_ring_t ring = {config->accumulator_depth/width, 0, 0, 0, 0};
+
+	if(buffer_rows > config->unified_buffer_depth) return ENOMEM;
+
+	program->count = 0;
+	program->input_rows = input_rows;
+
+	for(uint32_t l = 0; l < layer_count; ++l) {
+		uint32_t rows = tile_count(layers[l].rows, width)*width;
+		uint32_t columns = tile_count(layers[l].columns, width);
+		uint32_t output_rows = columns*width;
+
+		// The padded rows have to match the padded columns of the layer before
+		if(rows != input_rows) return EINVAL;
+
+		// Place the outputs below the inputs, if the inputs of the layer before left enough space
+		uint32_t output_address = batches*output_rows <= input_address ? 0 : input_address + batches*input_rows;
+		if(output_address + batches*output_rows > config->unified_buffer_depth) return ENOMEM;
+		if(output_address + batches*output_rows > buffer_rows) buffer_rows = output_address + batches*output_rows;
+
+		uint8_t activate_op = TPU_OP_ACTIVATE | (config->is_signed ? TPU_ACTIVATION_SIGNED : 0) | (layers[l].activation & TPU_ACTIVATION_MASK);
+
+		for(uint32_t c = 0; c < columns; c += group_size) {
+			uint32_t count = columns - c < group_size ? columns - c : group_size;
+			uint32_t slot;
+			// Weights of the group, which are read for every batch
+			uint64_t group_address = weight_address;
+
+			// The partial sums of all batches are live until the group is activated
+			int32_t error = allocate_accumulators(&ring, batches*count, &slot);
+			if(error) return error;
+
+			for(uint32_t b = 0; b < batches; ++b) {
+				weight_address = group_address;
+				for(uint32_t k = 0; k < count; ++k) {
+					error = schedule_column(config, program, &layers[l], c+k, &weight_address, (slot + b*count + k)*width, input_address + b*input_rows);
+					if(error) return error;
+				}
+			}
+
+			for(uint32_t b = 0; b < batches; ++b) {
+				error = emit(program, activate_op, count*width, (slot + b*count)*width, output_address + b*output_rows + c*width);
+				if(error) return error;
+			}
+		}
+
+		input_address = output_address;
+		input_rows = output_rows;
+	}
+
+	if(weight_address > config->weight_buffer_depth) return ENOMEM;
+
+	program->weight_rows = (uint32_t)weight_address;
+	program->buffer_rows = buffer_rows;
+	program->output_address = input_address;
+	program->output_length = input_rows;
+	program->group_size = group_size;
+	program->accumulators = ring.used*width;
+
+	return emit(program, TPU_OP_SYNCHRONIZE, 0, 0, 0);
+}
+
+/**
+ * Inserts a synchronize in front of the instructions at the given indices of the scheduled program.
+ * The indices are ascending and don't count the synchronizes, which are inserted.
+ */
+static int32_t insert_barriers(tpu_program_t *program, uint32_t *barriers, uint32_t barrier_count) {
+	if(program->count + barrier_count > program->capacity) return ENOMEM;
+
+	// Moves the instructions from the end, so every instruction is moved only once
+	uint32_t i = program->count;
+	program->count += barrier_count;
+	for(uint32_t b = barrier_count; b > 0; --b) {
+		uint32_t target = barriers[b-1] + b;
+		while(i > barriers[b-1]) {
+			i--;
+			program->instructions[i + b] = program->instructions[i];
+		}
+		set_instruction(&program->instructions[target - 1], TPU_OP_SYNCHRONIZE, 0, 0, 0);
+	}
+
+	return 0;
+}
+
+static int32_t simulate(tpu_program_t *program, uint64_t *issue_cycles) {
+	tpu_sim_config_t config;
+	tpu_sim_result_t result;
+
+	tpu_sim_default_config(&config);
+	int32_t error = tpu_sim_run(&config, program->instructions, program->count, &result, issue_cycles);
+	program->cycles = result.cycles;
+
+	return error;
+}
+
+/**
+ * Cycle, in which the activation unit doesn't access the accumulators and the unified buffer for the activation anymore.
+ */
+static uint64_t activation_end(instruction_t *instruction, uint64_t issue_cycle) {
+	return issue_cycle + get_calc_length(instruction) + TPU_SIM_LENGTH_DELAY + TPU_SIM_ACTIVATION_PIPELINE;
+}
+
+/**
+ * Cycle, in which the activation wrote the unified buffer at address. The activation writes one vector per cycle.
+ */
+static uint64_t activation_written(instruction_t *instruction, uint64_t issue_cycle, uint32_t address) {
+	return issue_cycle + (address - get_buf_address(instruction)) + 1 + TPU_SIM_LENGTH_DELAY + TPU_SIM_ACTIVATION_PIPELINE;
+}
+
+/**
+ * Checks a matrix multiply against the activations, which didn't finish before it was issued.
+ * first is the earliest activation, which may not be finished, and is advanced by the call.
+ */
+static int32_t check_multiply(tpu_compiler_config_t *config, instruction_t *instructions, uint64_t *issue_cycles, uint32_t i, uint32_t *first, uint64_t *missing) {
+	uint64_t issue = issue_cycles[i];
+	// Activations finish in program order, earlier ones finished before the multiply
+	while(*first < i && (!is_activation(&instructions[*first]) || activation_end(&instructions[*first], issue_cycles[*first]) <= issue)) (*first)++;
+
+	uint32_t length = get_calc_length(&instructions[i]);
+	// The accumulator address wraps after matrix_width vectors
+	uint32_t acc_length = length < config->matrix_width ? length : config->matrix_width;
+	*missing = 0;
+
+	for(uint32_t j = *first; j < i; ++j) {
+		if(!is_activation(&instructions[j])) continue;
+
+		uint32_t activation_length = get_calc_length(&instructions[j]);
+		if(overlaps(get_acc_address(&instructions[i]), acc_length, get_acc_address(&instructions[j]), activation_length)) return EINVAL;
+
+		// The multiply reads one vector per cycle at most, so the first vector, which is written by the activation, is read first
+		uint32_t buf_address = get_buf_address(&instructions[i]);
+		uint32_t activation_address = get_buf_address(&instructions[j]);
+		if(!overlaps(buf_address, length, activation_address, activation_length)) continue;
+
+		uint32_t address = buf_address > activation_address ? buf_address : activation_address;
+		uint64_t read = issue + (address - buf_address);
+		uint64_t written = activation_written(&instructions[j], issue_cycles[j], address);
+		if(written > read && written - read > *missing) *missing = written - read;
+	}
+
+	return *missing ? EAGAIN : 0;
+}
+
+/**
+ * Checks the simulated issue cycles of the program for matrix multiplies, which access the unified buffer or the accumulators
+ * of an activation, before the activation finished. A host, which writes instructions slower than simulated, only delays the multiplies.
+ * Returns EAGAIN, if a multiply reads activations too early, and stores the multiply and the missing cycles.
+ * Returns EINVAL, if a multiply overwrites accumulators, which are activated.
+ */
+int32_t tpu_compiler_check(tpu_compiler_config_t *config, tpu_program_t *program, uint64_t *issue_cycles, uint32_t *instruction, uint32_t *cycles) {
+	uint32_t first = 0;
+
+	for(uint32_t i = 0; i < program->count; ++i) {
+		if(!is_multiply(&program->instructions[i])) continue;
+
+		uint64_t missing;
+		int32_t error = check_multiply(config, program->instructions, issue_cycles, i, &first, &missing);
+		if(error) {
+			*instruction = i;
+			*cycles = (uint32_t)missing;
+			return error;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Number of matrix multiplies, which access the unified buffer or the accumulators of an activation too early.
+ */
+uint32_t tpu_compiler_hazards(tpu_compiler_config_t *config, instruction_t *instructions, uint32_t count, uint64_t *issue_cycles) {
+	uint32_t first = 0;
+	uint32_t hazards = 0;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		uint64_t missing;
+		if(is_multiply(&instructions[i]) && check_multiply(config, instructions, issue_cycles, i, &first, &missing)) hazards++;
+	}
+
+	return hazards;
+}
+
+/**
+ * Schedules and simulates the program with a fixed group size. Synchronizes are inserted in front of multiplies, which read
+ * activations too early, until the program has no hazards. A synchronize waits for all units, so the activations before it
+ * can't be read too early anymore.
+ */
+static int32_t compile_group(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count, uint32_t group_size, uint32_t *barriers, uint64_t *issue_cycles, tpu_program_t *program) {
+	uint32_t barrier_count = 0;
+
+	int32_t error = schedule(config, layers, layer_count, group_size, program);
+	if(error) return error;
+
+	// Only the multiplies at a layer boundary read activations, so every layer needs one synchronize at most
+	for(;;) {
+		error = simulate(program, issue_cycles);
+		if(error) return error;
+
+		uint32_t instruction;
+		uint32_t cycles;
+		error = tpu_compiler_check(config, program, issue_cycles, &instruction, &cycles);
+		if(error != EAGAIN) return error;
+		if(barrier_count == layer_count) return EINVAL;
+
+		// The index in the scheduled program without synchronizes, the barriers before it are sorted
+		uint32_t b = 0;
+		while(b < barrier_count && barriers[b] + b < instruction) b++;
+		for(uint32_t k = barrier_count; k > b; --k) {
+			barriers[k] = barriers[k-1];
+		}
+		barriers[b] = instruction - b;
+		barrier_count++;
+
+		error = schedule(config, layers, layer_count, group_size, program);
+		if(!error) error = insert_barriers(program, barriers, barrier_count);
+		if(error) return error;
+	}
+}
+
+/**
+ * Writes the weights of the layers in the layout of the program like transfer_weights.py. All-zero tiles are left out.
+ * Every layer needs a kernel and weights has to hold the weight rows of the program.
+ */
+int32_t tpu_compiler_weights(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count, tpu_vector_t *weights) {
+	uint32_t width = config->matrix_width;
+	uint64_t address = 0;
+
+	if(width == 0 || width > TPU_VECTOR_SIZE) return EINVAL;
+
+	for(uint32_t l = 0; l < layer_count; ++l) {
+		tpu_compiler_layer_t *layer = &layers[l];
+		uint32_t row_tiles = tile_count(layer->rows, width);
+		if(layer->kernel == NULL) return EINVAL;
+
+		for(uint32_t column_tile = 0; column_tile < tile_count(layer->columns, width); ++column_tile) {
+			uint8_t empty = 1;
+			for(uint32_t t = 0; t < row_tiles && empty; ++t) {
+				if(is_used(config, layer, t, column_tile)) empty = 0;
+			}
+
+			for(uint32_t t = 0; t < row_tiles; ++t) {
+				if(empty ? t > 0 : !is_used(config, layer, t, column_tile)) continue;
+				if(address + width > config->weight_buffer_depth) return ENOMEM;
+
+				for(uint32_t r = t*width; r < (t+1)*width; ++r) {
+					tpu_vector_t *vector = &weights[address++];
+					memset(vector, 0, sizeof(tpu_vector_t));
+					for(uint32_t c = column_tile*width; c < (column_tile+1)*width && r < layer->rows && c < layer->columns; ++c) {
+						vector->byte_vector[c - column_tile*width] = layer->kernel[r*layer->columns + c];
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Configuration of the TPU in TPU.vhdl and TPU_CORE.vhdl with signed weights and inputs.
+ */
+void tpu_compiler_default_config(tpu_compiler_config_t *config) {
+	config->matrix_width = TPU_VECTOR_SIZE;
+	config->weight_buffer_depth = WEIGHT_BUFFER_SIZE;
+	config->unified_buffer_depth = UNIFIED_BUFFER_SIZE;
+	config->accumulator_depth = 512;
+	config->is_signed = 1;
+	config->batches = 1;
+	config->group_size = 0;
+}
+
+/**
+ * Number of instructions, the program array has to hold.
+ */
+uint32_t tpu_compiler_max_instructions(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count) {
+	uint32_t width = config->matrix_width;
+	uint32_t count = 1;
+	for(uint32_t l = 0; l < layer_count; ++l) {
+		// Two pairs and one activation per column and batch for dense kernels, every other tile may start a run otherwise
+		uint32_t pairs = layers[l].kernel ? tile_count(layers[l].rows, width)/2 + 2 : 2;
+		count += (2*pairs + 1)*config->batches*tile_count(layers[l].columns, width) + 1;
+	}
+	return count;
+}
+
+/**
+ * Compiles the layers into program->instructions, which has to hold program->capacity instructions.
+ */
+int32_t tpu_compiler_compile(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count, tpu_program_t *program) {
+	if(layer_count == 0 || config->matrix_width == 0 || config->batches == 0) return EINVAL;
+
+	// A group and the group before have to fit into the accumulators
+	uint32_t max_group = config->accumulator_depth/config->matrix_width/(2*config->batches);
+	if(max_group == 0) return EINVAL;
+	if(config->group_size > max_group) return EINVAL;
+
+	uint32_t *barriers = malloc(layer_count*sizeof(uint32_t));
+	uint64_t *issue_cycles = malloc(program->capacity*sizeof(uint64_t));
+	if(barriers == NULL || issue_cycles == NULL) {
+		free(barriers);
+		free(issue_cycles);
+		return ENOMEM;
+	}
+
+	int32_t error;
+	if(config->group_size) {
+		error = compile_group(config, layers, layer_count, config->group_size, barriers, issue_cycles, program);
+	} else {
+		uint32_t best_group = 0;
+		uint32_t best_count = 0;
+		uint64_t best_cycles = 0;
+
+		// Powers of two and the largest group, groups with hazards are skipped
+		for(uint32_t group = 1; ; group = 2*group < max_group ? 2*group : max_group) {
+			error = compile_group(config, layers, layer_count, group, barriers, issue_cycles, program);
+			if(error && error != EINVAL) break;
+
+			// Fewer instructions leave more room in the instruction FIFO, if the cycles are the same
+			if(!error && (best_group == 0 || program->cycles < best_cycles || (program->cycles == best_cycles && program->count < best_count))) {
+				best_group = group;
+				best_count = program->count;
+				best_cycles = program->cycles;
+			}
+
+			if(group == max_group) break;
+		}
+
+		if(!error || error == EINVAL) {
+			error = best_group ? compile_group(config, layers, layer_count, best_group, barriers, issue_cycles, program) : EINVAL;
+		}
+	}
+
+	free(barriers);
+	free(issue_cycles);
+	return error;
+}
@@ -0,0 +1,114 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_compiler.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_COMPILER_H_
+#define SRC_TINYTPU_COMPILER_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+
+/*
+ * Compiler for fully connected models.
+ *
+ * Emits the instructions for batches of matrix_width inputs. The inputs of batch b are stored at unified buffer
+ * address b*input_rows in the layout of transfer_complete_model.py. Weights are expected in the layout of transfer_weights.py,
+ * which tpu_compiler_weights writes: layers with a kernel leave out all-zero tiles, layers without one are dense (with "dense").
+ * Every output column tile is calculated by a read_weights/matrix_multiply pair for the first tile and one for every run
+ * of used tiles, like transfer_instructions.py does, because the weight loads run in lockstep with the multiplies.
+ * The compiler schedules around these pairs:
+ * - columns are grouped and the columns of all batches are activated by a single instruction per batch
+ * - accumulators are allocated from a ring, so the partial sums of a group never share registers with the group before,
+ *   which may still be activated while the group is multiplied
+ * - the output of a layer reuses the unified buffer space of the input of the layer before
+ * - the group size is picked by simulating the candidates with tinyTPU_sim
+ *
+ * With a group size of 1 and a single batch, the instructions are issued in the order of transfer_instructions.py.
+ *
+ * CONTROL_COORDINATOR doesn't let matrix multiplies wait for the activation unit. The simulated issue cycles are checked
+ * for multiplies, which read activations or overwrite accumulators, before the activation finished. Multiplies read and
+ * activations write one vector per cycle. A multiply, which reads activations too early, waits for a synchronize in front
+ * of it.
+ */
+
+typedef struct tpu_compiler_config {
+	// Generics of TPU.vhdl
+	uint32_t matrix_width;
+	uint32_t weight_buffer_depth;
+	uint32_t unified_buffer_depth;
+	// REGISTER_DEPTH of TPU_CORE.vhdl
+	uint32_t accumulator_depth;
+	uint8_t is_signed;
+	// Batches of matrix_width inputs, which are calculated by the program
+	uint32_t batches;
+	// Group size, 0 to pick the fastest one
+	uint32_t group_size;
+} tpu_compiler_config_t;
+
+typedef struct tpu_compiler_layer {
+	// Size of the kernel
+	uint32_t rows;
+	uint32_t columns;
+	// Activation function, e.g. TPU_SIGMOID
+	uint8_t activation;
+	// Row major weights to skip all-zero tiles, NULL for the dense layout
+	const int8_t *kernel;
+} tpu_compiler_layer_t;
+
+typedef struct tpu_program {
+	instruction_t *instructions;
+	uint32_t count;
+	uint32_t capacity;
+	// Rows of the weight buffer used by the weights
+	uint32_t weight_rows;
+	// Rows of the unified buffer used by all batches
+	uint32_t buffer_rows;
+	// Rows of the inputs of a single batch
+	uint32_t input_rows;
+	// Output of the first batch, the outputs of the other batches follow with output_length rows each
+	uint32_t output_address;
+	uint32_t output_length;
+	uint32_t group_size;
+	// Highest number of accumulators, which were allocated at the same time
+	uint32_t accumulators;
+	// Simulated cycles of the program
+	uint64_t cycles;
+} tpu_program_t;
+
+void tpu_compiler_default_config(tpu_compiler_config_t *config);
+
+uint32_t tpu_compiler_max_instructions(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count);
+
+int32_t tpu_compiler_weights(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count, tpu_vector_t *weights);
+
+int32_t tpu_compiler_compile(tpu_compiler_config_t *config, tpu_compiler_layer_t *layers, uint32_t layer_count, tpu_program_t *program);
+
+int32_t tpu_compiler_check(tpu_compiler_config_t *config, tpu_program_t *program, uint64_t *issue_cycles, uint32_t *instruction, uint32_t *cycles);
+
+uint32_t tpu_compiler_hazards(tpu_compiler_config_t *config, instruction_t *instructions, uint32_t count, uint64_t *issue_cycles);
+
+#endif /* SRC_TINYTPU_COMPILER_H_ */
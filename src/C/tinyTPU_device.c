@@ -0,0 +1,183 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_device.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_device.h"
+#include <errno.h>
+#include <stddef.h>
+
+void tpu_device_init(tpu_device_t *device, uintptr_t base) {
+	device->base = base;
+	device->model = NULL;
+	tpu_queue_init(&device->queue, base);
+
+	uint32_t synchronize_count;
+	tpu_device_read_synchronize_count(device, &synchronize_count);
+	tpu_fence_init(&device->fences, synchronize_count);
+}
+
+/**
+ * Initializes a stand-in device, which executes the instructions on the model.
+ */
+void tpu_device_init_model(tpu_device_t *device, tpu_model_t *model) {
+	device->base = 0;
+	device->model = model;
+	tpu_model_init(model);
+	tpu_fence_init(&device->fences, model->synchronize_count);
+}
+
+int32_t tpu_device_write_weights(tpu_device_t *device, tpu_vector_t *weight_vectors, uint32_t first_address, uint32_t count) {
+	if(first_address >= WEIGHT_BUFFER_SIZE || count > WEIGHT_BUFFER_SIZE - first_address) return EFAULT;
+
+	if(device->model != NULL) {
+		for(uint32_t i = 0; i < count; ++i) {
+			tpu_model_write_weight_vector(device->model, &weight_vectors[i], first_address + i);
+		}
+		return 0;
+	}
+
+	return write_weight_block_at(device->base, weight_vectors, first_address, count);
+}
+
+int32_t tpu_device_write_inputs(tpu_device_t *device, tpu_vector_t *input_vectors, uint32_t first_address, uint32_t count) {
+	if(first_address >= UNIFIED_BUFFER_SIZE || count > UNIFIED_BUFFER_SIZE - first_address) return EFAULT;
+
+	if(device->model != NULL) {
+		for(uint32_t i = 0; i < count; ++i) {
+			tpu_model_write_input_vector(device->model, &input_vectors[i], first_address + i);
+		}
+		return 0;
+	}
+
+	return write_input_block_at(device->base, input_vectors, first_address, count);
+}
+
+int32_t tpu_device_read_outputs(tpu_device_t *device, tpu_vector_t *output_vectors, uint32_t first_address, uint32_t count) {
+	if(first_address >= UNIFIED_BUFFER_SIZE || count > UNIFIED_BUFFER_SIZE - first_address) return EFAULT;
+
+	if(device->model != NULL) {
+		for(uint32_t i = 0; i < count; ++i) {
+			tpu_model_read_output_vector(device->model, &output_vectors[i], first_address + i);
+		}
+		return 0;
+	}
+
+	return read_output_block_at(device->base, output_vectors, first_address, count);
+}
+
+int32_t tpu_device_write_biases(tpu_device_t *device, int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count) {
+	if(first_address >= BIAS_BUFFER_SIZE || count > BIAS_BUFFER_SIZE - first_address) return EFAULT;
+
+	if(device->model != NULL) {
+		for(uint32_t i = 0; i < count; ++i) {
+			tpu_model_write_bias(device->model, bias_vectors[i], first_address + i);
+		}
+		return 0;
+	}
+
+	return write_bias_block_at(device->base, bias_vectors, first_address, count);
+}
+
+/**
+ * Queues the instructions for the instruction FIFO of the device and returns the fence of the last synchronize.
+ * The queue writes only as many instructions as the FIFO takes, the rest is written by tpu_device_drain and tpu_device_wait.
+ * This blocks only, while the queue is full.
+ */
+tpu_fence_t tpu_device_write_instructions(tpu_device_t *device, instruction_t *instructions, uint32_t count) {
+	tpu_fence_t fence = tpu_fence_scan(&device->fences, instructions, count);
+
+	if(device->model != NULL) {
+		for(uint32_t i = 0; i < count; ++i) {
+			tpu_model_execute(device->model, &instructions[i]);
+			// The model finished everything before, when the synchronize is executed
+			if(instructions[i].op_code == TPU_OP_SYNCHRONIZE) tpu_fence_signal(&device->fences, device->model->synchronize_count);
+		}
+		return fence;
+	}
+
+	while(count) {
+		uint32_t pushed = tpu_queue_push(&device->queue, instructions, count);
+		instructions += pushed;
+		count -= pushed;
+	}
+
+	return fence;
+}
+
+/**
+ * Writes queued instructions as long as the instruction FIFO takes them and returns the number of instructions left in the queue.
+ */
+uint32_t tpu_device_drain(tpu_device_t *device) {
+	if(device->model != NULL) return 0;
+
+	tpu_queue_drain(&device->queue);
+	return tpu_queue_pending(&device->queue);
+}
+
+/**
+ * Reads the cycles of the last calculation. Stand-ins have no timing.
+ */
+int32_t tpu_device_read_runtime(tpu_device_t *device, uint32_t *runtime_cycles) {
+	if(device->model != NULL) return EINVAL;
+
+	return read_runtime_at(device->base, runtime_cycles);
+}
+
+int32_t tpu_device_read_instruction_count(tpu_device_t *device, uint32_t *instruction_count) {
+	if(device->model != NULL) {
+		*instruction_count = (uint32_t)device->model->instruction_count;
+		return 0;
+	}
+
+	return read_instruction_count_at(device->base, instruction_count);
+}
+
+int32_t tpu_device_read_synchronize_count(tpu_device_t *device, uint32_t *synchronize_count) {
+	if(device->model != NULL) {
+		*synchronize_count = device->model->synchronize_count;
+		return 0;
+	}
+
+	return read_synchronize_count_at(device->base, synchronize_count);
+}
+
+/**
+ * Reads the performance counters of the last calculation. Stand-ins have no timing.
+ */
+int32_t tpu_device_read_perf_counters(tpu_device_t *device, tpu_perf_counters_t *counters) {
+	if(device->model != NULL) return EINVAL;
+
+	return read_perf_counters_at(device->base, counters);
+}
+
+/**
+ * Writes the queued instructions and waits for a fence of the device.
+ */
+void tpu_device_wait(tpu_device_t *device, tpu_fence_t fence) {
+	if(device->model == NULL) tpu_queue_flush(&device->queue);
+	tpu_fence_wait(&device->fences, fence, NULL, NULL);
+}
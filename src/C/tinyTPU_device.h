@@ -0,0 +1,87 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_device.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_DEVICE_H_
+#define SRC_TINYTPU_DEVICE_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_fence.h"
+#include "tinyTPU_model.h"
+#include "tinyTPU_queue.h"
+#include <stdint.h>
+
+/*
+ * Handle of a single tinyTPU_v1_0 instance.
+ *
+ * The functions of tinyTPU_access.h always address the instance at TPU_BASE. A device addresses the instance at its own base
+ * address, so several instances of a larger FPGA can be used side by side. A device can be backed by a functional model
+ * instead, which executes the instructions when they are written. This stands in for the hardware on Linux.
+ *
+ * Every device counts its own synchronize instructions. The ISR of an instance has to call tpu_fence_signal with the fences
+ * of its device and its synchronize count (tpu_device_read_synchronize_count). Stand-in devices signal their fences themselves.
+ *
+ * Instructions of a device are written through its own queue (tinyTPU_queue.h), so a device never gets more instructions
+ * than its instruction FIFO takes. Other writers of the instance have to use the queue of the device as well.
+ */
+typedef struct tpu_device {
+	// Base address of the AXI slave, 0 for a stand-in
+	uintptr_t base;
+	// Functional model, which stands in for the hardware
+	tpu_model_t *model;
+	tpu_fences_t fences;
+	// Instructions, which weren't written to the instruction FIFO yet
+	tpu_queue_t queue;
+} tpu_device_t;
+
+void tpu_device_init(tpu_device_t *device, uintptr_t base);
+
+void tpu_device_init_model(tpu_device_t *device, tpu_model_t *model);
+
+int32_t tpu_device_write_weights(tpu_device_t *device, tpu_vector_t *weight_vectors, uint32_t first_address, uint32_t count);
+
+int32_t tpu_device_write_inputs(tpu_device_t *device, tpu_vector_t *input_vectors, uint32_t first_address, uint32_t count);
+
+int32_t tpu_device_read_outputs(tpu_device_t *device, tpu_vector_t *output_vectors, uint32_t first_address, uint32_t count);
+
+int32_t tpu_device_write_biases(tpu_device_t *device, int32_t (*bias_vectors)[TPU_VECTOR_SIZE], uint32_t first_address, uint32_t count);
+
+tpu_fence_t tpu_device_write_instructions(tpu_device_t *device, instruction_t *instructions, uint32_t count);
+
+uint32_t tpu_device_drain(tpu_device_t *device);
+
+int32_t tpu_device_read_runtime(tpu_device_t *device, uint32_t *runtime_cycles);
+
+int32_t tpu_device_read_instruction_count(tpu_device_t *device, uint32_t *instruction_count);
+
+int32_t tpu_device_read_synchronize_count(tpu_device_t *device, uint32_t *synchronize_count);
+
+int32_t tpu_device_read_perf_counters(tpu_device_t *device, tpu_perf_counters_t *counters);
+
+void tpu_device_wait(tpu_device_t *device, tpu_fence_t fence);
+
+#endif /* SRC_TINYTPU_DEVICE_H_ */
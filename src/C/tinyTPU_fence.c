@@ -0,0 +1,135 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_fence.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_fence.h"
+#include <errno.h>
+#include <stddef.h>
+
+/**
+ * Starts the fences at the current synchronize count of the TPU, which doesn't restart with the host.
+ */
+void tpu_fence_init(tpu_fences_t *fences, tpu_fence_t completed) {
+	fences->issued = completed;
+	fences->completed = completed;
+	fences->callback_count = 0;
+}
+
+/**
+ * Returns the fence of a synchronize instruction, which is submitted next.
+ */
+tpu_fence_t tpu_fence_issue(tpu_fences_t *fences) {
+	return ++fences->issued;
+}
+
+/**
+ * Issues a fence for every synchronize instruction in the array, returns the last issued fence.
+ */
+tpu_fence_t tpu_fence_scan(tpu_fences_t *fences, instruction_t *instructions, uint32_t count) {
+	for(uint32_t i = 0; i < count; ++i) {
+		if(instructions[i].op_code == TPU_OP_SYNCHRONIZE) fences->issued++;
+	}
+	return fences->issued;
+}
+
+/**
+ * Has to be called by the synchronize ISR with the synchronize count read from the TPU.
+ * Older counts, e.g. of a late interrupt, are ignored.
+ */
+void tpu_fence_signal(tpu_fences_t *fences, tpu_fence_t completed) {
+	if((int32_t)(completed - fences->completed) > 0) fences->completed = completed;
+}
+
+uint8_t tpu_fence_done(tpu_fences_t *fences, tpu_fence_t fence) {
+	return (int32_t)(fences->completed - fence) >= 0;
+}
+
+/**
+ * Synchronize instructions, which were issued but didn't complete yet.
+ */
+uint32_t tpu_fence_in_flight(tpu_fences_t *fences) {
+	return fences->issued - fences->completed;
+}
+
+/**
+ * Registers a callback for a fence. The callback is run by the next poll after the fence is done.
+ */
+int32_t tpu_fence_on_complete(tpu_fences_t *fences, tpu_fence_t fence, tpu_fence_callback_t callback, void *context) {
+	if(fences->callback_count == TPU_FENCE_CALLBACKS) return ENOMEM;
+
+	tpu_fence_entry_t *entry = &fences->callbacks[fences->callback_count++];
+	entry->fence = fence;
+	entry->callback = callback;
+	entry->context = context;
+
+	return 0;
+}
+
+/**
+ * Runs the callbacks of all completed fences, returns the number of callbacks run.
+ */
+uint32_t tpu_fence_poll(tpu_fences_t *fences) {
+	uint32_t run = 0;
+
+	for(uint32_t i = 0; i < fences->callback_count;) {
+		tpu_fence_entry_t entry = fences->callbacks[i];
+		if(!tpu_fence_done(fences, entry.fence)) {
+			++i;
+			continue;
+		}
+
+		// Remove before the call, so the callback may register new callbacks
+		fences->callbacks[i] = fences->callbacks[--fences->callback_count];
+		entry.callback(entry.context, entry.fence);
+		run++;
+	}
+
+	return run;
+}
+
+/**
+ * Blocks until the fence is done. Callbacks of completed fences are run meanwhile.
+ * Without an idle function the core sleeps until the next interrupt on bare metal.
+ */
+void tpu_fence_wait(tpu_fences_t *fences, tpu_fence_t fence, tpu_fence_idle_t idle, void *context) {
+	while(!tpu_fence_done(fences, fence)) {
+		tpu_fence_poll(fences);
+
+		if(idle != NULL) {
+			idle(context);
+		} else {
+#if defined(__arm__) && !defined(__linux__)
+			// Interrupts are masked while checking, a pending interrupt still wakes the core up
+			__asm__ volatile("cpsid i" ::: "memory");
+			if(!tpu_fence_done(fences, fence)) __asm__ volatile("wfi" ::: "memory");
+			__asm__ volatile("cpsie i" ::: "memory");
+#endif
+		}
+	}
+
+	tpu_fence_poll(fences);
+}
@@ -0,0 +1,85 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_fence.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_FENCE_H_
+#define SRC_TINYTPU_FENCE_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+
+/*
+ * Completion fences for synchronize instructions.
+ *
+ * Every synchronize instruction, which is submitted, gets the next sequence number (fence).
+ * The synchronize ISR passes the synchronize count of the TPU, so a fence is done, when the TPU finished as many
+ * synchronize instructions. Interrupts may coalesce, the count doesn't. Sequence numbers wrap around and are
+ * compared by their difference.
+ * Callbacks are run by tpu_fence_poll (or tpu_fence_wait), never from the ISR.
+ */
+#define TPU_FENCE_CALLBACKS 16
+
+typedef uint32_t tpu_fence_t;
+
+typedef void (*tpu_fence_callback_t)(void *context, tpu_fence_t fence);
+// Called while waiting for a fence, e.g. to drain a submission queue
+typedef void (*tpu_fence_idle_t)(void *context);
+
+typedef struct tpu_fence_entry {
+	tpu_fence_t fence;
+	tpu_fence_callback_t callback;
+	void *context;
+} tpu_fence_entry_t;
+
+typedef struct tpu_fences {
+	// Sequence number of the last submitted synchronize
+	tpu_fence_t issued;
+	// Synchronize count of the TPU at the last signal
+	volatile tpu_fence_t completed;
+	uint32_t callback_count;
+	tpu_fence_entry_t callbacks[TPU_FENCE_CALLBACKS];
+} tpu_fences_t;
+
+void tpu_fence_init(tpu_fences_t *fences, tpu_fence_t completed);
+
+tpu_fence_t tpu_fence_issue(tpu_fences_t *fences);
+
+tpu_fence_t tpu_fence_scan(tpu_fences_t *fences, instruction_t *instructions, uint32_t count);
+
+void tpu_fence_signal(tpu_fences_t *fences, tpu_fence_t completed);
+
+uint8_t tpu_fence_done(tpu_fences_t *fences, tpu_fence_t fence);
+
+uint32_t tpu_fence_in_flight(tpu_fences_t *fences);
+
+int32_t tpu_fence_on_complete(tpu_fences_t *fences, tpu_fence_t fence, tpu_fence_callback_t callback, void *context);
+
+uint32_t tpu_fence_poll(tpu_fences_t *fences);
+
+void tpu_fence_wait(tpu_fences_t *fences, tpu_fence_t fence, tpu_fence_idle_t idle, void *context);
+
+#endif /* SRC_TINYTPU_FENCE_H_ */
@@ -0,0 +1,623 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_model.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_model.h"
+#include <errno.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Width of the matrix multiply result before the sign extension (see MATRIX_MULTIPLY_UNIT.vhdl)
+#define RESULT_WIDTH (2*9+TPU_VECTOR_SIZE-1)
+#if RESULT_WIDTH < 32
+#define RESULT_MASK ((uint32_t)((1UL << RESULT_WIDTH)-1))
+#else
+#define RESULT_MASK ((uint32_t)0xFFFFFFFF)
+#endif
+
+// Look-up-tables of ACTIVATION.vhdl
+static const uint8_t SIGMOID_UNSIGNED[165] = {
+	128, 130, 132, 134, 136, 138, 140, 142, 144, 146, 148, 150, 152, 154, 156, 157, 159, 161, 163, 165,
+	167, 169, 170, 172, 174, 176, 177, 179, 181, 182, 184, 186, 187, 189, 190, 192, 193, 195, 196, 198,
+	199, 200, 202, 203, 204, 206, 207, 208, 209, 210, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221,
+	222, 223, 224, 225, 225, 226, 227, 228, 229, 229, 230, 231, 232, 232, 233, 234, 234, 235, 235, 236,
+	237, 237, 238, 238, 239, 239, 240, 240, 241, 241, 241, 242, 242, 243, 243, 243, 244, 244, 245, 245,
+	245, 246, 246, 246, 246, 247, 247, 247, 248, 248, 248, 248, 248, 249, 249, 249, 249, 250, 250, 250,
+	250, 250, 250, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252, 252, 252, 252, 252, 253, 253, 253,
+	253, 253, 253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+	254, 254, 254, 254, 254
+};
+
+// Indexed from -88 to 70
+static const uint8_t SIGMOID_SIGNED[159] = {
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2,
+	2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 5, 5, 5, 6,
+	6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 12, 12, 13, 14, 14, 15, 16, 17, 18,
+	19, 20, 21, 22, 23, 25, 26, 27, 29, 30, 31, 33, 34, 36, 38, 39, 41, 43, 45, 46,
+	48, 50, 52, 54, 56, 58, 60, 62, 64, 66, 68, 70, 72, 74, 76, 78, 80, 82, 83, 85,
+	87, 89, 90, 92, 94, 95, 97, 98, 99, 101, 102, 103, 105, 106, 107, 108, 109, 110, 111, 112,
+	113, 114, 114, 115, 116, 116, 117, 118, 118, 119, 119, 120, 120, 121, 121, 122, 122, 122, 123, 123,
+	123, 124, 124, 124, 124, 124, 125, 125, 125, 125, 125, 126, 126, 126, 126, 126, 126, 126, 126
+};
+
+// Indexed from -128 to 127
+static const int8_t ELU_SIGNED[256] = {
+	-16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16,
+	-16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16,
+	-16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16,
+	-16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, -15, -15, -15, -15, -15, -15, -15,
+	-15, -15, -15, -15, -15, -15, -15, -15, -15, -15, -15, -14, -14, -14, -14, -14, -14, -14, -14, -13,
+	-13, -13, -13, -13, -12, -12, -12, -12, -11, -11, -11, -10, -10, -10, -9, -9, -8, -8, -7, -7,
+	-6, -6, -5, -4, -4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+	32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+	72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91,
+	92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+	112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127
+};
+
+static const uint8_t ELU_UNSIGNED[256] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+	20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+	40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+	60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+	80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+	100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+	120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
+	140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+	160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179,
+	180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+	200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219,
+	220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+	240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255
+};
+
+// Indexed from -128 to 127
+static const int8_t SELU_SIGNED[256] = {
+	-28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28,
+	-28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28,
+	-28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28, -28,
+	-28, -28, -28, -28, -28, -28, -28, -28, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27, -27,
+	-27, -27, -27, -26, -26, -26, -26, -26, -26, -26, -26, -25, -25, -25, -25, -25, -24, -24, -24, -24,
+	-23, -23, -23, -22, -22, -21, -21, -21, -20, -20, -19, -18, -18, -17, -16, -16, -15, -14, -13, -12,
+	-11, -10, -9, -8, -6, -5, -3, -2, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12,
+	13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 32, 33,
+	34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 53, 54,
+	55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 74, 75,
+	76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 94, 95, 96,
+	97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 115, 116, 117,
+	118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 127, 127, 127, 127, 127, 127
+};
+
+static const uint8_t SELU_UNSIGNED[256] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+	21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
+	42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62,
+	63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83,
+	84, 85, 86, 87, 88, 89, 90, 91, 92, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104,
+	105, 106, 107, 108, 109, 110, 111, 112, 113, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125,
+	126, 127, 128, 129, 130, 131, 132, 133, 134, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146,
+	147, 148, 149, 150, 151, 152, 153, 154, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167,
+	168, 169, 170, 171, 172, 173, 174, 175, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188,
+	189, 190, 191, 192, 193, 194, 195, 196, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209,
+	210, 211, 212, 213, 214, 215, 216, 217, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230,
+	231, 232, 233, 234, 235, 236, 237, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251,
+	252, 253, 254, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255
+};
+
+// Indexed from -128 to 127
+static const int8_t SOFTPLUS_SIGNED[256] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+	3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 5, 5, 5, 6, 6, 6, 7, 7, 7,
+	8, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 16, 16, 17, 18,
+	18, 19, 20, 20, 21, 22, 22, 23, 24, 25, 26, 26, 27, 28, 29, 30, 31, 31, 32, 33,
+	34, 35, 36, 37, 38, 39, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52,
+	53, 54, 55, 56, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+	72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91,
+	92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+	112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127
+};
+
+static const uint8_t SOFTPLUS_UNSIGNED[256] = {
+	22, 23, 23, 24, 24, 25, 25, 26, 26, 27, 28, 28, 29, 29, 30, 31, 31, 32, 32, 33,
+	34, 34, 35, 36, 36, 37, 38, 38, 39, 40, 41, 41, 42, 43, 43, 44, 45, 46, 47, 47,
+	48, 49, 50, 50, 51, 52, 53, 54, 54, 55, 56, 57, 58, 59, 59, 60, 61, 62, 63, 64,
+	65, 65, 66, 67, 68, 69, 70, 71, 72, 73, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82,
+	83, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 99, 100,
+	101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120,
+	121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 133, 134, 135, 136, 137, 138, 139,
+	140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+	160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179,
+	180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+	200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219,
+	220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+	240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255
+};
+
+// Indexed from -128 to 127
+static const int8_t SOFTSIGN_SIGNED[256] = {
+	-114, -114, -114, -113, -113, -113, -113, -113, -113, -113, -113, -113, -112, -112, -112, -112, -112, -112, -112, -112,
+	-111, -111, -111, -111, -111, -111, -111, -110, -110, -110, -110, -110, -110, -110, -109, -109, -109, -109, -109, -108,
+	-108, -108, -108, -108, -108, -107, -107, -107, -107, -106, -106, -106, -106, -105, -105, -105, -105, -104, -104, -104,
+	-104, -103, -103, -103, -102, -102, -102, -101, -101, -101, -100, -100, -100, -99, -99, -98, -98, -97, -97, -96,
+	-96, -95, -95, -94, -94, -93, -93, -92, -91, -91, -90, -89, -89, -88, -87, -86, -85, -84, -83, -82,
+	-81, -80, -79, -78, -77, -75, -74, -73, -71, -69, -68, -66, -64, -62, -60, -57, -55, -52, -49, -46,
+	-43, -39, -35, -30, -26, -20, -14, -8, 0, 8, 14, 20, 26, 30, 35, 39, 43, 46, 49, 52,
+	55, 57, 60, 62, 64, 66, 68, 69, 71, 73, 74, 75, 77, 78, 79, 80, 81, 82, 83, 84,
+	85, 86, 87, 88, 89, 89, 90, 91, 91, 92, 93, 93, 94, 94, 95, 95, 96, 96, 97, 97,
+	98, 98, 99, 99, 100, 100, 100, 101, 101, 101, 102, 102, 102, 103, 103, 103, 104, 104, 104, 104,
+	105, 105, 105, 105, 106, 106, 106, 106, 107, 107, 107, 107, 108, 108, 108, 108, 108, 108, 109, 109,
+	109, 109, 109, 110, 110, 110, 110, 110, 110, 110, 111, 111, 111, 111, 111, 111, 111, 112, 112, 112,
+	112, 112, 112, 112, 112, 113, 113, 113, 113, 113, 113, 113, 113, 113, 114, 114
+};
+
+static const uint8_t SOFTSIGN_UNSIGNED[256] = {
+	0, 8, 15, 22, 28, 35, 40, 46, 51, 56, 61, 65, 70, 74, 78, 82, 85, 89, 92, 95,
+	98, 101, 104, 107, 110, 112, 115, 117, 119, 122, 124, 126, 128, 130, 132, 134, 136, 137, 139, 141,
+	142, 144, 145, 147, 148, 150, 151, 152, 154, 155, 156, 157, 158, 160, 161, 162, 163, 164, 165, 166,
+	167, 168, 169, 170, 171, 172, 172, 173, 174, 175, 176, 176, 177, 178, 179, 179, 180, 181, 182, 182,
+	183, 184, 184, 185, 185, 186, 187, 187, 188, 188, 189, 189, 190, 190, 191, 191, 192, 192, 193, 193,
+	194, 194, 195, 195, 196, 196, 197, 197, 197, 198, 198, 199, 199, 200, 200, 200, 201, 201, 201, 202,
+	202, 202, 203, 203, 203, 204, 204, 204, 205, 205, 205, 206, 206, 206, 207, 207, 207, 208, 208, 208,
+	208, 209, 209, 209, 209, 210, 210, 210, 210, 211, 211, 211, 211, 212, 212, 212, 212, 213, 213, 213,
+	213, 214, 214, 214, 214, 214, 215, 215, 215, 215, 215, 216, 216, 216, 216, 216, 217, 217, 217, 217,
+	217, 218, 218, 218, 218, 218, 218, 219, 219, 219, 219, 219, 219, 220, 220, 220, 220, 220, 220, 221,
+	221, 221, 221, 221, 221, 221, 222, 222, 222, 222, 222, 222, 222, 223, 223, 223, 223, 223, 223, 223,
+	223, 224, 224, 224, 224, 224, 224, 224, 224, 225, 225, 225, 225, 225, 225, 225, 225, 226, 226, 226,
+	226, 226, 226, 226, 226, 226, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227
+};
+
+// Indexed from 8 to 255
+static const int8_t SOFTSIGN_SIGNED_COARSE[248] = {
+	114, 115, 116, 117, 118, 119, 119, 120, 120, 121, 121, 122, 122, 122, 122, 123, 123, 123, 123, 123,
+	124, 124, 124, 124, 124, 124, 124, 124, 125, 125, 125, 125, 125, 125, 125, 125, 125, 125, 125, 125,
+	125, 125, 125, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126,
+	126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127
+};
+
+// Indexed from 8 to 255
+static const uint8_t SOFTSIGN_UNSIGNED_COARSE[248] = {
+	228, 230, 233, 235, 236, 238, 239, 240, 241, 242, 243, 243, 244, 244, 245, 245, 246, 246, 247, 247,
+	247, 247, 248, 248, 248, 248, 249, 249, 249, 249, 249, 250, 250, 250, 250, 250, 250, 250, 251, 251,
+	251, 251, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252,
+	252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+	253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254,
+	254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+	254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+	254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+	254, 254, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255
+};
+
+// Indexed from -128 to 127
+static const int8_t TANH_SIGNED[256] = {
+	-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+	-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+	-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+	-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -127,
+	-127, -127, -127, -127, -127, -127, -127, -126, -126, -126, -126, -126, -125, -125, -124, -124, -123, -123, -122, -121,
+	-120, -120, -118, -117, -116, -114, -113, -111, -109, -106, -104, -101, -97, -94, -90, -86, -81, -76, -71, -65,
+	-59, -53, -46, -39, -31, -24, -16, -8, 0, 8, 16, 24, 31, 39, 46, 53, 59, 65, 71, 76,
+	81, 86, 90, 94, 97, 101, 104, 106, 109, 111, 113, 114, 116, 117, 118, 120, 120, 121, 122, 123,
+	123, 124, 124, 125, 125, 126, 126, 126, 126, 126, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127
+};
+
+static const uint8_t TANH_UNSIGNED[256] = {
+	0, 8, 16, 24, 32, 40, 47, 55, 63, 70, 77, 85, 92, 99, 105, 112, 118, 125, 131, 136,
+	142, 147, 153, 158, 163, 167, 172, 176, 180, 184, 188, 192, 195, 198, 201, 204, 207, 210, 212, 215,
+	217, 219, 221, 223, 225, 227, 229, 230, 232, 233, 234, 236, 237, 238, 239, 240, 241, 242, 243, 243,
+	244, 245, 246, 246, 247, 247, 248, 248, 249, 249, 250, 250, 250, 251, 251, 251, 252, 252, 252, 252,
+	253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255
+};
+
+static inline int16_t extend_byte(uint8_t value, uint8_t is_signed) {
+	return is_signed ? (int16_t)(int8_t)value : (int16_t)value;
+}
+
+void tpu_model_init(tpu_model_t *model) {
+	memset(model, 0, sizeof(tpu_model_t));
+}
+
+int32_t tpu_model_write_weight_vector(tpu_model_t *model, tpu_vector_t *weight_vector, uint32_t weight_address) {
+	if(weight_address >= WEIGHT_BUFFER_SIZE) return EFAULT;
+
+	model->weight_buffer[weight_address] = *weight_vector;
+
+	return 0;
+}
+
+int32_t tpu_model_write_input_vector(tpu_model_t *model, tpu_vector_t *input_vector, uint32_t buffer_address) {
+	if(buffer_address >= UNIFIED_BUFFER_SIZE) return EFAULT;
+
+	model->unified_buffer[buffer_address] = *input_vector;
+
+	return 0;
+}
+
+int32_t tpu_model_read_output_vector(tpu_model_t *model, tpu_vector_t *output_vector, uint32_t buffer_address) {
+	if(buffer_address >= UNIFIED_BUFFER_SIZE) return EFAULT;
+
+	*output_vector = model->unified_buffer[buffer_address];
+
+	return 0;
+}
+
+int32_t tpu_model_write_bias(tpu_model_t *model, int32_t *bias_vector, uint32_t bias_address) {
+	if(bias_address >= BIAS_BUFFER_SIZE) return EFAULT;
+
+	memcpy(model->bias_buffer[bias_address], bias_vector, sizeof(model->bias_buffer[bias_address]));
+
+	return 0;
+}
+
+int32_t tpu_model_read_bias(tpu_model_t *model, int32_t *bias_vector, uint32_t bias_address) {
+	if(bias_address >= BIAS_BUFFER_SIZE) return EFAULT;
+
+	memcpy(bias_vector, model->bias_buffer[bias_address], sizeof(model->bias_buffer[bias_address]));
+
+	return 0;
+}
+
+/**
+ * Looks up a signed table of the Q4.4 table range, indices outside of the table saturate.
+ */
+static inline uint8_t lookup_signed(const int8_t *table, int32_t value) {
+	if(value < -128) value = -128;
+	if(value > 127) value = 127;
+	return (uint8_t)table[value+128];
+}
+
+/**
+ * Looks up an unsigned table of the Qu3.5 table range, indices outside of the table saturate.
+ */
+static inline uint8_t lookup_unsigned(const uint8_t *table, uint32_t round) {
+	if(round > 255) round = 255;
+	return table[round];
+}
+
+static uint8_t softsign_signed(int32_t value) {
+	if(value >= -128 && value <= 127) return (uint8_t)SOFTSIGN_SIGNED[value+128];
+	// Integer part of the magnitude, softsign is odd
+	uint32_t coarse = (uint32_t)(value < 0 ? -value : value) / 16;
+	if(coarse > 255) coarse = 255;
+	int8_t result = SOFTSIGN_SIGNED_COARSE[coarse-8];
+	return (uint8_t)(value < 0 ? -result : result);
+}
+
+static uint8_t softsign_unsigned(uint32_t round) {
+	if(round <= 255) return SOFTSIGN_UNSIGNED[round];
+	uint32_t coarse = round / 32;
+	if(coarse > 255) coarse = 255;
+	return SOFTSIGN_UNSIGNED_COARSE[coarse-8];
+}
+
+uint8_t tpu_model_activate(uint32_t accumulator, uint8_t function, uint8_t is_signed) {
+	uint32_t round;
+	int32_t value;
+
+	switch(function) {
+		case TPU_RELU:
+		case TPU_CRELU:
+			// Round to bits [31:8], bounded to the output range
+			round = ((accumulator >> 8) + ((accumulator >> 7) & 1)) & 0xFFFFFF;
+			if(is_signed) {
+				value = (int32_t)(round << 8) >> 8;
+				// CReLU is the ReLU of the negated input
+				if(function == TPU_CRELU) value = -value;
+				if(value < 0) return 0;
+				if(value > 127) return 127;
+				return (uint8_t)value;
+			}
+			if(function == TPU_CRELU) return 0;
+			if(round > 255) return 255;
+			return (uint8_t)round;
+		case TPU_RELU6:
+		case TPU_ELU:
+		case TPU_SELU:
+		case TPU_SOFTPLUS:
+		case TPU_SOFTSIGN:
+		case TPU_SIGMOID:
+		case TPU_TANH:
+			if(is_signed) {
+				// Q4.4 table range
+				round = ((accumulator >> 12) + ((accumulator >> 11) & 1)) & 0xFFFFF;
+				value = (int32_t)(round << 12) >> 12;
+				switch(function) {
+					case TPU_RELU6:
+						if(value < 0) return 0;
+						if(value > 96) return 96;
+						return (uint8_t)value;
+					case TPU_ELU:
+						return lookup_signed(ELU_SIGNED, value);
+					case TPU_SELU:
+						return lookup_signed(SELU_SIGNED, value);
+					case TPU_SOFTPLUS:
+						return lookup_signed(SOFTPLUS_SIGNED, value);
+					case TPU_SOFTSIGN:
+						return softsign_signed(value);
+					case TPU_TANH:
+						return lookup_signed(TANH_SIGNED, value);
+					default:
+						if(value < -88) return 0;
+						if(value > 70) return 127;
+						return SIGMOID_SIGNED[value+88];
+				}
+			}
+			// Qu3.5 table range
+			round = ((accumulator >> 11) + ((accumulator >> 10) & 1)) & 0x1FFFFF;
+			switch(function) {
+				case TPU_RELU6:
+					if(round > 192) return 192;
+					return (uint8_t)round;
+				case TPU_ELU:
+					return lookup_unsigned(ELU_UNSIGNED, round);
+				case TPU_SELU:
+					return lookup_unsigned(SELU_UNSIGNED, round);
+				case TPU_SOFTPLUS:
+					return lookup_unsigned(SOFTPLUS_UNSIGNED, round);
+				case TPU_SOFTSIGN:
+					return softsign_unsigned(round);
+				case TPU_TANH:
+					return lookup_unsigned(TANH_UNSIGNED, round);
+				default:
+					if(round > 164) return 255;
+					return SIGMOID_UNSIGNED[round];
+			}
+		default:
+			// No activation and dropout (identity at inference) - unknown functions are passed through by the hardware as well
+			return (uint8_t)(accumulator >> 24);
+	}
+}
+
+/**
+ * Moves the next row of a pending weight load into the preweights.
+ * The row index restarts at 0 for every read_weights instruction, like in WEIGHT_CONTROL.vhdl.
+ */
+static void preload_weight_row(tpu_model_t *model, tpu_weight_load_t *load) {
+	uint32_t row = load->position % TPU_VECTOR_SIZE;
+	tpu_vector_t *vector = &model->weight_buffer[(load->address + load->position) % WEIGHT_BUFFER_SIZE];
+
+	for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+		model->preweights[row][j] = extend_byte(vector->byte_vector[j], load->is_signed);
+	}
+
+	load->position++;
+}
+
+static void pop_weight_load(tpu_model_t *model) {
+	model->weight_queue_head = (model->weight_queue_head + 1) % TPU_MODEL_WEIGHT_QUEUE;
+	model->weight_queue_count--;
+}
+
+static void push_weight_load(tpu_model_t *model, uint64_t address, uint32_t length, uint8_t is_signed) {
+	if(length == 0) return;
+
+	if(model->weight_queue_count == TPU_MODEL_WEIGHT_QUEUE) {
+		// The oldest load would have been overwritten in the preweights by now
+		tpu_weight_load_t *load = &model->weight_queue[model->weight_queue_head];
+		while(load->position < load->length) {
+			preload_weight_row(model, load);
+		}
+		pop_weight_load(model);
+	}
+
+	tpu_weight_load_t *load = &model->weight_queue[(model->weight_queue_head + model->weight_queue_count) % TPU_MODEL_WEIGHT_QUEUE];
+	load->address = (uint32_t)(address % WEIGHT_BUFFER_SIZE);
+	load->length = length;
+	load->position = 0;
+	load->is_signed = is_signed;
+	model->weight_queue_count++;
+}
+
+/**
+ * Activates the next weight tile. Rows, which weren't loaded since the last activation, keep their preweights.
+ */
+static void activate_weights(tpu_model_t *model) {
+	for(uint32_t rows = 0; rows < TPU_VECTOR_SIZE && model->weight_queue_count; ++rows) {
+		tpu_weight_load_t *load = &model->weight_queue[model->weight_queue_head];
+		preload_weight_row(model, load);
+		if(load->position == load->length) {
+			pop_weight_load(model);
+		}
+	}
+
+	memcpy(model->weights, model->preweights, sizeof(model->weights));
+
+	for(uint32_t p = 0; p < TPU_MODEL_ROWS/2; ++p) {
+		for(uint32_t j = 0; j < TPU_MODEL_LANES; ++j) {
+			model->packed_weights[p][2*j]   = model->weights[2*p][j];
+			model->packed_weights[p][2*j+1] = model->weights[2*p+1][j];
+		}
+	}
+}
+
+/**
+ * Multiplies count extended input vectors with the active weight tile.
+ */
+static void multiply_tile(tpu_model_t *model, int16_t input[][TPU_MODEL_ROWS], int32_t result[][TPU_MODEL_LANES], uint32_t count) {
+#if defined(__AVX2__)
+	for(uint32_t k = 0; k < count; ++k) {
+		for(uint32_t g = 0; g < TPU_MODEL_LANES/8; ++g) {
+			__m256i sum = _mm256_setzero_si256();
+			for(uint32_t p = 0; p < TPU_MODEL_ROWS/2; ++p) {
+				int32_t pair;
+				memcpy(&pair, &input[k][2*p], sizeof(pair));
+				__m256i weights = _mm256_loadu_si256((__m256i *) &model->packed_weights[p][16*g]);
+				sum = _mm256_add_epi32(sum, _mm256_madd_epi16(weights, _mm256_set1_epi32(pair)));
+			}
+			_mm256_storeu_si256((__m256i *) &result[k][8*g], sum);
+		}
+	}
+#elif defined(__ARM_NEON)
+	for(uint32_t k = 0; k < count; ++k) {
+		for(uint32_t g = 0; g < TPU_MODEL_LANES/4; ++g) {
+			int32x4_t sum = vdupq_n_s32(0);
+			for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+				sum = vmlal_n_s16(sum, vld1_s16(&model->weights[i][4*g]), input[k][i]);
+			}
+			vst1q_s32(&result[k][4*g], sum);
+		}
+	}
+#else
+	for(uint32_t k = 0; k < count; ++k) {
+		for(uint32_t j = 0; j < TPU_MODEL_LANES; ++j) {
+			result[k][j] = 0;
+		}
+		for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+			int32_t x = input[k][i];
+			for(uint32_t j = 0; j < TPU_MODEL_LANES; ++j) {
+				result[k][j] += x * model->weights[i][j];
+			}
+		}
+	}
+#endif
+}
+
+static void matrix_multiply(tpu_model_t *model, instruction_t *instruction) {
+	int16_t input[TPU_VECTOR_SIZE][TPU_MODEL_ROWS];
+	int32_t result[TPU_VECTOR_SIZE][TPU_MODEL_LANES];
+
+	uint8_t is_signed = instruction->op_code & TPU_MULTIPLY_SIGNED;
+	uint8_t accumulate = instruction->op_code & TPU_MULTIPLY_ACCUMULATE;
+	uint32_t length = get_calc_length(instruction);
+	uint32_t acc_address = get_acc_address(instruction);
+	uint32_t buf_address = get_buf_address(instruction);
+
+	memset(input, 0, sizeof(input));
+
+	for(uint32_t tile = 0; tile < length; tile += TPU_VECTOR_SIZE) {
+		uint32_t count = length - tile < TPU_VECTOR_SIZE ? length - tile : TPU_VECTOR_SIZE;
+
+		// The matrix multiply unit activates the next weights every TPU_VECTOR_SIZE vectors
+		activate_weights(model);
+
+		for(uint32_t k = 0; k < count; ++k) {
+			tpu_vector_t *vector = &model->unified_buffer[(buf_address + tile + k) % UNIFIED_BUFFER_SIZE];
+			for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+				input[k][i] = extend_byte(vector->byte_vector[i], is_signed);
+			}
+		}
+
+		multiply_tile(model, input, result, count);
+
+		// The accumulator address wraps after TPU_VECTOR_SIZE vectors (ACC_LOAD_COUNTER.vhdl)
+		for(uint32_t k = 0; k < count; ++k) {
+			uint32_t *accumulator = model->accumulators[(acc_address + k) % TPU_REGISTER_DEPTH];
+			for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+				// Unsigned results are zero extended, even if the weights were signed
+				uint32_t value = is_signed ? (uint32_t)result[k][j] : (uint32_t)result[k][j] & RESULT_MASK;
+				accumulator[j] = accumulate ? accumulator[j] + value : value;
+			}
+		}
+	}
+}
+
+static void activate(tpu_model_t *model, instruction_t *instruction) {
+	uint8_t function = instruction->op_code & TPU_ACTIVATION_MASK;
+	uint8_t is_signed = (instruction->op_code & TPU_ACTIVATION_SIGNED) != 0;
+	uint32_t length = get_calc_length(instruction);
+	uint32_t acc_address = get_acc_address(instruction);
+	uint32_t buf_address = get_buf_address(instruction);
+	uint8_t is_biased = (instruction->op_code & TPU_ACTIVATION_BIAS) != 0;
+	// One bias vector for the whole instruction - the bias of every column is added to all of its accumulators
+	int32_t *biases = model->bias_buffer[get_bias_address(instruction) % BIAS_BUFFER_SIZE];
+
+	for(uint32_t k = 0; k < length; ++k) {
+		uint32_t *accumulator = model->accumulators[(acc_address + k) % TPU_REGISTER_DEPTH];
+		tpu_vector_t *vector = &model->unified_buffer[(buf_address + k) % UNIFIED_BUFFER_SIZE];
+
+		memset(vector, 0, sizeof(tpu_vector_t));
+		for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+			// Wrapping like the adder in ACTIVATION.vhdl
+			uint32_t bias = is_biased ? (uint32_t)biases[j] : 0;
+			vector->byte_vector[j] = tpu_model_activate(accumulator[j] + bias, function, is_signed);
+		}
+	}
+}
+
+int32_t tpu_model_execute(tpu_model_t *model, instruction_t *instruction) {
+	uint8_t op_code = instruction->op_code;
+
+	// Same priorities as the decoder in CONTROL_COORDINATOR.vhdl
+	if(op_code == TPU_OP_SYNCHRONIZE) {
+		model->synchronize_count++;
+	} else if(op_code & TPU_OP_ACTIVATE) {
+		activate(model, instruction);
+	} else if(op_code & TPU_OP_MATRIX_MULTIPLY) {
+		matrix_multiply(model, instruction);
+	} else if(op_code & TPU_OP_READ_WEIGHTS) {
+		push_weight_load(model, get_weight_address(instruction), get_calc_length(instruction), op_code & TPU_WEIGHTS_SIGNED);
+	}
+	// nop and halt do nothing
+
+	model->instruction_count++;
+
+	return 0;
+}
+
+int32_t tpu_model_execute_program(tpu_model_t *model, instruction_t *instructions, uint32_t count) {
+	for(uint32_t i = 0; i < count; ++i) {
+		int32_t result = tpu_model_execute(model, &instructions[i]);
+		if(result) return result;
+	}
+
+	return 0;
+}
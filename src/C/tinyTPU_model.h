@@ -0,0 +1,97 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_model.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_MODEL_H_
+#define SRC_TINYTPU_MODEL_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+
+// Depth of the accumulator register file (REGISTER_DEPTH in TPU_CORE.vhdl)
+#define TPU_REGISTER_DEPTH 512
+
+// Lanes and rows padded for the vectorized multiply core
+#define TPU_MODEL_LANES ((TPU_VECTOR_SIZE+7) & ~7)
+#define TPU_MODEL_ROWS  ((TPU_VECTOR_SIZE+1) & ~1)
+
+// Maximum number of read_weights instructions waiting for a matrix multiply
+#define TPU_MODEL_WEIGHT_QUEUE 64
+
+/**
+ * Pending weight load, which will be moved into the preweights when the next tile gets activated.
+ */
+typedef struct tpu_weight_load {
+	uint32_t address;
+	uint32_t length;
+	uint32_t position;
+	uint8_t is_signed;
+} tpu_weight_load_t;
+
+/**
+ * Functional model of TPU_CORE.
+ * Executes the same instruction stream as the hardware and produces bit exact buffer contents.
+ */
+typedef struct tpu_model {
+	tpu_vector_t weight_buffer[WEIGHT_BUFFER_SIZE];
+	tpu_vector_t unified_buffer[UNIFIED_BUFFER_SIZE];
+	int32_t bias_buffer[BIAS_BUFFER_SIZE][TPU_VECTOR_SIZE];
+	uint32_t accumulators[TPU_REGISTER_DEPTH][TPU_MODEL_LANES];
+
+	// Matrix multiply unit state (9 bit extended values)
+	int16_t preweights[TPU_MODEL_ROWS][TPU_MODEL_LANES];
+	int16_t weights[TPU_MODEL_ROWS][TPU_MODEL_LANES];
+	// Row pairs interleaved per lane for 16 bit multiply-add instructions
+	int16_t packed_weights[TPU_MODEL_ROWS/2][2*TPU_MODEL_LANES];
+
+	tpu_weight_load_t weight_queue[TPU_MODEL_WEIGHT_QUEUE];
+	uint32_t weight_queue_head;
+	uint32_t weight_queue_count;
+
+	uint32_t synchronize_count;
+	uint64_t instruction_count;
+} tpu_model_t;
+
+void tpu_model_init(tpu_model_t *model);
+
+int32_t tpu_model_write_weight_vector(tpu_model_t *model, tpu_vector_t *weight_vector, uint32_t weight_address);
+
+int32_t tpu_model_write_input_vector(tpu_model_t *model, tpu_vector_t *input_vector, uint32_t buffer_address);
+
+int32_t tpu_model_read_output_vector(tpu_model_t *model, tpu_vector_t *output_vector, uint32_t buffer_address);
+
+int32_t tpu_model_write_bias(tpu_model_t *model, int32_t *bias_vector, uint32_t bias_address);
+
+int32_t tpu_model_read_bias(tpu_model_t *model, int32_t *bias_vector, uint32_t bias_address);
+
+int32_t tpu_model_execute(tpu_model_t *model, instruction_t *instruction);
+
+int32_t tpu_model_execute_program(tpu_model_t *model, instruction_t *instructions, uint32_t count);
+
+uint8_t tpu_model_activate(uint32_t accumulator, uint8_t function, uint8_t is_signed);
+
+#endif /* SRC_TINYTPU_MODEL_H_ */
@@ -0,0 +1,319 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_optimizer.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_optimizer.h"
+#include "tinyTPU_compiler.h"
+#include "tinyTPU_sim.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum unit {
+	UNIT_WEIGHT = 0,
+	UNIT_MATRIX,
+	UNIT_ACTIVATION,
+	// Synchronize, halt and unknown instructions
+	UNIT_BARRIER
+} unit_t;
+
+typedef struct schedule {
+	tpu_compiler_config_t config;
+	tpu_sim_config_t sim;
+	instruction_t *candidate;
+	uint64_t *issue_cycles;
+} schedule_t;
+
+/**
+ * Decodes the instruction like CONTROL_COORDINATOR.vhdl.
+ */
+static unit_t decode(instruction_t *instruction) {
+	uint8_t op_code = instruction->op_code;
+
+	if(op_code == TPU_OP_SYNCHRONIZE)		return UNIT_BARRIER;
+	if(op_code & TPU_OP_ACTIVATE)			return UNIT_ACTIVATION;
+	if(op_code & TPU_OP_MATRIX_MULTIPLY)	return UNIT_MATRIX;
+	if(op_code & TPU_OP_READ_WEIGHTS)		return UNIT_WEIGHT;
+	return UNIT_BARRIER;
+}
+
+static uint32_t tile_count(uint32_t length) {
+	return (length + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE;
+}
+
+/**
+ * Checks two ranges of a buffer, which wraps after depth entries.
+ */
+static int overlaps(uint32_t a, uint32_t a_length, uint32_t b, uint32_t b_length, uint32_t depth) {
+	a %= depth;
+	b %= depth;
+	return (a < b + b_length && b < a + a_length) || (a + depth < b + b_length && b < a + depth + a_length) || (b + depth < a + a_length && a < b + depth + b_length);
+}
+
+static int is_same_load(instruction_t *a, instruction_t *b) {
+	return a->op_code == b->op_code && get_calc_length(a) == get_calc_length(b) && get_weight_address(a) == get_weight_address(b);
+}
+
+/**
+ * Appends an instruction to the optimized stream or merges it into the instruction before.
+ */
+static int merge(instruction_t *last, instruction_t *instruction) {
+	uint8_t op_code = instruction->op_code;
+	unit_t unit = decode(instruction);
+	if(last->op_code != op_code || unit == UNIT_BARRIER) return 0;
+
+	uint32_t last_length = get_calc_length(last);
+	uint32_t length = get_calc_length(instruction);
+	if(last_length + length < length) return 0;
+
+	switch(unit) {
+		case UNIT_WEIGHT:
+			// The row index restarts for every read_weights
+			if(last_length % TPU_VECTOR_SIZE || get_weight_address(last) + last_length != get_weight_address(instruction)) return 0;
+			set_weight_instruction(last, op_code, last_length + length, get_weight_address(last));
+			return 1;
+		case UNIT_MATRIX:
+			// The accumulator address wraps after every tile
+			if(last_length % TPU_VECTOR_SIZE || get_acc_address(last) != get_acc_address(instruction) || get_buf_address(last) + last_length != get_buf_address(instruction)) return 0;
+			break;
+		default:
+			if(get_acc_address(last) + last_length != get_acc_address(instruction) || get_buf_address(last) + last_length != get_buf_address(instruction)) return 0;
+			// Biased activations keep the bias vector address in the upper half of the length and use it for all accumulators
+			if(op_code & TPU_ACTIVATION_BIAS && (last_length + length > TPU_BIAS_LENGTH_MASK || get_bias_address(last) != get_bias_address(instruction))) return 0;
+			break;
+	}
+
+	set_bias_instruction(last, op_code, last_length + length, get_acc_address(last), get_buf_address(last), get_bias_address(last));
+	return 1;
+}
+
+/**
+ * Drops nops, empty instructions and weight loads, which don't change the weights, and merges adjacent instructions.
+ */
+int32_t tpu_optimizer_peephole(instruction_t *instructions, uint32_t *count, tpu_optimizer_stats_t *stats) {
+	// Rows of the weight loads, which weren't activated by a multiply yet
+	uint64_t queued = 0;
+	instruction_t *last_load = NULL;
+	uint32_t length = 0;
+
+	for(uint32_t i = 0; i < *count; ++i) {
+		instruction_t instruction = instructions[i];
+		unit_t unit = decode(&instruction);
+		uint32_t calc_length = get_calc_length(&instruction);
+
+		if(instruction.op_code == TPU_OP_NOP || (unit != UNIT_BARRIER && calc_length == 0)) {
+			stats->dropped++;
+			continue;
+		}
+
+		if(unit == UNIT_WEIGHT) {
+			// All rows of the last load are in the preweights, loading them again changes nothing
+			if(queued == 0 && last_load != NULL && calc_length <= TPU_VECTOR_SIZE && is_same_load(last_load, &instruction)) {
+				stats->dropped++;
+				continue;
+			}
+			queued += calc_length;
+		} else if(unit == UNIT_MATRIX) {
+			// Every tile activates the next rows
+			uint64_t rows = (uint64_t)tile_count(calc_length)*TPU_VECTOR_SIZE;
+			queued = queued > rows ? queued - rows : 0;
+		}
+
+		if(length && merge(&instructions[length-1], &instruction)) {
+			stats->merged++;
+		} else {
+			instructions[length++] = instruction;
+		}
+
+		if(unit == UNIT_WEIGHT) last_load = &instructions[length-1];
+	}
+
+	*count = length;
+	return 0;
+}
+
+/**
+ * Checks, if an activation can be moved past the instructions. Multiplies must neither write the accumulators
+ * nor read the unified buffer of the activation.
+ */
+static int is_independent(tpu_compiler_config_t *config, instruction_t *activation, instruction_t *instructions, uint32_t count) {
+	uint32_t length = get_calc_length(activation);
+
+	for(uint32_t i = 0; i < count; ++i) {
+		unit_t unit = decode(&instructions[i]);
+		if(unit == UNIT_ACTIVATION || unit == UNIT_BARRIER) return 0;
+		if(unit != UNIT_MATRIX) continue;
+
+		uint32_t calc_length = get_calc_length(&instructions[i]);
+		uint32_t acc_length = calc_length < TPU_VECTOR_SIZE ? calc_length : TPU_VECTOR_SIZE;
+		if(overlaps(get_acc_address(&instructions[i]), acc_length, get_acc_address(activation), length, config->accumulator_depth)) return 0;
+		if(overlaps(get_buf_address(&instructions[i]), calc_length, get_buf_address(activation), length, config->unified_buffer_depth)) return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * End of the multiply, which starts at index with its weight loads.
+ */
+static uint32_t block_end(instruction_t *instructions, uint32_t count, uint32_t index) {
+	while(index < count && decode(&instructions[index]) == UNIT_WEIGHT) index++;
+	if(index < count && decode(&instructions[index]) == UNIT_MATRIX) index++;
+	return index;
+}
+
+/**
+ * Start of the multiply with its weight loads, which ends at index.
+ */
+static uint32_t block_start(instruction_t *instructions, uint32_t index) {
+	if(index && decode(&instructions[index-1]) == UNIT_MATRIX) index--;
+	while(index && decode(&instructions[index-1]) == UNIT_WEIGHT) index--;
+	return index;
+}
+
+/**
+ * Builds the program with the activation at index moved to target and simulates it.
+ */
+static int32_t try_move(schedule_t *schedule, instruction_t *instructions, uint32_t count, uint32_t index, uint32_t target, tpu_optimizer_stats_t *stats, uint32_t *candidate_count, uint64_t *cycles, uint32_t *hazards) {
+	instruction_t *candidate = schedule->candidate;
+
+	memcpy(candidate, instructions, count*sizeof(instruction_t));
+	if(target > index) {
+		memmove(&candidate[index], &instructions[index+1], (target - index - 1)*sizeof(instruction_t));
+		candidate[target-1] = instructions[index];
+	} else {
+		memmove(&candidate[target+1], &instructions[target], (index - target)*sizeof(instruction_t));
+		candidate[target] = instructions[index];
+	}
+
+	*candidate_count = count;
+	tpu_optimizer_peephole(candidate, candidate_count, stats);
+
+	tpu_sim_result_t result;
+	int32_t error = tpu_sim_run(&schedule->sim, candidate, *candidate_count, &result, schedule->issue_cycles);
+	*cycles = result.cycles;
+	*hazards = tpu_compiler_hazards(&schedule->config, candidate, *candidate_count, schedule->issue_cycles);
+
+	return error;
+}
+
+/**
+ * Moves the activation at index to the position with the fewest cycles within the window.
+ */
+static int32_t move_activation(schedule_t *schedule, instruction_t *instructions, uint32_t *count, uint32_t index, uint64_t *cycles, uint32_t *hazards, tpu_optimizer_stats_t *stats, uint8_t *moved) {
+	instruction_t *activation = &instructions[index];
+	uint32_t best_target = index;
+	uint64_t best_cycles = *cycles;
+
+	for(int32_t direction = -1; direction <= 1; direction += 2) {
+		uint32_t target = direction > 0 ? index + 1 : index;
+
+		for(uint32_t step = 0; step < TPU_OPTIMIZER_WINDOW; ++step) {
+			uint32_t next = direction > 0 ? block_end(instructions, *count, target) : block_start(instructions, target);
+			if(next == target) break;
+
+			uint32_t first = direction > 0 ? target : next;
+			uint32_t last = direction > 0 ? next : target;
+			if(!is_independent(&schedule->config, activation, &instructions[first], last - first)) break;
+			target = next;
+
+			tpu_optimizer_stats_t candidate_stats = {0};
+			uint32_t candidate_count;
+			uint64_t candidate_cycles;
+			uint32_t candidate_hazards;
+			int32_t error = try_move(schedule, instructions, *count, index, target, &candidate_stats, &candidate_count, &candidate_cycles, &candidate_hazards);
+			if(error) return error;
+
+			if(candidate_cycles < best_cycles && candidate_hazards <= *hazards) {
+				best_target = target;
+				best_cycles = candidate_cycles;
+			}
+		}
+	}
+
+	*moved = best_target != index;
+	if(!*moved) return 0;
+
+	int32_t error = try_move(schedule, instructions, *count, index, best_target, stats, count, cycles, hazards);
+	if(error) return error;
+
+	memcpy(instructions, schedule->candidate, *count*sizeof(instruction_t));
+	stats->moved++;
+	return 0;
+}
+
+static int32_t simulate(schedule_t *schedule, instruction_t *instructions, uint32_t count, uint64_t *cycles, uint32_t *hazards) {
+	tpu_sim_result_t result;
+	int32_t error = tpu_sim_run(&schedule->sim, instructions, count, &result, schedule->issue_cycles);
+	*cycles = result.cycles;
+	if(hazards != NULL) *hazards = tpu_compiler_hazards(&schedule->config, instructions, count, schedule->issue_cycles);
+	return error;
+}
+
+/**
+ * Runs the peephole and the reorder pass. The count is updated to the optimized instructions.
+ */
+int32_t tpu_optimizer_run(instruction_t *instructions, uint32_t *count, tpu_optimizer_stats_t *stats) {
+	schedule_t schedule;
+
+	memset(stats, 0, sizeof(tpu_optimizer_stats_t));
+	stats->count_before = *count;
+
+	tpu_compiler_default_config(&schedule.config);
+	tpu_sim_default_config(&schedule.sim);
+	schedule.candidate = malloc(*count*sizeof(instruction_t));
+	schedule.issue_cycles = malloc(*count*sizeof(uint64_t));
+	if(schedule.candidate == NULL || schedule.issue_cycles == NULL) {
+		free(schedule.candidate);
+		free(schedule.issue_cycles);
+		return ENOMEM;
+	}
+
+	uint64_t cycles = 0;
+	uint32_t hazards = 0;
+	int32_t error = simulate(&schedule, instructions, *count, &stats->cycles_before, NULL);
+	if(!error) error = tpu_optimizer_peephole(instructions, count, stats);
+	if(!error) error = simulate(&schedule, instructions, *count, &cycles, &hazards);
+
+	uint32_t i = 0;
+	while(i < *count && !error) {
+		uint8_t moved = 0;
+		if(decode(&instructions[i]) == UNIT_ACTIVATION) {
+			error = move_activation(&schedule, instructions, count, i, &cycles, &hazards, stats, &moved);
+		}
+		// The instructions, which took the place of the activation, are visited next
+		if(!moved) i++;
+	}
+
+	stats->count_after = *count;
+	stats->cycles_after = cycles;
+
+	free(schedule.candidate);
+	free(schedule.issue_cycles);
+	return error;
+}
@@ -0,0 +1,66 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_optimizer.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_OPTIMIZER_H_
+#define SRC_TINYTPU_OPTIMIZER_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+
+/*
+ * Optimizer for instruction streams.
+ *
+ * The peephole pass drops nops and weight loads, which don't change the weights, and merges adjacent instructions:
+ * - read_weights, which continue the weight address of the one before at a tile boundary
+ * - matrix multiplies, which continue the unified buffer address of the one before at a tile boundary with the same accumulators
+ * - activations, which continue the accumulator and unified buffer addresses of the one before
+ *
+ * The reorder pass moves activations past independent multiplies, which keeps MATRIX_MULTIPLY_CONTROL busy and lets
+ * activations meet, so they can be merged. Weight loads always stay in front of their multiply, because WEIGHT_CONTROL
+ * streams into the preweights without a handshake. A move is kept, if tinyTPU_sim predicts fewer cycles and the move
+ * adds no hazards between multiplies and running activations. Synchronize and halt aren't passed.
+ */
+// Multiplies an activation is moved past at most
+#define TPU_OPTIMIZER_WINDOW 16
+
+typedef struct tpu_optimizer_stats {
+	uint32_t count_before;
+	uint32_t count_after;
+	uint32_t dropped;
+	uint32_t merged;
+	uint32_t moved;
+	// Simulated cycles
+	uint64_t cycles_before;
+	uint64_t cycles_after;
+} tpu_optimizer_stats_t;
+
+int32_t tpu_optimizer_peephole(instruction_t *instructions, uint32_t *count, tpu_optimizer_stats_t *stats);
+
+int32_t tpu_optimizer_run(instruction_t *instructions, uint32_t *count, tpu_optimizer_stats_t *stats);
+
+#endif /* SRC_TINYTPU_OPTIMIZER_H_ */
@@ -0,0 +1,316 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_parser.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_parser.h"
+#include <errno.h>
+#include <string.h>
+
+typedef enum parser_state {
+	OUTSIDE = 0,
+	SECTION,
+	RECORD
+} parser_state_t;
+
+typedef struct keyword {
+	const char *name;
+	tpu_section_type_t section;
+} keyword_t;
+
+static const keyword_t KEYWORDS[] = {
+	{"weights:", TPU_SECTION_WEIGHTS},
+	{"inputs:", TPU_SECTION_INPUTS},
+	{"instructions:", TPU_SECTION_INSTRUCTIONS},
+	{"results:", TPU_SECTION_RESULTS}
+};
+
+static uint32_t batch_size(uint32_t section) {
+	switch(section) {
+		case TPU_SECTION_WEIGHTS:
+		case TPU_SECTION_INPUTS:
+			return TPU_PARSER_BATCH_VECTORS;
+		case TPU_SECTION_INSTRUCTIONS:
+			return TPU_PARSER_BATCH_INSTRUCTIONS;
+		default:
+			return TPU_PARSER_BATCH_RESULTS;
+	}
+}
+
+static int32_t flush(tpu_parser_t *parser) {
+	tpu_bundle_handler_t *handler = parser->handler;
+	uint32_t count = parser->batch_count;
+	int32_t error = 0;
+
+	if(count == 0) return 0;
+	parser->batch_count = 0;
+
+	switch(parser->section) {
+		case TPU_SECTION_WEIGHTS:
+			if(handler->weights != NULL) error = handler->weights(handler->context, parser->batch.vectors, parser->address, count);
+			parser->address += count;
+			break;
+		case TPU_SECTION_INPUTS:
+			if(handler->inputs != NULL) error = handler->inputs(handler->context, parser->batch.vectors, parser->address, count);
+			parser->address += count;
+			break;
+		case TPU_SECTION_INSTRUCTIONS:
+			if(handler->instructions != NULL) error = handler->instructions(handler->context, parser->batch.instructions, count);
+			break;
+		case TPU_SECTION_RESULTS:
+			if(handler->results != NULL) error = handler->results(handler->context, parser->batch.results, count);
+			break;
+	}
+
+	return error;
+}
+
+static int32_t begin_section(tpu_parser_t *parser) {
+	for(uint32_t i = 0; i < sizeof(KEYWORDS)/sizeof(keyword_t); ++i) {
+		if(parser->keyword_length == strlen(KEYWORDS[i].name) && strncmp(parser->keyword, KEYWORDS[i].name, parser->keyword_length) == 0) {
+			parser->section = KEYWORDS[i].section;
+			parser->address = 0;
+			parser->batch_count = 0;
+			parser->keyword_length = 0;
+			return 0;
+		}
+	}
+	return EINVAL;
+}
+
+static int32_t end_section(tpu_parser_t *parser) {
+	int32_t error = flush(parser);
+	if(error) return error;
+
+	tpu_bundle_handler_t *handler = parser->handler;
+	if(handler->section_end != NULL) return handler->section_end(handler->context, (tpu_section_type_t)parser->section);
+	return 0;
+}
+
+static int32_t end_field(tpu_parser_t *parser) {
+	if(!parser->in_number) return 0;
+	if(parser->field_count >= TPU_PARSER_MAX_FIELDS) return EINVAL;
+
+	uint64_t value = parser->fields[parser->field_count];
+	parser->fields[parser->field_count++] = parser->negative ? -value : value;
+	parser->in_number = 0;
+	parser->negative = 0;
+	return 0;
+}
+
+static int32_t end_record(tpu_parser_t *parser) {
+	uint64_t *fields = parser->fields;
+	uint32_t count = parser->field_count;
+	uint32_t index = parser->batch_count;
+
+	switch(parser->section) {
+		case TPU_SECTION_WEIGHTS:
+		case TPU_SECTION_INPUTS: {
+			if(count > TPU_VECTOR_SIZE) return EINVAL;
+			tpu_vector_t *vector = &parser->batch.vectors[index];
+			uint32_t i = 0;
+			for(; i < count; ++i) vector->byte_vector[i] = fields[i];
+			for(; i < TPU_VECTOR_SIZE; ++i) vector->byte_vector[i] = 0;
+			break;
+		}
+		case TPU_SECTION_INSTRUCTIONS:
+			if(count == 3) {
+				set_weight_instruction(&parser->batch.instructions[index], fields[0], fields[1], fields[2]);
+			} else if(count == 4) {
+				set_instruction(&parser->batch.instructions[index], fields[0], fields[1], fields[2], fields[3]);
+			} else {
+				return EINVAL;
+			}
+			break;
+		case TPU_SECTION_RESULTS:
+			if(count != 3) return EINVAL;
+			parser->batch.results[index].address = fields[0];
+			parser->batch.results[index].length = fields[1];
+			parser->batch.results[index].append = fields[2];
+			break;
+	}
+
+	if(++parser->batch_count == batch_size(parser->section)) return flush(parser);
+	return 0;
+}
+
+void tpu_parser_init(tpu_parser_t *parser, tpu_bundle_handler_t *handler) {
+	parser->handler = handler;
+	parser->state = OUTSIDE;
+	parser->in_number = 0;
+	parser->negative = 0;
+	parser->base = 10;
+	parser->section = 0;
+	parser->keyword_length = 0;
+	parser->field_count = 0;
+	parser->address = 0;
+	parser->batch_count = 0;
+	parser->line = 1;
+	parser->bytes = 0;
+}
+
+int32_t tpu_parser_feed(tpu_parser_t *parser, const char *data, uint32_t size) {
+	const char *end = data + size;
+	int32_t error = 0;
+
+	parser->bytes += size;
+
+	while(data < end) {
+		char c = *data++;
+
+		if(parser->state == RECORD) {
+			if(c >= '0' && c <= '9') {
+				if(!parser->in_number) {
+					if(parser->field_count >= TPU_PARSER_MAX_FIELDS) return EINVAL;
+					parser->fields[parser->field_count] = 0;
+					parser->in_number = 1;
+					// A leading zero starts an octal or hexadecimal number
+					if(c == '0') {
+						parser->base = 0;
+						continue;
+					}
+					parser->base = 10;
+				} else if(parser->base == 0) {
+					parser->base = 8;
+				}
+
+				if(parser->base == 10) {
+					// Most characters are decimal digits, so stay in this loop as long as possible
+					uint64_t value = parser->fields[parser->field_count]*10 + (c - '0');
+					while(data < end && *data >= '0' && *data <= '9') {
+						value = value*10 + (*data++ - '0');
+					}
+					parser->fields[parser->field_count] = value;
+				} else {
+					if(parser->base == 8 && c > '7') return EINVAL;
+					parser->fields[parser->field_count] = parser->fields[parser->field_count]*parser->base + (c - '0');
+				}
+				continue;
+			}
+
+			if(parser->in_number && parser->base == 16 && ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
+				parser->fields[parser->field_count] = parser->fields[parser->field_count]*16 + ((c | 0x20) - 'a' + 10);
+				continue;
+			}
+
+			switch(c) {
+				case 'x':
+				case 'X':
+					// Only directly after the leading zero
+					if(!parser->in_number || parser->base != 0) return EINVAL;
+					parser->base = 16;
+					break;
+				case ',':
+					if(!parser->in_number) return EINVAL;
+					error = end_field(parser);
+					break;
+				case ']':
+					error = end_field(parser);
+					if(!error) error = end_record(parser);
+					parser->field_count = 0;
+					parser->state = SECTION;
+					break;
+				case '-':
+					if(parser->in_number || parser->negative) return EINVAL;
+					parser->negative = 1;
+					break;
+				case '\n':
+					parser->line++;
+					break;
+				case ' ':
+				case '\t':
+				case '\r':
+					break;
+				default:
+					return EINVAL;
+			}
+		} else if(parser->state == SECTION) {
+			switch(c) {
+				case '[':
+					parser->field_count = 0;
+					parser->in_number = 0;
+					parser->negative = 0;
+					parser->state = RECORD;
+					break;
+				case ']':
+					error = end_section(parser);
+					parser->state = OUTSIDE;
+					break;
+				case '\n':
+					parser->line++;
+					break;
+				case ' ':
+				case '\t':
+				case '\r':
+					break;
+				default:
+					return EINVAL;
+			}
+		} else {
+			switch(c) {
+				case '[':
+					error = begin_section(parser);
+					parser->state = SECTION;
+					break;
+				case '\n':
+					parser->line++;
+					// fall through
+				case ' ':
+				case '\t':
+				case '\r':
+					if(parser->keyword_length) return EINVAL;
+					break;
+				default:
+					if(parser->keyword_length == TPU_PARSER_KEYWORD_SIZE) return EINVAL;
+					parser->keyword[parser->keyword_length++] = c;
+			}
+		}
+
+		if(error) return error;
+	}
+
+	return 0;
+}
+
+/**
+ * Checks, that the text didn't end within a section.
+ */
+int32_t tpu_parser_finish(tpu_parser_t *parser) {
+	if(parser->state != OUTSIDE || parser->keyword_length) return EINVAL;
+	return 0;
+}
+
+int32_t tpu_parser_stream(tpu_parser_t *parser, tpu_parser_read_t read, void *source) {
+	int32_t error;
+	uint32_t bytes_read;
+
+	do {
+		if(read(source, parser->buffer, sizeof(parser->buffer), &bytes_read)) return EIO;
+		if((error = tpu_parser_feed(parser, parser->buffer, bytes_read))) return error;
+	} while(bytes_read);
+
+	return tpu_parser_finish(parser);
+}
@@ -0,0 +1,97 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_parser.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_PARSER_H_
+#define SRC_TINYTPU_PARSER_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_bundle.h"
+#include <stdint.h>
+
+/*
+ * Single pass parser for the text programs of transfer_complete_model.py.
+ *
+ * The text is fed in blocks of any size. The parse state is kept between blocks, so numbers and
+ * records may be split at block boundaries. Records are collected in batches and passed to the
+ * same handler as the sections of a bundle.
+ * Numbers are read like strtoul with base 0: decimal, octal with a leading 0 or hexadecimal with 0x.
+ * Vector elements may be negative.
+ */
+#define TPU_PARSER_BUFFER_SIZE			4096
+#define TPU_PARSER_BATCH_VECTORS		256
+#define TPU_PARSER_BATCH_INSTRUCTIONS	512
+#define TPU_PARSER_BATCH_RESULTS		32
+#define TPU_PARSER_KEYWORD_SIZE			16
+
+#if TPU_VECTOR_SIZE > 4
+#define TPU_PARSER_MAX_FIELDS TPU_VECTOR_SIZE
+#else
+#define TPU_PARSER_MAX_FIELDS 4
+#endif
+
+/**
+ * Reads up to size bytes from a sequential source (e.g. f_read of FatFs), 0 bytes are read at the end.
+ */
+typedef int32_t (*tpu_parser_read_t)(void *source, void *buffer, uint32_t size, uint32_t *bytes_read);
+
+typedef struct tpu_parser {
+	tpu_bundle_handler_t *handler;
+	// Parse state
+	uint8_t state;
+	uint8_t in_number;
+	uint8_t negative;
+	// Base of the current number, 0 after a leading zero, until the next character decides
+	uint8_t base;
+	uint32_t section;
+	char keyword[TPU_PARSER_KEYWORD_SIZE];
+	uint32_t keyword_length;
+	uint64_t fields[TPU_PARSER_MAX_FIELDS];
+	uint32_t field_count;
+	// Next weight or unified buffer address of the current section
+	uint32_t address;
+	uint32_t batch_count;
+	// Statistics and position for error messages
+	uint32_t line;
+	uint64_t bytes;
+	union {
+		tpu_vector_t vectors[TPU_PARSER_BATCH_VECTORS];
+		instruction_t instructions[TPU_PARSER_BATCH_INSTRUCTIONS];
+		tpu_bundle_result_t results[TPU_PARSER_BATCH_RESULTS];
+	} batch;
+	char buffer[TPU_PARSER_BUFFER_SIZE];
+} tpu_parser_t;
+
+void tpu_parser_init(tpu_parser_t *parser, tpu_bundle_handler_t *handler);
+
+int32_t tpu_parser_feed(tpu_parser_t *parser, const char *data, uint32_t size);
+
+int32_t tpu_parser_finish(tpu_parser_t *parser);
+
+int32_t tpu_parser_stream(tpu_parser_t *parser, tpu_parser_read_t read, void *source);
+
+#endif /* SRC_TINYTPU_PARSER_H_ */
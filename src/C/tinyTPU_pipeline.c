@@ -0,0 +1,236 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_pipeline.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_pipeline.h"
+#include <errno.h>
+#include <stddef.h>
+
+static uint32_t region_base(tpu_pipeline_t *pipeline) {
+	return pipeline->enabled ? pipeline->region*TPU_PIPELINE_REGION_SIZE : 0;
+}
+
+/**
+ * Checks a buffer range of the loaded batch. Ranges of the first batch, which don't fit into a region, disable double buffering.
+ */
+static int32_t check_range(tpu_pipeline_t *pipeline, uint32_t address, uint32_t length) {
+	if(!pipeline->enabled || address + length <= TPU_PIPELINE_REGION_SIZE) return 0;
+	if(pipeline->decided) return EINVAL;
+
+	pipeline->enabled = 0;
+	return 0;
+}
+
+/**
+ * Waits for the batch of the region and passes its results to the sink.
+ */
+static int32_t complete_batch(tpu_pipeline_t *pipeline, uint32_t region) {
+	tpu_pipeline_batch_t *batch = &pipeline->batch[region];
+	tpu_bundle_handler_t *sink = pipeline->sink;
+
+	tpu_fence_wait(pipeline->fences, batch->fence, pipeline->idle, pipeline->idle_context);
+
+	if(batch->result_count == 0) return 0;
+
+	int32_t error = 0;
+	if(sink->results != NULL) error = sink->results(sink->context, batch->results, batch->result_count);
+	batch->result_count = 0;
+	if(error) return error;
+
+	if(sink->section_end != NULL) return sink->section_end(sink->context, TPU_SECTION_RESULTS);
+	return 0;
+}
+
+/**
+ * Closes the loaded batch. With double buffering, the batch in the other region is completed and its region gets loaded next.
+ */
+static int32_t close_batch(tpu_pipeline_t *pipeline) {
+	tpu_pipeline_batch_t *batch = &pipeline->batch[pipeline->region];
+	if(!pipeline->submitted && batch->result_count == 0) return 0;
+
+	if(pipeline->submitted && pipeline->fences->issued == pipeline->last_fence) {
+		// The batch can only be waited for with a synchronize at its end
+		instruction_t synchronize;
+		set_instruction(&synchronize, TPU_OP_SYNCHRONIZE, 0, 0, 0);
+		int32_t error = pipeline->sink->instructions(pipeline->sink->context, &synchronize, 1);
+		if(error) return error;
+	}
+
+	batch->fence = pipeline->fences->issued;
+	pipeline->last_fence = batch->fence;
+	pipeline->submitted = 0;
+	pipeline->decided = 1;
+	pipeline->batches++;
+
+	if(!pipeline->enabled) return complete_batch(pipeline, pipeline->region);
+
+	uint32_t other = pipeline->region ^ 1;
+	int32_t error = 0;
+	if(pipeline->pending) error = complete_batch(pipeline, other);
+	pipeline->pending = 1;
+	pipeline->region = other;
+
+	return error;
+}
+
+/**
+ * Closes the loaded batch and completes all batches in flight.
+ */
+static int32_t flush_batches(tpu_pipeline_t *pipeline) {
+	int32_t error = close_batch(pipeline);
+	if(error) return error;
+
+	if(pipeline->pending) {
+		pipeline->pending = 0;
+		return complete_batch(pipeline, pipeline->region ^ 1);
+	}
+	return 0;
+}
+
+static int32_t pipeline_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	tpu_pipeline_t *pipeline = (tpu_pipeline_t*)context;
+
+	// Weights may be in use by the batches in flight
+	int32_t error = flush_batches(pipeline);
+	if(error) return error;
+
+	if(pipeline->sink->weights == NULL) return 0;
+	return pipeline->sink->weights(pipeline->sink->context, vectors, address, count);
+}
+
+static int32_t pipeline_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	tpu_pipeline_t *pipeline = (tpu_pipeline_t*)context;
+
+	int32_t error = 0;
+	if(pipeline->submitted) error = close_batch(pipeline);
+	if(!error) error = check_range(pipeline, address, count);
+	if(error) return error;
+
+	if(pipeline->sink->inputs == NULL) return 0;
+	return pipeline->sink->inputs(pipeline->sink->context, vectors, address + region_base(pipeline), count);
+}
+
+static int32_t pipeline_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	tpu_pipeline_t *pipeline = (tpu_pipeline_t*)context;
+	instruction_t chunk[TPU_PIPELINE_CHUNK];
+
+	while(count) {
+		uint32_t length = count < TPU_PIPELINE_CHUNK ? count : TPU_PIPELINE_CHUNK;
+
+		for(uint32_t i = 0; i < length; ++i) {
+			chunk[i] = instructions[i];
+
+			// Matrix multiplies and activations address the unified buffer
+			uint8_t op_code = chunk[i].op_code;
+			if(op_code == TPU_OP_SYNCHRONIZE || !(op_code & (TPU_OP_ACTIVATE | TPU_OP_MATRIX_MULTIPLY))) continue;
+
+			uint32_t buf_address = get_buf_address(&chunk[i]);
+			if(check_range(pipeline, buf_address, get_calc_length(&chunk[i]))) return EINVAL;
+			set_bias_instruction(&chunk[i], op_code, get_calc_length(&chunk[i]), get_acc_address(&chunk[i]), buf_address + region_base(pipeline), get_bias_address(&chunk[i]));
+		}
+
+		if(pipeline->sink->instructions != NULL) {
+			int32_t error = pipeline->sink->instructions(pipeline->sink->context, chunk, length);
+			if(error) return error;
+		}
+		pipeline->submitted = 1;
+
+		instructions += length;
+		count -= length;
+	}
+
+	return 0;
+}
+
+static int32_t pipeline_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	tpu_pipeline_t *pipeline = (tpu_pipeline_t*)context;
+	tpu_pipeline_batch_t *batch = &pipeline->batch[pipeline->region];
+
+	for(uint32_t i = 0; i < count; ++i) {
+		if(batch->result_count == TPU_PIPELINE_RESULTS) return ENOMEM;
+		if(check_range(pipeline, results[i].address, results[i].length)) return EINVAL;
+
+		batch->results[batch->result_count] = results[i];
+		batch->results[batch->result_count].address += region_base(pipeline);
+		batch->result_count++;
+	}
+
+	return 0;
+}
+
+static int32_t pipeline_section_end(void *context, tpu_section_type_t type) {
+	tpu_pipeline_t *pipeline = (tpu_pipeline_t*)context;
+
+	switch(type) {
+		case TPU_SECTION_INSTRUCTIONS:
+			// Completion is handled by the batches
+			return 0;
+		case TPU_SECTION_RESULTS:
+			return close_batch(pipeline);
+		default:
+			if(pipeline->sink->section_end == NULL) return 0;
+			return pipeline->sink->section_end(pipeline->sink->context, type);
+	}
+}
+
+void tpu_pipeline_init(tpu_pipeline_t *pipeline, tpu_bundle_handler_t *sink, tpu_fences_t *fences, tpu_fence_idle_t idle, void *idle_context) {
+	pipeline->sink = sink;
+	pipeline->fences = fences;
+	pipeline->idle = idle;
+	pipeline->idle_context = idle_context;
+	pipeline->region = 0;
+	pipeline->last_fence = fences->issued;
+	pipeline->enabled = 1;
+	pipeline->decided = 0;
+	pipeline->submitted = 0;
+	pipeline->pending = 0;
+	pipeline->batches = 0;
+
+	for(uint32_t i = 0; i < TPU_PIPELINE_REGIONS; ++i) {
+		pipeline->batch[i].fence = fences->issued;
+		pipeline->batch[i].result_count = 0;
+	}
+}
+
+/**
+ * Fills a handler, which executes a program through the pipeline.
+ */
+void tpu_pipeline_handler(tpu_pipeline_t *pipeline, tpu_bundle_handler_t *handler) {
+	handler->context = pipeline;
+	handler->weights = pipeline_weights;
+	handler->inputs = pipeline_inputs;
+	handler->instructions = pipeline_instructions;
+	handler->results = pipeline_results;
+	handler->section_end = pipeline_section_end;
+}
+
+/**
+ * Has to be called after the program was handled, completes all batches in flight.
+ */
+int32_t tpu_pipeline_finish(tpu_pipeline_t *pipeline) {
+	return flush_batches(pipeline);
+}
@@ -0,0 +1,89 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_pipeline.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_PIPELINE_H_
+#define SRC_TINYTPU_PIPELINE_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_bundle.h"
+#include "tinyTPU_fence.h"
+#include <stdint.h>
+
+/*
+ * Double buffered execution of batched programs.
+ *
+ * Programs like the ones of transfer_complete_model.py repeat inputs, instructions and results for every batch.
+ * The pipeline splits the unified buffer into two regions and relocates every other batch into the upper region.
+ * The inputs of batch N+1 are written while batch N computes, the results of batch N-1 are read after
+ * batch N was submitted. Results are passed to the sink, when the fence of their batch is done.
+ *
+ * The pipeline is a bundle handler, which forwards to the sink handler. The sink has to issue the fences of
+ * the synchronize instructions it writes (tpu_fence_scan). Batches without a synchronize get one appended.
+ * Whether the batches fit into a region is decided by the first batch, otherwise batches are executed one after another.
+ */
+#define TPU_PIPELINE_REGIONS 2
+#define TPU_PIPELINE_REGION_SIZE (UNIFIED_BUFFER_SIZE/TPU_PIPELINE_REGIONS)
+// Result descriptors of a single batch
+#define TPU_PIPELINE_RESULTS 32
+// Instructions, which are relocated at once
+#define TPU_PIPELINE_CHUNK 64
+
+typedef struct tpu_pipeline_batch {
+	tpu_fence_t fence;
+	uint32_t result_count;
+	tpu_bundle_result_t results[TPU_PIPELINE_RESULTS];
+} tpu_pipeline_batch_t;
+
+typedef struct tpu_pipeline {
+	tpu_bundle_handler_t *sink;
+	tpu_fences_t *fences;
+	// Called while waiting for a batch, e.g. to drain a submission queue
+	tpu_fence_idle_t idle;
+	void *idle_context;
+	// Region of the batch, which is loaded
+	uint32_t region;
+	// Fence of the last closed batch
+	tpu_fence_t last_fence;
+	// Double buffering is used, decided by the first batch
+	uint8_t enabled;
+	uint8_t decided;
+	// The loaded batch has instructions
+	uint8_t submitted;
+	// The other region holds a batch, which wasn't completed yet
+	uint8_t pending;
+	uint32_t batches;
+	tpu_pipeline_batch_t batch[TPU_PIPELINE_REGIONS];
+} tpu_pipeline_t;
+
+void tpu_pipeline_init(tpu_pipeline_t *pipeline, tpu_bundle_handler_t *sink, tpu_fences_t *fences, tpu_fence_idle_t idle, void *idle_context);
+
+void tpu_pipeline_handler(tpu_pipeline_t *pipeline, tpu_bundle_handler_t *handler);
+
+int32_t tpu_pipeline_finish(tpu_pipeline_t *pipeline);
+
+#endif /* SRC_TINYTPU_PIPELINE_H_ */
@@ -0,0 +1,184 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_quantize.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_quantize.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Adding and subtracting 1.5*2^23 rounds floats below 2^22 half to even
+#define ROUND_MAGIC 12582912.0f
+
+static uint32_t tiles(uint32_t size) {
+	return (size + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE;
+}
+
+static int8_t quantize_value(float value, float scale, float offset) {
+	float x = value*scale + offset;
+	x = x < -128.0f ? -128.0f : (x > 127.0f ? 127.0f : x);
+	x = (x + ROUND_MAGIC) - ROUND_MAGIC;
+	return (int8_t)(int32_t)x;
+}
+
+/**
+ * Quantizes count values to round(value*scale + offset), saturated to int8.
+ */
+void tpu_quantize(const float *values, int8_t *quantized, uint32_t count, float scale, float offset) {
+	uint32_t i = 0;
+#if defined(__AVX2__)
+	const __m256 scales = _mm256_set1_ps(scale);
+	const __m256 offsets = _mm256_set1_ps(offset);
+	const __m256 low = _mm256_set1_ps(-128.0f);
+	const __m256 high = _mm256_set1_ps(127.0f);
+	// Packing interleaves the 128 Bit lanes
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	for(; i + 32 <= count; i += 32) {
+		__m256i words[4];
+		for(uint32_t j = 0; j < 4; ++j) {
+			// No FMA, so the results are the same as the ones of the scalar code
+			__m256 x = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&values[i + 8*j]), scales), offsets);
+			x = _mm256_min_ps(_mm256_max_ps(x, low), high);
+			// Rounds half to even by default
+			words[j] = _mm256_cvtps_epi32(x);
+		}
+		__m256i halfs = _mm256_packs_epi16(_mm256_packs_epi32(words[0], words[1]), _mm256_packs_epi32(words[2], words[3]));
+		_mm256_storeu_si256((__m256i *) &quantized[i], _mm256_permutevar8x32_epi32(halfs, order));
+	}
+#elif defined(__ARM_NEON)
+	const float32x4_t low = vdupq_n_f32(-128.0f);
+	const float32x4_t high = vdupq_n_f32(127.0f);
+	const float32x4_t magic = vdupq_n_f32(ROUND_MAGIC);
+
+	for(; i + 8 <= count; i += 8) {
+		int32x4_t words[2];
+		for(uint32_t j = 0; j < 2; ++j) {
+			float32x4_t x = vaddq_f32(vmulq_n_f32(vld1q_f32(&values[i + 4*j]), scale), vdupq_n_f32(offset));
+			x = vminq_f32(vmaxq_f32(x, low), high);
+			// ARMv7 only converts by truncation, the value is rounded before
+			x = vsubq_f32(vaddq_f32(x, magic), magic);
+			words[j] = vcvtq_s32_f32(x);
+		}
+		int16x8_t halfs = vcombine_s16(vmovn_s32(words[0]), vmovn_s32(words[1]));
+		vst1_s8(&quantized[i], vmovn_s16(halfs));
+	}
+#endif
+	for(; i < count; ++i) {
+		quantized[i] = quantize_value(values[i], scale, offset);
+	}
+}
+
+/**
+ * Copies a quantized sample into its slot of a batch in the input layout.
+ */
+void tpu_tile_sample(const int8_t *sample, uint32_t features, uint32_t slot, tpu_vector_t *vectors) {
+	uint32_t t = 0;
+	for(; (t+1)*TPU_VECTOR_SIZE <= features; ++t) {
+		memcpy(vectors[t*TPU_VECTOR_SIZE + slot].byte_vector, &sample[t*TPU_VECTOR_SIZE], TPU_VECTOR_SIZE);
+	}
+	if(t*TPU_VECTOR_SIZE < features) {
+		uint8_t *vector = vectors[t*TPU_VECTOR_SIZE + slot].byte_vector;
+		memcpy(vector, &sample[t*TPU_VECTOR_SIZE], features - t*TPU_VECTOR_SIZE);
+		memset(vector + features - t*TPU_VECTOR_SIZE, 0, TPU_VECTOR_SIZE - (features - t*TPU_VECTOR_SIZE));
+	}
+}
+
+/**
+ * Quantizes count samples of features values, which start stride values apart, into the input layout.
+ * The vectors hold ceil(count/TPU_VECTOR_SIZE) batches of ceil(features/TPU_VECTOR_SIZE)*TPU_VECTOR_SIZE vectors.
+ * Slots without a sample are zero.
+ */
+void tpu_tile_inputs(const float *samples, uint32_t count, uint32_t features, uint32_t stride, float scale, float offset, tpu_vector_t *vectors) {
+	int8_t chunk[TPU_QUANTIZE_CHUNK];
+	uint32_t batch_rows = tiles(features)*TPU_VECTOR_SIZE;
+
+	memset(vectors, 0, tiles(count)*batch_rows*sizeof(tpu_vector_t));
+
+	for(uint32_t s = 0; s < count; ++s) {
+		tpu_vector_t *batch = &vectors[s/TPU_VECTOR_SIZE*batch_rows];
+
+		for(uint32_t f = 0; f < features; f += TPU_QUANTIZE_CHUNK) {
+			uint32_t length = features - f < TPU_QUANTIZE_CHUNK ? features - f : TPU_QUANTIZE_CHUNK;
+			tpu_quantize(&samples[(uint64_t)s*stride + f], chunk, length, scale, offset);
+			tpu_tile_sample(chunk, length, s%TPU_VECTOR_SIZE, &batch[f]);
+		}
+	}
+}
+
+/**
+ * Quantizes a kernel of rows inputs and columns outputs into the weight layout, padded_rows is the
+ * row count rounded up to TPU_VECTOR_SIZE. The kernel is stored row by row (kernel[r*columns+c], like Keras),
+ * or transposed column by column (kernel[c*rows+r], like the weights of PyTorch).
+ */
+void tpu_tile_weights(const float *kernel, uint32_t rows, uint32_t columns, uint8_t transposed, float scale, tpu_vector_t *weights) {
+	uint32_t padded_rows = tiles(rows)*TPU_VECTOR_SIZE;
+
+	memset(weights, 0, (uint64_t)tiles(columns)*padded_rows*sizeof(tpu_vector_t));
+
+	if(!transposed) {
+		int8_t chunk[TPU_QUANTIZE_CHUNK];
+		for(uint32_t r = 0; r < rows; ++r) {
+			for(uint32_t c = 0; c < columns; c += TPU_QUANTIZE_CHUNK) {
+				uint32_t length = columns - c < TPU_QUANTIZE_CHUNK ? columns - c : TPU_QUANTIZE_CHUNK;
+				tpu_quantize(&kernel[(uint64_t)r*columns + c], chunk, length, scale, 0.0f);
+
+				// Column tiles are padded_rows vectors apart
+				for(uint32_t j = 0; j < length; j += TPU_VECTOR_SIZE) {
+					uint32_t width = length - j < TPU_VECTOR_SIZE ? length - j : TPU_VECTOR_SIZE;
+					memcpy(weights[(c + j)/TPU_VECTOR_SIZE*padded_rows + r].byte_vector, &chunk[j], width);
+				}
+			}
+		}
+		return;
+	}
+
+	// Square tiles are quantized from the columns and transposed in the cache
+	int8_t tile[TPU_VECTOR_SIZE][TPU_VECTOR_SIZE];
+	for(uint32_t c = 0; c < columns; c += TPU_VECTOR_SIZE) {
+		uint32_t width = columns - c < TPU_VECTOR_SIZE ? columns - c : TPU_VECTOR_SIZE;
+
+		for(uint32_t r = 0; r < rows; r += TPU_VECTOR_SIZE) {
+			uint32_t height = rows - r < TPU_VECTOR_SIZE ? rows - r : TPU_VECTOR_SIZE;
+
+			for(uint32_t j = 0; j < width; ++j) {
+				tpu_quantize(&kernel[(uint64_t)(c + j)*rows + r], tile[j], height, scale, 0.0f);
+			}
+
+			tpu_vector_t *vectors = &weights[c/TPU_VECTOR_SIZE*padded_rows + r];
+			for(uint32_t i = 0; i < height; ++i) {
+				for(uint32_t j = 0; j < width; ++j) {
+					vectors[i].byte_vector[j] = tile[j][i];
+				}
+			}
+		}
+	}
+}
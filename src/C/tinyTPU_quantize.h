@@ -0,0 +1,56 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_quantize.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_QUANTIZE_H_
+#define SRC_TINYTPU_QUANTIZE_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+
+/*
+ * Quantization and tiling of inputs and weights on the host.
+ *
+ * Values are quantized like quantize_weights.py: scaled, rounded half to even and saturated to int8.
+ * The tiling functions write the layouts of transfer_complete_model.py and transfer_weights.py directly:
+ * - inputs: vector t*TPU_VECTOR_SIZE+k holds the features of tile t of sample k, batches of TPU_VECTOR_SIZE samples
+ *   follow one another
+ * - weights: vector c*padded_rows+r holds the columns of tile c of kernel row r
+ * Features, rows and columns are padded with zeros to multiples of TPU_VECTOR_SIZE.
+ */
+// Values, which are quantized at once before they are tiled, a multiple of TPU_VECTOR_SIZE
+#define TPU_QUANTIZE_CHUNK (64*TPU_VECTOR_SIZE)
+
+void tpu_quantize(const float *values, int8_t *quantized, uint32_t count, float scale, float offset);
+
+void tpu_tile_sample(const int8_t *sample, uint32_t features, uint32_t slot, tpu_vector_t *vectors);
+
+void tpu_tile_inputs(const float *samples, uint32_t count, uint32_t features, uint32_t stride, float scale, float offset, tpu_vector_t *vectors);
+
+void tpu_tile_weights(const float *kernel, uint32_t rows, uint32_t columns, uint8_t transposed, float scale, tpu_vector_t *weights);
+
+#endif /* SRC_TINYTPU_QUANTIZE_H_ */
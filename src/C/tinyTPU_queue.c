@@ -0,0 +1,124 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_queue.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_queue.h"
+#include <errno.h>
+
+#if TPU_QUEUE_SIZE & (TPU_QUEUE_SIZE-1)
+#error "TPU_QUEUE_SIZE has to be a power of two!"
+#endif
+
+static uint32_t refresh_credits(tpu_queue_t *queue) {
+	read_instruction_count_at(queue->base, &queue->retired);
+	queue->count_reads++;
+	return tpu_queue_credits(queue);
+}
+
+/**
+ * Initializes the queue of the instance at base (e.g. TPU_MAPPED_BASE) with the current instruction count,
+ * the instruction FIFO should be empty.
+ */
+int32_t tpu_queue_init(tpu_queue_t *queue, uintptr_t base) {
+	queue->base = base;
+	queue->head = 0;
+	queue->tail = 0;
+	queue->fifo_depth = TPU_INSTRUCTION_FIFO_DEPTH;
+	queue->count_reads = 0;
+	queue->empty_drains = 0;
+
+	if(read_instruction_count_at(base, &queue->retired)) return EFAULT;
+	queue->submitted = queue->retired;
+
+	return 0;
+}
+
+/**
+ * Copies as many instructions into the ring as fit and writes as many to the FIFO as it can take.
+ * Returns the number of instructions taken from the array.
+ */
+uint32_t tpu_queue_push(tpu_queue_t *queue, instruction_t *instructions, uint32_t count) {
+	uint32_t space = TPU_QUEUE_SIZE - tpu_queue_pending(queue);
+	if(count > space) count = space;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		queue->ring[(queue->head + i) & (TPU_QUEUE_SIZE-1)] = instructions[i];
+	}
+	queue->head += count;
+
+	tpu_queue_drain(queue);
+	return count;
+}
+
+/**
+ * Writes pending instructions to the FIFO without blocking, returns the number of written instructions.
+ */
+uint32_t tpu_queue_drain(tpu_queue_t *queue) {
+	uint32_t pending = tpu_queue_pending(queue);
+	if(pending == 0) return 0;
+
+	// Only read the instruction count, if the known credits can't cover a reasonable batch
+	uint32_t batch = pending < queue->fifo_depth/2 ? pending : queue->fifo_depth/2;
+	uint32_t credits = tpu_queue_credits(queue);
+	if(credits < batch) credits = refresh_credits(queue);
+	if(credits == 0) {
+		queue->empty_drains++;
+		return 0;
+	}
+
+	uint32_t count = pending < credits ? pending : credits;
+	for(uint32_t i = 0; i < count; ++i) {
+		write_instruction_at(queue->base, &queue->ring[(queue->tail + i) & (TPU_QUEUE_SIZE-1)]);
+	}
+	queue->tail += count;
+	queue->submitted += count;
+
+	return count;
+}
+
+/**
+ * Blocks until all pending instructions were written to the FIFO.
+ */
+int32_t tpu_queue_flush(tpu_queue_t *queue) {
+	while(tpu_queue_pending(queue)) {
+		tpu_queue_drain(queue);
+	}
+	return 0;
+}
+
+uint32_t tpu_queue_pending(tpu_queue_t *queue) {
+	return queue->head - queue->tail;
+}
+
+/**
+ * Free entries of the FIFO, as known by the last read of the instruction count.
+ */
+uint32_t tpu_queue_credits(tpu_queue_t *queue) {
+	uint32_t in_fifo = queue->submitted - queue->retired;
+	if(in_fifo >= queue->fifo_depth) return 0;
+	return queue->fifo_depth - in_fifo;
+}
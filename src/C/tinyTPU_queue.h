@@ -0,0 +1,74 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_queue.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_QUEUE_H_
+#define SRC_TINYTPU_QUEUE_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+
+/*
+ * Submission queue for instructions.
+ *
+ * Instructions are buffered in a ring and written to the instruction FIFO only as long as the FIFO
+ * has free entries (credits), so AXI writes never stall on a full FIFO. The credits are calculated from
+ * the instructions written and INSTRUCTION_COUNT, which is only read when the known credits run out.
+ * All instructions have to be written through the queue, while it is in use.
+ */
+// Has to be a power of two
+#define TPU_QUEUE_SIZE 1024
+
+typedef struct tpu_queue {
+	instruction_t ring[TPU_QUEUE_SIZE];
+	// Base address of the AXI slave, which gets the instructions
+	uintptr_t base;
+	// Free running ring indices
+	uint32_t head;
+	uint32_t tail;
+	// Free running instruction counts - written to the FIFO and taken by the TPU
+	uint32_t submitted;
+	uint32_t retired;
+	uint32_t fifo_depth;
+	// Statistics
+	uint64_t count_reads;
+	uint64_t empty_drains;
+} tpu_queue_t;
+
+int32_t tpu_queue_init(tpu_queue_t *queue, uintptr_t base);
+
+uint32_t tpu_queue_push(tpu_queue_t *queue, instruction_t *instructions, uint32_t count);
+
+uint32_t tpu_queue_drain(tpu_queue_t *queue);
+
+int32_t tpu_queue_flush(tpu_queue_t *queue);
+
+uint32_t tpu_queue_pending(tpu_queue_t *queue);
+
+uint32_t tpu_queue_credits(tpu_queue_t *queue);
+
+#endif /* SRC_TINYTPU_QUEUE_H_ */
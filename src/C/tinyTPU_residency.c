@@ -0,0 +1,409 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_residency.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_residency.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if TPU_RESIDENCY_BUCKETS & (TPU_RESIDENCY_BUCKETS-1)
+#error "TPU_RESIDENCY_BUCKETS has to be a power of two!"
+#endif
+
+/**
+ * FNV-1a hash of the bytes of a tile, the padding of the vectors is ignored.
+ */
+static uint64_t hash_tile(tpu_vector_t *rows) {
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+		for(uint32_t j = 0; j < TPU_VECTOR_SIZE; ++j) {
+			hash ^= rows[i].byte_vector[j];
+			hash *= 0x100000001B3ULL;
+		}
+	}
+	return hash;
+}
+
+static uint8_t equal_tiles(tpu_vector_t *a, tpu_vector_t *b) {
+	for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+		if(memcmp(a[i].byte_vector, b[i].byte_vector, TPU_VECTOR_SIZE)) return 0;
+	}
+	return 1;
+}
+
+static uint32_t find_slot(tpu_residency_t *residency, uint64_t hash, tpu_vector_t *rows) {
+	for(uint32_t s = residency->buckets[hash & (TPU_RESIDENCY_BUCKETS-1)]; s != TPU_RESIDENCY_NONE; s = residency->slots[s].next) {
+		tpu_residency_slot_t *slot = &residency->slots[s];
+		if(slot->hash == hash && equal_tiles(slot->rows, rows)) return s;
+	}
+	return TPU_RESIDENCY_NONE;
+}
+
+static void remove_slot(tpu_residency_t *residency, uint32_t s) {
+	uint16_t *link = &residency->buckets[residency->slots[s].hash & (TPU_RESIDENCY_BUCKETS-1)];
+	while(*link != s) {
+		link = &residency->slots[*link].next;
+	}
+	*link = residency->slots[s].next;
+}
+
+/**
+ * Takes a free slot or the least recently used one, which isn't used by the current program.
+ * The slot after the last allocated one is preferred, so the tiles of a program stay in one run.
+ */
+static int32_t allocate_slot(tpu_residency_t *residency, uint32_t *slot) {
+	uint32_t victim = TPU_RESIDENCY_NONE;
+	uint32_t oldest = residency->generation;
+
+	for(uint32_t s = 0; s < TPU_RESIDENCY_SLOTS; ++s) {
+		if(residency->slots[s].generation < oldest) {
+			oldest = residency->slots[s].generation;
+			victim = s;
+			if(oldest == 0) break;
+		}
+	}
+	if(victim == TPU_RESIDENCY_NONE) return ENOMEM;
+
+	uint32_t next = residency->last_slot + 1;
+	if(next < TPU_RESIDENCY_SLOTS && residency->slots[next].generation == oldest) victim = next;
+
+	if(residency->slots[victim].generation) {
+		remove_slot(residency, victim);
+		residency->evicted++;
+	}
+
+	residency->last_slot = victim;
+	*slot = victim;
+	return 0;
+}
+
+/**
+ * Writes a missing tile into a slot or maps it to a resident copy, which was written meanwhile.
+ */
+static int32_t upload_tile(tpu_residency_t *residency, tpu_residency_pending_t *pending) {
+	uint32_t s = find_slot(residency, pending->hash, pending->rows);
+
+	if(s != TPU_RESIDENCY_NONE) {
+		residency->reused++;
+	} else {
+		int32_t error = allocate_slot(residency, &s);
+		if(error) return error;
+
+		tpu_residency_slot_t *slot = &residency->slots[s];
+		memcpy(slot->rows, pending->rows, sizeof(slot->rows));
+		slot->hash = pending->hash;
+		slot->next = residency->buckets[pending->hash & (TPU_RESIDENCY_BUCKETS-1)];
+		residency->buckets[pending->hash & (TPU_RESIDENCY_BUCKETS-1)] = s;
+
+		if(residency->sink->weights != NULL) {
+			error = residency->sink->weights(residency->sink->context, slot->rows, s*TPU_VECTOR_SIZE, TPU_VECTOR_SIZE);
+			if(error) return error;
+		}
+		residency->uploaded++;
+	}
+
+	residency->slots[s].generation = residency->generation;
+	residency->map[pending->tile] = s;
+	return 0;
+}
+
+/**
+ * Makes the pending tiles resident. Tiles, which are used by the program, were marked before, so they aren't evicted.
+ */
+static int32_t upload_pending(tpu_residency_t *residency) {
+	for(uint32_t i = 0; i < residency->pending_count; ++i) {
+		tpu_residency_pending_t *pending = &residency->pending[i];
+		if(pending->tile == TPU_RESIDENCY_NONE) continue;
+
+		int32_t error = upload_tile(residency, pending);
+		if(error) return error;
+	}
+
+	residency->pending_count = 0;
+	return 0;
+}
+
+/**
+ * Maps the staged tile to a resident copy or adds it to the pending tiles.
+ */
+static int32_t flush_staged(tpu_residency_t *residency) {
+	if(!residency->staged) return 0;
+	residency->staged = 0;
+
+	uint32_t tile = residency->staged_tile;
+	uint32_t mapped = residency->map[tile];
+	uint64_t hash = hash_tile(residency->staging);
+	uint32_t s = find_slot(residency, hash, residency->staging);
+
+	if(s != TPU_RESIDENCY_NONE) {
+		if(mapped != TPU_RESIDENCY_NONE && (mapped & TPU_RESIDENCY_PENDING)) {
+			residency->pending[mapped & ~TPU_RESIDENCY_PENDING].tile = TPU_RESIDENCY_NONE;
+		}
+		residency->slots[s].generation = residency->generation;
+		residency->map[tile] = s;
+		residency->reused++;
+		return 0;
+	}
+
+	tpu_residency_pending_t *pending;
+	if(mapped != TPU_RESIDENCY_NONE && (mapped & TPU_RESIDENCY_PENDING)) {
+		pending = &residency->pending[mapped & ~TPU_RESIDENCY_PENDING];
+	} else {
+		if(residency->pending_count == TPU_RESIDENCY_SLOTS) {
+			int32_t error = upload_pending(residency);
+			if(error) return error;
+		}
+		pending = &residency->pending[residency->pending_count];
+		residency->map[tile] = residency->pending_count++ | TPU_RESIDENCY_PENDING;
+	}
+
+	pending->hash = hash;
+	pending->tile = tile;
+	memcpy(pending->rows, residency->staging, sizeof(pending->rows));
+	return 0;
+}
+
+/**
+ * Starts collecting a tile. Rows, which aren't written, keep the content of a tile mapped before.
+ */
+static void stage_tile(tpu_residency_t *residency, uint32_t tile) {
+	uint32_t mapped = residency->map[tile];
+	if(mapped == TPU_RESIDENCY_NONE) {
+		memset(residency->staging, 0, sizeof(residency->staging));
+	} else if(mapped & TPU_RESIDENCY_PENDING) {
+		memcpy(residency->staging, residency->pending[mapped & ~TPU_RESIDENCY_PENDING].rows, sizeof(residency->staging));
+	} else {
+		memcpy(residency->staging, residency->slots[mapped].rows, sizeof(residency->staging));
+	}
+	residency->staged_tile = tile;
+	residency->staged = 1;
+}
+
+static int32_t residency_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	tpu_residency_t *residency = (tpu_residency_t*)context;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		uint32_t row = (address + i) % WEIGHT_BUFFER_SIZE;
+		uint32_t tile = row / TPU_VECTOR_SIZE;
+
+		if(!residency->staged || residency->staged_tile != tile) {
+			int32_t error = flush_staged(residency);
+			if(error) return error;
+			stage_tile(residency, tile);
+		}
+		residency->staging[row % TPU_VECTOR_SIZE] = vectors[i];
+	}
+
+	return 0;
+}
+
+static int32_t residency_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	tpu_residency_t *residency = (tpu_residency_t*)context;
+	if(residency->sink->inputs == NULL) return 0;
+	return residency->sink->inputs(residency->sink->context, vectors, address, count);
+}
+
+static int32_t emit_instruction(tpu_residency_t *residency, instruction_t *chunk, uint32_t *length, instruction_t *instruction) {
+	if(*length == TPU_RESIDENCY_CHUNK) {
+		if(residency->sink->instructions != NULL) {
+			int32_t error = residency->sink->instructions(residency->sink->context, chunk, *length);
+			if(error) return error;
+		}
+		*length = 0;
+	}
+	chunk[(*length)++] = *instruction;
+	return 0;
+}
+
+/**
+ * Resident address of a weight address of the program, TPU_RESIDENCY_NONE if the tile wasn't written.
+ */
+static uint32_t resident_address(tpu_residency_t *residency, uint32_t row) {
+	uint32_t s = residency->map[row / TPU_VECTOR_SIZE];
+	if(s == TPU_RESIDENCY_NONE) return TPU_RESIDENCY_NONE;
+	return s*TPU_VECTOR_SIZE + row % TPU_VECTOR_SIZE;
+}
+
+/**
+ * Position of the next tile boundary after position p of a read_weights, which starts at row start.
+ */
+static uint32_t next_tile(uint32_t start, uint32_t p) {
+	uint32_t row = (start + p) % WEIGHT_BUFFER_SIZE;
+	uint32_t step = TPU_VECTOR_SIZE - row % TPU_VECTOR_SIZE;
+	// The last tile of the weight buffer is partial
+	if(row + step > WEIGHT_BUFFER_SIZE) step = WEIGHT_BUFFER_SIZE - row;
+	return p + step;
+}
+
+/**
+ * Emits a read_weights instruction for every run of resident rows.
+ * Instructions, which read tiles, which weren't written, are emitted as they are.
+ */
+static int32_t rewrite_weights(tpu_residency_t *residency, instruction_t *chunk, uint32_t *length, instruction_t *instruction) {
+	uint32_t start = get_weight_address(instruction) % WEIGHT_BUFFER_SIZE;
+	uint32_t calc_length = get_calc_length(instruction);
+
+	// Reads, which wrap around the whole weight buffer, can't be relocated
+	if(calc_length > WEIGHT_BUFFER_SIZE) return emit_instruction(residency, chunk, length, instruction);
+	if(resident_address(residency, start) == TPU_RESIDENCY_NONE) return emit_instruction(residency, chunk, length, instruction);
+	for(uint32_t p = next_tile(start, 0); p < calc_length; p = next_tile(start, p)) {
+		if(resident_address(residency, (start + p) % WEIGHT_BUFFER_SIZE) == TPU_RESIDENCY_NONE) {
+			return emit_instruction(residency, chunk, length, instruction);
+		}
+	}
+
+	instruction_t piece;
+	uint32_t piece_start = 0;
+	uint32_t piece_address = resident_address(residency, start);
+
+	for(uint32_t p = next_tile(start, 0); p < calc_length; p = next_tile(start, p)) {
+		uint32_t address = resident_address(residency, (start + p) % WEIGHT_BUFFER_SIZE);
+		if(address == piece_address + p - piece_start) continue;
+
+		// The row index restarts with every read_weights
+		if(p % TPU_VECTOR_SIZE) return EINVAL;
+
+		set_weight_instruction(&piece, instruction->op_code, p - piece_start, piece_address);
+		int32_t error = emit_instruction(residency, chunk, length, &piece);
+		if(error) return error;
+		residency->split++;
+
+		piece_start = p;
+		piece_address = address;
+	}
+
+	set_weight_instruction(&piece, instruction->op_code, calc_length - piece_start, piece_address);
+	return emit_instruction(residency, chunk, length, &piece);
+}
+
+static int32_t residency_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	tpu_residency_t *residency = (tpu_residency_t*)context;
+	instruction_t chunk[TPU_RESIDENCY_CHUNK];
+	uint32_t length = 0;
+
+	int32_t error = flush_staged(residency);
+	if(!error) error = upload_pending(residency);
+	if(error) return error;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		uint8_t op_code = instructions[i].op_code;
+		if(op_code != TPU_OP_SYNCHRONIZE && !(op_code & (TPU_OP_ACTIVATE | TPU_OP_MATRIX_MULTIPLY)) && (op_code & TPU_OP_READ_WEIGHTS)) {
+			error = rewrite_weights(residency, chunk, &length, &instructions[i]);
+		} else {
+			error = emit_instruction(residency, chunk, &length, &instructions[i]);
+		}
+		if(error) return error;
+	}
+
+	if(length == 0 || residency->sink->instructions == NULL) return 0;
+	return residency->sink->instructions(residency->sink->context, chunk, length);
+}
+
+static int32_t residency_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	tpu_residency_t *residency = (tpu_residency_t*)context;
+	if(residency->sink->results == NULL) return 0;
+	return residency->sink->results(residency->sink->context, results, count);
+}
+
+static int32_t residency_section_end(void *context, tpu_section_type_t type) {
+	tpu_residency_t *residency = (tpu_residency_t*)context;
+
+	if(type == TPU_SECTION_WEIGHTS) {
+		int32_t error = flush_staged(residency);
+		if(!error) error = upload_pending(residency);
+		if(error) return error;
+	}
+
+	if(residency->sink->section_end == NULL) return 0;
+	return residency->sink->section_end(residency->sink->context, type);
+}
+
+/**
+ * Initializes an empty cache, the weight buffer is considered to hold no tiles.
+ * Returns ENOMEM, if the slots and the pending tiles can't be allocated.
+ */
+int32_t tpu_residency_init(tpu_residency_t *residency) {
+	residency->slots = malloc(TPU_RESIDENCY_SLOTS*sizeof(tpu_residency_slot_t));
+	residency->pending = malloc(TPU_RESIDENCY_SLOTS*sizeof(tpu_residency_pending_t));
+	if(residency->slots == NULL || residency->pending == NULL) {
+		tpu_residency_free(residency);
+		return ENOMEM;
+	}
+
+	residency->sink = NULL;
+	residency->generation = 0;
+	residency->last_slot = UINT32_MAX;
+	residency->staged = 0;
+
+	for(uint32_t s = 0; s < TPU_RESIDENCY_SLOTS; ++s) {
+		residency->slots[s].generation = 0;
+	}
+	for(uint32_t b = 0; b < TPU_RESIDENCY_BUCKETS; ++b) {
+		residency->buckets[b] = TPU_RESIDENCY_NONE;
+	}
+
+	return 0;
+}
+
+void tpu_residency_free(tpu_residency_t *residency) {
+	free(residency->slots);
+	free(residency->pending);
+	residency->slots = NULL;
+	residency->pending = NULL;
+}
+
+/**
+ * Starts a new program. Tiles of earlier programs stay resident, until they are evicted.
+ */
+void tpu_residency_begin(tpu_residency_t *residency, tpu_bundle_handler_t *sink) {
+	residency->sink = sink;
+	residency->generation++;
+	residency->staged = 0;
+	residency->pending_count = 0;
+	residency->uploaded = 0;
+	residency->reused = 0;
+	residency->evicted = 0;
+	residency->split = 0;
+
+	for(uint32_t t = 0; t < TPU_RESIDENCY_TILES; ++t) {
+		residency->map[t] = TPU_RESIDENCY_NONE;
+	}
+}
+
+/**
+ * Fills a handler, which passes a program through the cache.
+ */
+void tpu_residency_handler(tpu_residency_t *residency, tpu_bundle_handler_t *handler) {
+	handler->context = residency;
+	handler->weights = residency_weights;
+	handler->inputs = residency_inputs;
+	handler->instructions = residency_instructions;
+	handler->results = residency_results;
+	handler->section_end = residency_section_end;
+}
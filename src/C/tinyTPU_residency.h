@@ -0,0 +1,112 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_residency.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_RESIDENCY_H_
+#define SRC_TINYTPU_RESIDENCY_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_bundle.h"
+#include <stdint.h>
+
+/*
+ * Residency cache for the weight buffer.
+ *
+ * Weights of a program are split into tiles of TPU_VECTOR_SIZE rows, aligned to the weight addresses of the program.
+ * Tiles are identified by their content, so tiles, which are already in the weight buffer, aren't written again.
+ * Missing tiles are collected, until the weights of the program were looked up, and replace the least recently used
+ * tiles of other programs. The weight addresses of read_weights
+ * instructions are rewritten to the resident tiles. Instructions are only split, where consecutive tiles aren't
+ * resident one after another, so read_weights have to start at a tile boundary or stay within resident runs.
+ *
+ * The cache is a bundle handler, which forwards to the sink handler. All weights have to be written through the cache.
+ * The slots and the pending tiles mirror the whole weight buffer, so they are allocated by tpu_residency_init.
+ */
+#define TPU_RESIDENCY_SLOTS		(WEIGHT_BUFFER_SIZE/TPU_VECTOR_SIZE)
+// Tiles of the weight address space of a program, the last one may be partial
+#define TPU_RESIDENCY_TILES		((WEIGHT_BUFFER_SIZE+TPU_VECTOR_SIZE-1)/TPU_VECTOR_SIZE)
+// Has to be a power of two
+#define TPU_RESIDENCY_BUCKETS	1024
+#define TPU_RESIDENCY_NONE		0xFFFF
+// Marks program tiles, which are mapped to a pending tile
+#define TPU_RESIDENCY_PENDING	0x8000
+// Instructions, which are rewritten at once
+#define TPU_RESIDENCY_CHUNK		64
+
+// Slots and pending tiles are kept in 16 Bit, below the pending flag and TPU_RESIDENCY_NONE
+#if TPU_RESIDENCY_TILES >= TPU_RESIDENCY_PENDING
+#error "WEIGHT_BUFFER_SIZE has too many tiles for the residency cache!"
+#endif
+
+typedef struct tpu_residency_slot {
+	uint64_t hash;
+	// Generation of the last program, which used the tile, 0 if the slot is free
+	uint32_t generation;
+	// Next slot in the same hash bucket
+	uint16_t next;
+	tpu_vector_t rows[TPU_VECTOR_SIZE];
+} tpu_residency_slot_t;
+
+typedef struct tpu_residency_pending {
+	uint64_t hash;
+	// Program tile, TPU_RESIDENCY_NONE if the tile was written again
+	uint32_t tile;
+	tpu_vector_t rows[TPU_VECTOR_SIZE];
+} tpu_residency_pending_t;
+
+typedef struct tpu_residency {
+	tpu_bundle_handler_t *sink;
+	uint32_t generation;
+	uint32_t last_slot;
+	// Tile of the program, which is collected from the written weights
+	uint32_t staged_tile;
+	uint8_t staged;
+	tpu_vector_t staging[TPU_VECTOR_SIZE];
+	// Program tile to slot or pending tile
+	uint16_t map[TPU_RESIDENCY_TILES];
+	// Tiles of the program, which aren't resident yet
+	uint32_t pending_count;
+	// TPU_RESIDENCY_SLOTS each
+	tpu_residency_pending_t *pending;
+	uint16_t buckets[TPU_RESIDENCY_BUCKETS];
+	tpu_residency_slot_t *slots;
+	// Statistics
+	uint32_t uploaded;
+	uint32_t reused;
+	uint32_t evicted;
+	uint32_t split;
+} tpu_residency_t;
+
+int32_t tpu_residency_init(tpu_residency_t *residency);
+
+void tpu_residency_free(tpu_residency_t *residency);
+
+void tpu_residency_begin(tpu_residency_t *residency, tpu_bundle_handler_t *sink);
+
+void tpu_residency_handler(tpu_residency_t *residency, tpu_bundle_handler_t *handler);
+
+#endif /* SRC_TINYTPU_RESIDENCY_H_ */
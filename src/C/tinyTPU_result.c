@@ -0,0 +1,277 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_result.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_result.h"
+#include <errno.h>
+#include <string.h>
+
+// Vectors are ranked within a single register
+#if TPU_VECTOR_PADDING == 16
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TPU_RESULT_AVX2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TPU_RESULT_NEON
+#endif
+#endif
+
+// Largest record, a CSV line of TPU_VECTOR_SIZE bytes or TPU_VECTOR_SIZE floats
+#define MAX_RECORD_SIZE (TPU_VECTOR_SIZE*4)
+
+static const char *format_names[] = {"csv", "raw", "float", "class", "top"};
+
+int32_t tpu_result_parse_format(const char *name, tpu_result_format_t *format) {
+	for(uint32_t i = 0; i < sizeof(format_names)/sizeof(format_names[0]); ++i) {
+		if(!strcmp(name, format_names[i])) {
+			*format = (tpu_result_format_t)i;
+			return 0;
+		}
+	}
+	return EINVAL;
+}
+
+/**
+ * Sets up the result stage. Columns of 0 use the whole vector, top_k is only used by TPU_RESULT_TOP_K.
+ */
+int32_t tpu_result_init(tpu_result_t *result, tpu_result_format_t format, uint32_t columns, uint32_t top_k, uint8_t is_signed, tpu_result_read_t read, void *read_context) {
+	if(columns == 0) columns = TPU_VECTOR_SIZE;
+	if(format > TPU_RESULT_TOP_K || columns > TPU_VECTOR_SIZE) return EINVAL;
+	if(format == TPU_RESULT_CLASS) top_k = 1;
+	if(format == TPU_RESULT_TOP_K && (top_k == 0 || top_k > columns)) return EINVAL;
+
+	memset(result, 0, sizeof(tpu_result_t));
+	result->format = format;
+	result->columns = columns;
+	result->top_k = top_k;
+	result->is_signed = is_signed;
+	result->read = read;
+	result->read_context = read_context;
+
+	result->flip = is_signed ? 0x00 : 0x80;
+	for(uint32_t i = 0; i < TPU_VECTOR_PADDING; ++i) {
+		result->keep[i] = i < columns ? 0xFF : 0x00;
+		result->fill[i] = i < columns ? 0x00 : 0x80;
+	}
+	return 0;
+}
+
+/**
+ * Starts a new sink, records of the sink before have to be flushed.
+ */
+void tpu_result_begin(tpu_result_t *result, tpu_result_write_t write, tpu_result_rewind_t rewind, void *sink_context) {
+	result->write = write;
+	result->rewind = rewind;
+	result->sink_context = sink_context;
+	result->length = 0;
+}
+
+int32_t tpu_result_flush(tpu_result_t *result) {
+	if(result->length == 0) return 0;
+
+	int32_t error = result->write(result->sink_context, result->buffer, result->length);
+	result->bytes += result->length;
+	result->length = 0;
+	return error;
+}
+
+/**
+ * Writes the indices of the top_k largest columns into classes, larger indices lose on ties.
+ */
+static void rank_vector(tpu_result_t *result, const tpu_vector_t *vector, uint8_t *classes) {
+#if defined(TPU_RESULT_AVX2)
+	const __m128i smallest = _mm_set1_epi8(-128);
+	const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i values = _mm_xor_si128(_mm_loadu_si128((const __m128i *) vector->byte_vector), _mm_set1_epi8(result->flip));
+	values = _mm_or_si128(_mm_and_si128(values, _mm_loadu_si128((const __m128i *) result->keep)), _mm_loadu_si128((const __m128i *) result->fill));
+	// Unused columns and ranked columns can't be picked again, even if all other columns hold the smallest value
+	uint32_t taken = ~((1U << result->columns) - 1);
+
+	for(uint32_t k = 0; k < result->top_k; ++k) {
+		// Rotations keep the maximum in every byte
+		__m128i maximum = _mm_max_epi8(values, _mm_shuffle_epi32(values, 0x4E));
+		maximum = _mm_max_epi8(maximum, _mm_shuffle_epi32(maximum, 0xB1));
+		maximum = _mm_max_epi8(maximum, _mm_alignr_epi8(maximum, maximum, 2));
+		maximum = _mm_max_epi8(maximum, _mm_alignr_epi8(maximum, maximum, 1));
+
+		uint32_t index = __builtin_ctz(_mm_movemask_epi8(_mm_cmpeq_epi8(values, maximum)) & ~taken);
+		classes[k] = index;
+		taken |= 1U << index;
+		values = _mm_blendv_epi8(values, smallest, _mm_cmpeq_epi8(lanes, _mm_set1_epi8(index)));
+	}
+#elif defined(TPU_RESULT_NEON)
+	const uint8_t lane_indices[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+	const uint8x16_t lanes = vld1q_u8(lane_indices);
+	int8x16_t values = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(vector->byte_vector), vdupq_n_u8(result->flip)));
+	values = vorrq_s8(vandq_s8(values, vreinterpretq_s8_u8(vld1q_u8(result->keep))), vreinterpretq_s8_u8(vld1q_u8(result->fill)));
+	uint8x16_t available = vld1q_u8(result->keep);
+
+	for(uint32_t k = 0; k < result->top_k; ++k) {
+		// ARMv7 has no reductions across the register, pairwise maxima are used instead
+		int8x8_t maximum = vpmax_s8(vget_low_s8(values), vget_high_s8(values));
+		maximum = vpmax_s8(maximum, maximum);
+		maximum = vpmax_s8(maximum, maximum);
+		maximum = vpmax_s8(maximum, maximum);
+
+		uint8x16_t candidates = vandq_u8(vceqq_s8(values, vdupq_lane_s8(maximum, 0)), available);
+		uint8x16_t indices = vbslq_u8(candidates, lanes, vdupq_n_u8(0xFF));
+		uint8x8_t index = vpmin_u8(vget_low_u8(indices), vget_high_u8(indices));
+		index = vpmin_u8(index, index);
+		index = vpmin_u8(index, index);
+		index = vpmin_u8(index, index);
+
+		classes[k] = vget_lane_u8(index, 0);
+		uint8x16_t lane = vceqq_u8(lanes, vdupq_lane_u8(index, 0));
+		available = vbicq_u8(available, lane);
+		values = vbslq_s8(lane, vdupq_n_s8(-128), values);
+	}
+#else
+	uint64_t taken = 0;
+
+	for(uint32_t k = 0; k < result->top_k; ++k) {
+		int32_t best = -1;
+		int32_t best_value = 0;
+		for(uint32_t c = 0; c < result->columns; ++c) {
+			if(taken & (1ULL << c)) continue;
+			int32_t value = (int8_t)(vector->byte_vector[c] ^ result->flip);
+			if(best < 0 || value > best_value) {
+				best = c;
+				best_value = value;
+			}
+		}
+		classes[k] = best;
+		taken |= 1ULL << best;
+	}
+#endif
+}
+
+static uint32_t dequantize_vector(tpu_result_t *result, const tpu_vector_t *vector, char *record) {
+	float values[TPU_VECTOR_PADDING];
+#if defined(TPU_RESULT_AVX2)
+	const __m256 scale = _mm256_set1_ps(TPU_RESULT_SCALE);
+	__m128i bytes = _mm_loadu_si128((const __m128i *) vector->byte_vector);
+
+	for(uint32_t i = 0; i < 2; ++i) {
+		__m256i words = result->is_signed ? _mm256_cvtepi8_epi32(bytes) : _mm256_cvtepu8_epi32(bytes);
+		_mm256_storeu_ps(&values[8*i], _mm256_mul_ps(_mm256_cvtepi32_ps(words), scale));
+		bytes = _mm_srli_si128(bytes, 8);
+	}
+#elif defined(TPU_RESULT_NEON)
+	uint8x16_t bytes = vld1q_u8(vector->byte_vector);
+	int16x8_t halfs[2];
+	if(result->is_signed) {
+		halfs[0] = vmovl_s8(vget_low_s8(vreinterpretq_s8_u8(bytes)));
+		halfs[1] = vmovl_s8(vget_high_s8(vreinterpretq_s8_u8(bytes)));
+	} else {
+		halfs[0] = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(bytes)));
+		halfs[1] = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(bytes)));
+	}
+
+	for(uint32_t i = 0; i < 2; ++i) {
+		vst1q_f32(&values[8*i], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(halfs[i]))), TPU_RESULT_SCALE));
+		vst1q_f32(&values[8*i + 4], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(halfs[i]))), TPU_RESULT_SCALE));
+	}
+#else
+	for(uint32_t i = 0; i < result->columns; ++i) {
+		int32_t value = result->is_signed ? (int8_t)vector->byte_vector[i] : vector->byte_vector[i];
+		values[i] = value*TPU_RESULT_SCALE;
+	}
+#endif
+	memcpy(record, values, result->columns*sizeof(float));
+	return result->columns*sizeof(float);
+}
+
+static uint32_t format_csv(tpu_result_t *result, const tpu_vector_t *vector, char *record) {
+	uint32_t length = 0;
+	for(uint32_t i = 0; i < result->columns; ++i) {
+		uint8_t value = vector->byte_vector[i];
+		if(i) record[length++] = ',';
+		if(value >= 100) record[length++] = '0' + value/100;
+		if(value >= 10) record[length++] = '0' + value/10%10;
+		record[length++] = '0' + value%10;
+	}
+	record[length++] = '\n';
+	return length;
+}
+
+static uint32_t format_vector(tpu_result_t *result, const tpu_vector_t *vector, char *record) {
+	uint8_t classes[TPU_VECTOR_SIZE];
+
+	switch(result->format) {
+		case TPU_RESULT_CSV:
+			return format_csv(result, vector, record);
+		case TPU_RESULT_RAW:
+			memcpy(record, vector->byte_vector, result->columns);
+			return result->columns;
+		case TPU_RESULT_FLOAT:
+			return dequantize_vector(result, vector, record);
+		case TPU_RESULT_CLASS:
+			rank_vector(result, vector, (uint8_t*)record);
+			return 1;
+		case TPU_RESULT_TOP_K:
+			rank_vector(result, vector, classes);
+			for(uint32_t k = 0; k < result->top_k; ++k) {
+				record[2*k] = classes[k];
+				record[2*k + 1] = vector->byte_vector[classes[k]];
+			}
+			return 2*result->top_k;
+	}
+	return 0;
+}
+
+/**
+ * Reads the ranges of the result descriptors and appends their records to the sink.
+ */
+int32_t tpu_result_store(tpu_result_t *result, tpu_bundle_result_t *results, uint32_t count) {
+	for(uint32_t i = 0; i < count; ++i) {
+		if(!results[i].append) {
+			// Buffered records would be overwritten anyway
+			result->length = 0;
+			if(result->rewind) {
+				int32_t error = result->rewind(result->sink_context);
+				if(error) return error;
+			}
+		}
+
+		for(uint32_t offset = 0; offset < results[i].length; offset += TPU_RESULT_CHUNK) {
+			uint32_t length = results[i].length - offset < TPU_RESULT_CHUNK ? results[i].length - offset : TPU_RESULT_CHUNK;
+			int32_t error = result->read(result->read_context, result->block, results[i].address + offset, length);
+			if(error) return error;
+
+			for(uint32_t j = 0; j < length; ++j) {
+				if(result->length + MAX_RECORD_SIZE > TPU_RESULT_BUFFER_SIZE) {
+					error = tpu_result_flush(result);
+					if(error) return error;
+				}
+				result->length += format_vector(result, &result->block[j], &result->buffer[result->length]);
+			}
+			result->vectors += length;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,104 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_result.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_RESULT_H_
+#define SRC_TINYTPU_RESULT_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_bundle.h"
+#include <stdint.h>
+
+/*
+ * Result stage, which reads the ranges of result descriptors and appends records to a buffered sink.
+ *
+ * Ranges are read in blocks of TPU_RESULT_CHUNK vectors. Every vector becomes one record, only the first columns
+ * are used (e.g. the classes of a layer, which is padded to TPU_VECTOR_SIZE):
+ * - CSV: decimal bytes, one line per vector, like results.csv of sd_main.c
+ * - RAW: columns bytes
+ * - FLOAT: columns little endian floats, dequantized by TPU_RESULT_SCALE
+ * - CLASS: index of the largest column as a single byte, the first one on ties like numpy's argmax
+ * - TOP_K: top_k pairs of index and byte, ordered by value and index
+ * Bytes are compared and dequantized as int8 or uint8, depending on is_signed.
+ * Descriptors, which don't append, discard the buffered records and rewind the sink.
+ */
+// Vectors, which are read at once
+#define TPU_RESULT_CHUNK		256
+// Bytes, which are buffered before they are written to the sink
+#define TPU_RESULT_BUFFER_SIZE	4096
+#define TPU_RESULT_SCALE		(1.0f/128.0f)
+
+typedef enum tpu_result_format {
+	TPU_RESULT_CSV,
+	TPU_RESULT_RAW,
+	TPU_RESULT_FLOAT,
+	TPU_RESULT_CLASS,
+	TPU_RESULT_TOP_K
+} tpu_result_format_t;
+
+/**
+ * Reads count vectors of the unified buffer, starting at address (e.g. read_output_block), returns 0 on success.
+ */
+typedef int32_t (*tpu_result_read_t)(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count);
+
+typedef int32_t (*tpu_result_write_t)(void *context, const char *data, uint32_t length);
+
+typedef int32_t (*tpu_result_rewind_t)(void *context);
+
+typedef struct tpu_result {
+	tpu_result_format_t format;
+	uint32_t columns;
+	uint32_t top_k;
+	uint8_t is_signed;
+	tpu_result_read_t read;
+	void *read_context;
+	tpu_result_write_t write;
+	tpu_result_rewind_t rewind;
+	void *sink_context;
+	// Flips unsigned bytes into signed order and replaces unused columns by the smallest value
+	uint8_t flip;
+	uint8_t keep[TPU_VECTOR_PADDING];
+	uint8_t fill[TPU_VECTOR_PADDING];
+	uint32_t length;
+	// Statistics
+	uint64_t vectors;
+	uint64_t bytes;
+	tpu_vector_t block[TPU_RESULT_CHUNK];
+	char buffer[TPU_RESULT_BUFFER_SIZE];
+} tpu_result_t;
+
+int32_t tpu_result_parse_format(const char *name, tpu_result_format_t *format);
+
+int32_t tpu_result_init(tpu_result_t *result, tpu_result_format_t format, uint32_t columns, uint32_t top_k, uint8_t is_signed, tpu_result_read_t read, void *read_context);
+
+void tpu_result_begin(tpu_result_t *result, tpu_result_write_t write, tpu_result_rewind_t rewind, void *sink_context);
+
+int32_t tpu_result_store(tpu_result_t *result, tpu_bundle_result_t *results, uint32_t count);
+
+int32_t tpu_result_flush(tpu_result_t *result);
+
+#endif /* SRC_TINYTPU_RESULT_H_ */
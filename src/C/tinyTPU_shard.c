@@ -0,0 +1,165 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_shard.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_shard.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+int32_t tpu_shard_init(tpu_shard_t *shard, tpu_device_t *devices, uint32_t device_count) {
+	if(device_count == 0 || device_count > TPU_SHARD_DEVICES) return EINVAL;
+
+	shard->device_count = device_count;
+	shard->rows = 0;
+	shard->columns = 0;
+	shard->batches = 0;
+
+	for(uint32_t d = 0; d < device_count; ++d) {
+		shard->slices[d].device = &devices[d];
+		shard->slices[d].first_column = 0;
+		shard->slices[d].columns = 0;
+		shard->slices[d].program.instructions = NULL;
+		shard->slices[d].program.count = 0;
+	}
+
+	return 0;
+}
+
+/**
+ * Compiles the program of a slice.
+ */
+static int32_t compile_slice(tpu_shard_slice_t *slice, uint32_t rows, uint8_t activation, uint8_t is_signed, uint32_t batches) {
+	tpu_compiler_config_t config;
+	tpu_compiler_layer_t layer = {rows, slice->columns*TPU_VECTOR_SIZE, activation, NULL};
+
+	tpu_compiler_default_config(&config);
+	config.is_signed = is_signed;
+	config.batches = batches;
+
+	tpu_program_t *program = &slice->program;
+	free(program->instructions);
+	program->capacity = tpu_compiler_max_instructions(&config, &layer, 1);
+	program->instructions = malloc(program->capacity*sizeof(instruction_t));
+	if(program->instructions == NULL) return ENOMEM;
+
+	return tpu_compiler_compile(&config, &layer, 1, program);
+}
+
+/**
+ * Splits the layer between the devices, writes the weights and compiles the programs of the devices.
+ */
+int32_t tpu_shard_load(tpu_shard_t *shard, tpu_vector_t *weights, uint32_t rows, uint32_t columns, uint8_t activation, uint8_t is_signed, uint32_t batches) {
+	if(rows == 0 || columns == 0 || batches == 0) return EINVAL;
+
+	shard->rows = (rows + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE*TPU_VECTOR_SIZE;
+	shard->columns = (columns + TPU_VECTOR_SIZE - 1)/TPU_VECTOR_SIZE;
+	shard->batches = batches;
+
+	uint32_t first_column = 0;
+	for(uint32_t d = 0; d < shard->device_count; ++d) {
+		tpu_shard_slice_t *slice = &shard->slices[d];
+
+		// The first devices get one more column, if the columns can't be split evenly
+		slice->first_column = first_column;
+		slice->columns = shard->columns/shard->device_count + (d < shard->columns%shard->device_count);
+		slice->program.count = 0;
+		first_column += slice->columns;
+		if(slice->columns == 0) continue;
+
+		int32_t error = tpu_device_write_weights(slice->device, weights + slice->first_column*shard->rows, 0, slice->columns*shard->rows);
+		if(!error) error = compile_slice(slice, rows, activation, is_signed, batches);
+		if(error) return error;
+	}
+
+	return 0;
+}
+
+/**
+ * Calculates the batches of inputs on all devices and gathers the outputs.
+ */
+int32_t tpu_shard_run(tpu_shard_t *shard, tpu_vector_t *inputs, tpu_vector_t *outputs) {
+	uint32_t written[TPU_SHARD_DEVICES];
+	tpu_fence_t fences[TPU_SHARD_DEVICES];
+	uint32_t remaining = 0;
+
+	for(uint32_t d = 0; d < shard->device_count; ++d) {
+		tpu_shard_slice_t *slice = &shard->slices[d];
+		written[d] = 0;
+		if(slice->columns == 0) continue;
+
+		int32_t error = tpu_device_write_inputs(slice->device, inputs, 0, shard->batches*shard->rows);
+		if(error) return error;
+		remaining += slice->program.count;
+	}
+
+	// A full queue blocks the writes, so every device gets a part of its program in turn
+	while(remaining) {
+		for(uint32_t d = 0; d < shard->device_count; ++d) {
+			tpu_shard_slice_t *slice = &shard->slices[d];
+			uint32_t count = slice->program.count - written[d];
+			if(count == 0) continue;
+			if(count > TPU_SHARD_CHUNK) count = TPU_SHARD_CHUNK;
+
+			fences[d] = tpu_device_write_instructions(slice->device, &slice->program.instructions[written[d]], count);
+			written[d] += count;
+			remaining -= count;
+		}
+	}
+
+	// The queues only write as many instructions as the instruction FIFOs take, so they are drained in turn as well
+	uint32_t pending;
+	do {
+		pending = 0;
+		for(uint32_t d = 0; d < shard->device_count; ++d) {
+			if(shard->slices[d].columns) pending += tpu_device_drain(shard->slices[d].device);
+		}
+	} while(pending);
+
+	for(uint32_t d = 0; d < shard->device_count; ++d) {
+		tpu_shard_slice_t *slice = &shard->slices[d];
+		if(slice->columns == 0) continue;
+
+		tpu_device_wait(slice->device, fences[d]);
+
+		for(uint32_t b = 0; b < shard->batches; ++b) {
+			tpu_vector_t *output = outputs + (b*shard->columns + slice->first_column)*TPU_VECTOR_SIZE;
+			int32_t error = tpu_device_read_outputs(slice->device, output, slice->program.output_address + b*slice->program.output_length, slice->columns*TPU_VECTOR_SIZE);
+			if(error) return error;
+		}
+	}
+
+	return 0;
+}
+
+void tpu_shard_free(tpu_shard_t *shard) {
+	for(uint32_t d = 0; d < shard->device_count; ++d) {
+		free(shard->slices[d].program.instructions);
+		shard->slices[d].program.instructions = NULL;
+		shard->slices[d].program.count = 0;
+	}
+}
@@ -0,0 +1,77 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_shard.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_SHARD_H_
+#define SRC_TINYTPU_SHARD_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_compiler.h"
+#include "tinyTPU_device.h"
+#include <stdint.h>
+
+/*
+ * Runtime, which shards a fully connected layer across several devices.
+ *
+ * The output column tiles of the layer are split evenly between the devices, every device holds the weights of its
+ * columns and runs a program of tinyTPU_compiler for them. Inputs are broadcast to all devices, the instructions are
+ * written to the devices in turns, so all devices calculate at the same time. The results of every device are gathered
+ * into the output columns it calculated.
+ *
+ * Weights are expected in the layout of transfer_weights.py, inputs and outputs in the layout of transfer_complete_model.py
+ * with the batches one after another.
+ */
+#define TPU_SHARD_DEVICES 8
+// Instructions written to a device in one turn
+#define TPU_SHARD_CHUNK TPU_INSTRUCTION_FIFO_DEPTH
+
+typedef struct tpu_shard_slice {
+	tpu_device_t *device;
+	// Output column tiles calculated by the device
+	uint32_t first_column;
+	uint32_t columns;
+	tpu_program_t program;
+} tpu_shard_slice_t;
+
+typedef struct tpu_shard {
+	uint32_t device_count;
+	// Padded rows of the inputs of a batch and column tiles of the layer
+	uint32_t rows;
+	uint32_t columns;
+	uint32_t batches;
+	tpu_shard_slice_t slices[TPU_SHARD_DEVICES];
+} tpu_shard_t;
+
+int32_t tpu_shard_init(tpu_shard_t *shard, tpu_device_t *devices, uint32_t device_count);
+
+int32_t tpu_shard_load(tpu_shard_t *shard, tpu_vector_t *weights, uint32_t rows, uint32_t columns, uint8_t activation, uint8_t is_signed, uint32_t batches);
+
+int32_t tpu_shard_run(tpu_shard_t *shard, tpu_vector_t *inputs, tpu_vector_t *outputs);
+
+void tpu_shard_free(tpu_shard_t *shard);
+
+#endif /* SRC_TINYTPU_SHARD_H_ */
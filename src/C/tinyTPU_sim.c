@@ -0,0 +1,237 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_sim.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_sim.h"
+#include <errno.h>
+#include <string.h>
+
+// Safety limit for programs which never drain, e.g. a trailing weight instruction in the look-ahead buffer
+#define IDLE_LIMIT 1024
+
+typedef struct slot {
+	uint8_t valid;
+	uint32_t index;
+} slot_t;
+
+typedef struct unit {
+	// Remaining cycles of RUNNING_cs and of the RUNNING_PIPE_cs shift register
+	uint64_t running;
+	uint64_t resource;
+} unit_t;
+
+static const uint32_t PIPELINE[TPU_SIM_UNITS] = {
+	TPU_SIM_WEIGHT_PIPELINE,
+	TPU_SIM_MATRIX_PIPELINE,
+	TPU_SIM_ACTIVATION_PIPELINE
+};
+
+static int is_weight(instruction_t *instruction) {
+	return (instruction->op_code & 0xF8) == TPU_OP_READ_WEIGHTS;
+}
+
+/**
+ * Decodes the instruction like CONTROL_COORDINATOR.vhdl, returns TPU_SIM_UNITS for synchronize and nop.
+ */
+static tpu_sim_unit_t decode(instruction_t *instruction) {
+	uint8_t op_code = instruction->op_code;
+
+	if(op_code == TPU_OP_SYNCHRONIZE)		return TPU_SIM_UNITS;
+	if(op_code & TPU_OP_ACTIVATE)			return TPU_SIM_ACTIVATION;
+	if(op_code & TPU_OP_MATRIX_MULTIPLY)	return TPU_SIM_MATRIX;
+	if(op_code & TPU_OP_READ_WEIGHTS)		return TPU_SIM_WEIGHT;
+	return TPU_SIM_UNITS;
+}
+
+void tpu_sim_default_config(tpu_sim_config_t *config) {
+	config->host_interval = 0;
+	config->fifo_depth = TPU_INSTRUCTION_FIFO_DEPTH;
+}
+
+int32_t tpu_sim_run(tpu_sim_config_t *config, instruction_t *instructions, uint32_t count, tpu_sim_result_t *result, uint64_t *issue_cycles) {
+	if(config->fifo_depth == 0) return EFAULT;
+
+	memset(result, 0, sizeof(tpu_sim_result_t));
+
+	unit_t units[TPU_SIM_UNITS];
+	memset(units, 0, sizeof(units));
+
+	// Host side
+	uint32_t written = 0;
+	uint64_t next_write = 0;
+
+	// INSTRUCTION_FIFO
+	uint32_t fifo_head = 0;
+	uint32_t fifo_count = 0;
+
+	// LOOK_AHEAD_BUFFER and CONTROL_COORDINATOR registers
+	slot_t input_reg = {0, 0};
+	slot_t pipe_reg = {0, 0};
+	slot_t output_reg = {0, 0};
+	slot_t coordinator = {0, 0};
+
+	// RUNTIME_COUNTER
+	uint8_t runtime_state = 0;
+	uint64_t runtime_start = 0;
+
+	uint64_t idle = 0;
+	uint64_t cycle;
+
+	for(cycle = 0; ; ++cycle) {
+		uint8_t busy[TPU_SIM_UNITS];
+		uint8_t resource_busy = 0;
+		for(uint32_t u = 0; u < TPU_SIM_UNITS; ++u) {
+			busy[u] = units[u].running > 0;
+			resource_busy |= units[u].resource > 0;
+			if(busy[u]) result->busy_cycles[u]++;
+		}
+
+		// Coordinator - decide if the current instruction stalls
+		uint8_t stall = 0;
+		uint8_t synchronize = 0;
+		int32_t issue = -1;
+		if(coordinator.valid) {
+			instruction_t *instruction = &instructions[coordinator.index];
+			tpu_sim_unit_t unit = decode(instruction);
+
+			if(instruction->op_code == TPU_OP_SYNCHRONIZE) {
+				if(resource_busy) {
+					// Blame the unit, which is finished last
+					tpu_sim_unit_t last = TPU_SIM_WEIGHT;
+					for(uint32_t u = 1; u < TPU_SIM_UNITS; ++u) {
+						if(units[u].resource > units[last].resource) last = u;
+					}
+					result->stall_cycles[last]++;
+					stall = 1;
+				} else {
+					synchronize = 1;
+				}
+			} else if(unit == TPU_SIM_WEIGHT && busy[TPU_SIM_WEIGHT]) {
+				result->stall_cycles[TPU_SIM_WEIGHT]++;
+				stall = 1;
+			} else if((unit == TPU_SIM_MATRIX || unit == TPU_SIM_ACTIVATION) && busy[TPU_SIM_MATRIX]) {
+				// Activation waits for the matrix multiply to finish
+				result->stall_cycles[TPU_SIM_MATRIX]++;
+				stall = 1;
+			} else if(unit == TPU_SIM_ACTIVATION && busy[TPU_SIM_ACTIVATION]) {
+				result->stall_cycles[TPU_SIM_ACTIVATION]++;
+				stall = 1;
+			} else if(unit != TPU_SIM_UNITS) {
+				issue = unit;
+			}
+
+			if(!stall && issue_cycles != NULL) issue_cycles[coordinator.index] = cycle;
+		} else if(runtime_state) {
+			if(pipe_reg.valid && is_weight(&instructions[pipe_reg.index]) && !input_reg.valid) {
+				result->look_ahead_cycles++;
+			} else {
+				result->starve_cycles++;
+			}
+		}
+
+		// INSTRUCTION_FEED of TPU.vhdl
+		uint8_t feed = !stall && fifo_count > 0;
+		uint8_t full = fifo_count >= config->fifo_depth;
+
+		// RUNTIME_COUNTER
+		if(runtime_state) {
+			if(synchronize) {
+				runtime_state = 0;
+				result->runtime_cycles = (uint32_t)(cycle - runtime_start);
+			}
+		} else if(feed && !synchronize) {
+			runtime_state = 1;
+			runtime_start = cycle;
+		}
+		if(synchronize) result->synchronize_count++;
+
+		// Next state of the units
+		for(uint32_t u = 0; u < TPU_SIM_UNITS; ++u) {
+			if(units[u].running) units[u].running--;
+			if(units[u].resource) units[u].resource--;
+		}
+		if(issue >= 0) {
+			uint64_t length = get_calc_length(&instructions[coordinator.index]);
+			units[issue].running = length + TPU_SIM_LENGTH_DELAY;
+			units[issue].resource = length + TPU_SIM_LENGTH_DELAY + PIPELINE[issue];
+			result->issued_instructions++;
+		} else if(coordinator.valid && !stall) {
+			result->issued_instructions++;
+		}
+
+		// Next state of the front end, which is frozen while the coordinator stalls
+		if(!stall) {
+			coordinator = output_reg;
+
+			if(pipe_reg.valid && is_weight(&instructions[pipe_reg.index]) && !input_reg.valid) {
+				// Wait until the next instruction is feeded
+				output_reg.valid = 0;
+			} else {
+				output_reg = pipe_reg;
+				pipe_reg = input_reg;
+			}
+
+			input_reg.valid = feed;
+			input_reg.index = fifo_head;
+		}
+
+		if(feed) {
+			fifo_head++;
+			fifo_count--;
+		}
+
+		// Host writes are stalled by the AXI slave while the FIFO is full
+		if(written < count && cycle >= next_write && !full) {
+			written++;
+			fifo_count++;
+			next_write = cycle + config->host_interval;
+		}
+
+		uint8_t units_idle = 1;
+		for(uint32_t u = 0; u < TPU_SIM_UNITS; ++u) {
+			if(units[u].resource) units_idle = 0;
+		}
+
+		if(written == count && fifo_count == 0 && !coordinator.valid && !output_reg.valid && units_idle) {
+			// A weight instruction in the pipe register would never leave the look-ahead buffer
+			if(!input_reg.valid && (!pipe_reg.valid || is_weight(&instructions[pipe_reg.index]))) {
+				break;
+			}
+		}
+
+		idle = (feed || issue >= 0 || synchronize || resource_busy) ? 0 : idle + 1;
+		if(idle > IDLE_LIMIT + config->host_interval) break;
+	}
+
+	result->cycles = cycle + 1;
+	if(runtime_state) {
+		// No synchronize at the end of the program
+		result->runtime_cycles = (uint32_t)(cycle + 1 - runtime_start);
+	}
+
+	return 0;
+}
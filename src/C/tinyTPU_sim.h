@@ -0,0 +1,76 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_sim.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_SIM_H_
+#define SRC_TINYTPU_SIM_H_
+
+#include "tinyTPU_access.h"
+#include <stdint.h>
+
+// Additional cycles the resources of a unit are in use after it isn't busy anymore
+#define TPU_SIM_WEIGHT_PIPELINE		3
+#define TPU_SIM_MATRIX_PIPELINE		(TPU_VECTOR_SIZE+2+3)
+#define TPU_SIM_ACTIVATION_PIPELINE	(3+TPU_VECTOR_SIZE+2+7+3)
+// Cycles a control unit stays busy in addition to the calculation length (DSP_COUNTER event delay)
+#define TPU_SIM_LENGTH_DELAY		3
+
+typedef enum tpu_sim_unit {
+	TPU_SIM_WEIGHT = 0,
+	TPU_SIM_MATRIX,
+	TPU_SIM_ACTIVATION,
+	TPU_SIM_UNITS
+} tpu_sim_unit_t;
+
+typedef struct tpu_sim_config {
+	// Cycles between two instructions written by the host, 0 if the host is always faster than the TPU
+	uint32_t host_interval;
+	uint32_t fifo_depth;
+} tpu_sim_config_t;
+
+typedef struct tpu_sim_result {
+	// Simulated cycles until all instructions were issued and all units finished
+	uint64_t cycles;
+	// The value RUNTIME_COUNTER holds after the last synchronize
+	uint32_t runtime_cycles;
+	uint32_t synchronize_count;
+	// Cycles each control unit was busy
+	uint64_t busy_cycles[TPU_SIM_UNITS];
+	// Cycles CONTROL_COORDINATOR stalled, sorted by the unit it waited for
+	uint64_t stall_cycles[TPU_SIM_UNITS];
+	// Cycles the coordinator had no instruction, because the FIFO ran empty
+	uint64_t starve_cycles;
+	// Cycles the coordinator had no instruction, because a weight instruction waited in the look-ahead buffer
+	uint64_t look_ahead_cycles;
+	uint64_t issued_instructions;
+} tpu_sim_result_t;
+
+void tpu_sim_default_config(tpu_sim_config_t *config);
+
+int32_t tpu_sim_run(tpu_sim_config_t *config, instruction_t *instructions, uint32_t count, tpu_sim_result_t *result, uint64_t *issue_cycles);
+
+#endif /* SRC_TINYTPU_SIM_H_ */
@@ -0,0 +1,382 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_trace.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_trace.h"
+#include "tinyTPU_sim.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stddef.h>
+
+static const char *track_names[TPU_TRACE_TRACKS] = {"host", "device", "weight", "matrix", "activation"};
+
+static uint64_t trace_now(tpu_trace_t *trace) {
+	return trace->clock(trace->clock_context) - trace->origin;
+}
+
+static uint64_t cycles_to_ns(uint64_t cycles) {
+	return (uint64_t)(cycles*(double)TPU_CLOCK_CYCLE);
+}
+
+/**
+ * Forwards instructions to the sink and copies them for the simulation of the stage.
+ */
+static int32_t forward(tpu_trace_t *trace, instruction_t *instructions, uint32_t count) {
+	if(count == 0) return 0;
+
+	if(!trace->submitted) {
+		trace->stage_start = trace_now(trace);
+		trace->submitted = 1;
+	}
+
+	for(uint32_t i = 0; i < count; ++i) {
+		if(trace->stage_count < TPU_TRACE_STAGE) trace->stage_instructions[trace->stage_count] = instructions[i];
+		// Stages, which don't fit, are counted beyond the capacity and not simulated
+		if(trace->stage_count <= TPU_TRACE_STAGE) trace->stage_count++;
+	}
+
+	if(trace->sink->instructions == NULL) return 0;
+	return trace->sink->instructions(trace->sink->context, instructions, count);
+}
+
+static int32_t flush_held(tpu_trace_t *trace) {
+	int32_t error = forward(trace, trace->held, trace->held_count);
+	trace->held_count = 0;
+	return error;
+}
+
+/**
+ * Adds the simulated spans of the instructions of the stage to the unit tracks.
+ */
+static void add_units(tpu_trace_t *trace) {
+	for(uint32_t i = 0; i < trace->stage_count; ++i) {
+		instruction_t *instruction = &trace->stage_instructions[i];
+		uint8_t op_code = instruction->op_code;
+		tpu_trace_track_t track;
+		const char *name;
+
+		if(op_code == TPU_OP_SYNCHRONIZE) {
+			continue;
+		} else if(op_code & TPU_OP_ACTIVATE) {
+			track = TPU_TRACE_ACTIVATION;
+			name = "activate";
+		} else if(op_code & TPU_OP_MATRIX_MULTIPLY) {
+			track = TPU_TRACE_MATRIX;
+			name = "multiply";
+		} else if(op_code & TPU_OP_READ_WEIGHTS) {
+			track = TPU_TRACE_WEIGHT;
+			name = "weights";
+		} else {
+			continue;
+		}
+
+		uint64_t duration = get_calc_length(instruction) + TPU_SIM_LENGTH_DELAY;
+		tpu_trace_add(trace, track, name, trace->stage_start + cycles_to_ns(trace->issue_cycles[i]), cycles_to_ns(duration));
+	}
+}
+
+/**
+ * Ends the stage, which is submitted. Waits for it and records its span on the device track.
+ */
+static int32_t end_stage(tpu_trace_t *trace, uint8_t synchronize) {
+	if(!trace->submitted) return 0;
+
+	if(synchronize) {
+		instruction_t instruction;
+		set_instruction(&instruction, TPU_OP_SYNCHRONIZE, 0, 0, 0);
+		int32_t error = forward(trace, &instruction, 1);
+		if(error) return error;
+	}
+
+	if(trace->fences != NULL) tpu_fence_wait(trace->fences, trace->fences->issued, trace->idle, trace->idle_context);
+	uint64_t end = trace_now(trace);
+
+	tpu_sim_config_t config;
+	tpu_sim_result_t result;
+	tpu_sim_default_config(&config);
+	uint8_t simulated = trace->stage_count <= TPU_TRACE_STAGE
+		&& !tpu_sim_run(&config, trace->stage_instructions, trace->stage_count, &result, trace->issue_cycles);
+
+	uint32_t runtime_cycles;
+	uint64_t duration = end - trace->stage_start;
+	if(trace->runtime != NULL && !trace->runtime(&runtime_cycles)) {
+		duration = cycles_to_ns(runtime_cycles);
+	} else if(simulated) {
+		duration = cycles_to_ns(result.cycles);
+	}
+
+	char name[TPU_TRACE_NAME_SIZE];
+	switch(trace->granularity) {
+		case TPU_TRACE_LAYER:
+			snprintf(name, sizeof(name), "layer %u", trace->layer);
+			break;
+		case TPU_TRACE_TILE:
+			snprintf(name, sizeof(name), "tile %u", trace->stage);
+			break;
+		default:
+			snprintf(name, sizeof(name), "%s %u", trace->stage_class == TPU_OP_ACTIVATE ? "activate" : "multiply", trace->stage);
+			break;
+	}
+	tpu_trace_add(trace, TPU_TRACE_DEVICE, name, trace->stage_start, duration);
+	if(simulated) add_units(trace);
+
+	trace->stage++;
+	trace->submitted = 0;
+	trace->stage_class = 0;
+	trace->stage_count = 0;
+	return 0;
+}
+
+static void reset_section(tpu_trace_t *trace) {
+	trace->stage = 0;
+	trace->layer = 0;
+	trace->submitted = 0;
+	trace->stage_class = 0;
+	trace->overflow = 0;
+	trace->output_start = 0;
+	trace->output_end = 0;
+	trace->held_count = 0;
+	trace->stage_count = 0;
+}
+
+static int32_t trace_activate(tpu_trace_t *trace, instruction_t *instruction) {
+	int32_t error = 0;
+	if(trace->granularity == TPU_TRACE_CLASS && trace->stage_class == TPU_OP_MATRIX_MULTIPLY) error = end_stage(trace, 1);
+	if(!error) error = flush_held(trace);
+	if(!error) error = forward(trace, instruction, 1);
+	if(error) return error;
+
+	uint32_t start = get_buf_address(instruction);
+	uint32_t end = start + get_calc_length(instruction);
+	if(trace->output_start == trace->output_end) {
+		trace->output_start = start;
+		trace->output_end = end;
+	} else {
+		if(start < trace->output_start) trace->output_start = start;
+		if(end > trace->output_end) trace->output_end = end;
+	}
+	trace->stage_class = TPU_OP_ACTIVATE;
+
+	if(trace->granularity == TPU_TRACE_TILE) return end_stage(trace, 1);
+	return 0;
+}
+
+static int32_t trace_multiply(tpu_trace_t *trace, instruction_t *instruction) {
+	uint32_t start = get_buf_address(instruction);
+	uint32_t end = start + get_calc_length(instruction);
+	uint8_t boundary = 0;
+
+	if(trace->granularity == TPU_TRACE_LAYER) {
+		// The multiply reads activations of the stage before
+		boundary = trace->output_start != trace->output_end && start < trace->output_end && end > trace->output_start;
+	} else if(trace->granularity == TPU_TRACE_CLASS) {
+		boundary = trace->stage_class == TPU_OP_ACTIVATE;
+	}
+
+	int32_t error = 0;
+	if(boundary && !trace->overflow) {
+		// The weight loads of the multiply follow the synchronize
+		error = end_stage(trace, 1);
+		trace->layer++;
+		trace->output_start = 0;
+		trace->output_end = 0;
+	}
+	if(!error) error = flush_held(trace);
+	if(!error) error = forward(trace, instruction, 1);
+
+	trace->overflow = 0;
+	trace->stage_class = TPU_OP_MATRIX_MULTIPLY;
+	return error;
+}
+
+static int32_t trace_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	tpu_trace_t *trace = (tpu_trace_t*)context;
+
+	for(uint32_t i = 0; i < count; ++i) {
+		instruction_t *instruction = &instructions[i];
+		uint8_t op_code = instruction->op_code;
+		int32_t error;
+
+		if(op_code == TPU_OP_SYNCHRONIZE) {
+			error = flush_held(trace);
+			if(!error) error = forward(trace, instruction, 1);
+			if(!error) error = end_stage(trace, 0);
+		} else if(op_code & TPU_OP_ACTIVATE) {
+			error = trace_activate(trace, instruction);
+		} else if(op_code & TPU_OP_MATRIX_MULTIPLY) {
+			error = trace_multiply(trace, instruction);
+		} else {
+			// Weight loads are held until their multiply, so no synchronize is inserted between them
+			error = 0;
+			if(trace->held_count == TPU_TRACE_HELD) {
+				error = flush_held(trace);
+				trace->overflow = 1;
+			}
+			trace->held[trace->held_count++] = *instruction;
+		}
+		if(error) return error;
+	}
+
+	return 0;
+}
+
+static int32_t trace_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	tpu_trace_t *trace = (tpu_trace_t*)context;
+	if(trace->sink->weights == NULL) return 0;
+
+	uint64_t start = trace_now(trace);
+	int32_t error = trace->sink->weights(trace->sink->context, vectors, address, count);
+	tpu_trace_add(trace, TPU_TRACE_HOST, "weights", start, trace_now(trace) - start);
+	return error;
+}
+
+static int32_t trace_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	tpu_trace_t *trace = (tpu_trace_t*)context;
+	if(trace->sink->inputs == NULL) return 0;
+
+	uint64_t start = trace_now(trace);
+	int32_t error = trace->sink->inputs(trace->sink->context, vectors, address, count);
+	tpu_trace_add(trace, TPU_TRACE_HOST, "inputs", start, trace_now(trace) - start);
+	return error;
+}
+
+static int32_t trace_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	tpu_trace_t *trace = (tpu_trace_t*)context;
+	if(trace->sink->results == NULL) return 0;
+
+	uint64_t start = trace_now(trace);
+	int32_t error = trace->sink->results(trace->sink->context, results, count);
+	tpu_trace_add(trace, TPU_TRACE_HOST, "results", start, trace_now(trace) - start);
+	return error;
+}
+
+static int32_t trace_section_end(void *context, tpu_section_type_t type) {
+	tpu_trace_t *trace = (tpu_trace_t*)context;
+
+	if(type == TPU_SECTION_INSTRUCTIONS) {
+		int32_t error = flush_held(trace);
+		if(!error) error = end_stage(trace, 1);
+		reset_section(trace);
+		if(error) return error;
+	}
+
+	if(trace->sink->section_end == NULL) return 0;
+	return trace->sink->section_end(trace->sink->context, type);
+}
+
+/**
+ * Initializes an empty trace. Times are taken relative to this call.
+ */
+void tpu_trace_init(tpu_trace_t *trace, tpu_trace_granularity_t granularity, tpu_trace_clock_t clock, void *clock_context, tpu_trace_runtime_t runtime) {
+	trace->sink = NULL;
+	trace->fences = NULL;
+	trace->idle = NULL;
+	trace->idle_context = NULL;
+	trace->clock = clock;
+	trace->clock_context = clock_context;
+	trace->runtime = runtime;
+	trace->granularity = granularity;
+	trace->origin = clock(clock_context);
+	trace->event_count = 0;
+	trace->dropped = 0;
+	reset_section(trace);
+}
+
+/**
+ * Starts tracing a program, which is executed by the sink. Events of earlier programs are kept.
+ */
+void tpu_trace_begin(tpu_trace_t *trace, tpu_bundle_handler_t *sink, tpu_fences_t *fences, tpu_fence_idle_t idle, void *idle_context) {
+	trace->sink = sink;
+	trace->fences = fences;
+	trace->idle = idle;
+	trace->idle_context = idle_context;
+	reset_section(trace);
+}
+
+/**
+ * Fills a handler, which executes a program through the trace.
+ */
+void tpu_trace_handler(tpu_trace_t *trace, tpu_bundle_handler_t *handler) {
+	handler->context = trace;
+	handler->weights = trace_weights;
+	handler->inputs = trace_inputs;
+	handler->instructions = trace_instructions;
+	handler->results = trace_results;
+	handler->section_end = trace_section_end;
+}
+
+/**
+ * Records a span. Events, which don't fit into the trace, are counted as dropped.
+ */
+void tpu_trace_add(tpu_trace_t *trace, tpu_trace_track_t track, const char *name, uint64_t start, uint64_t duration) {
+	if(trace->event_count == TPU_TRACE_EVENTS) {
+		trace->dropped++;
+		return;
+	}
+
+	tpu_trace_event_t *event = &trace->events[trace->event_count++];
+	uint32_t i;
+	for(i = 0; i < TPU_TRACE_NAME_SIZE-1 && name[i]; ++i) {
+		// Names aren't escaped in the JSON
+		event->name[i] = name[i] == '"' || name[i] == '\\' ? '\'' : name[i];
+	}
+	event->name[i] = 0;
+	event->track = track;
+	event->start = start;
+	event->duration = duration;
+}
+
+/**
+ * Writes the trace in the Chrome trace event format (chrome://tracing, Perfetto).
+ */
+int32_t tpu_trace_write(tpu_trace_t *trace, tpu_trace_write_t write, void *context) {
+	char line[128];
+	int length;
+	int32_t error = 0;
+
+	length = snprintf(line, sizeof(line), "{\"otherData\":{\"dropped\":%u},\"traceEvents\":[\n", trace->dropped);
+	error = write(context, line, length);
+
+	for(uint32_t i = 0; i < TPU_TRACE_TRACKS && !error; ++i) {
+		length = snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+				i ? ",\n" : "", i, track_names[i]);
+		error = write(context, line, length);
+	}
+
+	for(uint32_t i = 0; i < trace->event_count && !error; ++i) {
+		tpu_trace_event_t *event = &trace->events[i];
+		// Microseconds with nanosecond precision, without floating point
+		length = snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%llu.%03u,\"dur\":%llu.%03u}",
+				event->name, event->track,
+				(unsigned long long)(event->start/1000), (uint32_t)(event->start%1000),
+				(unsigned long long)(event->duration/1000), (uint32_t)(event->duration%1000));
+		error = write(context, line, length);
+	}
+
+	if(!error) error = write(context, "\n]}\n", 4);
+	return error;
+}
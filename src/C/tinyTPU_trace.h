@@ -0,0 +1,132 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_trace.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_TRACE_H_
+#define SRC_TINYTPU_TRACE_H_
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_bundle.h"
+#include "tinyTPU_fence.h"
+#include <stdint.h>
+
+/*
+ * Profiling of programs as Chrome trace events.
+ *
+ * The trace is a bundle handler, which forwards to the sink handler and records spans on a timeline:
+ * - host: the time the sink took for weights, inputs and results
+ * - device: stages of the program, which are ended by a synchronize, measured by RUNTIME_COUNTER
+ * - weight, matrix, activation: the instructions of every stage, as simulated by tinyTPU_sim
+ *
+ * Stages end at every synchronize of the program and at the boundaries of the granularity, where a synchronize is inserted:
+ * - layer: before a multiply, which reads the activations of the stage before
+ * - tile: after the activations of a column tile
+ * - class: where multiplies and activations alternate
+ * Weight loads stay in the stage of their multiply. The sink has to issue the fences of the synchronize instructions it writes.
+ * The trace waits for every stage, so stages don't overlap, which makes the program slower than without profiling.
+ */
+#define TPU_TRACE_EVENTS 4096
+#define TPU_TRACE_NAME_SIZE 24
+// Weight loads, which wait for their multiply
+#define TPU_TRACE_HELD 16
+// Instructions of a stage, which are simulated
+#define TPU_TRACE_STAGE 1024
+
+typedef enum tpu_trace_granularity {
+	TPU_TRACE_LAYER = 0,
+	TPU_TRACE_TILE,
+	TPU_TRACE_CLASS
+} tpu_trace_granularity_t;
+
+typedef enum tpu_trace_track {
+	TPU_TRACE_HOST = 0,
+	TPU_TRACE_DEVICE,
+	TPU_TRACE_WEIGHT,
+	TPU_TRACE_MATRIX,
+	TPU_TRACE_ACTIVATION,
+	TPU_TRACE_TRACKS
+} tpu_trace_track_t;
+
+// Host time in nanoseconds
+typedef uint64_t (*tpu_trace_clock_t)(void *context);
+// Cycles of the last calculation, e.g. read_runtime
+typedef int32_t (*tpu_trace_runtime_t)(uint32_t *runtime_cycles);
+typedef int32_t (*tpu_trace_write_t)(void *context, const char *data, uint32_t length);
+
+typedef struct tpu_trace_event {
+	char name[TPU_TRACE_NAME_SIZE];
+	uint8_t track;
+	// Nanoseconds since the trace was initialized
+	uint64_t start;
+	uint64_t duration;
+} tpu_trace_event_t;
+
+typedef struct tpu_trace {
+	tpu_bundle_handler_t *sink;
+	// Fences of the sink, NULL if the sink calculates the instructions, before it returns
+	tpu_fences_t *fences;
+	tpu_fence_idle_t idle;
+	void *idle_context;
+	tpu_trace_clock_t clock;
+	void *clock_context;
+	// NULL to take the simulated cycles
+	tpu_trace_runtime_t runtime;
+	tpu_trace_granularity_t granularity;
+	uint64_t origin;
+	// Stage, which is submitted, counted within the instruction section
+	uint32_t stage;
+	uint32_t layer;
+	uint8_t submitted;
+	// Class of the last instruction of the stage, TPU_OP_MATRIX_MULTIPLY or TPU_OP_ACTIVATE
+	uint8_t stage_class;
+	// Held instructions overflowed, so no boundary is inserted before the next multiply
+	uint8_t overflow;
+	uint64_t stage_start;
+	// Unified buffer range written by the activations since the last layer boundary
+	uint32_t output_start;
+	uint32_t output_end;
+	uint32_t held_count;
+	instruction_t held[TPU_TRACE_HELD];
+	uint32_t stage_count;
+	instruction_t stage_instructions[TPU_TRACE_STAGE];
+	uint64_t issue_cycles[TPU_TRACE_STAGE];
+	uint32_t event_count;
+	uint32_t dropped;
+	tpu_trace_event_t events[TPU_TRACE_EVENTS];
+} tpu_trace_t;
+
+void tpu_trace_init(tpu_trace_t *trace, tpu_trace_granularity_t granularity, tpu_trace_clock_t clock, void *clock_context, tpu_trace_runtime_t runtime);
+
+void tpu_trace_begin(tpu_trace_t *trace, tpu_bundle_handler_t *sink, tpu_fences_t *fences, tpu_fence_idle_t idle, void *idle_context);
+
+void tpu_trace_handler(tpu_trace_t *trace, tpu_bundle_handler_t *handler);
+
+void tpu_trace_add(tpu_trace_t *trace, tpu_trace_track_t track, const char *name, uint64_t start, uint64_t duration);
+
+int32_t tpu_trace_write(tpu_trace_t *trace, tpu_trace_write_t write, void *context);
+
+#endif /* SRC_TINYTPU_TRACE_H_ */
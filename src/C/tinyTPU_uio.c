@@ -0,0 +1,205 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_uio.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_uio.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+
+/**
+ * Reads the interrupts a UIO device counted so far from sysfs.
+ */
+static int32_t read_event_count(const char *path, uint32_t *events) {
+	const char *name = strrchr(path, '/');
+	char sysfs_path[128];
+	snprintf(sysfs_path, sizeof(sysfs_path), "/sys/class/uio/%s/event", name != NULL ? name+1 : path);
+
+	FILE *file = fopen(sysfs_path, "r");
+	if(file == NULL) return EIO;
+	int32_t error = fscanf(file, "%u", events) == 1 ? 0 : EIO;
+	fclose(file);
+	return error;
+}
+
+static int32_t enable_interrupt(tpu_uio_t *uio) {
+	uint32_t enable = 1;
+	return write(uio->event_fd, &enable, sizeof(enable)) == sizeof(enable) ? 0 : EIO;
+}
+
+static int32_t map(tpu_uio_t *uio, off_t offset) {
+	uio->mapping = mmap(NULL, TPU_UIO_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, uio->fd, offset);
+	if(uio->mapping == MAP_FAILED) return EIO;
+
+	pthread_mutex_init(&uio->mutex, NULL);
+	tpu_device_init(&uio->device, (uintptr_t)uio->mapping);
+	return 0;
+}
+
+/**
+ * Opens a UIO device like /dev/uio0, which maps the AXI slave and delivers the synchronize interrupt.
+ */
+int32_t tpu_uio_open(tpu_uio_t *uio, const char *path) {
+	uio->fd = open(path, O_RDWR | O_CLOEXEC);
+	if(uio->fd < 0) return EIO;
+
+	uio->event_fd = uio->fd;
+	uio->is_uio = 1;
+	uio->events = 0;
+
+	int32_t error = read_event_count(path, &uio->events);
+	if(!error) error = enable_interrupt(uio);
+	if(!error) error = map(uio, 0);
+	if(error) close(uio->fd);
+	return error;
+}
+
+/**
+ * Maps the AXI slave from /dev/mem at its physical address, or a file at offset 0, which stands in for it.
+ * Interrupts are read from event_fd, e.g. an eventfd, which is closed with the backend. Without an event_fd
+ * (-1), fences can't be waited for.
+ */
+int32_t tpu_uio_open_map(tpu_uio_t *uio, const char *path, off_t offset, int event_fd) {
+	uio->fd = open(path, O_RDWR | O_SYNC | O_CLOEXEC);
+	if(uio->fd < 0) return EIO;
+
+	uio->event_fd = event_fd;
+	uio->is_uio = 0;
+	uio->events = 0;
+
+	int32_t error = map(uio, offset);
+	if(error) close(uio->fd);
+	return error;
+}
+
+void tpu_uio_close(tpu_uio_t *uio) {
+	if(tpu_base == (uintptr_t)uio->mapping) tpu_base = TPU_BASE;
+
+	munmap(uio->mapping, TPU_UIO_MAP_SIZE);
+	pthread_mutex_destroy(&uio->mutex);
+	if(uio->event_fd >= 0 && uio->event_fd != uio->fd) close(uio->event_fd);
+	close(uio->fd);
+}
+
+/**
+ * Lets the functions of tinyTPU_access.h address the mapping of the backend.
+ */
+void tpu_uio_select(tpu_uio_t *uio) {
+	tpu_base = (uintptr_t)uio->mapping;
+}
+
+/**
+ * Reads pending interrupts without blocking. Interrupts may coalesce, so they only wake the waiting thread up.
+ */
+static int32_t read_interrupts(tpu_uio_t *uio) {
+	if(uio->is_uio) {
+		uint32_t events;
+		if(read(uio->event_fd, &events, sizeof(events)) != sizeof(events)) return EIO;
+		uio->events = events;
+		return enable_interrupt(uio);
+	}
+
+	uint64_t events;
+	if(read(uio->event_fd, &events, sizeof(events)) != sizeof(events)) return EIO;
+	return 0;
+}
+
+/**
+ * Waits up to timeout milliseconds (-1 without a timeout) for an interrupt and signals the fences of the device
+ * with the synchronize count of the TPU. Returns EAGAIN, if no interrupt arrived.
+ */
+int32_t tpu_uio_wait_interrupt(tpu_uio_t *uio, int timeout) {
+	if(uio->event_fd < 0) return EINVAL;
+
+	struct pollfd descriptor = {uio->event_fd, POLLIN, 0};
+	int ready;
+	do {
+		ready = poll(&descriptor, 1, timeout);
+	} while(ready < 0 && errno == EINTR);
+
+	if(ready < 0) return EIO;
+	if(ready == 0) return EAGAIN;
+
+	int32_t error = read_interrupts(uio);
+	if(error) return error;
+
+	uint32_t synchronize_count;
+	tpu_device_read_synchronize_count(&uio->device, &synchronize_count);
+	tpu_fence_signal(&uio->device.fences, synchronize_count);
+	return 0;
+}
+
+/**
+ * Idle function for tpu_fence_wait, which sleeps until the next interrupt.
+ */
+void tpu_uio_idle(void *context) {
+	tpu_uio_wait_interrupt((tpu_uio_t*)context, -1);
+}
+
+/**
+ * Waits for a fence of the device.
+ */
+void tpu_uio_wait(tpu_uio_t *uio, tpu_fence_t fence) {
+	tpu_fence_wait(&uio->device.fences, fence, tpu_uio_idle, uio);
+}
+
+/**
+ * Takes the TPU for the calling thread and process. Interrupts, which arrived before, belong to the previous holder
+ * and are discarded. The fences continue at the synchronize count of the previous holder.
+ * The holder has to wait for all its fences before tpu_uio_unlock.
+ */
+int32_t tpu_uio_lock(tpu_uio_t *uio) {
+	pthread_mutex_lock(&uio->mutex);
+	if(flock(uio->fd, LOCK_EX)) {
+		pthread_mutex_unlock(&uio->mutex);
+		return EIO;
+	}
+
+	struct pollfd descriptor = {uio->event_fd, POLLIN, 0};
+	while(uio->event_fd >= 0 && poll(&descriptor, 1, 0) == 1) {
+		if(read_interrupts(uio)) break;
+	}
+
+	uint32_t synchronize_count;
+	tpu_device_read_synchronize_count(&uio->device, &synchronize_count);
+	uio->device.fences.issued = synchronize_count;
+	uio->device.fences.completed = synchronize_count;
+	return 0;
+}
+
+void tpu_uio_unlock(tpu_uio_t *uio) {
+	flock(uio->fd, LOCK_UN);
+	pthread_mutex_unlock(&uio->mutex);
+}
+#endif
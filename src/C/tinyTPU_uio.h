@@ -0,0 +1,91 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * tinyTPU_uio.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#ifndef SRC_TINYTPU_UIO_H_
+#define SRC_TINYTPU_UIO_H_
+
+#ifdef __linux__
+#include "tinyTPU_access.h"
+#include "tinyTPU_device.h"
+#include "tinyTPU_fence.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <pthread.h>
+
+/*
+ * Userspace backend for Linux.
+ *
+ * The AXI slave is mapped through a UIO device (uio_pdrv_genirq, map 0), /dev/mem or a file, which stands in for the
+ * hardware. The synchronize interrupt is waited for by reading a file descriptor: the UIO device itself, or any
+ * descriptor, which delivers a 64 Bit counter like an eventfd. Interrupts may coalesce, so they only wake the waiting
+ * thread up, which signals the fences of the device with the synchronize count of the TPU.
+ *
+ * The device of the backend addresses the mapping. tpu_uio_select points the functions of tinyTPU_access.h to the
+ * mapping as well, so code for bare metal runs unchanged.
+ *
+ * Processes and threads share the TPU by holding tpu_uio_lock, while they submit work, until their last fence is done.
+ * Interrupts of other processes, which arrived before, are discarded, when the lock is taken.
+ */
+// Covers all address windows of a tinyTPU_v1_0 AXI slave
+#define TPU_UIO_MAP_SIZE (TPU_INSTRUCTION_OFFSET + 0x10000)
+
+typedef struct tpu_uio {
+	// Mapped file
+	int fd;
+	// Delivers the interrupts, -1 if there are none
+	int event_fd;
+	// The event descriptor is a UIO device, which counts interrupts with 32 Bit and needs to be reenabled
+	uint8_t is_uio;
+	// Interrupts the UIO device counted so far
+	uint32_t events;
+	void *mapping;
+	pthread_mutex_t mutex;
+	tpu_device_t device;
+} tpu_uio_t;
+
+int32_t tpu_uio_open(tpu_uio_t *uio, const char *path);
+
+int32_t tpu_uio_open_map(tpu_uio_t *uio, const char *path, off_t offset, int event_fd);
+
+void tpu_uio_close(tpu_uio_t *uio);
+
+void tpu_uio_select(tpu_uio_t *uio);
+
+int32_t tpu_uio_wait_interrupt(tpu_uio_t *uio, int timeout);
+
+void tpu_uio_idle(void *context);
+
+void tpu_uio_wait(tpu_uio_t *uio, tpu_fence_t fence);
+
+int32_t tpu_uio_lock(tpu_uio_t *uio);
+
+void tpu_uio_unlock(tpu_uio_t *uio);
+#endif
+
+#endif /* SRC_TINYTPU_UIO_H_ */
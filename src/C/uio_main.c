@@ -0,0 +1,450 @@
+// Copyright 2018 Jonas Fuhrmann. All rights reserved.
+//
+// This project is dual licensed under GNU General Public License version 3
+// and a commercial license available on request.
+//-------------------------------------------------------------------------
+// For non commercial use only:
+// This file is part of tinyTPU.
+// 
+// tinyTPU is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// tinyTPU is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * uio_main.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: Jonas Fuhrmann
+ */
+
+#include "tinyTPU_access.h"
+#include "tinyTPU_bundle.h"
+#include "tinyTPU_parser.h"
+#include "tinyTPU_queue.h"
+#include "tinyTPU_uio.h"
+#include "tinyTPU_result.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#define RESULT_FILE_NAME "results.csv"
+// Records of all other formats
+#define RESULT_BINARY_FILE_NAME "results.bin"
+
+#ifdef UIO
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+
+#define SEED 176
+// Processes and threads per process of the sharing test
+#define TEST_PROCESSES	4
+#define TEST_THREADS	2
+#define TEST_ROUNDS		50
+#define TEST_VECTORS	64
+
+typedef struct uio_context {
+	tpu_uio_t *uio;
+	tpu_queue_t *queue;
+	tpu_result_t *result;
+	FILE *result_file;
+} uio_context_t;
+
+static int32_t uio_weights(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	return tpu_device_write_weights(&((uio_context_t*)context)->uio->device, vectors, address, count);
+}
+
+static int32_t uio_inputs(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	return tpu_device_write_inputs(&((uio_context_t*)context)->uio->device, vectors, address, count);
+}
+
+static int32_t uio_instructions(void *context, instruction_t *instructions, uint32_t count) {
+	uio_context_t *uio_context = (uio_context_t*)context;
+	tpu_fence_scan(&uio_context->uio->device.fences, instructions, count);
+	while(count) {
+		uint32_t pushed = tpu_queue_push(uio_context->queue, instructions, count);
+		instructions += pushed;
+		count -= pushed;
+	}
+	return 0;
+}
+
+static int32_t uio_results(void *context, tpu_bundle_result_t *results, uint32_t count) {
+	return tpu_result_store(((uio_context_t*)context)->result, results, count);
+}
+
+static int32_t read_results(void *context, tpu_vector_t *vectors, uint32_t address, uint32_t count) {
+	return tpu_device_read_outputs(&((tpu_uio_t*)context)->device, vectors, address, count);
+}
+
+static int32_t write_result_file(void *context, const char *data, uint32_t length) {
+	return fwrite(data, 1, length, (FILE*)context) == length ? 0 : EIO;
+}
+
+static int32_t rewind_result_file(void *context) {
+	return fseek((FILE*)context, 0, SEEK_SET) ? EIO : 0;
+}
+
+/**
+ * Writes queued instructions, sleeps until the next interrupt, when there are none.
+ */
+static void drain_queue(void *context) {
+	uio_context_t *uio_context = (uio_context_t*)context;
+	if(tpu_queue_pending(uio_context->queue)) {
+		tpu_queue_drain(uio_context->queue);
+		tpu_uio_wait_interrupt(uio_context->uio, 0);
+	} else {
+		tpu_uio_wait_interrupt(uio_context->uio, -1);
+	}
+}
+
+static int32_t uio_section_end(void *context, tpu_section_type_t type) {
+	uio_context_t *uio_context = (uio_context_t*)context;
+	tpu_device_t *device = &uio_context->uio->device;
+
+	if(type == TPU_SECTION_INSTRUCTIONS) {
+		tpu_fence_wait(&device->fences, device->fences.issued, drain_queue, uio_context);
+		uint32_t cycles;
+		tpu_device_read_runtime(device, &cycles);
+		printf("Calculations took %u cycles/%f nanoseconds to complete.\n", cycles, cycles*TPU_CLOCK_CYCLE);
+		tpu_perf_counters_t counters;
+		if(!tpu_device_read_perf_counters(device, &counters)) {
+			printf("Busy cycles: weights %u, matrix %u, activation %u. Stalled %u cycles, %u for synchronize. Instruction FIFO empty for %u cycles.\n",
+				counters.weight_busy, counters.matrix_busy, counters.activation_busy, counters.stall, counters.resource_stall, counters.fifo_empty);
+			printf("Dispatched instructions: weights %u, matrix %u, activation %u.\n", counters.weight_instructions, counters.matrix_instructions, counters.activation_instructions);
+		}
+	} else if(type == TPU_SECTION_RESULTS) {
+		if(tpu_result_flush(uio_context->result)) printf("Error writing results!\n");
+		fflush(uio_context->result_file);
+		if(ftruncate(fileno(uio_context->result_file), ftell(uio_context->result_file))) {
+			printf("Error truncating file!\n");
+		}
+	}
+	return 0;
+}
+
+static int32_t read_file(void *source, void *buffer, uint32_t size, uint32_t *bytes_read) {
+	*bytes_read = fread(buffer, 1, size, (FILE*)source);
+	return ferror((FILE*)source) ? EIO : 0;
+}
+
+/**
+ * Runs a program file of transfer_complete_model.py or a bundle of transfer_bundle.py on the TPU of a UIO device.
+ */
+static int run_program(const char *device_name, const char *program_name, tpu_result_t *result) {
+	static tpu_uio_t uio;
+	static tpu_parser_t parser;
+
+	FILE *file = fopen(program_name, "r");
+	if(file == NULL) {
+		printf("Error opening file %s!\n", program_name);
+		return 1;
+	}
+
+	const char *result_file_name = result->format == TPU_RESULT_CSV ? RESULT_FILE_NAME : RESULT_BINARY_FILE_NAME;
+	FILE *result_file = fopen(result_file_name, "w+");
+	if(result_file == NULL) {
+		printf("Error creating file %s!\n", result_file_name);
+		fclose(file);
+		return 1;
+	}
+
+	if(tpu_uio_open(&uio, device_name)) {
+		printf("Error opening UIO device %s!\n", device_name);
+		fclose(result_file);
+		fclose(file);
+		return 1;
+	}
+	tpu_uio_select(&uio);
+	result->read_context = &uio;
+	tpu_result_begin(result, write_result_file, rewind_result_file, result_file);
+
+	uio_context_t context = {&uio, &uio.device.queue, result, result_file};
+	tpu_bundle_handler_t handler = {
+		.context = &context,
+		.weights = uio_weights,
+		.inputs = uio_inputs,
+		.instructions = uio_instructions,
+		.results = uio_results,
+		.section_end = uio_section_end
+	};
+
+	// The queue has to start from the instruction count of an idle TPU
+	int32_t error = tpu_uio_lock(&uio);
+	if(!error) error = tpu_queue_init(&uio.device.queue, uio.device.base);
+	if(error) {
+		printf("Error taking the TPU!\n");
+	} else {
+		uint32_t magic;
+		uint8_t bundle = fread(&magic, sizeof(magic), 1, file) == 1 && magic == TPU_BUNDLE_MAGIC;
+		rewind(file);
+
+		if(bundle) {
+			error = tpu_bundle_map_file(program_name, &handler);
+			if(error) printf("Error loading bundle with error code %d!\n", error);
+		} else {
+			tpu_parser_init(&parser, &handler);
+			error = tpu_parser_stream(&parser, read_file, file);
+			if(error) printf("Error in line %u with error code %d!\n", parser.line, error);
+		}
+		tpu_uio_unlock(&uio);
+	}
+
+	tpu_uio_close(&uio);
+	fclose(result_file);
+	fclose(file);
+	return error ? 1 : 0;
+}
+
+/**
+ * Stands in for the TPU, which counts the finished synchronize instructions and interrupts the host.
+ */
+static void *signal_interrupts(void *context) {
+	tpu_uio_t *uio = (tpu_uio_t*)context;
+	volatile uint32_t *synchronize_count = (volatile uint32_t*)((uintptr_t)uio->mapping + TPU_INSTRUCTION_OFFSET + TPU_SYNCHRONIZE_COUNT_OFFSET);
+	uint64_t interrupts = 1;
+
+	usleep(10000);
+	*synchronize_count = 1;
+	if(write(uio->event_fd, &interrupts, sizeof(interrupts)) != sizeof(interrupts)) return NULL;
+	// Two synchronize instructions, but the interrupts coalesced
+	usleep(10000);
+	*synchronize_count = 3;
+	if(write(uio->event_fd, &interrupts, sizeof(interrupts)) != sizeof(interrupts)) return NULL;
+	return NULL;
+}
+
+static int test_access(int backing_fd) {
+	static tpu_vector_t vectors[UNIFIED_BUFFER_SIZE];
+
+	srand(SEED);
+	for(uint32_t address = 0; address < UNIFIED_BUFFER_SIZE; ++address) {
+		for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+			vectors[address].byte_vector[i] = rand();
+		}
+	}
+
+	// Through tinyTPU_access.h
+	if(write_input_block(vectors, 0, UNIFIED_BUFFER_SIZE) || read_output_block(vectors, 0, UNIFIED_BUFFER_SIZE)) {
+		printf("Bad address on block access!\n");
+		return 1;
+	}
+
+	srand(SEED);
+	for(uint32_t address = 0; address < UNIFIED_BUFFER_SIZE; ++address) {
+		tpu_vector_t stored;
+		if(pread(backing_fd, &stored, TPU_VECTOR_SIZE, TPU_UNIFIED_BUFFER_OFFSET + (address << TPU_VECTOR_SHIFT)) != TPU_VECTOR_SIZE) {
+			printf("Error reading the backing file!\n");
+			return 1;
+		}
+
+		for(uint32_t i = 0; i < TPU_VECTOR_SIZE; ++i) {
+			uint8_t value = rand();
+			if(vectors[address].byte_vector[i] != value || stored.byte_vector[i] != value) {
+				printf("Read wrong value at address 0x%08x!\n", address);
+				return 1;
+			}
+		}
+	}
+
+	instruction_t instruction;
+	uint32_t lower_word;
+	set_instruction(&instruction, TPU_OP_MATRIX_MULTIPLY, 14, 3, 42);
+	write_instruction(&instruction);
+	if(pread(backing_fd, &lower_word, sizeof(lower_word), TPU_INSTRUCTION_OFFSET + TPU_LOWER_WORD_OFFSET) != sizeof(lower_word)
+			|| lower_word != instruction.lower_word) {
+		printf("Instruction wasn't written to the backing file!\n");
+		return 1;
+	}
+
+	printf("Mapped access test was successful!\n");
+	return 0;
+}
+
+static int test_interrupts(tpu_uio_t *uio) {
+	if(tpu_uio_wait_interrupt(uio, 1) != EAGAIN) {
+		printf("Interrupt without a signal!\n");
+		return 1;
+	}
+
+	// The backing file shares the register with the middle instruction word, which test_access wrote
+	tpu_fence_init(&uio->device.fences, 0);
+	tpu_fence_t fence = 0;
+	for(uint32_t i = 0; i < 3; ++i) {
+		fence = tpu_fence_issue(&uio->device.fences);
+	}
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, signal_interrupts, uio);
+	tpu_uio_wait(uio, fence);
+	pthread_join(thread, NULL);
+
+	if(uio->device.fences.completed != 3 || tpu_fence_in_flight(&uio->device.fences)) {
+		printf("%u synchronize instructions were signaled but should be 3!\n", uio->device.fences.completed);
+		return 1;
+	}
+
+	printf("Interrupt test was successful!\n");
+	return 0;
+}
+
+typedef struct share_context {
+	tpu_uio_t *uio;
+	// Unique for every process and thread
+	uint8_t id;
+} share_context_t;
+
+static void *share_tpu(void *context) {
+	tpu_uio_t *uio = ((share_context_t*)context)->uio;
+	uint8_t id = ((share_context_t*)context)->id;
+	tpu_vector_t vectors[TEST_VECTORS];
+
+	for(uint32_t round = 0; round < TEST_ROUNDS; ++round) {
+		if(tpu_uio_lock(uio)) return (void*)1;
+
+		memset(vectors, id, sizeof(vectors));
+		tpu_device_write_inputs(&uio->device, vectors, 0, TEST_VECTORS);
+		usleep(100);
+		tpu_device_read_outputs(&uio->device, vectors, 0, TEST_VECTORS);
+
+		tpu_uio_unlock(uio);
+
+		for(uint32_t i = 0; i < TEST_VECTORS; ++i) {
+			for(uint32_t k = 0; k < TPU_VECTOR_SIZE; ++k) {
+				if(vectors[i].byte_vector[k] != id) return (void*)1;
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Every process opens the backend on its own and shares it with its threads.
+ */
+static int test_sharing(const char *backing_name) {
+	fflush(stdout);
+	for(uint32_t p = 0; p < TEST_PROCESSES; ++p) {
+		if(fork() != 0) continue;
+
+		tpu_uio_t uio;
+		if(tpu_uio_open_map(&uio, backing_name, 0, -1)) exit(1);
+
+		pthread_t threads[TEST_THREADS];
+		share_context_t contexts[TEST_THREADS];
+		void *failed[TEST_THREADS];
+		for(uint32_t t = 0; t < TEST_THREADS; ++t) {
+			contexts[t].uio = &uio;
+			contexts[t].id = p*TEST_THREADS + t + 1;
+			pthread_create(&threads[t], NULL, share_tpu, &contexts[t]);
+		}
+		int status = 0;
+		for(uint32_t t = 0; t < TEST_THREADS; ++t) {
+			pthread_join(threads[t], &failed[t]);
+			if(failed[t] != NULL) status = 1;
+		}
+
+		tpu_uio_close(&uio);
+		exit(status);
+	}
+
+	int failed = 0;
+	for(uint32_t p = 0; p < TEST_PROCESSES; ++p) {
+		int status;
+		if(wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status)) failed = 1;
+	}
+
+	if(failed) {
+		printf("Accesses of processes and threads overlapped!\n");
+		return 1;
+	}
+
+	printf("Sharing test was successful!\n");
+	return 0;
+}
+
+/**
+ * Tests the backend on a plain Linux host. A file stands in for the AXI slave and an eventfd for the interrupt.
+ */
+static int run_tests(const char *backing_name) {
+	static tpu_uio_t uio;
+
+	int backing_fd = open(backing_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(backing_fd < 0 || ftruncate(backing_fd, TPU_UIO_MAP_SIZE)) {
+		printf("Error creating file %s!\n", backing_name);
+		return 1;
+	}
+
+	int event_fd = eventfd(0, EFD_CLOEXEC);
+	if(event_fd < 0 || tpu_uio_open_map(&uio, backing_name, 0, event_fd)) {
+		printf("Error mapping file %s!\n", backing_name);
+		close(backing_fd);
+		return 1;
+	}
+	tpu_uio_select(&uio);
+
+	int failed = test_access(backing_fd) || test_interrupts(&uio);
+	tpu_uio_close(&uio);
+	close(backing_fd);
+
+	return failed || test_sharing(backing_name);
+}
+
+int main(int argc, char *argv[]) {
+	static tpu_result_t result;
+	tpu_result_format_t format = TPU_RESULT_CSV;
+	uint32_t columns = 0;
+	uint32_t top_k = 1;
+	uint8_t is_signed = 0;
+	int option;
+
+	while((option = getopt(argc, argv, "t:f:c:k:s")) != -1) {
+		switch(option) {
+			case 't':
+				return run_tests(optarg);
+			case 'f':
+				if(tpu_result_parse_format(optarg, &format)) {
+					printf("Unknown result format %s!\n", optarg);
+					return 1;
+				}
+				break;
+			case 'c':
+				columns = strtoul(optarg, NULL, 0);
+				break;
+			case 'k':
+				top_k = strtoul(optarg, NULL, 0);
+				break;
+			case 's':
+				is_signed = 1;
+				break;
+			default:
+				return 1;
+		}
+	}
+
+	if(argc - optind != 2) {
+		printf("Usage: %s [-f csv|raw|float|class|top] [-c columns] [-k top k] [-s] <UIO device> <program file>\n", argv[0]);
+		printf("       %s -t <backing file>\n", argv[0]);
+		return 1;
+	}
+
+	if(tpu_result_init(&result, format, columns, top_k, is_signed, read_results, NULL)) {
+		printf("Invalid result format!\n");
+		return 1;
+	}
+
+	return run_program(argv[optind], argv[optind+1], &result);
+}
+#endif
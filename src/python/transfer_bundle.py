@@ -0,0 +1,120 @@
+# Copyright 2018 Jonas Fuhrmann. All rights reserved.
+#
+# This project is dual licensed under GNU General Public License version 3
+# and a commercial license available on request.
+#-------------------------------------------------------------------------
+# For non commercial use only:
+# This file is part of tinyTPU.
+# 
+# tinyTPU is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# tinyTPU is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+import struct
+import sys
+
+# Converts a program file of transfer_complete_model.py (or weights.txt, inputs.txt, instructions.txt)
+# into the binary bundle format of tinyTPU_bundle.h:
+# header - magic, version, vector size, section count, section table offset
+# [uint32,uint16,uint16,uint32,uint32]
+# section - type, address, count, offset, size, flags
+# [uint32,uint32,uint32,uint32,uint32,uint32]
+# Weights and inputs are stored as padded vectors, instructions with 10 bytes and results as
+# address - length - append
+# [uint32,uint32,uint32]
+
+PROGRAM_NAME = sys.argv[1]
+BUNDLE_NAME = sys.argv[2]
+TPU_WIDTH = int(sys.argv[3])
+
+MAGIC = 0x55505474
+VERSION = 1
+ALIGNMENT = 16
+
+WEIGHTS = 1
+INPUTS = 2
+INSTRUCTIONS = 3
+RESULTS = 4
+
+HEADER_SIZE = 16
+SECTION_SIZE = 24
+
+# Size of tpu_vector_t
+VECTOR_SIZE = max(TPU_WIDTH, (TPU_WIDTH + 2) // 4 * 4)
+VECTOR_SIZE = (VECTOR_SIZE + 3) // 4 * 4
+
+def parse(line):
+    return [int(x, 0) for x in line.strip().strip("[]").split(",") if x != ""]
+
+def pack_vector(values):
+    if len(values) > TPU_WIDTH:
+        raise ValueError("Vector out of bounds: " + str(values))
+    values = values + [0] * (VECTOR_SIZE - len(values))
+    return struct.pack("<" + str(VECTOR_SIZE) + "B", *[x & 0xFF for x in values])
+
+def pack_instruction(values):
+    if len(values) <= 3:
+        # op_code - calc_length - weight_addr
+        return struct.pack("<BIIB", values[0], values[1], values[2] & 0xFFFFFFFF, values[2] >> 32)
+    # op_code - calc_length - acc_addr - buffer_addr
+    return struct.pack("<BIHHB", values[0], values[1], values[2], values[3] & 0xFFFF, values[3] >> 16)
+
+def pack_result(values):
+    return struct.pack("<III", values[0], values[1], values[2])
+
+SECTIONS = {
+    "weights:[" : (WEIGHTS, pack_vector),
+    "inputs:[" : (INPUTS, pack_vector),
+    "instructions:[" : (INSTRUCTIONS, pack_instruction),
+    "results:[" : (RESULTS, pack_result)
+}
+
+# Collect sections in program order
+sections = []
+section = None
+program = open(PROGRAM_NAME, 'r')
+for line in program:
+    line = line.strip()
+    if line == "":
+        continue
+    if section == None:
+        if line in SECTIONS:
+            section = (SECTIONS[line][0], SECTIONS[line][1], [])
+        continue
+    if line == "]":
+        sections.append(section)
+        section = None
+        continue
+    section[2].append(section[1](parse(line)))
+program.close()
+
+# Lay out the data behind the section table
+offset = HEADER_SIZE + len(sections)*SECTION_SIZE
+table = b""
+data = b""
+for (type, pack, records) in sections:
+    padding = (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT
+    data += b"\0" * padding
+    offset += padding
+    content = b"".join(records)
+    # Weights and inputs of every section start at address 0, like in sd_main.c
+    table += struct.pack("<IIIIII", type, 0, len(records), offset, len(content), 0)
+    data += content
+    offset += len(content)
+    print("Section " + str(type) + ": " + str(len(records)) + " records")
+
+file = open(BUNDLE_NAME, 'wb')
+file.write(struct.pack("<IHHII", MAGIC, VERSION, TPU_WIDTH, len(sections), HEADER_SIZE))
+file.write(table)
+file.write(data)
+file.flush()
+file.close()
@@ -33,6 +33,28 @@ import sys
 # [uint8,uint32,uint40]
 
 TPU_WIDTH = int(sys.argv[1])
+# All-zero tiles are skipped, unless "dense" is given as second argument
+DENSE = len(sys.argv) > 2 and sys.argv[2] == "dense"
+
+# Row tiles of a column tile, which are stored - has to match transfer_weights.py
+def used_tiles(weights, matrix_column, row_length):
+    tiles = []
+    for matrix_row in range(0, row_length, TPU_WIDTH):
+        if DENSE or np.any(weights[matrix_row:matrix_row+TPU_WIDTH, matrix_column:matrix_column+TPU_WIDTH]):
+            tiles.append(matrix_row)
+    if len(tiles) == 0:
+        tiles.append(0)
+    return tiles
+
+# Groups consecutive tiles, which are loaded and multiplied by a single instruction pair
+def tile_runs(tiles):
+    runs = []
+    for tile in tiles:
+        if len(runs) > 0 and runs[-1][0] + runs[-1][1] == tile:
+            runs[-1][1] = runs[-1][1] + TPU_WIDTH
+        else:
+            runs.append([tile, TPU_WIDTH])
+    return runs
 
 # Open file
 file = open("instructions.txt", 'w')
@@ -78,18 +100,25 @@ for path in list:
     
     for matrix_column in range(column_length):
         print("Column: " + str(matrix_column))
+        runs = tile_runs(used_tiles(weights, matrix_column*TPU_WIDTH, row_length))
+        first_row = runs[0][0]
         # Load first signed matrix
-        file.write("[9," + str(TPU_WIDTH) + "," + str(matrix_column*row_length + weight_count) + "]\n")
+        file.write("[9," + str(TPU_WIDTH) + "," + str(weight_count) + "]\n")
         # First signed matrix multiply without accumulation
-        file.write("[33," + str(TPU_WIDTH) + "," + str(matrix_column*TPU_WIDTH) + "," + str(input_base) + "]\n")
-        # Load signed weight - complete row exluding the first matrix
-        file.write("[9," + str(row_length-TPU_WIDTH) + "," + str(matrix_column*row_length+TPU_WIDTH + weight_count) + "]\n")
+        file.write("[33," + str(TPU_WIDTH) + "," + str(matrix_column*TPU_WIDTH) + "," + str(input_base+first_row) + "]\n")
+        # Load signed weight - remaining tiles of the first run
+        file.write("[9," + str(runs[0][1]-TPU_WIDTH) + "," + str(weight_count+TPU_WIDTH) + "]\n")
         # Signed matrix multiply with accumulation
-        file.write("[35," + str(row_length-TPU_WIDTH) + "," + str(matrix_column*TPU_WIDTH) + "," + str(input_base+TPU_WIDTH) + "]\n")
+        file.write("[35," + str(runs[0][1]-TPU_WIDTH) + "," + str(matrix_column*TPU_WIDTH) + "," + str(input_base+first_row+TPU_WIDTH) + "]\n")
+        weight_count = weight_count + runs[0][1]
+        # Skipped tiles only add zeros, the other runs accumulate in the same order
+        for (matrix_row, length) in runs[1:]:
+            file.write("[9," + str(length) + "," + str(weight_count) + "]\n")
+            file.write("[35," + str(length) + "," + str(matrix_column*TPU_WIDTH) + "," + str(input_base+matrix_row) + "]\n")
+            weight_count = weight_count + length
         # Activation - signed sigmoid
         file.write("[153," + str(TPU_WIDTH) + "," + str(matrix_column*TPU_WIDTH) + "," + str(input_count+matrix_column*TPU_WIDTH) + "]\n")
        
-    weight_count = weight_count + column_length*row_length
 # Synchronize - calculations are finished
 file.write("[255,0,0]\n")
     
@@ -25,6 +25,20 @@ import re
 import sys
 
 TPU_WIDTH = int(sys.argv[1])
+# All-zero tiles are left out, unless "dense" is given as second argument
+# (e.g. for programs of tinyTPU_compiler.c, which expect every tile)
+DENSE = len(sys.argv) > 2 and sys.argv[2] == "dense"
+
+# Row tiles of a column tile, which are stored - has to match transfer_instructions.py
+# A column tile without any non-zero weights keeps its first tile, which initializes the accumulators
+def used_tiles(weights, matrix_column, row_length):
+    tiles = []
+    for matrix_row in range(0, row_length, TPU_WIDTH):
+        if DENSE or np.any(weights[matrix_row:matrix_row+TPU_WIDTH, matrix_column:matrix_column+TPU_WIDTH]):
+            tiles.append(matrix_row)
+    if len(tiles) == 0:
+        tiles.append(0)
+    return tiles
 
 # Open file
 file = open("weights.txt", 'w')
@@ -62,11 +76,13 @@ for path in list:
     
     print("Rows: " + str(row_length) + " Columns: " + str(column_length))
     
-    
+    stored_tiles = 0
         
     for matrix_column in range(0, column_length, TPU_WIDTH):
         #print("Column: " + str(matrix_column))
-        for matrix_row in range(0, row_length, TPU_WIDTH):
+        tiles = used_tiles(weights, matrix_column, row_length)
+        stored_tiles = stored_tiles + len(tiles)
+        for matrix_row in tiles:
             #print("Row: " + str(matrix_row))
             #print("Next matrix:")
             for sub_matrix_row in range(TPU_WIDTH):
@@ -82,6 +98,8 @@ for path in list:
                 vector_str = str(vector).replace(" ", "") + "\n"
                 file.write(vector_str)
                 #print(vector_str)
+    
+    print("Stored tiles: " + str(stored_tiles) + " of " + str(row_length*column_length//(TPU_WIDTH*TPU_WIDTH)))
  
 file.write("]\n")
 file.flush()
@@ -35,6 +35,8 @@ architecture BEH of TB_tinyTPU_v1_0_S00_AXI is
             -- User parameters ends
             -- Do not modify the parameters beyond this line
 
+            -- Width of ID for write address, write data, read address and read data
+            C_S_AXI_ID_WIDTH	: integer	:= 1;
             -- Width of S_AXI data bus
             C_S_AXI_DATA_WIDTH	: integer	:= 32;
             -- Width of S_AXI address bus
@@ -50,8 +52,17 @@ architecture BEH of TB_tinyTPU_v1_0_S00_AXI is
             S_AXI_ACLK	: in std_logic;
             -- Global Reset Signal. This Signal is Active LOW
             S_AXI_ARESETN	: in std_logic;
+            -- Write Address ID
+            S_AXI_AWID	: in std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
             -- Write address (issued by master, acceped by Slave)
             S_AXI_AWADDR	: in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+            -- Burst length. The burst length gives the exact number of transfers in a burst
+            S_AXI_AWLEN	: in std_logic_vector(7 downto 0);
+            -- Burst size. This signal indicates the size of each transfer in the burst
+            S_AXI_AWSIZE	: in std_logic_vector(2 downto 0);
+            -- Burst type. The burst type and the size information, 
+                -- determine how the address for each transfer within the burst is calculated.
+            S_AXI_AWBURST	: in std_logic_vector(1 downto 0);
             -- Write channel Protection type. This signal indicates the
                 -- privilege and security level of the transaction, and whether
                 -- the transaction is a data access or an instruction access.
@@ -68,12 +79,18 @@ architecture BEH of TB_tinyTPU_v1_0_S00_AXI is
                 -- valid data. There is one write strobe bit for each eight
                 -- bits of the write data bus.    
             S_AXI_WSTRB	: in std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+            -- Write last. This signal indicates the last transfer
+                -- in a write burst.
+            S_AXI_WLAST	: in std_logic;
             -- Write valid. This signal indicates that valid write
                 -- data and strobes are available.
             S_AXI_WVALID	: in std_logic;
             -- Write ready. This signal indicates that the slave
                 -- can accept the write data.
             S_AXI_WREADY	: out std_logic;
+            -- Response ID tag. This signal is the ID tag of the
+                -- write response.
+            S_AXI_BID	: out std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
             -- Write response. This signal indicates the status
                 -- of the write transaction.
             S_AXI_BRESP	: out std_logic_vector(1 downto 0);
@@ -83,8 +100,18 @@ architecture BEH of TB_tinyTPU_v1_0_S00_AXI is
             -- Response ready. This signal indicates that the master
                 -- can accept a write response.
             S_AXI_BREADY	: in std_logic;
+            -- Read address ID. This signal is the identification
+                -- tag for the read address group of signals.
+            S_AXI_ARID	: in std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
             -- Read address (issued by master, acceped by Slave)
             S_AXI_ARADDR	: in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+            -- Burst length. The burst length gives the exact number of transfers in a burst
+            S_AXI_ARLEN	: in std_logic_vector(7 downto 0);
+            -- Burst size. This signal indicates the size of each transfer in the burst
+            S_AXI_ARSIZE	: in std_logic_vector(2 downto 0);
+            -- Burst type. The burst type and the size information, 
+                -- determine how the address for each transfer within the burst is calculated.
+            S_AXI_ARBURST	: in std_logic_vector(1 downto 0);
             -- Protection type. This signal indicates the privilege
                 -- and security level of the transaction, and whether the
                 -- transaction is a data access or an instruction access.
@@ -95,11 +122,17 @@ architecture BEH of TB_tinyTPU_v1_0_S00_AXI is
             -- Read address ready. This signal indicates that the slave is
                 -- ready to accept an address and associated control signals.
             S_AXI_ARREADY	: out std_logic;
+            -- Read ID tag. This signal is the identification tag
+                -- for the read data group of signals generated by the slave.
+            S_AXI_RID	: out std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
             -- Read data (issued by slave)
             S_AXI_RDATA	: out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
             -- Read response. This signal indicates the status of the
                 -- read transfer.
             S_AXI_RRESP	: out std_logic_vector(1 downto 0);
+            -- Read last. This signal indicates the last transfer
+                -- in a read burst.
+            S_AXI_RLAST	: out std_logic;
             -- Read valid. This signal indicates that the channel is
                 -- signaling the required read data.
             S_AXI_RVALID	: out std_logic;
@@ -113,119 +146,250 @@ architecture BEH of TB_tinyTPU_v1_0_S00_AXI is
     signal CLK : std_logic;
     signal NRESET : std_logic;
     
+    constant C_S_AXI_ID_WIDTH	    : integer	:= 1;
     constant C_S_AXI_DATA_WIDTH	    : integer	:= 32;
     constant C_S_AXI_ADDR_WIDTH	    : integer	:= 20;
     
+    constant BURST_FIXED    : std_logic_vector(1 downto 0) := "00";
+    constant BURST_INCR     : std_logic_vector(1 downto 0) := "01";
+    constant BURST_WRAP     : std_logic_vector(1 downto 0) := "10";
+    constant SIZE_WORD      : std_logic_vector(2 downto 0) := "010";
+    constant SIZE_HALFWORD  : std_logic_vector(2 downto 0) := "001";
+    constant RESP_OKAY      : std_logic_vector(1 downto 0) := "00";
+    constant RESP_SLVERR    : std_logic_vector(1 downto 0) := "10";
+    
+    -- Cycles of a burst, which aren't used for data beats (address and response handshakes, read latency)
+    constant WRITE_OVERHEAD : natural := 4;
+    constant READ_OVERHEAD  : natural := 8;
+    
+    type DATA_ARRAY_TYPE is array(natural range <>) of std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+    
+    signal S_AXI_AWID	    : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
     signal S_AXI_AWADDR	    : std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+    signal S_AXI_AWLEN	    : std_logic_vector(7 downto 0);
+    signal S_AXI_AWSIZE	    : std_logic_vector(2 downto 0);
+    signal S_AXI_AWBURST	: std_logic_vector(1 downto 0);
     signal S_AXI_AWPROT	    : std_logic_vector(2 downto 0);
     signal S_AXI_AWVALID	: std_logic;
     signal S_AXI_AWREADY	: std_logic;
     signal S_AXI_WDATA	    : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
     signal S_AXI_WSTRB	    : std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+    signal S_AXI_WLAST	    : std_logic;
     signal S_AXI_WVALID	    : std_logic;
     signal S_AXI_WREADY	    : std_logic;
+    signal S_AXI_BID	    : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
     signal S_AXI_BRESP	    : std_logic_vector(1 downto 0);
     signal S_AXI_BVALID	    : std_logic;
     signal S_AXI_BREADY	    : std_logic;
+    signal S_AXI_ARID	    : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
     signal S_AXI_ARADDR	    : std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+    signal S_AXI_ARLEN	    : std_logic_vector(7 downto 0);
+    signal S_AXI_ARSIZE	    : std_logic_vector(2 downto 0);
+    signal S_AXI_ARBURST	: std_logic_vector(1 downto 0);
     signal S_AXI_ARPROT	    : std_logic_vector(2 downto 0);
     signal S_AXI_ARVALID	: std_logic;
     signal S_AXI_ARREADY	: std_logic;
+    signal S_AXI_RID	    : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
     signal S_AXI_RDATA	    : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
     signal S_AXI_RRESP	    : std_logic_vector(1 downto 0);
+    signal S_AXI_RLAST	    : std_logic;
     signal S_AXI_RVALID	    : std_logic;
     signal S_AXI_RREADY	    : std_logic;
     
     -- for clock gen
     constant clock_period   : time := 10 ns;
-    signal stop_the_clock   : boolean;
+    signal stop_the_clock   : boolean := false;
 begin
     DUT_i : DUT
     generic map(
+        C_S_AXI_ID_WIDTH   => C_S_AXI_ID_WIDTH,
         C_S_AXI_DATA_WIDTH => C_S_AXI_DATA_WIDTH,
         C_S_AXI_ADDR_WIDTH => C_S_AXI_ADDR_WIDTH
     )
     port map(
         S_AXI_ACLK      => CLK,
         S_AXI_ARESETN   => NRESET,
+        S_AXI_AWID      => S_AXI_AWID,
         S_AXI_AWADDR    => S_AXI_AWADDR,
+        S_AXI_AWLEN     => S_AXI_AWLEN,
+        S_AXI_AWSIZE    => S_AXI_AWSIZE,
+        S_AXI_AWBURST   => S_AXI_AWBURST,
         S_AXI_AWPROT    => S_AXI_AWPROT,
         S_AXI_AWVALID   => S_AXI_AWVALID,
         S_AXI_AWREADY   => S_AXI_AWREADY,
         S_AXI_WDATA     => S_AXI_WDATA,
         S_AXI_WSTRB     => S_AXI_WSTRB,
+        S_AXI_WLAST     => S_AXI_WLAST,
         S_AXI_WVALID    => S_AXI_WVALID,
         S_AXI_WREADY    => S_AXI_WREADY,
+        S_AXI_BID       => S_AXI_BID,
         S_AXI_BRESP     => S_AXI_BRESP,
         S_AXI_BVALID    => S_AXI_BVALID,
         S_AXI_BREADY    => S_AXI_BREADY,
+        S_AXI_ARID      => S_AXI_ARID,
         S_AXI_ARADDR    => S_AXI_ARADDR,
+        S_AXI_ARLEN     => S_AXI_ARLEN,
+        S_AXI_ARSIZE    => S_AXI_ARSIZE,
+        S_AXI_ARBURST   => S_AXI_ARBURST,
         S_AXI_ARPROT    => S_AXI_ARPROT,
         S_AXI_ARVALID   => S_AXI_ARVALID,
         S_AXI_ARREADY   => S_AXI_ARREADY,
+        S_AXI_RID       => S_AXI_RID,
         S_AXI_RDATA     => S_AXI_RDATA,
         S_AXI_RRESP     => S_AXI_RRESP,
+        S_AXI_RLAST     => S_AXI_RLAST,
         S_AXI_RVALID    => S_AXI_RVALID,
         S_AXI_RREADY    => S_AXI_RREADY
     );
     
     STIMULUS:
     process is
-        procedure WRITE_PROCEDURE(
-            constant ADDRESS : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
-            constant DATA    : in std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
-            constant STROBE  : in std_logic_vector(3 downto 0)
+        -- Writes a burst and counts the cycles from the address handshake to the response handshake
+        -- WLAST is set on LAST_BEAT (the last beat by default), the burst ends there
+        procedure WRITE_BURST_PROCEDURE(
+            constant ADDRESS    : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+            constant DATA       : in DATA_ARRAY_TYPE;
+            constant STROBE     : in std_logic_vector(3 downto 0);
+            constant BURST      : in std_logic_vector(1 downto 0);
+            variable CYCLES     : out natural;
+            constant RESPONSE   : in std_logic_vector(1 downto 0) := RESP_OKAY;
+            constant SIZE       : in std_logic_vector(2 downto 0) := SIZE_WORD;
+            constant LAST_BEAT  : in integer := -1
         ) is
+            variable CYCLES_v : natural;
         begin
+            CYCLES_v := 0;
             S_AXI_AWADDR <= ADDRESS;
+            S_AXI_AWLEN <= std_logic_vector(to_unsigned(DATA'length-1, 8));
+            S_AXI_AWSIZE <= SIZE;
+            S_AXI_AWBURST <= BURST;
             S_AXI_AWVALID <= '1';
-            --wait until S_AXI_AWREADY = '1';
-            wait until CLK='1' and CLK'event;
+            loop
+                wait until CLK='1' and CLK'event;
+                CYCLES_v := CYCLES_v + 1;
+                exit when S_AXI_AWREADY = '1';
+            end loop;
             S_AXI_AWVALID <= '0';
-            wait until CLK='1' and CLK'event;
-            S_AXI_WDATA <= DATA;
-            S_AXI_WSTRB <= STROBE;
-            S_AXI_WVALID <= '1';
-            --wait until S_AXI_WREADY = '1';
-            wait until CLK='1' and CLK'event;
+            for i in DATA'range loop
+                S_AXI_WDATA <= DATA(i);
+                S_AXI_WSTRB <= STROBE;
+                if (LAST_BEAT < 0 and i = DATA'right) or i = LAST_BEAT then
+                    S_AXI_WLAST <= '1';
+                else
+                    S_AXI_WLAST <= '0';
+                end if;
+                S_AXI_WVALID <= '1';
+                loop
+                    wait until CLK='1' and CLK'event;
+                    CYCLES_v := CYCLES_v + 1;
+                    exit when S_AXI_WREADY = '1';
+                end loop;
+                exit when i = LAST_BEAT;
+            end loop;
             S_AXI_WVALID <= '0';
-            wait until CLK='1' and CLK'event;
+            S_AXI_WLAST <= '0';
             S_AXI_BREADY <= '1';
-            --wait until S_AXI_BVALID = '1';
-            wait until CLK='1' and CLK'event;
+            loop
+                wait until CLK='1' and CLK'event;
+                CYCLES_v := CYCLES_v + 1;
+                exit when S_AXI_BVALID = '1';
+            end loop;
+            assert S_AXI_BRESP = RESPONSE report "Wrong write response!" severity error;
+            assert S_AXI_BID = S_AXI_AWID report "Write response ID doesn't match!" severity error;
             S_AXI_BREADY <= '0';
-            wait until CLK='1' and CLK'event;
-        end procedure WRITE_PROCEDURE;
+            CYCLES := CYCLES_v;
+        end procedure WRITE_BURST_PROCEDURE;
         
-        procedure READ_PROCEDURE(
-            constant ADDRESS : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0)
+        -- Reads a burst, compares the data if CHECK is set and counts the cycles from the address handshake to the last beat
+        procedure READ_BURST_PROCEDURE(
+            constant ADDRESS  : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+            constant EXPECTED : in DATA_ARRAY_TYPE;
+            constant CHECK    : in boolean;
+            constant BURST    : in std_logic_vector(1 downto 0);
+            variable CYCLES   : out natural;
+            constant RESPONSE : in std_logic_vector(1 downto 0) := RESP_OKAY;
+            constant SIZE     : in std_logic_vector(2 downto 0) := SIZE_WORD
         ) is
+            variable CYCLES_v : natural;
         begin
+            CYCLES_v := 0;
             S_AXI_ARADDR <= ADDRESS;
+            S_AXI_ARLEN <= std_logic_vector(to_unsigned(EXPECTED'length-1, 8));
+            S_AXI_ARSIZE <= SIZE;
+            S_AXI_ARBURST <= BURST;
             S_AXI_ARVALID <= '1';
-            wait until CLK='1' and CLK'event;
+            loop
+                wait until CLK='1' and CLK'event;
+                CYCLES_v := CYCLES_v + 1;
+                exit when S_AXI_ARREADY = '1';
+            end loop;
             S_AXI_ARVALID <= '0';
-            wait until CLK='1' and CLK'event;
             S_AXI_RREADY <= '1';
-            wait until CLK='1' and CLK'event;
-            wait until CLK='1' and CLK'event;
-            wait until CLK='1' and CLK'event;
-            wait until CLK='1' and CLK'event;
-            wait until CLK='1' and CLK'event;
+            for i in EXPECTED'range loop
+                loop
+                    wait until CLK='1' and CLK'event;
+                    CYCLES_v := CYCLES_v + 1;
+                    exit when S_AXI_RVALID = '1';
+                end loop;
+                if CHECK then
+                    assert S_AXI_RDATA = EXPECTED(i) report "Read data doesn't match!" severity error;
+                end if;
+                assert S_AXI_RRESP = RESPONSE report "Wrong read response!" severity error;
+                assert S_AXI_RID = S_AXI_ARID report "Read ID doesn't match!" severity error;
+                if i = EXPECTED'right then
+                    assert S_AXI_RLAST = '1' report "RLAST missing on last beat!" severity error;
+                else
+                    assert S_AXI_RLAST = '0' report "RLAST before last beat!" severity error;
+                end if;
+            end loop;
             S_AXI_RREADY <= '0';
+            CYCLES := CYCLES_v;
+        end procedure READ_BURST_PROCEDURE;
+        
+        procedure WRITE_PROCEDURE(
+            constant ADDRESS : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+            constant DATA    : in std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+            constant STROBE  : in std_logic_vector(3 downto 0)
+        ) is
+            variable CYCLES : natural;
+        begin
+            WRITE_BURST_PROCEDURE(ADDRESS, (0 => DATA), STROBE, BURST_INCR, CYCLES);
+            wait until CLK='1' and CLK'event;
+        end procedure WRITE_PROCEDURE;
+        
+        procedure READ_PROCEDURE(
+            constant ADDRESS : in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0)
+        ) is
+            variable CYCLES : natural;
+        begin
+            READ_BURST_PROCEDURE(ADDRESS, (0 => (C_S_AXI_DATA_WIDTH-1 downto 0 => '0')), false, BURST_INCR, CYCLES);
             wait until CLK='1' and CLK'event;
         end procedure READ_PROCEDURE;
         
         variable INSTRUCTION : INSTRUCTION_TYPE;
+        variable BURST_DATA  : DATA_ARRAY_TYPE(0 to 15);
+        variable WEIGHT_DATA : DATA_ARRAY_TYPE(0 to 255);
+        variable INSTRUCTION_DATA : DATA_ARRAY_TYPE(0 to 2);
+        variable BIAS_DATA   : DATA_ARRAY_TYPE(0 to 15);
+        variable CYCLES      : natural;
     begin
-        S_AXI_ARADDR <= (others => '0');
+        S_AXI_AWID <= (others => '0');
+        S_AXI_AWADDR <= (others => '0');
+        S_AXI_AWLEN <= (others => '0');
+        S_AXI_AWSIZE <= "010"; -- 4 bytes per beat
+        S_AXI_AWBURST <= BURST_INCR;
         S_AXI_AWPROT <= (others => '0');
         S_AXI_AWVALID <= '0';
         S_AXI_WDATA <= (others => '0');
         S_AXI_WSTRB <= (others => '0');
+        S_AXI_WLAST <= '0';
         S_AXI_WVALID <= '0';
         S_AXI_BREADY <= '0';
+        S_AXI_ARID <= (others => '0');
         S_AXI_ARADDR <= (others => '0');
+        S_AXI_ARLEN <= (others => '0');
+        S_AXI_ARSIZE <= "010"; -- 4 bytes per beat
+        S_AXI_ARBURST <= BURST_INCR;
         S_AXI_ARPROT <= (others => '0');
         S_AXI_ARVALID <= '0';
         S_AXI_RREADY <= '0';
@@ -258,7 +422,9 @@ begin
         
         WRITE_PROCEDURE(x"90004", INSTRUCTION_TO_BITS(INSTRUCTION)(1*4*BYTE_WIDTH-1 downto 0*4*BYTE_WIDTH), "1111"); -- Write lower instruction word
         WRITE_PROCEDURE(x"90008", INSTRUCTION_TO_BITS(INSTRUCTION)(2*4*BYTE_WIDTH-1 downto 1*4*BYTE_WIDTH), "1111"); -- Write middle instruction word
-        WRITE_PROCEDURE(x"9000C", x"0000" & INSTRUCTION_TO_BITS(INSTRUCTION)(2*4*BYTE_WIDTH + 2*BYTE_WIDTH-1 downto 2*4*BYTE_WIDTH), "1111"); -- Write upper instruction word
+        -- Write upper instruction word with a halfword store like write_instruction
+        WRITE_BURST_PROCEDURE(x"9000C", (0 => x"0000" & INSTRUCTION_TO_BITS(INSTRUCTION)(2*4*BYTE_WIDTH + 2*BYTE_WIDTH-1 downto 2*4*BYTE_WIDTH)), "0011", BURST_INCR, CYCLES, RESP_OKAY, SIZE_HALFWORD);
+        wait until CLK='1' and CLK'event;
         
         -- Weight buffer read test - shouldn't do anything
         READ_PROCEDURE(x"00000");
@@ -279,6 +445,133 @@ begin
         READ_PROCEDURE(x"90004"); -- shouldn't do anything
         READ_PROCEDURE(x"90008"); -- shouldn't do anything
         READ_PROCEDURE(x"9000C"); -- shouldn't do anything
+        
+        -- Unified buffer burst test - the last word of each row only holds 2 bytes (MATRIX_WIDTH = 14)
+        for i in BURST_DATA'range loop
+            if i mod 4 = 3 then
+                BURST_DATA(i) := x"0000" & std_logic_vector(to_unsigned(255-i, 8)) & x"5A";
+            else
+                BURST_DATA(i) := std_logic_vector(to_unsigned(i, 8)) & x"A5" & std_logic_vector(to_unsigned(255-i, 8)) & x"5A";
+            end if;
+        end loop;
+        S_AXI_AWID <= "1";
+        WRITE_BURST_PROCEDURE(x"80100", BURST_DATA, "1111", BURST_INCR, CYCLES);
+        assert CYCLES <= BURST_DATA'length + WRITE_OVERHEAD report "Write burst too slow: " & natural'image(CYCLES) & " cycles" severity error;
+        wait until CLK='1' and CLK'event;
+        S_AXI_ARID <= "1";
+        READ_BURST_PROCEDURE(x"80100", BURST_DATA, true, BURST_INCR, CYCLES);
+        assert CYCLES <= BURST_DATA'length + READ_OVERHEAD report "Read burst too slow: " & natural'image(CYCLES) & " cycles" severity error;
+        wait until CLK='1' and CLK'event;
+        S_AXI_ARID <= "0";
+        S_AXI_AWID <= "0";
+        
+        -- Master stalls - RREADY is held low, so the read FIFO has to fill up without losing data
+        S_AXI_ARADDR <= x"80100";
+        S_AXI_ARLEN <= std_logic_vector(to_unsigned(BURST_DATA'length-1, 8));
+        S_AXI_ARBURST <= BURST_INCR;
+        S_AXI_ARVALID <= '1';
+        wait until CLK='1' and CLK'event and S_AXI_ARREADY = '1';
+        S_AXI_ARVALID <= '0';
+        for i in BURST_DATA'range loop
+            S_AXI_RREADY <= '0';
+            for j in 0 to i mod 3 loop
+                wait until CLK='1' and CLK'event;
+            end loop;
+            S_AXI_RREADY <= '1';
+            loop
+                wait until CLK='1' and CLK'event;
+                exit when S_AXI_RVALID = '1';
+            end loop;
+            assert S_AXI_RDATA = BURST_DATA(i) report "Read data doesn't match after stall!" severity error;
+        end loop;
+        S_AXI_RREADY <= '0';
+        wait until CLK='1' and CLK'event;
+        
+        -- Fixed burst reads the same word
+        READ_BURST_PROCEDURE(x"80104", (0 to 3 => BURST_DATA(1)), true, BURST_FIXED, CYCLES);
+        wait until CLK='1' and CLK'event;
+        
+        -- Weight buffer burst with maximum length
+        for i in WEIGHT_DATA'range loop
+            WEIGHT_DATA(i) := std_logic_vector(to_unsigned(i, 16)) & std_logic_vector(to_unsigned(65535-i, 16));
+        end loop;
+        WRITE_BURST_PROCEDURE(x"01000", WEIGHT_DATA, "1111", BURST_INCR, CYCLES);
+        assert CYCLES <= WEIGHT_DATA'length + WRITE_OVERHEAD report "Weight burst too slow: " & natural'image(CYCLES) & " cycles" severity error;
+        wait until CLK='1' and CLK'event;
+        
+        -- Bias buffer burst test - one bias per word, the whole bias vector 1 is written and read back
+        -- A vector takes 16 words (MATRIX_WIDTH = 14), the last 2 words aren't stored and read as 0
+        for i in BIAS_DATA'range loop
+            BIAS_DATA(i) := std_logic_vector(to_signed(i*1000 - 8000, C_S_AXI_DATA_WIDTH));
+        end loop;
+        WRITE_BURST_PROCEDURE(x"98040", BIAS_DATA, "1111", BURST_INCR, CYCLES);
+        assert CYCLES <= BIAS_DATA'length + WRITE_OVERHEAD report "Bias burst too slow: " & natural'image(CYCLES) & " cycles" severity error;
+        wait until CLK='1' and CLK'event;
+        BIAS_DATA(14) := (others => '0');
+        BIAS_DATA(15) := (others => '0');
+        READ_BURST_PROCEDURE(x"98040", BIAS_DATA, true, BURST_INCR, CYCLES);
+        assert CYCLES <= BIAS_DATA'length + READ_OVERHEAD report "Bias read burst too slow: " & natural'image(CYCLES) & " cycles" severity error;
+        wait until CLK='1' and CLK'event;
+        
+        -- WRAP bursts wrap at the boundary of their length - 4 beats from the third bias of vector 1 wrap to its first bias
+        WRITE_BURST_PROCEDURE(x"98048", (x"00000001", x"00000002", x"00000003", x"00000004"), "1111", BURST_WRAP, CYCLES);
+        wait until CLK='1' and CLK'event;
+        READ_BURST_PROCEDURE(x"98040", (x"00000003", x"00000004", x"00000001", x"00000002"), true, BURST_INCR, CYCLES);
+        wait until CLK='1' and CLK'event;
+        READ_BURST_PROCEDURE(x"98048", (x"00000001", x"00000002", x"00000003", x"00000004"), true, BURST_WRAP, CYCLES);
+        wait until CLK='1' and CLK'event;
+        
+        -- Narrow single beats only write the strobed bytes, like the halfword store of the upper instruction word
+        WRITE_BURST_PROCEDURE(x"98040", (0 => x"FFFFABCD"), "0011", BURST_INCR, CYCLES, RESP_OKAY, SIZE_HALFWORD);
+        wait until CLK='1' and CLK'event;
+        READ_BURST_PROCEDURE(x"98040", (0 => x"0000ABCD"), true, BURST_INCR, CYCLES, RESP_OKAY, SIZE_HALFWORD);
+        wait until CLK='1' and CLK'event;
+        
+        -- Narrow bursts get SLVERR and don't access the TPU
+        WRITE_BURST_PROCEDURE(x"98040", (x"0000FFFF", x"0000FFFF"), "0011", BURST_INCR, CYCLES, RESP_SLVERR, SIZE_HALFWORD);
+        wait until CLK='1' and CLK'event;
+        READ_BURST_PROCEDURE(x"98040", (x"00000000", x"00000000"), false, BURST_INCR, CYCLES, RESP_SLVERR, SIZE_HALFWORD);
+        wait until CLK='1' and CLK'event;
+        
+        -- WRAP bursts need 2, 4, 8 or 16 beats
+        WRITE_BURST_PROCEDURE(x"98040", (x"FFFFFFFF", x"FFFFFFFF", x"FFFFFFFF"), "1111", BURST_WRAP, CYCLES, RESP_SLVERR);
+        wait until CLK='1' and CLK'event;
+        READ_BURST_PROCEDURE(x"98040", (x"00000000", x"00000000", x"00000000"), false, BURST_WRAP, CYCLES, RESP_SLVERR);
+        wait until CLK='1' and CLK'event;
+        READ_BURST_PROCEDURE(x"98040", (x"0000ABCD", x"00000004", x"00000001"), true, BURST_INCR, CYCLES); -- not written
+        wait until CLK='1' and CLK'event;
+        
+        -- WLAST has to be set on the last beat and only there
+        WRITE_BURST_PROCEDURE(x"98050", (x"00000005", x"00000006", x"00000007", x"00000008"), "1111", BURST_INCR, CYCLES, RESP_SLVERR, SIZE_WORD, 1); -- early
+        wait until CLK='1' and CLK'event;
+        WRITE_BURST_PROCEDURE(x"98050", (x"00000005", x"00000006"), "1111", BURST_INCR, CYCLES, RESP_SLVERR, SIZE_WORD, 2); -- missing
+        wait until CLK='1' and CLK'event;
+        WRITE_BURST_PROCEDURE(x"98050", (x"00000005", x"00000006"), "1111", BURST_INCR, CYCLES); -- OKAY again
+        wait until CLK='1' and CLK'event;
+        
+        -- Instruction burst - lower, middle and upper word
+        INSTRUCTION_DATA(0) := INSTRUCTION_TO_BITS(INSTRUCTION)(1*4*BYTE_WIDTH-1 downto 0*4*BYTE_WIDTH);
+        INSTRUCTION_DATA(1) := INSTRUCTION_TO_BITS(INSTRUCTION)(2*4*BYTE_WIDTH-1 downto 1*4*BYTE_WIDTH);
+        INSTRUCTION_DATA(2) := x"0000" & INSTRUCTION_TO_BITS(INSTRUCTION)(2*4*BYTE_WIDTH + 2*BYTE_WIDTH-1 downto 2*4*BYTE_WIDTH);
+        WRITE_BURST_PROCEDURE(x"90004", INSTRUCTION_DATA, "1111", BURST_INCR, CYCLES);
+        wait until CLK='1' and CLK'event;
+        
+        -- Performance counters - both weight loads were dispatched before the synchronize
+        INSTRUCTION.OP_CODE := x"FF"; -- synchronize
+        INSTRUCTION.CALC_LENGTH := (others => '0');
+        INSTRUCTION_DATA(0) := INSTRUCTION_TO_BITS(INSTRUCTION)(1*4*BYTE_WIDTH-1 downto 0*4*BYTE_WIDTH);
+        INSTRUCTION_DATA(1) := INSTRUCTION_TO_BITS(INSTRUCTION)(2*4*BYTE_WIDTH-1 downto 1*4*BYTE_WIDTH);
+        INSTRUCTION_DATA(2) := x"0000" & INSTRUCTION_TO_BITS(INSTRUCTION)(2*4*BYTE_WIDTH + 2*BYTE_WIDTH-1 downto 2*4*BYTE_WIDTH);
+        WRITE_BURST_PROCEDURE(x"90004", INSTRUCTION_DATA, "1111", BURST_INCR, CYCLES);
+        for i in 0 to 99 loop
+            wait until CLK='1' and CLK'event;
+        end loop;
+        READ_BURST_PROCEDURE(x"90024", (x"00000002", x"00000000", x"00000000"), true, BURST_INCR, CYCLES); -- weight, matrix and activation instructions
+        wait until CLK='1' and CLK'event;
+        READ_BURST_PROCEDURE(x"90034", (0 => x"00000000"), true, BURST_INCR, CYCLES); -- behind the last counter
+        wait until CLK='1' and CLK'event;
+        
+        stop_the_clock <= true;
         wait;
     end process STIMULUS;
     
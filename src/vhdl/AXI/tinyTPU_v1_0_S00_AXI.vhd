@@ -33,6 +33,8 @@ entity tinyTPU_v1_0_S00_AXI is
 		-- User parameters ends
 		-- Do not modify the parameters beyond this line
 
+		-- Width of ID for write address, write data, read address and read data
+		C_S_AXI_ID_WIDTH	: integer	:= 1;
 		-- Width of S_AXI data bus
 		C_S_AXI_DATA_WIDTH	: integer	:= 32;
 		-- Width of S_AXI address bus
@@ -48,8 +50,17 @@ entity tinyTPU_v1_0_S00_AXI is
 		S_AXI_ACLK	: in std_logic;
 		-- Global Reset Signal. This Signal is Active LOW
 		S_AXI_ARESETN	: in std_logic;
+		-- Write Address ID
+		S_AXI_AWID	: in std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
 		-- Write address (issued by master, acceped by Slave)
 		S_AXI_AWADDR	: in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+		-- Burst length. The burst length gives the exact number of transfers in a burst
+		S_AXI_AWLEN	: in std_logic_vector(7 downto 0);
+		-- Burst size. This signal indicates the size of each transfer in the burst
+		S_AXI_AWSIZE	: in std_logic_vector(2 downto 0);
+		-- Burst type. The burst type and the size information, 
+    		-- determine how the address for each transfer within the burst is calculated.
+		S_AXI_AWBURST	: in std_logic_vector(1 downto 0);
 		-- Write channel Protection type. This signal indicates the
     		-- privilege and security level of the transaction, and whether
     		-- the transaction is a data access or an instruction access.
@@ -66,12 +77,18 @@ entity tinyTPU_v1_0_S00_AXI is
     		-- valid data. There is one write strobe bit for each eight
     		-- bits of the write data bus.    
 		S_AXI_WSTRB	: in std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+		-- Write last. This signal indicates the last transfer
+    		-- in a write burst.
+		S_AXI_WLAST	: in std_logic;
 		-- Write valid. This signal indicates that valid write
     		-- data and strobes are available.
 		S_AXI_WVALID	: in std_logic;
 		-- Write ready. This signal indicates that the slave
     		-- can accept the write data.
 		S_AXI_WREADY	: out std_logic;
+		-- Response ID tag. This signal is the ID tag of the
+    		-- write response.
+		S_AXI_BID	: out std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
 		-- Write response. This signal indicates the status
     		-- of the write transaction.
 		S_AXI_BRESP	: out std_logic_vector(1 downto 0);
@@ -81,8 +98,18 @@ entity tinyTPU_v1_0_S00_AXI is
 		-- Response ready. This signal indicates that the master
     		-- can accept a write response.
 		S_AXI_BREADY	: in std_logic;
+		-- Read address ID. This signal is the identification
+    		-- tag for the read address group of signals.
+		S_AXI_ARID	: in std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
 		-- Read address (issued by master, acceped by Slave)
 		S_AXI_ARADDR	: in std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+		-- Burst length. The burst length gives the exact number of transfers in a burst
+		S_AXI_ARLEN	: in std_logic_vector(7 downto 0);
+		-- Burst size. This signal indicates the size of each transfer in the burst
+		S_AXI_ARSIZE	: in std_logic_vector(2 downto 0);
+		-- Burst type. The burst type and the size information, 
+    		-- determine how the address for each transfer within the burst is calculated.
+		S_AXI_ARBURST	: in std_logic_vector(1 downto 0);
 		-- Protection type. This signal indicates the privilege
     		-- and security level of the transaction, and whether the
     		-- transaction is a data access or an instruction access.
@@ -93,11 +120,17 @@ entity tinyTPU_v1_0_S00_AXI is
 		-- Read address ready. This signal indicates that the slave is
     		-- ready to accept an address and associated control signals.
 		S_AXI_ARREADY	: out std_logic;
+		-- Read ID tag. This signal is the identification tag
+    		-- for the read data group of signals generated by the slave.
+		S_AXI_RID	: out std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
 		-- Read data (issued by slave)
 		S_AXI_RDATA	: out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
 		-- Read response. This signal indicates the status of the
     		-- read transfer.
 		S_AXI_RRESP	: out std_logic_vector(1 downto 0);
+		-- Read last. This signal indicates the last transfer
+    		-- in a read burst.
+		S_AXI_RLAST	: out std_logic;
 		-- Read valid. This signal indicates that the channel is
     		-- signaling the required read data.
 		S_AXI_RVALID	: out std_logic;
@@ -114,13 +147,15 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
         generic(
             MATRIX_WIDTH            : natural := 14;
             WEIGHT_BUFFER_DEPTH     : natural := 32768;
-            UNIFIED_BUFFER_DEPTH    : natural := 4096
+            UNIFIED_BUFFER_DEPTH    : natural := 4096;
+            BIAS_BUFFER_DEPTH       : natural := 512
         );  
         port(   
             CLK, RESET              : in  std_logic;
             ENABLE                  : in  std_logic;
             -- For calculation runtime check
             RUNTIME_COUNT           : out WORD_TYPE;
+            PERF_COUNT              : out WORD_ARRAY_TYPE(0 to PERF_COUNTER_COUNT-1);
             -- Splitted instruction input
             LOWER_INSTRUCTION_WORD  : in  WORD_TYPE;
             MIDDLE_INSTRUCTION_WORD : in  WORD_TYPE;
@@ -129,6 +164,9 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
             -- Instruction buffer flags for interrupts
             INSTRUCTION_EMPTY       : out std_logic;
             INSTRUCTION_FULL        : out std_logic;
+            -- For flow control of the host
+            INSTRUCTION_COUNT       : out WORD_TYPE;
+            SYNCHRONIZE_COUNT       : out WORD_TYPE;
         
             WEIGHT_WRITE_PORT       : in  BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
             WEIGHT_ADDRESS          : in  WEIGHT_ADDRESS_TYPE;
@@ -140,17 +178,24 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
             BUFFER_ADDRESS          : in  BUFFER_ADDRESS_TYPE;
             BUFFER_ENABLE           : in  std_logic;
             BUFFER_WRITE_ENABLE     : in  std_logic_vector(0 to MATRIX_WIDTH-1);
+            
+            BIAS_WRITE_PORT         : in  WORD_TYPE;
+            BIAS_READ_PORT          : out WORD_TYPE;
+            BIAS_ADDRESS            : in  BIAS_ADDRESS_TYPE;
+            BIAS_ENABLE             : in  std_logic;
+            BIAS_WRITE_ENABLE       : in  std_logic_vector(0 to 3);
             -- Memory synchronization flag for interrupt 
             SYNCHRONIZE             : out std_logic
         );
     end component TPU;
     for all : TPU use entity WORK.TPU(BEH);
     
-    type FSM_TYPE is (IDLE, WRITE_ADDRESS, WRITE_DATA, WRITE_RESPONSE, READ_ADDRESS, READ_DATA, READ_RESPONSE);
+    type FSM_TYPE is (IDLE, WRITE_DATA, WRITE_RESPONSE, READ_DATA);
     
     constant MATRIX_WIDTH           : natural := 14;
     constant WEIGHT_BUFFER_DEPTH    : natural := 32768;
     constant UNIFIED_BUFFER_DEPTH   : natural := 4096;
+    constant BIAS_BUFFER_DEPTH      : natural := 512; -- Bias vectors, one per output column tile
     
     constant MATRIX_ADDRESS_WIDTH       : natural := natural(ceil(log2(real(MATRIX_WIDTH) / 4.0 - 1.0))); -- Atomic range - LSBs
     constant WEIGHT_ADDRESS_BASE        : natural := 0;
@@ -161,22 +206,99 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
     constant INSTRUCTION_ADDRESS_BASE   : natural := WEIGHT_BUFFER_DEPTH + UNIFIED_BUFFER_DEPTH;
     constant INSTRUCTION_ADDRESS_END    : natural := WEIGHT_BUFFER_DEPTH + UNIFIED_BUFFER_DEPTH;
     constant INSTRUCTION_BIT_POSITION   : natural := natural(log2(real(UNIFIED_BUFFER_DEPTH)));
+    -- The upper half of the instruction space holds the bias vectors, one bias per word - a vector takes 2**ceil(log2(MATRIX_WIDTH)) words
+    constant BIAS_BIT_POSITION          : natural := INSTRUCTION_BIT_POSITION-1;
+    -- Registers of the instruction space - the performance counters start at byte offset 0x10, one counter per word
+    constant REGISTER_ADDRESS_WIDTH     : natural := 4;
+    constant PERF_REGISTER_BASE         : natural := 4;
     
     constant MATRIX_ADDRESS_SIZE        : natural := 2**MATRIX_ADDRESS_WIDTH;
     
     constant UPPER_ADDRESS_WIDTH        : natural := natural(ceil(log2(real(BUFFER_ADDRESS_END)))); -- MSBs
     constant ADDRESS_WIDTH              : natural := UPPER_ADDRESS_WIDTH + MATRIX_ADDRESS_WIDTH;
     
+    -- Burst types
+    constant BURST_FIXED                : std_logic_vector(1 downto 0) := "00";
+    constant BURST_INCR                 : std_logic_vector(1 downto 0) := "01";
+    constant BURST_WRAP                 : std_logic_vector(1 downto 0) := "10";
+    -- Beats transfer whole words
+    constant SIZE_WORD                  : std_logic_vector(2 downto 0) := "010";
+    -- Responses
+    constant RESP_OKAY                  : std_logic_vector(1 downto 0) := "00";
+    constant RESP_SLVERR                : std_logic_vector(1 downto 0) := "10";
+    
+    --! Returns the word address of the next beat. WRAP bursts wrap at the boundary of their length, the length minus one is the mask of the wrapping bits.
+    function NEXT_ADDRESS(
+        ADDRESS : std_logic_vector;
+        BURST   : std_logic_vector(1 downto 0);
+        LENGTH  : std_logic_vector(7 downto 0)
+    ) return std_logic_vector is
+        variable INCREMENTED_v  : std_logic_vector(ADDRESS'range);
+        variable NEXT_v         : std_logic_vector(ADDRESS'range);
+    begin
+        INCREMENTED_v := std_logic_vector(unsigned(ADDRESS) + 1);
+        case BURST is
+            when BURST_FIXED =>
+                NEXT_v := ADDRESS;
+            when BURST_WRAP =>
+                NEXT_v := ADDRESS;
+                NEXT_v(7 downto 0) := (ADDRESS(7 downto 0) and not LENGTH) or (INCREMENTED_v(7 downto 0) and LENGTH);
+            when others =>
+                NEXT_v := INCREMENTED_v;
+        end case;
+        return NEXT_v;
+    end function NEXT_ADDRESS;
+    
+    --! Full word beats of FIXED, INCR and aligned WRAP bursts with 2, 4, 8 or 16 beats and narrow single beats (e.g. the halfword store of the upper instruction word) are supported.
+    --! Narrow beats are written by WSTRB. Other bursts are answered with SLVERR and don't access the TPU.
+    function BURST_ERROR(
+        ADDRESS : std_logic_vector(1 downto 0);
+        BURST   : std_logic_vector(1 downto 0);
+        LENGTH  : std_logic_vector(7 downto 0);
+        SIZE    : std_logic_vector(2 downto 0)
+    ) return std_logic is
+    begin
+        if unsigned(SIZE) > unsigned(SIZE_WORD) then
+            return '1';
+        elsif SIZE /= SIZE_WORD then
+            if LENGTH = x"00" and BURST /= BURST_WRAP and BURST /= "11" then
+                return '0';
+            else
+                return '1';
+            end if;
+        end if;
+        case BURST is
+            when BURST_FIXED | BURST_INCR =>
+                return '0';
+            when BURST_WRAP =>
+                if ADDRESS = "00" and (LENGTH = x"01" or LENGTH = x"03" or LENGTH = x"07" or LENGTH = x"0F") then
+                    return '0';
+                else
+                    return '1';
+                end if;
+            when others =>
+                return '1';
+        end case;
+    end function BURST_ERROR;
+    
+    -- Read data, which was requested from the TPU, but wasn't taken by the master yet.
+    -- Has to cover the read latency of the unified buffer and the handshake, so bursts are read with one word per cycle.
+    constant READ_FIFO_DEPTH            : natural := 8;
+    type READ_FIFO_TYPE is array(0 to READ_FIFO_DEPTH-1) of std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+    
     -- TPU signals
     signal Reset                    : std_logic;
     
     signal RUNTIME_COUNT            : WORD_TYPE;
+    signal PERF_COUNT               : WORD_ARRAY_TYPE(0 to PERF_COUNTER_COUNT-1);
         
     signal LOWER_INSTRUCTION_WORD   : WORD_TYPE;
     signal MIDDLE_INSTRUCTION_WORD  : WORD_TYPE;
     signal UPPER_INSTRUCTION_WORD   : HALFWORD_TYPE;
     signal INSTRUCTION_WRITE_EN     : std_logic_vector(0 to 2);
     signal INSTRUCTION_FULL         : std_logic;
+    signal INSTRUCTION_COUNT        : WORD_TYPE;
+    signal SYNCHRONIZE_COUNT        : WORD_TYPE;
             
     signal WEIGHT_WRITE_PORT        : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     signal WEIGHT_ADDRESS           : WEIGHT_ADDRESS_TYPE;
@@ -188,6 +310,12 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
     signal BUFFER_ADDRESS           : BUFFER_ADDRESS_TYPE;
     signal BUFFER_ENABLE            : std_logic;
     signal BUFFER_WRITE_ENABLE      : std_logic_vector(0 to MATRIX_WIDTH-1);
+    
+    signal BIAS_WRITE_PORT          : WORD_TYPE;
+    signal BIAS_READ_PORT           : WORD_TYPE;
+    signal BIAS_ADDRESS             : BIAS_ADDRESS_TYPE;
+    signal BIAS_ENABLE              : std_logic;
+    signal BIAS_WRITE_ENABLE        : std_logic_vector(0 to 3);
         
     -- Address mux signals
     signal WEIGHT_WRITE_ADDRESS     : WEIGHT_ADDRESS_TYPE;
@@ -197,6 +325,12 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
     signal BUFFER_ENABLE_ON_WRITE   : std_logic;
     signal BUFFER_ENABLE_ON_READ    : std_logic;
     
+    signal BIAS_WRITE_ADDRESS       : BIAS_ADDRESS_TYPE;
+    signal BIAS_READ_ADDRESS        : BIAS_ADDRESS_TYPE;
+    
+    signal BIAS_ENABLE_ON_WRITE     : std_logic;
+    signal BIAS_ENABLE_ON_READ      : std_logic;
+    
     -- Input registers for weight buffer
     signal WEIGHT_WRITE_PORT_REG0_cs    : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1) := (others => (others => '0'));
     signal WEIGHT_WRITE_PORT_REG0_ns    : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
@@ -233,6 +367,24 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
     signal BUFFER_ENABLE_ON_WRITE_REG1_cs   : std_logic := '0';
     signal BUFFER_ENABLE_ON_WRITE_REG1_ns   : std_logic;
     
+    -- Input registers for bias buffer
+    signal BIAS_WRITE_PORT_REG0_cs      : WORD_TYPE := (others => '0');
+    signal BIAS_WRITE_PORT_REG0_ns      : WORD_TYPE;
+    signal BIAS_WRITE_PORT_REG1_cs      : WORD_TYPE := (others => '0');
+    signal BIAS_WRITE_PORT_REG1_ns      : WORD_TYPE;
+    signal BIAS_ADDRESS_REG0_cs         : BIAS_ADDRESS_TYPE := (others => '0');
+    signal BIAS_ADDRESS_REG0_ns         : BIAS_ADDRESS_TYPE;
+    signal BIAS_ADDRESS_REG1_cs         : BIAS_ADDRESS_TYPE := (others => '0');
+    signal BIAS_ADDRESS_REG1_ns         : BIAS_ADDRESS_TYPE;
+    signal BIAS_WRITE_ENABLE_REG0_cs    : std_logic_vector(0 to 3) := (others => '0');
+    signal BIAS_WRITE_ENABLE_REG0_ns    : std_logic_vector(0 to 3);
+    signal BIAS_WRITE_ENABLE_REG1_cs    : std_logic_vector(0 to 3) := (others => '0');
+    signal BIAS_WRITE_ENABLE_REG1_ns    : std_logic_vector(0 to 3);
+    signal BIAS_ENABLE_ON_WRITE_REG0_cs : std_logic := '0';
+    signal BIAS_ENABLE_ON_WRITE_REG0_ns : std_logic;
+    signal BIAS_ENABLE_ON_WRITE_REG1_cs : std_logic := '0';
+    signal BIAS_ENABLE_ON_WRITE_REG1_ns : std_logic;
+    
     -- For read delays
     signal UPPER_READ_ADDRESS_DELAY0_cs : std_logic_vector(ADDRESS_WIDTH-MATRIX_ADDRESS_WIDTH-1 downto 0) := (others => '0');
     signal UPPER_READ_ADDRESS_DELAY0_ns : std_logic_vector(ADDRESS_WIDTH-MATRIX_ADDRESS_WIDTH-1 downto 0);
@@ -253,25 +405,66 @@ architecture arch_imp of tinyTPU_v1_0_S00_AXI is
     signal STATE_ns         : FSM_TYPE;
     
     signal WRITE_ACCEPT     : std_logic;
+    signal WRITE_READY      : std_logic;
     
+    -- Burst of the write channel, the length counts the remaining beats minus one
     signal WRITE_ADDRESS_EN : std_logic;
     signal WRITE_ADDRESS_cs : std_logic_vector(C_S_AXI_ADDR_WIDTH-2-1 downto 0) := (others => '0');
     signal WRITE_ADDRESS_ns : std_logic_vector(C_S_AXI_ADDR_WIDTH-2-1 downto 0);
+    signal WRITE_LENGTH_cs  : std_logic_vector(7 downto 0) := (others => '0');
+    signal WRITE_LENGTH_ns  : std_logic_vector(7 downto 0);
+    signal WRITE_BURST_cs   : std_logic_vector(1 downto 0) := (others => '0');
+    signal WRITE_BURST_ns   : std_logic_vector(1 downto 0);
+    -- AWLEN, which masks the wrapping bits of WRAP bursts
+    signal WRITE_WRAP_cs    : std_logic_vector(7 downto 0) := (others => '0');
+    signal WRITE_WRAP_ns    : std_logic_vector(7 downto 0);
+    -- The burst isn't supported or WLAST didn't match the length
+    signal WRITE_ERROR_cs   : std_logic := '0';
+    signal WRITE_ERROR_ns   : std_logic;
+    signal WRITE_ID_cs      : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0) := (others => '0');
+    signal WRITE_ID_ns      : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
+    
+    -- Burst of the read channel, beats are requested from the TPU ahead of the handshakes
     signal READ_ADDRESS_EN  : std_logic;
     signal READ_ADDRESS_cs  : std_logic_vector(C_S_AXI_ADDR_WIDTH-2-1 downto 0) := (others => '0');
     signal READ_ADDRESS_ns  : std_logic_vector(C_S_AXI_ADDR_WIDTH-2-1 downto 0);
-    signal WRITE_DATA_EN    : std_logic;
-    signal WRITE_DATA_cs    : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0) := (others => '0');
-    signal WRITE_DATA_ns    : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
-    signal READ_DATA_EN     : std_logic;
-    signal READ_DATA_cs     : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0) := (others => '0');
-    signal READ_DATA_ns     : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+    -- Beats, which weren't requested yet
+    signal READ_ISSUE_cs    : std_logic_vector(8 downto 0) := (others => '0');
+    signal READ_ISSUE_ns    : std_logic_vector(8 downto 0);
+    -- Beats, which weren't taken by the master yet, minus one
+    signal READ_LENGTH_cs   : std_logic_vector(7 downto 0) := (others => '0');
+    signal READ_LENGTH_ns   : std_logic_vector(7 downto 0);
+    signal READ_BURST_cs    : std_logic_vector(1 downto 0) := (others => '0');
+    signal READ_BURST_ns    : std_logic_vector(1 downto 0);
+    signal READ_WRAP_cs     : std_logic_vector(7 downto 0) := (others => '0');
+    signal READ_WRAP_ns     : std_logic_vector(7 downto 0);
+    signal READ_ERROR_cs    : std_logic := '0';
+    signal READ_ERROR_ns    : std_logic;
+    signal READ_ID_cs       : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0) := (others => '0');
+    signal READ_ID_ns       : std_logic_vector(C_S_AXI_ID_WIDTH-1 downto 0);
     
     signal SLAVE_WRITE_EN   : std_logic;
     signal SLAVE_READ_EN    : std_logic;
+    signal READ_WORD        : std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
     signal READ_DATA_ON_BUS : std_logic;
     signal READ_DATA_DELAY_cs   : std_logic_vector(0 to 2) := (others => '0');
     signal READ_DATA_DELAY_ns   : std_logic_vector(0 to 2);
+    
+    -- Read data FIFO
+    signal READ_VALID       : std_logic;
+    signal READ_POP         : std_logic;
+    signal READ_FIFO_cs     : READ_FIFO_TYPE := (others => (others => '0'));
+    signal READ_FIFO_ns     : READ_FIFO_TYPE;
+    signal READ_HEAD_cs     : natural range 0 to READ_FIFO_DEPTH-1 := 0;
+    signal READ_HEAD_ns     : natural range 0 to READ_FIFO_DEPTH-1;
+    signal READ_TAIL_cs     : natural range 0 to READ_FIFO_DEPTH-1 := 0;
+    signal READ_TAIL_ns     : natural range 0 to READ_FIFO_DEPTH-1;
+    -- Words in the FIFO
+    signal READ_FILL_cs     : natural range 0 to READ_FIFO_DEPTH := 0;
+    signal READ_FILL_ns     : natural range 0 to READ_FIFO_DEPTH;
+    -- Words in the FIFO or in the read pipeline
+    signal READ_OUTSTANDING_cs  : natural range 0 to READ_FIFO_DEPTH := 0;
+    signal READ_OUTSTANDING_ns  : natural range 0 to READ_FIFO_DEPTH;
 
 begin
     RESET <= not S_AXI_ARESETN;
@@ -280,19 +473,23 @@ begin
     generic map(
         MATRIX_WIDTH            => MATRIX_WIDTH,
         WEIGHT_BUFFER_DEPTH     => WEIGHT_BUFFER_DEPTH,
-        UNIFIED_BUFFER_DEPTH    => UNIFIED_BUFFER_DEPTH
+        UNIFIED_BUFFER_DEPTH    => UNIFIED_BUFFER_DEPTH,
+        BIAS_BUFFER_DEPTH       => BIAS_BUFFER_DEPTH
     )
     port map(
         CLK                     => S_AXI_ACLK,
         RESET                   => RESET,
         ENABLE                  => '1', -- Enable always for now
         RUNTIME_COUNT           => RUNTIME_COUNT,
+        PERF_COUNT              => PERF_COUNT,
         LOWER_INSTRUCTION_WORD  => LOWER_INSTRUCTION_WORD,
         MIDDLE_INSTRUCTION_WORD => MIDDLE_INSTRUCTION_WORD,
         UPPER_INSTRUCTION_WORD  => UPPER_INSTRUCTION_WORD,
         INSTRUCTION_WRITE_EN    => INSTRUCTION_WRITE_EN,
         INSTRUCTION_EMPTY       => open,
         INSTRUCTION_FULL        => INSTRUCTION_FULL,
+        INSTRUCTION_COUNT       => INSTRUCTION_COUNT,
+        SYNCHRONIZE_COUNT       => SYNCHRONIZE_COUNT,
         WEIGHT_WRITE_PORT       => WEIGHT_WRITE_PORT,
         WEIGHT_ADDRESS          => WEIGHT_ADDRESS,
         WEIGHT_ENABLE           => WEIGHT_ENABLE,
@@ -302,6 +499,11 @@ begin
         BUFFER_ADDRESS          => BUFFER_ADDRESS,
         BUFFER_ENABLE           => BUFFER_ENABLE,
         BUFFER_WRITE_ENABLE     => BUFFER_WRITE_ENABLE,
+        BIAS_WRITE_PORT         => BIAS_WRITE_PORT,
+        BIAS_READ_PORT          => BIAS_READ_PORT,
+        BIAS_ADDRESS            => BIAS_ADDRESS,
+        BIAS_ENABLE             => BIAS_ENABLE,
+        BIAS_WRITE_ENABLE       => BIAS_WRITE_ENABLE,
         SYNCHRONIZE             => SYNCHRONIZE
     );
 
@@ -316,125 +518,87 @@ begin
     
     BUFFER_ENABLE <= BUFFER_ENABLE_ON_WRITE or BUFFER_ENABLE_ON_READ;
     
+    BIAS_ADDRESS <= BIAS_WRITE_ADDRESS when BIAS_ENABLE_ON_WRITE = '1' else BIAS_READ_ADDRESS;
+    
+    BIAS_ENABLE <= BIAS_ENABLE_ON_WRITE or BIAS_ENABLE_ON_READ;
+    
     READ_DATA_DELAY_ns(0) <= SLAVE_READ_EN;
     READ_DATA_DELAY_ns(1 to 2) <= READ_DATA_DELAY_cs(0 to 1);
     READ_DATA_ON_BUS <= READ_DATA_DELAY_cs(2);
     
-    -- Align on 32 Bit
-    WRITE_ADDRESS_ns <= S_AXI_AWADDR(C_S_AXI_ADDR_WIDTH-1 downto 2);
-    READ_ADDRESS_ns  <= S_AXI_ARADDR(C_S_AXI_ADDR_WIDTH-1 downto 2);
+    -- Responses
+    S_AXI_BRESP  <= RESP_SLVERR when WRITE_ERROR_cs = '1' else RESP_OKAY;
+    S_AXI_BID    <= WRITE_ID_cs;
+    S_AXI_RRESP  <= RESP_SLVERR when READ_ERROR_cs = '1' else RESP_OKAY;
+    S_AXI_RID    <= READ_ID_cs;
+    S_AXI_WREADY <= WRITE_READY;
     
-    WRITE_DATA_ns    <= S_AXI_WDATA;
-    S_AXI_RDATA      <= READ_DATA_cs;
+    -- Read data is taken from the head of the FIFO
+    READ_VALID   <= '1' when READ_FILL_cs /= 0 else '0';
+    READ_POP     <= READ_VALID and S_AXI_RREADY;
+    S_AXI_RVALID <= READ_VALID;
+    S_AXI_RDATA  <= READ_FIFO_cs(READ_HEAD_cs);
+    S_AXI_RLAST  <= '1' when READ_LENGTH_cs = x"00" else '0';
     
     FSM:
-    process(STATE_cs, WRITE_ACCEPT, S_AXI_AWVALID, S_AXI_ARVALID, S_AXI_WVALID, S_AXI_BREADY, S_AXI_RREADY, READ_DATA_ON_BUS) is
-        variable AWVALID_ARVALID : std_logic_vector(1 downto 0);
+    process(STATE_cs, WRITE_ACCEPT, S_AXI_AWVALID, S_AXI_ARVALID, S_AXI_WVALID, S_AXI_WLAST, S_AXI_BREADY, WRITE_LENGTH_cs, READ_ISSUE_cs, READ_LENGTH_cs, READ_OUTSTANDING_cs, READ_POP) is
     begin
-        AWVALID_ARVALID := S_AXI_AWVALID & S_AXI_ARVALID;
-    
         case STATE_cs is
             when IDLE =>
                 -- Response
-                S_AXI_BRESP <= "10"; -- Slave error
                 S_AXI_BVALID <= '0';
-                S_AXI_RVALID <= '0';
-                S_AXI_RRESP  <= "10"; -- Slave error
-                -- Address ready
+                -- Address ready - writes go first
                 S_AXI_AWREADY <= '1';
-                S_AXI_ARREADY <= '1';
+                S_AXI_ARREADY <= not S_AXI_AWVALID;
                 -- Data ready
-                S_AXI_WREADY  <= '0';
+                WRITE_READY <= '0';
                 -- Enable flags
                 SLAVE_WRITE_EN <= '0';
-                READ_DATA_EN <= '0';
                 SLAVE_READ_EN <= '0';
-                WRITE_DATA_EN <= '0';
-                case AWVALID_ARVALID is
-                    when "10" =>
-                        WRITE_ADDRESS_EN    <= '1';
-                        READ_ADDRESS_EN     <= '0';
-                        STATE_ns <= WRITE_ADDRESS;
-                    when "01" =>
-                        WRITE_ADDRESS_EN    <= '0';
-                        READ_ADDRESS_EN     <= '1';
-                        STATE_ns <= READ_ADDRESS;
-                    when others =>
-                        WRITE_ADDRESS_EN    <= '0';
-                        READ_ADDRESS_EN     <= '0';
-                        STATE_ns <= IDLE;
-                end case;
-            when WRITE_ADDRESS =>
-                -- Response
-                S_AXI_BRESP <= "10"; -- Slave error
-                S_AXI_BVALID <= '0';
-                S_AXI_RVALID <= '0';
-                S_AXI_RRESP  <= "10"; -- Slave error
-                -- Address ready
-                S_AXI_AWREADY <= '0';
-                S_AXI_ARREADY <= '0';
-                -- Data ready
-                S_AXI_WREADY  <= '1';
-                -- Enable flags
-                SLAVE_WRITE_EN <= '0';
-                WRITE_ADDRESS_EN <= '0';
-                READ_ADDRESS_EN  <= '0';
-                READ_DATA_EN <= '0';
-                SLAVE_READ_EN <= '0';
-                case S_AXI_WVALID is
-                    when '0' =>
-                        WRITE_DATA_EN <= '0';
-                        STATE_ns <= WRITE_ADDRESS;
-                    when '1' =>
-                        WRITE_DATA_EN <= '1';
-                        STATE_ns <= WRITE_DATA;
-                    when others => -- for simulation
-                        WRITE_DATA_EN <= '0';
-                        STATE_ns <= WRITE_ADDRESS;
-                end case;
+                if S_AXI_AWVALID = '1' then
+                    WRITE_ADDRESS_EN    <= '1';
+                    READ_ADDRESS_EN     <= '0';
+                    STATE_ns <= WRITE_DATA;
+                elsif S_AXI_ARVALID = '1' then
+                    WRITE_ADDRESS_EN    <= '0';
+                    READ_ADDRESS_EN     <= '1';
+                    STATE_ns <= READ_DATA;
+                else
+                    WRITE_ADDRESS_EN    <= '0';
+                    READ_ADDRESS_EN     <= '0';
+                    STATE_ns <= IDLE;
+                end if;
             when WRITE_DATA =>
                 -- Response
-                S_AXI_BRESP <= "10"; -- Slave error
                 S_AXI_BVALID <= '0';
-                S_AXI_RVALID <= '0';
-                S_AXI_RRESP  <= "10"; -- Slave error
                 -- Address ready
                 S_AXI_AWREADY <= '0';
                 S_AXI_ARREADY <= '0';
-                -- Data ready
-                S_AXI_WREADY  <= '0';
+                -- Data ready, while the device accepts
+                WRITE_READY <= WRITE_ACCEPT;
                 -- Enable flags
                 WRITE_ADDRESS_EN <= '0';
                 READ_ADDRESS_EN  <= '0';
-                READ_DATA_EN <= '0';
+                SLAVE_WRITE_EN <= WRITE_ACCEPT and S_AXI_WVALID;
                 SLAVE_READ_EN <= '0';
-                WRITE_DATA_EN <= '0';
-                SLAVE_WRITE_EN <= '1';
-                case WRITE_ACCEPT is
-                    when '0' => -- wait for the device to accept
-                        STATE_ns <= WRITE_DATA;
-                    when '1' => -- write is accepted
-                        STATE_ns <= WRITE_RESPONSE;
-                    when others =>
-                        STATE_ns <= WRITE_DATA;
-                end case;
+                -- A beat is written every cycle, until the last beat of the burst - an early WLAST ends the burst with SLVERR
+                if WRITE_ACCEPT = '1' and S_AXI_WVALID = '1' and (WRITE_LENGTH_cs = x"00" or S_AXI_WLAST = '1') then
+                    STATE_ns <= WRITE_RESPONSE;
+                else
+                    STATE_ns <= WRITE_DATA;
+                end if;
             when WRITE_RESPONSE =>
                 -- Response
-                S_AXI_BRESP <= "00"; -- OK
                 S_AXI_BVALID <= '1';
-                S_AXI_RVALID <= '0';
-                S_AXI_RRESP  <= "10"; -- Slave error
                 -- Address ready
                 S_AXI_AWREADY <= '0';
                 S_AXI_ARREADY <= '0';
                 -- Data ready
-                S_AXI_WREADY  <= '0';
+                WRITE_READY <= '0';
                 -- Enable flags
                 WRITE_ADDRESS_EN <= '0';
                 READ_ADDRESS_EN  <= '0';
                 SLAVE_WRITE_EN <= '0';
-                WRITE_DATA_EN <= '0';
-                READ_DATA_EN <= '0';
                 SLAVE_READ_EN <= '0';
                 case S_AXI_BREADY is
                     when '0' =>
@@ -444,102 +608,144 @@ begin
                     when others =>
                         STATE_ns <= WRITE_RESPONSE;
                 end case;
-            when READ_ADDRESS =>
-                -- Response
-                S_AXI_BRESP <= "10"; -- Slave error
-                S_AXI_BVALID <= '0';
-                S_AXI_RVALID <= '0';
-                S_AXI_RRESP  <= "10"; -- Slave error
-                -- Address ready
-                S_AXI_AWREADY <= '0';
-                S_AXI_ARREADY <= '0';
-                -- Data ready
-                S_AXI_WREADY  <= '0';
-                -- Enable flags
-                SLAVE_WRITE_EN <= '0';
-                WRITE_ADDRESS_EN <= '0';
-                READ_ADDRESS_EN  <= '0';
-                WRITE_DATA_EN <= '0';
-                READ_DATA_EN <= '0';
-                case S_AXI_RREADY is
-                    when '0' =>
-                        SLAVE_READ_EN <= '0';
-                        STATE_ns <= READ_ADDRESS;
-                    when '1' =>
-                        SLAVE_READ_EN <= '1';
-                        STATE_ns <= READ_DATA;
-                    when others =>
-                        SLAVE_READ_EN <= '0';
-                        STATE_ns <= READ_ADDRESS;
-                end case;
             when READ_DATA =>
                 -- Response
-                S_AXI_BRESP <= "10"; -- Slave error
-                S_AXI_BVALID <= '0';
-                S_AXI_RVALID <= '0';
-                S_AXI_RRESP  <= "10"; -- Slave error
-                -- Address ready
-                S_AXI_AWREADY <= '0';
-                S_AXI_ARREADY <= '0';
-                -- Data ready
-                S_AXI_WREADY  <= '0';
-                -- Enable flags
-                WRITE_ADDRESS_EN <= '0';
-                READ_ADDRESS_EN  <= '0';
-                WRITE_DATA_EN <= '0';
-                SLAVE_WRITE_EN <= '0';
-                SLAVE_READ_EN <= '0';
-                case READ_DATA_ON_BUS is
-                    when '0' =>
-                        READ_DATA_EN <= '0';
-                        STATE_ns <= READ_DATA;
-                    when '1' =>
-                        READ_DATA_EN <= '1';
-                        STATE_ns <= READ_RESPONSE;
-                    when others =>
-                        READ_DATA_EN <= '0';
-                        STATE_ns <= READ_DATA;
-                end case;
-            when READ_RESPONSE =>
-                -- Response
-                S_AXI_BRESP <= "10"; -- Slave error
                 S_AXI_BVALID <= '0';
-                S_AXI_RVALID <= '1';
-                S_AXI_RRESP  <= "00"; -- OK
                 -- Address ready
                 S_AXI_AWREADY <= '0';
                 S_AXI_ARREADY <= '0';
                 -- Data ready
-                S_AXI_WREADY  <= '0';
+                WRITE_READY <= '0';
                 -- Enable flags
                 WRITE_ADDRESS_EN <= '0';
                 READ_ADDRESS_EN  <= '0';
                 SLAVE_WRITE_EN <= '0';
-                WRITE_DATA_EN <= '0';
-                READ_DATA_EN <= '0';
-                SLAVE_READ_EN <= '0';
-                STATE_ns <= IDLE;
+                -- Beats are requested every cycle, as long as their data fits into the FIFO
+                if unsigned(READ_ISSUE_cs) /= 0 and READ_OUTSTANDING_cs /= READ_FIFO_DEPTH then
+                    SLAVE_READ_EN <= '1';
+                else
+                    SLAVE_READ_EN <= '0';
+                end if;
+                -- Done, when the master took the last beat
+                if READ_POP = '1' and READ_LENGTH_cs = x"00" then
+                    STATE_ns <= IDLE;
+                else
+                    STATE_ns <= READ_DATA;
+                end if;
             when others =>
                 -- Response
-                S_AXI_BRESP <= "10"; -- Slave error
                 S_AXI_BVALID <= '0';
-                S_AXI_RVALID <= '0';
-                S_AXI_RRESP  <= "10"; -- Slave error
                 -- Address ready
                 S_AXI_AWREADY <= '0';
                 S_AXI_ARREADY <= '0';
                 -- Data ready
-                S_AXI_WREADY  <= '0';
+                WRITE_READY <= '0';
                 -- Enable flags
                 WRITE_ADDRESS_EN <= '0';
                 READ_ADDRESS_EN  <= '0';
                 SLAVE_WRITE_EN <= '0';
-                WRITE_DATA_EN <= '0';
-                READ_DATA_EN <= '0';
                 SLAVE_READ_EN <= '0';
                 STATE_ns <= IDLE;
         end case;
     end process FSM;
+    
+    -- Every beat transfers a word, the address of the next beat is given by the burst type
+    BURST_COUNTER:
+    process(WRITE_ADDRESS_EN, READ_ADDRESS_EN, SLAVE_WRITE_EN, SLAVE_READ_EN, READ_POP, S_AXI_WLAST,
+            S_AXI_AWID, S_AXI_AWADDR, S_AXI_AWLEN, S_AXI_AWSIZE, S_AXI_AWBURST, S_AXI_ARID, S_AXI_ARADDR, S_AXI_ARLEN, S_AXI_ARSIZE, S_AXI_ARBURST,
+            WRITE_ADDRESS_cs, WRITE_LENGTH_cs, WRITE_BURST_cs, WRITE_WRAP_cs, WRITE_ERROR_cs, WRITE_ID_cs,
+            READ_ADDRESS_cs, READ_ISSUE_cs, READ_LENGTH_cs, READ_BURST_cs, READ_WRAP_cs, READ_ERROR_cs, READ_ID_cs) is
+    begin
+        if WRITE_ADDRESS_EN = '1' then
+            WRITE_ADDRESS_ns <= S_AXI_AWADDR(C_S_AXI_ADDR_WIDTH-1 downto 2);
+            WRITE_LENGTH_ns  <= S_AXI_AWLEN;
+            WRITE_BURST_ns   <= S_AXI_AWBURST;
+            WRITE_WRAP_ns    <= S_AXI_AWLEN;
+            WRITE_ERROR_ns   <= BURST_ERROR(S_AXI_AWADDR(1 downto 0), S_AXI_AWBURST, S_AXI_AWLEN, S_AXI_AWSIZE);
+            WRITE_ID_ns      <= S_AXI_AWID;
+        else
+            if SLAVE_WRITE_EN = '1' then
+                WRITE_ADDRESS_ns <= NEXT_ADDRESS(WRITE_ADDRESS_cs, WRITE_BURST_cs, WRITE_WRAP_cs);
+                WRITE_LENGTH_ns <= std_logic_vector(unsigned(WRITE_LENGTH_cs) - 1);
+                -- WLAST has to be set on the last beat of the burst and only there
+                if (S_AXI_WLAST = '1') /= (WRITE_LENGTH_cs = x"00") then
+                    WRITE_ERROR_ns <= '1';
+                else
+                    WRITE_ERROR_ns <= WRITE_ERROR_cs;
+                end if;
+            else
+                WRITE_ADDRESS_ns <= WRITE_ADDRESS_cs;
+                WRITE_LENGTH_ns  <= WRITE_LENGTH_cs;
+                WRITE_ERROR_ns   <= WRITE_ERROR_cs;
+            end if;
+            WRITE_BURST_ns   <= WRITE_BURST_cs;
+            WRITE_WRAP_ns    <= WRITE_WRAP_cs;
+            WRITE_ID_ns      <= WRITE_ID_cs;
+        end if;
+        
+        if READ_ADDRESS_EN = '1' then
+            READ_ADDRESS_ns <= S_AXI_ARADDR(C_S_AXI_ADDR_WIDTH-1 downto 2);
+            READ_ISSUE_ns   <= std_logic_vector(resize(unsigned(S_AXI_ARLEN), READ_ISSUE_ns'length) + 1);
+            READ_LENGTH_ns  <= S_AXI_ARLEN;
+            READ_BURST_ns   <= S_AXI_ARBURST;
+            READ_WRAP_ns    <= S_AXI_ARLEN;
+            READ_ERROR_ns   <= BURST_ERROR(S_AXI_ARADDR(1 downto 0), S_AXI_ARBURST, S_AXI_ARLEN, S_AXI_ARSIZE);
+            READ_ID_ns      <= S_AXI_ARID;
+        else
+            if SLAVE_READ_EN = '1' then
+                READ_ADDRESS_ns <= NEXT_ADDRESS(READ_ADDRESS_cs, READ_BURST_cs, READ_WRAP_cs);
+                READ_ISSUE_ns <= std_logic_vector(unsigned(READ_ISSUE_cs) - 1);
+            else
+                READ_ADDRESS_ns <= READ_ADDRESS_cs;
+                READ_ISSUE_ns   <= READ_ISSUE_cs;
+            end if;
+            
+            if READ_POP = '1' then
+                READ_LENGTH_ns <= std_logic_vector(unsigned(READ_LENGTH_cs) - 1);
+            else
+                READ_LENGTH_ns <= READ_LENGTH_cs;
+            end if;
+            READ_BURST_ns   <= READ_BURST_cs;
+            READ_WRAP_ns    <= READ_WRAP_cs;
+            READ_ERROR_ns   <= READ_ERROR_cs;
+            READ_ID_ns      <= READ_ID_cs;
+        end if;
+    end process BURST_COUNTER;
+    
+    READ_FIFO:
+    process(READ_FIFO_cs, READ_HEAD_cs, READ_TAIL_cs, READ_FILL_cs, READ_OUTSTANDING_cs, READ_DATA_ON_BUS, READ_WORD, READ_POP, SLAVE_READ_EN) is
+    begin
+        -- Data of the unified buffer arrives at the tail
+        READ_FIFO_ns <= READ_FIFO_cs;
+        if READ_DATA_ON_BUS = '1' then
+            READ_FIFO_ns(READ_TAIL_cs) <= READ_WORD;
+            READ_TAIL_ns <= (READ_TAIL_cs + 1) mod READ_FIFO_DEPTH;
+        else
+            READ_TAIL_ns <= READ_TAIL_cs;
+        end if;
+        
+        if READ_POP = '1' then
+            READ_HEAD_ns <= (READ_HEAD_cs + 1) mod READ_FIFO_DEPTH;
+        else
+            READ_HEAD_ns <= READ_HEAD_cs;
+        end if;
+        
+        if READ_DATA_ON_BUS = '1' and READ_POP = '0' then
+            READ_FILL_ns <= READ_FILL_cs + 1;
+        elsif READ_DATA_ON_BUS = '0' and READ_POP = '1' then
+            READ_FILL_ns <= READ_FILL_cs - 1;
+        else
+            READ_FILL_ns <= READ_FILL_cs;
+        end if;
+        
+        if SLAVE_READ_EN = '1' and READ_POP = '0' then
+            READ_OUTSTANDING_ns <= READ_OUTSTANDING_cs + 1;
+        elsif SLAVE_READ_EN = '0' and READ_POP = '1' then
+            READ_OUTSTANDING_ns <= READ_OUTSTANDING_cs - 1;
+        else
+            READ_OUTSTANDING_ns <= READ_OUTSTANDING_cs;
+        end if;
+    end process READ_FIFO;
    
     WEIGHT_WRITE_PORT_REG1_ns <= WEIGHT_WRITE_PORT_REG0_cs;
     WEIGHT_WRITE_PORT <= WEIGHT_WRITE_PORT_REG1_cs;
@@ -564,9 +770,21 @@ begin
     
     BUFFER_ENABLE_ON_WRITE_REG1_ns <= BUFFER_ENABLE_ON_WRITE_REG0_cs;
     BUFFER_ENABLE_ON_WRITE <= BUFFER_ENABLE_ON_WRITE_REG1_cs;
+    --
+    BIAS_WRITE_PORT_REG1_ns <= BIAS_WRITE_PORT_REG0_cs;
+    BIAS_WRITE_PORT <= BIAS_WRITE_PORT_REG1_cs;
+    
+    BIAS_ADDRESS_REG1_ns <= BIAS_ADDRESS_REG0_cs;
+    BIAS_WRITE_ADDRESS <= BIAS_ADDRESS_REG1_cs;
+    
+    BIAS_WRITE_ENABLE_REG1_ns <= BIAS_WRITE_ENABLE_REG0_cs;
+    BIAS_WRITE_ENABLE <= BIAS_WRITE_ENABLE_REG1_cs;
+    
+    BIAS_ENABLE_ON_WRITE_REG1_ns <= BIAS_ENABLE_ON_WRITE_REG0_cs;
+    BIAS_ENABLE_ON_WRITE <= BIAS_ENABLE_ON_WRITE_REG1_cs;
     
     TPU_WRITE:
-    process(SLAVE_WRITE_EN, WRITE_ADDRESS_cs, WRITE_DATA_cs, S_AXI_WSTRB, INSTRUCTION_FULL) is
+    process(SLAVE_WRITE_EN, WRITE_ERROR_cs, WRITE_ADDRESS_cs, S_AXI_WDATA, S_AXI_WSTRB, INSTRUCTION_FULL) is
         variable UPPER_WRITE_ADDRESS_v : std_logic_vector(ADDRESS_WIDTH-MATRIX_ADDRESS_WIDTH-1 downto 0);
         variable LOWER_WRITE_ADDRESS_v : std_logic_vector(MATRIX_ADDRESS_WIDTH-1 downto 0);
     begin
@@ -574,15 +792,16 @@ begin
         LOWER_WRITE_ADDRESS_v := WRITE_ADDRESS_cs(MATRIX_ADDRESS_WIDTH-1 downto 0);
         
         -- Connect write data to instruction ports
-        LOWER_INSTRUCTION_WORD  <= WRITE_DATA_cs;
-        MIDDLE_INSTRUCTION_WORD <= WRITE_DATA_cs;
-        UPPER_INSTRUCTION_WORD  <= WRITE_DATA_cs(2*BYTE_WIDTH-1 downto 0);
+        LOWER_INSTRUCTION_WORD  <= S_AXI_WDATA;
+        MIDDLE_INSTRUCTION_WORD <= S_AXI_WDATA;
+        UPPER_INSTRUCTION_WORD  <= S_AXI_WDATA(2*BYTE_WIDTH-1 downto 0);
         
         -- Connect write data to weight buffer and unified buffer write port
         for i in 0 to MATRIX_WIDTH-1 loop
-            WEIGHT_WRITE_PORT_REG0_ns(i) <= WRITE_DATA_cs(((i mod 4)+1)*BYTE_WIDTH-1 downto (i mod 4)*BYTE_WIDTH);
-            BUFFER_WRITE_PORT_REG0_ns(i) <= WRITE_DATA_cs(((i mod 4)+1)*BYTE_WIDTH-1 downto (i mod 4)*BYTE_WIDTH);
+            WEIGHT_WRITE_PORT_REG0_ns(i) <= S_AXI_WDATA(((i mod 4)+1)*BYTE_WIDTH-1 downto (i mod 4)*BYTE_WIDTH);
+            BUFFER_WRITE_PORT_REG0_ns(i) <= S_AXI_WDATA(((i mod 4)+1)*BYTE_WIDTH-1 downto (i mod 4)*BYTE_WIDTH);
         end loop;
+        BIAS_WRITE_PORT_REG0_ns <= S_AXI_WDATA;
         
         WEIGHT_ADDRESS_REG0_ns(BUFFER_BIT_POSITION-1 downto 0) <= UPPER_WRITE_ADDRESS_v(BUFFER_BIT_POSITION-1 downto 0);
         WEIGHT_ADDRESS_REG0_ns(WEIGHT_ADDRESS_WIDTH-1 downto BUFFER_BIT_POSITION) <= (others => '0');
@@ -590,7 +809,24 @@ begin
         BUFFER_ADDRESS_REG0_ns(INSTRUCTION_BIT_POSITION-1 downto 0) <= UPPER_WRITE_ADDRESS_v(INSTRUCTION_BIT_POSITION-1 downto 0);
         BUFFER_ADDRESS_REG0_ns(BUFFER_ADDRESS_WIDTH-1 downto INSTRUCTION_BIT_POSITION) <= (others => '0');
         
-        if SLAVE_WRITE_EN = '1' then
+        BIAS_ADDRESS_REG0_ns(BIAS_BIT_POSITION+MATRIX_ADDRESS_WIDTH-1 downto 0) <= UPPER_WRITE_ADDRESS_v(BIAS_BIT_POSITION-1 downto 0) & LOWER_WRITE_ADDRESS_v;
+        BIAS_ADDRESS_REG0_ns(BIAS_ADDRESS_WIDTH-1 downto BIAS_BIT_POSITION+MATRIX_ADDRESS_WIDTH) <= (others => '0');
+        
+        -- Instructions are only accepted, if they fit into the FIFO - the burst is stalled otherwise
+        if WRITE_ERROR_cs = '1' then -- Beats of failed bursts are dropped
+            WRITE_ACCEPT <= '1';
+        elsif UPPER_WRITE_ADDRESS_v(BUFFER_BIT_POSITION) = '1' and UPPER_WRITE_ADDRESS_v(INSTRUCTION_BIT_POSITION) = '1' and UPPER_WRITE_ADDRESS_v(BIAS_BIT_POSITION) = '0' then -- Instruction space
+            case to_integer(unsigned(LOWER_WRITE_ADDRESS_v)) is
+                when 1 to 3 =>
+                    WRITE_ACCEPT <= not INSTRUCTION_FULL;
+                when others =>
+                    WRITE_ACCEPT <= '1';
+            end case;
+        else
+            WRITE_ACCEPT <= '1';
+        end if;
+        
+        if SLAVE_WRITE_EN = '1' and WRITE_ERROR_cs = '0' then
             if    UPPER_WRITE_ADDRESS_v(     BUFFER_BIT_POSITION) = '0' then -- Weight space
                 WEIGHT_ENABLE_ON_WRITE_REG0_ns <= '1';
                 
@@ -609,7 +845,8 @@ begin
                 INSTRUCTION_WRITE_EN <= "000";
                 BUFFER_ENABLE_ON_WRITE_REG0_ns <= '0';
                 BUFFER_WRITE_ENABLE_REG0_ns <= (others => '0');
-                WRITE_ACCEPT <= '1';
+                BIAS_ENABLE_ON_WRITE_REG0_ns <= '0';
+                BIAS_WRITE_ENABLE_REG0_ns <= (others => '0');
             elsif UPPER_WRITE_ADDRESS_v(INSTRUCTION_BIT_POSITION) = '0' then -- Buffer space
                 BUFFER_ENABLE_ON_WRITE_REG0_ns <= '1';
                 
@@ -628,42 +865,38 @@ begin
                 WEIGHT_ENABLE_ON_WRITE_REG0_ns <= '0';
                 WEIGHT_WRITE_ENABLE_REG0_ns <= (others => '0');
                 INSTRUCTION_WRITE_EN <= "000";
-                WRITE_ACCEPT <= '1';
-            else -- Instruction space
+                BIAS_ENABLE_ON_WRITE_REG0_ns <= '0';
+                BIAS_WRITE_ENABLE_REG0_ns <= (others => '0');
+            elsif UPPER_WRITE_ADDRESS_v(BIAS_BIT_POSITION) = '1' then -- Bias space
+                BIAS_ENABLE_ON_WRITE_REG0_ns <= '1';
+                
+                for i in 0 to 3 loop
+                    BIAS_WRITE_ENABLE_REG0_ns(i) <= S_AXI_WSTRB(i);
+                end loop;
+                
+                WEIGHT_ENABLE_ON_WRITE_REG0_ns <= '0';
+                WEIGHT_WRITE_ENABLE_REG0_ns <= (others => '0');
+                BUFFER_ENABLE_ON_WRITE_REG0_ns <= '0';
+                BUFFER_WRITE_ENABLE_REG0_ns <= (others => '0');
+                INSTRUCTION_WRITE_EN <= "000";
+            else -- Instruction space - SLAVE_WRITE_EN is only set, if the FIFO isn't full
                 case to_integer(unsigned(LOWER_WRITE_ADDRESS_v)) is
                     when 1 =>
-                        if INSTRUCTION_FULL = '1' then
-                            INSTRUCTION_WRITE_EN <= "000";
-                            WRITE_ACCEPT <= '0';
-                        else
-                            INSTRUCTION_WRITE_EN <= "100";
-                            WRITE_ACCEPT <= '1';
-                        end if;
+                        INSTRUCTION_WRITE_EN <= "100";
                     when 2 =>
-                        if INSTRUCTION_FULL = '1' then
-                            INSTRUCTION_WRITE_EN <= "000";
-                            WRITE_ACCEPT <= '0';
-                        else
-                            INSTRUCTION_WRITE_EN <= "010";
-                            WRITE_ACCEPT <= '1';
-                        end if;
+                        INSTRUCTION_WRITE_EN <= "010";
                     when 3 =>
-                        if INSTRUCTION_FULL = '1' then
-                            INSTRUCTION_WRITE_EN <= "000";
-                            WRITE_ACCEPT <= '0';
-                        else
-                            INSTRUCTION_WRITE_EN <= "001";
-                            WRITE_ACCEPT <= '1';
-                        end if;
+                        INSTRUCTION_WRITE_EN <= "001";
                     when others =>
                         INSTRUCTION_WRITE_EN <= "000";
-                        WRITE_ACCEPT <= '1';
                 end case;
                 
                 WEIGHT_ENABLE_ON_WRITE_REG0_ns <= '0';
                 WEIGHT_WRITE_ENABLE_REG0_ns <= (others => '0');
                 BUFFER_ENABLE_ON_WRITE_REG0_ns <= '0';
                 BUFFER_WRITE_ENABLE_REG0_ns <= (others => '0');
+                BIAS_ENABLE_ON_WRITE_REG0_ns <= '0';
+                BIAS_WRITE_ENABLE_REG0_ns <= (others => '0');
             end if;
         else
             INSTRUCTION_WRITE_EN <= "000";
@@ -671,15 +904,17 @@ begin
             WEIGHT_WRITE_ENABLE_REG0_ns <= (others => '0');
             BUFFER_ENABLE_ON_WRITE_REG0_ns <= '0';
             BUFFER_WRITE_ENABLE_REG0_ns <= (others => '0');
-            WRITE_ACCEPT <= '1';
+            BIAS_ENABLE_ON_WRITE_REG0_ns <= '0';
+            BIAS_WRITE_ENABLE_REG0_ns <= (others => '0');
         end if;
     end process TPU_WRITE;
 
     
     TPU_READ:
-	process (SLAVE_READ_EN, READ_ADDRESS_cs, UPPER_READ_ADDRESS_DELAY2_cs, LOWER_READ_ADDRESS_DELAY2_cs, BUFFER_READ_PORT, RUNTIME_COUNT)
+	process (SLAVE_READ_EN, READ_ERROR_cs, READ_ADDRESS_cs, UPPER_READ_ADDRESS_DELAY2_cs, LOWER_READ_ADDRESS_DELAY2_cs, BUFFER_READ_PORT, BIAS_READ_PORT, RUNTIME_COUNT, INSTRUCTION_COUNT, SYNCHRONIZE_COUNT, PERF_COUNT)
         variable UPPER_READ_ADDRESS_v : std_logic_vector(ADDRESS_WIDTH-MATRIX_ADDRESS_WIDTH-1 downto 0);
         variable LOWER_READ_ADDRESS_v : std_logic_vector(MATRIX_ADDRESS_WIDTH-1 downto 0);
+        variable REGISTER_v : natural;
     begin
         UPPER_READ_ADDRESS_v := READ_ADDRESS_cs(ADDRESS_WIDTH-1 downto MATRIX_ADDRESS_WIDTH);
         LOWER_READ_ADDRESS_v := READ_ADDRESS_cs(MATRIX_ADDRESS_WIDTH-1 downto 0);
@@ -690,33 +925,55 @@ begin
         BUFFER_READ_ADDRESS(INSTRUCTION_BIT_POSITION-1 downto 0) <= UPPER_READ_ADDRESS_v(INSTRUCTION_BIT_POSITION-1 downto 0);
         BUFFER_READ_ADDRESS(BUFFER_ADDRESS_WIDTH-1 downto INSTRUCTION_BIT_POSITION) <= (others => '0');
         
-        if SLAVE_READ_EN = '1' then
+        BIAS_READ_ADDRESS(BIAS_BIT_POSITION+MATRIX_ADDRESS_WIDTH-1 downto 0) <= UPPER_READ_ADDRESS_v(BIAS_BIT_POSITION-1 downto 0) & LOWER_READ_ADDRESS_v;
+        BIAS_READ_ADDRESS(BIAS_ADDRESS_WIDTH-1 downto BIAS_BIT_POSITION+MATRIX_ADDRESS_WIDTH) <= (others => '0');
+        
+        -- Beats of failed bursts are answered without reading the buffers
+        if SLAVE_READ_EN = '1' and READ_ERROR_cs = '0' then
             if UPPER_READ_ADDRESS_v(BUFFER_BIT_POSITION) = '1' and UPPER_READ_ADDRESS_v(INSTRUCTION_BIT_POSITION) = '0' then
                 BUFFER_ENABLE_ON_READ <= '1';
             else
                 BUFFER_ENABLE_ON_READ <= '0';
             end if;
+            
+            if UPPER_READ_ADDRESS_v(BUFFER_BIT_POSITION) = '1' and UPPER_READ_ADDRESS_v(INSTRUCTION_BIT_POSITION) = '1' and UPPER_READ_ADDRESS_v(BIAS_BIT_POSITION) = '1' then
+                BIAS_ENABLE_ON_READ <= '1';
+            else
+                BIAS_ENABLE_ON_READ <= '0';
+            end if;
         else
             BUFFER_ENABLE_ON_READ <= '0';
+            BIAS_ENABLE_ON_READ <= '0';
         end if;
         
         -- Read
         if    UPPER_READ_ADDRESS_DELAY2_cs(     BUFFER_BIT_POSITION) = '0' then -- Weight space
-            READ_DATA_ns <= (others => '0'); -- Weights are write-only
+            READ_WORD <= (others => '0'); -- Weights are write-only
         elsif UPPER_READ_ADDRESS_DELAY2_cs(INSTRUCTION_BIT_POSITION) = '0' then -- Buffer space
             for i in 0 to 3 loop
                 if to_integer(unsigned(LOWER_READ_ADDRESS_DELAY2_cs)) * 4 + i > MATRIX_WIDTH-1 then
-                    READ_DATA_ns((i+1)*BYTE_WIDTH-1 downto i*BYTE_WIDTH) <= (others => '0');
+                    READ_WORD((i+1)*BYTE_WIDTH-1 downto i*BYTE_WIDTH) <= (others => '0');
                 else
-                    READ_DATA_ns((i+1)*BYTE_WIDTH-1 downto i*BYTE_WIDTH) <= BUFFER_READ_PORT(to_integer(unsigned(LOWER_READ_ADDRESS_DELAY2_cs)) * 4 + i);
+                    READ_WORD((i+1)*BYTE_WIDTH-1 downto i*BYTE_WIDTH) <= BUFFER_READ_PORT(to_integer(unsigned(LOWER_READ_ADDRESS_DELAY2_cs)) * 4 + i);
                 end if;
             end loop;
+        elsif UPPER_READ_ADDRESS_DELAY2_cs(BIAS_BIT_POSITION) = '1' then -- Bias space
+            READ_WORD <= BIAS_READ_PORT;
         else -- Instruction space
-            case to_integer(unsigned(LOWER_READ_ADDRESS_DELAY2_cs)) is
+            REGISTER_v := to_integer(unsigned(UPPER_READ_ADDRESS_DELAY2_cs(REGISTER_ADDRESS_WIDTH-1 downto 0) & LOWER_READ_ADDRESS_DELAY2_cs));
+            case REGISTER_v is
                 when 0 =>
-                    READ_DATA_ns <= RUNTIME_COUNT;
+                    READ_WORD <= RUNTIME_COUNT;
+                when 1 =>
+                    READ_WORD <= INSTRUCTION_COUNT;
+                when 2 =>
+                    READ_WORD <= SYNCHRONIZE_COUNT;
                 when others =>
-                    READ_DATA_ns <= (others => '0');
+                    if REGISTER_v >= PERF_REGISTER_BASE and REGISTER_v < PERF_REGISTER_BASE + PERF_COUNTER_COUNT then
+                        READ_WORD <= PERF_COUNT(REGISTER_v - PERF_REGISTER_BASE);
+                    else
+                        READ_WORD <= (others => '0');
+                    end if;
             end case;
         end if;
 	end process TPU_READ; 
@@ -730,9 +987,23 @@ begin
                 STATE_cs <= IDLE;
                 READ_DATA_DELAY_cs  <= (others => '0');
                 WRITE_ADDRESS_cs    <= (others => '0');
+                WRITE_LENGTH_cs     <= (others => '0');
+                WRITE_BURST_cs      <= (others => '0');
+                WRITE_WRAP_cs       <= (others => '0');
+                WRITE_ERROR_cs      <= '0';
+                WRITE_ID_cs         <= (others => '0');
                 READ_ADDRESS_cs     <= (others => '0');
-                WRITE_DATA_cs       <= (others => '0');
-                READ_DATA_cs        <= (others => '0');
+                READ_ISSUE_cs       <= (others => '0');
+                READ_LENGTH_cs      <= (others => '0');
+                READ_BURST_cs       <= (others => '0');
+                READ_WRAP_cs        <= (others => '0');
+                READ_ERROR_cs       <= '0';
+                READ_ID_cs          <= (others => '0');
+                READ_FIFO_cs        <= (others => (others => '0'));
+                READ_HEAD_cs        <= 0;
+                READ_TAIL_cs        <= 0;
+                READ_FILL_cs        <= 0;
+                READ_OUTSTANDING_cs <= 0;
                 UPPER_READ_ADDRESS_DELAY0_cs <= (others => '0');
                 UPPER_READ_ADDRESS_DELAY1_cs <= (others => '0');
                 UPPER_READ_ADDRESS_DELAY2_cs <= (others => '0');
@@ -755,22 +1026,33 @@ begin
                 BUFFER_WRITE_ENABLE_REG1_cs <= (others => '0');
                 BUFFER_ENABLE_ON_WRITE_REG0_cs <= '0';
                 BUFFER_ENABLE_ON_WRITE_REG1_cs <= '0';
+                BIAS_WRITE_PORT_REG0_cs     <= (others => '0');
+                BIAS_WRITE_PORT_REG1_cs     <= (others => '0');
+                BIAS_ADDRESS_REG0_cs        <= (others => '0');
+                BIAS_ADDRESS_REG1_cs        <= (others => '0');
+                BIAS_WRITE_ENABLE_REG0_cs   <= (others => '0');
+                BIAS_WRITE_ENABLE_REG1_cs   <= (others => '0');
+                BIAS_ENABLE_ON_WRITE_REG0_cs <= '0';
+                BIAS_ENABLE_ON_WRITE_REG1_cs <= '0';
             else
-                if WRITE_ADDRESS_EN = '1' then
-                    WRITE_ADDRESS_cs <= WRITE_ADDRESS_ns;
-                end if;
-                
-                if READ_ADDRESS_EN = '1' then
-                    READ_ADDRESS_cs <= READ_ADDRESS_ns;
-                end if;
-                
-                if WRITE_DATA_EN = '1' then
-                    WRITE_DATA_cs <= WRITE_DATA_ns;
-                end if;
-                
-                if READ_DATA_EN = '1' then
-                    READ_DATA_cs <= READ_DATA_ns;
-                end if;
+                WRITE_ADDRESS_cs    <= WRITE_ADDRESS_ns;
+                WRITE_LENGTH_cs     <= WRITE_LENGTH_ns;
+                WRITE_BURST_cs      <= WRITE_BURST_ns;
+                WRITE_WRAP_cs       <= WRITE_WRAP_ns;
+                WRITE_ERROR_cs      <= WRITE_ERROR_ns;
+                WRITE_ID_cs         <= WRITE_ID_ns;
+                READ_ADDRESS_cs     <= READ_ADDRESS_ns;
+                READ_ISSUE_cs       <= READ_ISSUE_ns;
+                READ_LENGTH_cs      <= READ_LENGTH_ns;
+                READ_BURST_cs       <= READ_BURST_ns;
+                READ_WRAP_cs        <= READ_WRAP_ns;
+                READ_ERROR_cs       <= READ_ERROR_ns;
+                READ_ID_cs          <= READ_ID_ns;
+                READ_FIFO_cs        <= READ_FIFO_ns;
+                READ_HEAD_cs        <= READ_HEAD_ns;
+                READ_TAIL_cs        <= READ_TAIL_ns;
+                READ_FILL_cs        <= READ_FILL_ns;
+                READ_OUTSTANDING_cs <= READ_OUTSTANDING_ns;
             
                 STATE_cs <= STATE_ns;
                 READ_DATA_DELAY_cs <= READ_DATA_DELAY_ns;
@@ -798,6 +1080,15 @@ begin
                 BUFFER_WRITE_ENABLE_REG1_cs <= BUFFER_WRITE_ENABLE_REG1_ns;
                 BUFFER_ENABLE_ON_WRITE_REG0_cs <= BUFFER_ENABLE_ON_WRITE_REG0_ns;
                 BUFFER_ENABLE_ON_WRITE_REG1_cs <= BUFFER_ENABLE_ON_WRITE_REG1_ns;
+                
+                BIAS_WRITE_PORT_REG0_cs     <= BIAS_WRITE_PORT_REG0_ns;
+                BIAS_WRITE_PORT_REG1_cs     <= BIAS_WRITE_PORT_REG1_ns;
+                BIAS_ADDRESS_REG0_cs        <= BIAS_ADDRESS_REG0_ns;
+                BIAS_ADDRESS_REG1_cs        <= BIAS_ADDRESS_REG1_ns;
+                BIAS_WRITE_ENABLE_REG0_cs   <= BIAS_WRITE_ENABLE_REG0_ns;
+                BIAS_WRITE_ENABLE_REG1_cs   <= BIAS_WRITE_ENABLE_REG1_ns;
+                BIAS_ENABLE_ON_WRITE_REG0_cs <= BIAS_ENABLE_ON_WRITE_REG0_ns;
+                BIAS_ENABLE_ON_WRITE_REG1_cs <= BIAS_ENABLE_ON_WRITE_REG1_ns;
             end if;
         end if;
     end process SEQ_LOG;
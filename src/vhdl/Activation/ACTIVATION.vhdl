@@ -22,8 +22,14 @@
 --! @file ACTIVATION.vhdl
 --! @author Jonas Fuhrmann
 --! @brief This component calculates the selected activation function for the input array.
---! @details The input is rounded, has some checker logic for ReLU and look-up-tables for the sigmoid function.
---! All functions are quantized.
+--! @details The input is rounded, has some checker logic for ReLU, ReLU6 and CReLU and look-up-tables for the other functions.
+--! All functions are quantized. The look-up-tables use the rounded input of the sigmoid function (Q4.4 signed, Qu3.5 unsigned)
+--! and saturate outside of their range. ReLU6, ELU, SELU and softplus are unbounded and return the same format as their input,
+--! sigmoid, tanh and softsign return fractions (Q0.7 signed, Qu0.8 unsigned). Softsign converges slowly, so inputs outside of the
+--! table are looked up with integer precision in a second table.
+--! CReLU returns the ReLU of the negated input, which is the second half of the concatenation - the first half is calculated by ReLU.
+--! Dropout is the identity at inference.
+--! If the bias is enabled, the bias of each column is added to the inputs of the column before they are rounded.
 
 use WORK.TPU_pack.all;
 library IEEE;
@@ -41,6 +47,9 @@ entity ACTIVATION is
         ACTIVATION_FUNCTION : in  ACTIVATION_BIT_TYPE;
         SIGNED_NOT_UNSIGNED : in  std_logic;
         
+        BIAS_ENABLE         : in  std_logic; --!< Adds the bias to the input.
+        BIAS                : in  WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1); --!< The biases of the columns (output neurons).
+        
         ACTIVATION_INPUT    : in  WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
         ACTIVATION_OUTPUT   : out BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1)
     );
@@ -52,6 +61,19 @@ architecture BEH of ACTIVATION is
     constant SIGMOID_UNSIGNED   : INTEGER_ARRAY_TYPE(0 to 164)  := (128,130,132,134,136,138,140,142,144,146,148,150,152,154,156,157,159,161,163,165,167,169,170,172,174,176,177,179,181,182,184,186,187,189,190,192,193,195,196,198,199,200,202,203,204,206,207,208,209,210,212,213,214,215,216,217,218,219,220,221,222,223,224,225,225,226,227,228,229,229,230,231,232,232,233,234,234,235,235,236,237,237,238,238,239,239,240,240,241,241,241,242,242,243,243,243,244,244,245,245,245,246,246,246,246,247,247,247,248,248,248,248,248,249,249,249,249,250,250,250,250,250,250,251,251,251,251,251,251,252,252,252,252,252,252,252,252,253,253,253,253,253,253,253,253,253,253,253,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254);
     constant SIGMOID_SIGNED     : INTEGER_ARRAY_TYPE(-88 to 70) := (1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2,3,3,3,3,3,4,4,4,4,4,5,5,5,6,6,6,7,7,8,8,9,9,10,10,11,12,12,13,14,14,15,16,17,18,19,20,21,22,23,25,26,27,29,30,31,33,34,36,38,39,41,43,45,46,48,50,52,54,56,58,60,62,64,66,68,70,72,74,76,78,80,82,83,85,87,89,90,92,94,95,97,98,99,101,102,103,105,106,107,108,109,110,111,112,113,114,114,115,116,116,117,118,118,119,119,120,120,121,121,122,122,122,123,123,123,124,124,124,124,124,125,125,125,125,125,126,126,126,126,126,126,126,126);
 
+    constant ELU_SIGNED              : INTEGER_ARRAY_TYPE(-128 to 127) := (-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-16,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-15,-14,-14,-14,-14,-14,-14,-14,-14,-13,-13,-13,-13,-13,-12,-12,-12,-12,-11,-11,-11,-10,-10,-10,-9,-9,-8,-8,-7,-7,-6,-6,-5,-4,-4,-3,-2,-1,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60,61,62,63,64,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,123,124,125,126,127);
+    constant ELU_UNSIGNED            : INTEGER_ARRAY_TYPE(0 to 255) := (0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60,61,62,63,64,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,123,124,125,126,127,128,129,130,131,132,133,134,135,136,137,138,139,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,155,156,157,158,159,160,161,162,163,164,165,166,167,168,169,170,171,172,173,174,175,176,177,178,179,180,181,182,183,184,185,186,187,188,189,190,191,192,193,194,195,196,197,198,199,200,201,202,203,204,205,206,207,208,209,210,211,212,213,214,215,216,217,218,219,220,221,222,223,224,225,226,227,228,229,230,231,232,233,234,235,236,237,238,239,240,241,242,243,244,245,246,247,248,249,250,251,252,253,254,255);
+    constant SELU_SIGNED             : INTEGER_ARRAY_TYPE(-128 to 127) := (-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-28,-27,-27,-27,-27,-27,-27,-27,-27,-27,-27,-27,-27,-27,-27,-27,-26,-26,-26,-26,-26,-26,-26,-26,-25,-25,-25,-25,-25,-24,-24,-24,-24,-23,-23,-23,-22,-22,-21,-21,-21,-20,-20,-19,-18,-18,-17,-16,-16,-15,-14,-13,-12,-11,-10,-9,-8,-6,-5,-3,-2,0,1,2,3,4,5,6,7,8,9,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,53,54,55,56,57,58,59,60,61,62,63,64,65,66,67,68,69,70,71,72,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,115,116,117,118,119,120,121,122,123,124,125,126,127,127,127,127,127,127,127);
+    constant SELU_UNSIGNED           : INTEGER_ARRAY_TYPE(0 to 255) := (0,1,2,3,4,5,6,7,8,9,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,53,54,55,56,57,58,59,60,61,62,63,64,65,66,67,68,69,70,71,72,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,115,116,117,118,119,120,121,122,123,124,125,126,127,128,129,130,131,132,133,134,136,137,138,139,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,156,157,158,159,160,161,162,163,164,165,166,167,168,169,170,171,172,173,174,175,177,178,179,180,181,182,183,184,185,186,187,188,189,190,191,192,193,194,195,196,198,199,200,201,202,203,204,205,206,207,208,209,210,211,212,213,214,215,216,217,219,220,221,222,223,224,225,226,227,228,229,230,231,232,233,234,235,236,237,239,240,241,242,243,244,245,246,247,248,249,250,251,252,253,254,255,255,255,255,255,255,255,255,255,255,255,255,255);
+    constant SOFTPLUS_SIGNED         : INTEGER_ARRAY_TYPE(-128 to 127) := (0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2,2,3,3,3,3,3,3,4,4,4,4,4,5,5,5,6,6,6,7,7,7,8,8,8,9,9,10,10,11,11,12,12,13,13,14,14,15,16,16,17,18,18,19,20,20,21,22,22,23,24,25,26,26,27,28,29,30,31,31,32,33,34,35,36,37,38,39,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,56,57,58,59,60,61,62,63,64,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,123,124,125,126,127);
+    constant SOFTPLUS_UNSIGNED       : INTEGER_ARRAY_TYPE(0 to 255) := (22,23,23,24,24,25,25,26,26,27,28,28,29,29,30,31,31,32,32,33,34,34,35,36,36,37,38,38,39,40,41,41,42,43,43,44,45,46,47,47,48,49,50,50,51,52,53,54,54,55,56,57,58,59,59,60,61,62,63,64,65,65,66,67,68,69,70,71,72,73,73,74,75,76,77,78,79,80,81,82,83,83,84,85,86,87,88,89,90,91,92,93,94,95,96,97,98,99,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,123,124,125,126,127,128,129,130,131,132,133,133,134,135,136,137,138,139,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,155,156,157,158,159,160,161,162,163,164,165,166,167,168,169,170,171,172,173,174,175,176,177,178,179,180,181,182,183,184,185,186,187,188,189,190,191,192,193,194,195,196,197,198,199,200,201,202,203,204,205,206,207,208,209,210,211,212,213,214,215,216,217,218,219,220,221,222,223,224,225,226,227,228,229,230,231,232,233,234,235,236,237,238,239,240,241,242,243,244,245,246,247,248,249,250,251,252,253,254,255);
+    constant SOFTSIGN_SIGNED         : INTEGER_ARRAY_TYPE(-128 to 127) := (-114,-114,-114,-113,-113,-113,-113,-113,-113,-113,-113,-113,-112,-112,-112,-112,-112,-112,-112,-112,-111,-111,-111,-111,-111,-111,-111,-110,-110,-110,-110,-110,-110,-110,-109,-109,-109,-109,-109,-108,-108,-108,-108,-108,-108,-107,-107,-107,-107,-106,-106,-106,-106,-105,-105,-105,-105,-104,-104,-104,-104,-103,-103,-103,-102,-102,-102,-101,-101,-101,-100,-100,-100,-99,-99,-98,-98,-97,-97,-96,-96,-95,-95,-94,-94,-93,-93,-92,-91,-91,-90,-89,-89,-88,-87,-86,-85,-84,-83,-82,-81,-80,-79,-78,-77,-75,-74,-73,-71,-69,-68,-66,-64,-62,-60,-57,-55,-52,-49,-46,-43,-39,-35,-30,-26,-20,-14,-8,0,8,14,20,26,30,35,39,43,46,49,52,55,57,60,62,64,66,68,69,71,73,74,75,77,78,79,80,81,82,83,84,85,86,87,88,89,89,90,91,91,92,93,93,94,94,95,95,96,96,97,97,98,98,99,99,100,100,100,101,101,101,102,102,102,103,103,103,104,104,104,104,105,105,105,105,106,106,106,106,107,107,107,107,108,108,108,108,108,108,109,109,109,109,109,110,110,110,110,110,110,110,111,111,111,111,111,111,111,112,112,112,112,112,112,112,112,113,113,113,113,113,113,113,113,113,114,114);
+    constant SOFTSIGN_UNSIGNED       : INTEGER_ARRAY_TYPE(0 to 255) := (0,8,15,22,28,35,40,46,51,56,61,65,70,74,78,82,85,89,92,95,98,101,104,107,110,112,115,117,119,122,124,126,128,130,132,134,136,137,139,141,142,144,145,147,148,150,151,152,154,155,156,157,158,160,161,162,163,164,165,166,167,168,169,170,171,172,172,173,174,175,176,176,177,178,179,179,180,181,182,182,183,184,184,185,185,186,187,187,188,188,189,189,190,190,191,191,192,192,193,193,194,194,195,195,196,196,197,197,197,198,198,199,199,200,200,200,201,201,201,202,202,202,203,203,203,204,204,204,205,205,205,206,206,206,207,207,207,208,208,208,208,209,209,209,209,210,210,210,210,211,211,211,211,212,212,212,212,213,213,213,213,214,214,214,214,214,215,215,215,215,215,216,216,216,216,216,217,217,217,217,217,218,218,218,218,218,218,219,219,219,219,219,219,220,220,220,220,220,220,221,221,221,221,221,221,221,222,222,222,222,222,222,222,223,223,223,223,223,223,223,223,224,224,224,224,224,224,224,224,225,225,225,225,225,225,225,225,226,226,226,226,226,226,226,226,226,227,227,227,227,227,227,227,227,227,227);
+    constant SOFTSIGN_SIGNED_COARSE  : INTEGER_ARRAY_TYPE(8 to 255) := (114,115,116,117,118,119,119,120,120,121,121,122,122,122,122,123,123,123,123,123,124,124,124,124,124,124,124,124,125,125,125,125,125,125,125,125,125,125,125,125,125,125,125,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,126,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127);
+    constant SOFTSIGN_UNSIGNED_COARSE: INTEGER_ARRAY_TYPE(8 to 255) := (228,230,233,235,236,238,239,240,241,242,243,243,244,244,245,245,246,246,247,247,247,247,248,248,248,248,249,249,249,249,249,250,250,250,250,250,250,250,251,251,251,251,251,251,251,251,251,251,252,252,252,252,252,252,252,252,252,252,252,252,252,252,252,252,252,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,253,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,254,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255);
+    constant TANH_SIGNED             : INTEGER_ARRAY_TYPE(-128 to 127) := (-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-128,-127,-127,-127,-127,-127,-127,-127,-127,-126,-126,-126,-126,-126,-125,-125,-124,-124,-123,-123,-122,-121,-120,-120,-118,-117,-116,-114,-113,-111,-109,-106,-104,-101,-97,-94,-90,-86,-81,-76,-71,-65,-59,-53,-46,-39,-31,-24,-16,-8,0,8,16,24,31,39,46,53,59,65,71,76,81,86,90,94,97,101,104,106,109,111,113,114,116,117,118,120,120,121,122,123,123,124,124,125,125,126,126,126,126,126,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127,127);
+    constant TANH_UNSIGNED           : INTEGER_ARRAY_TYPE(0 to 255) := (0,8,16,24,32,40,47,55,63,70,77,85,92,99,105,112,118,125,131,136,142,147,153,158,163,167,172,176,180,184,188,192,195,198,201,204,207,210,212,215,217,219,221,223,225,227,229,230,232,233,234,236,237,238,239,240,241,242,243,243,244,245,246,246,247,247,248,248,249,249,250,250,250,251,251,251,252,252,252,252,253,253,253,253,253,253,254,254,254,254,254,254,254,254,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255);
+
     type SIGMOID_ARRAY_TYPE is array(natural range<>) of std_logic_vector(20 downto 0);
     type RELU_ARRAY_TYPE is array(natural range<>) of std_logic_vector(3*BYTE_WIDTH-1 downto 0);
     
@@ -68,7 +90,14 @@ architecture BEH of ACTIVATION is
     signal SIGMOID_ROUND_REG_ns : SIGMOID_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     
     signal RELU_OUTPUT      : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal CRELU_OUTPUT     : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     signal SIGMOID_OUTPUT   : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal RELU6_OUTPUT     : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal ELU_OUTPUT       : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal SELU_OUTPUT      : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal SOFTPLUS_OUTPUT  : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal SOFTSIGN_OUTPUT  : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal TANH_OUTPUT      : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     
     signal OUTPUT_REG_cs    : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1) := (others => (others => '0'));
     signal OUTPUT_REG_ns    : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
@@ -80,9 +109,41 @@ architecture BEH of ACTIVATION is
     
     signal SIGNED_NOT_UNSIGNED_REG_cs   : std_logic_vector(0 to 1) := (others => '0');
     signal SIGNED_NOT_UNSIGNED_REG_ns   : std_logic_vector(0 to 1);
+    
+    --! Looks up a signed table entry, indices outside of the table saturate to the first or last entry.
+    function LOOKUP_SIGNED(TABLE : INTEGER_ARRAY_TYPE; INDEX : integer) return BYTE_TYPE is
+    begin
+        if    INDEX < TABLE'low  then
+            return std_logic_vector(to_signed(TABLE(TABLE'low), BYTE_WIDTH));
+        elsif INDEX > TABLE'high then
+            return std_logic_vector(to_signed(TABLE(TABLE'high), BYTE_WIDTH));
+        else
+            return std_logic_vector(to_signed(TABLE(INDEX), BYTE_WIDTH));
+        end if;
+    end function LOOKUP_SIGNED;
+    
+    --! Looks up an unsigned table entry, indices outside of the table saturate to the last entry.
+    function LOOKUP_UNSIGNED(TABLE : INTEGER_ARRAY_TYPE; INDEX : natural) return BYTE_TYPE is
+    begin
+        if INDEX > TABLE'high then
+            return std_logic_vector(to_unsigned(TABLE(TABLE'high), BYTE_WIDTH));
+        else
+            return std_logic_vector(to_unsigned(TABLE(INDEX), BYTE_WIDTH));
+        end if;
+    end function LOOKUP_UNSIGNED;
 begin
 
-    INPUT_REG_ns    <= ACTIVATION_INPUT;
+    BIAS_ADD:
+    process(ACTIVATION_INPUT, BIAS_ENABLE, BIAS) is
+    begin
+        for i in 0 to MATRIX_WIDTH-1 loop
+            if BIAS_ENABLE = '1' then
+                INPUT_REG_ns(i) <= std_logic_vector(unsigned(ACTIVATION_INPUT(i)) + unsigned(BIAS(i)));
+            else
+                INPUT_REG_ns(i) <= ACTIVATION_INPUT(i);
+            end if;
+        end loop;
+    end process BIAS_ADD;
     
     ROUND:
     process(INPUT_REG_cs, SIGNED_NOT_UNSIGNED_REG_cs(0)) is
@@ -113,6 +174,7 @@ begin
         variable RELU_ROUND_v           : RELU_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
         
         variable RELU_OUTPUT_v          : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+        variable CRELU_OUTPUT_v         : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     begin
         SIGNED_NOT_UNSIGNED_v   := SIGNED_NOT_UNSIGNED_REG_cs(1);
         RELU_ROUND_v            := RELU_ROUND_REG_cs;
@@ -126,7 +188,19 @@ begin
                 else
                     RELU_OUTPUT_v(i) := RELU_ROUND_v(i)(BYTE_WIDTH-1 downto 0);
                 end if;
+                
+                -- CReLU - ReLU of the negated input
+                if    signed(RELU_ROUND_v(i)) >    0 then
+                    CRELU_OUTPUT_v(i) := (others => '0');
+                elsif signed(RELU_ROUND_v(i)) < -127 then -- Bounded ReLU
+                    CRELU_OUTPUT_v(i) := std_logic_vector(to_signed(127, BYTE_WIDTH));
+                else
+                    CRELU_OUTPUT_v(i) := std_logic_vector(resize(-signed(RELU_ROUND_v(i)), BYTE_WIDTH));
+                end if;
             else
+                -- Negated unsigned inputs are never positive
+                CRELU_OUTPUT_v(i) := (others => '0');
+                
                 if  unsigned(RELU_ROUND_v(i)) > 255 then -- Bounded ReLU
                     RELU_OUTPUT_v(i) := std_logic_vector(to_unsigned(255, BYTE_WIDTH));
                 else
@@ -136,6 +210,7 @@ begin
         end loop;
         
         RELU_OUTPUT <= RELU_OUTPUT_v;
+        CRELU_OUTPUT <= CRELU_OUTPUT_v;
     end process RELU_ACTIVATION;
     
     SIGMOID_ACTIVATION:
@@ -169,8 +244,87 @@ begin
         SIGMOID_OUTPUT <= SIGMOID_OUTPUT_v;
     end process SIGMOID_ACTIVATION;
     
+    -- Uses the rounded input of the sigmoid function
+    TABLE_ACTIVATION:
+    process(SIGNED_NOT_UNSIGNED_REG_cs(1), SIGMOID_ROUND_REG_cs) is
+        variable SIGNED_NOT_UNSIGNED_v  : std_logic;
+        variable SIGMOID_ROUND_v        : SIGMOID_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+        variable SIGNED_INDEX_v         : integer;
+        variable UNSIGNED_INDEX_v       : natural;
+        variable COARSE_INDEX_v         : natural;
+        
+        variable RELU6_OUTPUT_v         : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+        variable ELU_OUTPUT_v           : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+        variable SELU_OUTPUT_v          : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+        variable SOFTPLUS_OUTPUT_v      : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+        variable SOFTSIGN_OUTPUT_v      : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+        variable TANH_OUTPUT_v          : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    begin
+        SIGNED_NOT_UNSIGNED_v   := SIGNED_NOT_UNSIGNED_REG_cs(1);
+        SIGMOID_ROUND_v         := SIGMOID_ROUND_REG_cs;
+        
+        for i in 0 to MATRIX_WIDTH-1 loop
+            if SIGNED_NOT_UNSIGNED_v = '1' then -- Signed - Q4.4
+                SIGNED_INDEX_v := to_integer(signed(SIGMOID_ROUND_v(i)(20 downto 1)));
+                
+                if    SIGNED_INDEX_v <  0 then
+                    RELU6_OUTPUT_v(i) := (others => '0');
+                elsif SIGNED_INDEX_v > 96 then -- 6.0
+                    RELU6_OUTPUT_v(i) := std_logic_vector(to_signed(96, BYTE_WIDTH));
+                else
+                    RELU6_OUTPUT_v(i) := std_logic_vector(to_signed(SIGNED_INDEX_v, BYTE_WIDTH));
+                end if;
+                
+                ELU_OUTPUT_v(i)         := LOOKUP_SIGNED(ELU_SIGNED,        SIGNED_INDEX_v);
+                SELU_OUTPUT_v(i)        := LOOKUP_SIGNED(SELU_SIGNED,       SIGNED_INDEX_v);
+                SOFTPLUS_OUTPUT_v(i)    := LOOKUP_SIGNED(SOFTPLUS_SIGNED,   SIGNED_INDEX_v);
+                TANH_OUTPUT_v(i)        := LOOKUP_SIGNED(TANH_SIGNED,       SIGNED_INDEX_v);
+                
+                if SIGNED_INDEX_v >= SOFTSIGN_SIGNED'low and SIGNED_INDEX_v <= SOFTSIGN_SIGNED'high then
+                    SOFTSIGN_OUTPUT_v(i) := std_logic_vector(to_signed(SOFTSIGN_SIGNED(SIGNED_INDEX_v), BYTE_WIDTH));
+                else
+                    -- Integer part of the magnitude, softsign is odd
+                    COARSE_INDEX_v := abs(SIGNED_INDEX_v) / 16;
+                    if SIGNED_INDEX_v < 0 then
+                        SOFTSIGN_OUTPUT_v(i) := std_logic_vector(-signed(LOOKUP_SIGNED(SOFTSIGN_SIGNED_COARSE, COARSE_INDEX_v)));
+                    else
+                        SOFTSIGN_OUTPUT_v(i) := LOOKUP_SIGNED(SOFTSIGN_SIGNED_COARSE, COARSE_INDEX_v);
+                    end if;
+                end if;
+            else    -- Unsigned - Qu3.5
+                UNSIGNED_INDEX_v := to_integer(unsigned(SIGMOID_ROUND_v(i)));
+                
+                if UNSIGNED_INDEX_v > 192 then -- 6.0
+                    RELU6_OUTPUT_v(i) := std_logic_vector(to_unsigned(192, BYTE_WIDTH));
+                else
+                    RELU6_OUTPUT_v(i) := std_logic_vector(to_unsigned(UNSIGNED_INDEX_v, BYTE_WIDTH));
+                end if;
+                
+                ELU_OUTPUT_v(i)         := LOOKUP_UNSIGNED(ELU_UNSIGNED,        UNSIGNED_INDEX_v);
+                SELU_OUTPUT_v(i)        := LOOKUP_UNSIGNED(SELU_UNSIGNED,       UNSIGNED_INDEX_v);
+                SOFTPLUS_OUTPUT_v(i)    := LOOKUP_UNSIGNED(SOFTPLUS_UNSIGNED,   UNSIGNED_INDEX_v);
+                TANH_OUTPUT_v(i)        := LOOKUP_UNSIGNED(TANH_UNSIGNED,       UNSIGNED_INDEX_v);
+                
+                if UNSIGNED_INDEX_v <= SOFTSIGN_UNSIGNED'high then
+                    SOFTSIGN_OUTPUT_v(i) := std_logic_vector(to_unsigned(SOFTSIGN_UNSIGNED(UNSIGNED_INDEX_v), BYTE_WIDTH));
+                else
+                    -- Integer part
+                    COARSE_INDEX_v := UNSIGNED_INDEX_v / 32;
+                    SOFTSIGN_OUTPUT_v(i) := LOOKUP_UNSIGNED(SOFTSIGN_UNSIGNED_COARSE, COARSE_INDEX_v);
+                end if;
+            end if;
+        end loop;
+        
+        RELU6_OUTPUT    <= RELU6_OUTPUT_v;
+        ELU_OUTPUT      <= ELU_OUTPUT_v;
+        SELU_OUTPUT     <= SELU_OUTPUT_v;
+        SOFTPLUS_OUTPUT <= SOFTPLUS_OUTPUT_v;
+        SOFTSIGN_OUTPUT <= SOFTSIGN_OUTPUT_v;
+        TANH_OUTPUT     <= TANH_OUTPUT_v;
+    end process TABLE_ACTIVATION;
+    
     CHOOSE_ACTIVATION:
-    process(ACTIVATION_FUNCTION_REG1_cs, RELU_OUTPUT, SIGMOID_OUTPUT, INPUT_PIPE0_cs) is
+    process(ACTIVATION_FUNCTION_REG1_cs, RELU_OUTPUT, CRELU_OUTPUT, SIGMOID_OUTPUT, RELU6_OUTPUT, ELU_OUTPUT, SELU_OUTPUT, SOFTPLUS_OUTPUT, SOFTSIGN_OUTPUT, TANH_OUTPUT, INPUT_PIPE0_cs) is
         variable ACTIVATION_FUNCTION_v  : ACTIVATION_BIT_TYPE;
         variable RELU_OUTPUT_v          : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
         variable SIGMOID_OUTPUT_v       : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
@@ -185,11 +339,16 @@ begin
         for i in 0 to MATRIX_WIDTH-1 loop            
             case BITS_TO_ACTIVATION(ACTIVATION_FUNCTION_v) is
                 when RELU => OUTPUT_REG_ns_v(i) := RELU_OUTPUT_v(i);
+                when RELU6 => OUTPUT_REG_ns_v(i) := RELU6_OUTPUT(i);
+                when CRELU => OUTPUT_REG_ns_v(i) := CRELU_OUTPUT(i);
+                when ELU => OUTPUT_REG_ns_v(i) := ELU_OUTPUT(i);
+                when SELU => OUTPUT_REG_ns_v(i) := SELU_OUTPUT(i);
+                when SOFTPLUS => OUTPUT_REG_ns_v(i) := SOFTPLUS_OUTPUT(i);
+                when SOFTSIGN => OUTPUT_REG_ns_v(i) := SOFTSIGN_OUTPUT(i);
                 when SIGMOID => OUTPUT_REG_ns_v(i) := SIGMOID_OUTPUT_v(i);
+                when TANH => OUTPUT_REG_ns_v(i) := TANH_OUTPUT(i);
+                when DROPOUT => OUTPUT_REG_ns_v(i) := ACTIVATION_INPUT_v(i); -- Identity at inference
                 when NO_ACTIVATION => OUTPUT_REG_ns_v(i) := ACTIVATION_INPUT_v(i);
-                when others => 
-                    report "Unknown activation function!" severity ERROR;
-                    OUTPUT_REG_ns_v(i) := ACTIVATION_INPUT_v(i);
             end case;
         end loop;
         
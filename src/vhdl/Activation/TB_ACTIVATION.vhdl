@@ -39,6 +39,9 @@ architecture BEH of TB_ACTIVATION is
             ACTIVATION_FUNCTION : in ACTIVATION_BIT_TYPE;
             SIGNED_NOT_UNSIGNED : in std_logic;
             
+            BIAS_ENABLE         : in  std_logic;
+            BIAS                : in  WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+            
             ACTIVATION_INPUT    : in  WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
             ACTIVATION_OUTPUT   : out BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1)
         );
@@ -50,11 +53,17 @@ architecture BEH of TB_ACTIVATION is
     signal ENABLE               : std_logic;
     signal ACTIVATION_FUNCTION  : ACTIVATION_BIT_TYPE;
     signal SIGNED_NOT_UNSIGNED  : std_logic;
+    signal BIAS_ENABLE          : std_logic;
+    signal BIAS                 : WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     signal ACTIVATION_INPUT     : WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     signal ACTIVATION_OUTPUT    : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     
     signal ACTIVATION_FUNCTION_AS_TYPE  : ACTIVATION_TYPE;
     
+    type ACTIVATION_ARRAY_TYPE is array(natural range <>) of ACTIVATION_TYPE;
+    -- Functions, which use the rounded input of the sigmoid function
+    constant TABLE_FUNCTIONS    : ACTIVATION_ARRAY_TYPE := (RELU6, ELU, SELU, SOFTPLUS, SOFTSIGN, TANH);
+    
     -- for clock gen
     constant clock_period   : time := 10 ns;
     signal stop_the_clock   : boolean;
@@ -69,6 +78,8 @@ begin
         ENABLE => ENABLE,
         ACTIVATION_FUNCTION => ACTIVATION_FUNCTION,
         SIGNED_NOT_UNSIGNED => SIGNED_NOT_UNSIGNED,
+        BIAS_ENABLE => BIAS_ENABLE,
+        BIAS => BIAS,
         ACTIVATION_INPUT => ACTIVATION_INPUT,
         ACTIVATION_OUTPUT => ACTIVATION_OUTPUT
     );
@@ -77,11 +88,65 @@ begin
     
     STIMULUS:
     process is
+        -- Applies a single input and compares the output after the pipeline latency
+        procedure CHECK_PROCEDURE(
+            constant FUNCTION_TYPE  : in ACTIVATION_TYPE;
+            constant IS_SIGNED      : in std_logic;
+            constant INPUT          : in integer;
+            constant EXPECTED       : in integer
+        ) is
+        begin
+            ACTIVATION_FUNCTION_AS_TYPE <= FUNCTION_TYPE;
+            SIGNED_NOT_UNSIGNED <= IS_SIGNED;
+            ACTIVATION_INPUT <= (others => std_logic_vector(to_signed(INPUT, 4*BYTE_WIDTH)));
+            for i in 0 to 3 loop
+                wait until '1'=CLK and CLK'event;
+            end loop;
+            for i in 0 to MATRIX_WIDTH-1 loop
+                if IS_SIGNED = '1' then
+                    assert to_integer(signed(ACTIVATION_OUTPUT(i))) = EXPECTED report ACTIVATION_TYPE'image(FUNCTION_TYPE) & " of " & integer'image(INPUT) & " is wrong!" severity error;
+                else
+                    assert to_integer(unsigned(ACTIVATION_OUTPUT(i))) = EXPECTED report ACTIVATION_TYPE'image(FUNCTION_TYPE) & " of " & integer'image(INPUT) & " is wrong!" severity error;
+                end if;
+            end loop;
+        end procedure CHECK_PROCEDURE;
+        
+        -- Checks even and odd columns, which got different biases
+        procedure CHECK_COLUMNS_PROCEDURE(
+            FUNCTION_TYPE   : in ACTIVATION_TYPE;
+            IS_SIGNED       : in std_logic;
+            INPUT           : in integer;
+            EXPECTED_EVEN   : in integer;
+            EXPECTED_ODD    : in integer
+        ) is
+            variable EXPECTED : integer;
+        begin
+            ACTIVATION_FUNCTION_AS_TYPE <= FUNCTION_TYPE;
+            SIGNED_NOT_UNSIGNED <= IS_SIGNED;
+            ACTIVATION_INPUT <= (others => std_logic_vector(to_signed(INPUT, 4*BYTE_WIDTH)));
+            for i in 0 to 3 loop
+                wait until '1'=CLK and CLK'event;
+            end loop;
+            for i in 0 to MATRIX_WIDTH-1 loop
+                if i mod 2 = 0 then
+                    EXPECTED := EXPECTED_EVEN;
+                else
+                    EXPECTED := EXPECTED_ODD;
+                end if;
+                if IS_SIGNED = '1' then
+                    assert to_integer(signed(ACTIVATION_OUTPUT(i))) = EXPECTED report ACTIVATION_TYPE'image(FUNCTION_TYPE) & " of column " & integer'image(i) & " is wrong!" severity error;
+                else
+                    assert to_integer(unsigned(ACTIVATION_OUTPUT(i))) = EXPECTED report ACTIVATION_TYPE'image(FUNCTION_TYPE) & " of column " & integer'image(i) & " is wrong!" severity error;
+                end if;
+            end loop;
+        end procedure CHECK_COLUMNS_PROCEDURE;
     begin
         stop_the_clock <= false;
         RESET <= '0';
         ENABLE <= '0';
         SIGNED_NOT_UNSIGNED <= '0';
+        BIAS_ENABLE <= '0';
+        BIAS <= (others => (others => '0'));
         ACTIVATION_INPUT <= (others => (others => '0'));
         ACTIVATION_FUNCTION_AS_TYPE <= NO_ACTIVATION;
         -- RESET
@@ -160,6 +225,91 @@ begin
             end loop;
         end loop;
         
+        -- TEST: signed CReLU
+        SIGNED_NOT_UNSIGNED <= '1';
+        ACTIVATION_FUNCTION_AS_TYPE <= CRELU;
+        for i in -128 to 127 loop
+            for j in 0 to 255 loop
+                ACTIVATION_INPUT <= (others => std_logic_vector(to_signed(i, 2*BYTE_WIDTH)) & std_logic_vector(to_signed(j, BYTE_WIDTH)) & x"00");
+                wait until '1'=CLK and CLK'event;
+            end loop;
+        end loop;
+        
+        -- TEST: table range functions
+        for f in TABLE_FUNCTIONS'range loop
+            ACTIVATION_FUNCTION_AS_TYPE <= TABLE_FUNCTIONS(f);
+            -- signed - transition values and saturation
+            SIGNED_NOT_UNSIGNED <= '1';
+            ACTIVATION_INPUT <= (others => std_logic_vector(to_signed(-2147483648, 4*BYTE_WIDTH)));
+            wait until '1'=CLK and CLK'event;
+            for i in -9 to 8 loop
+                for j in 0 to 255 loop
+                    ACTIVATION_INPUT <= (others => std_logic_vector(to_signed(i, 2*BYTE_WIDTH)) & std_logic_vector(to_unsigned(j, BYTE_WIDTH)) & std_logic_vector(to_unsigned(0, BYTE_WIDTH)));
+                    wait until '1'=CLK and CLK'event;
+                end loop;
+            end loop;
+            ACTIVATION_INPUT <= (others => std_logic_vector(to_signed(2147483647, 4*BYTE_WIDTH)));
+            wait until '1'=CLK and CLK'event;
+            -- unsigned - transition values and saturation
+            SIGNED_NOT_UNSIGNED <= '0';
+            for i in 0 to 8 loop
+                for j in 0 to 255 loop
+                    ACTIVATION_INPUT <= (others => std_logic_vector(to_unsigned(i, 2*BYTE_WIDTH)) & std_logic_vector(to_unsigned(j, BYTE_WIDTH)) & std_logic_vector(to_unsigned(0, BYTE_WIDTH)));
+                    wait until '1'=CLK and CLK'event;
+                end loop;
+            end loop;
+            ACTIVATION_INPUT <= (others => (others => '1'));
+            wait until '1'=CLK and CLK'event;
+        end loop;
+        
+        -- TEST: expected values - inputs are in units of 2^-16 (table range), ReLU and CReLU in units of 2^-8
+        CHECK_PROCEDURE(TANH,       '1',  65536,    97); -- tanh(1.0)       Q0.7
+        CHECK_PROCEDURE(TANH,       '1', -65536,   -97); -- tanh(-1.0)      Q0.7
+        CHECK_PROCEDURE(TANH,       '0',  65536,   195); -- tanh(1.0)       Qu0.8
+        CHECK_PROCEDURE(ELU,        '1', -65536,   -10); -- elu(-1.0)       Q4.4
+        CHECK_PROCEDURE(ELU,        '1', 196608,    48); -- elu(3.0)        Q4.4
+        CHECK_PROCEDURE(ELU,        '0', 196608,    96); -- elu(3.0)        Qu3.5
+        CHECK_PROCEDURE(SELU,       '1',  65536,    17); -- selu(1.0)       Q4.4
+        CHECK_PROCEDURE(SELU,       '1', -65536,   -18); -- selu(-1.0)      Q4.4
+        CHECK_PROCEDURE(RELU6,      '1', 458752,    96); -- relu6(7.0)      Q4.4
+        CHECK_PROCEDURE(RELU6,      '1', -65536,     0); -- relu6(-1.0)     Q4.4
+        CHECK_PROCEDURE(RELU6,      '0', 458752,   192); -- relu6(7.0)      Qu3.5
+        CHECK_PROCEDURE(SOFTPLUS,   '1',      0,    11); -- softplus(0.0)   Q4.4
+        CHECK_PROCEDURE(SOFTPLUS,   '0',      0,    22); -- softplus(0.0)   Qu3.5
+        CHECK_PROCEDURE(SOFTSIGN,   '1',  65536,    64); -- softsign(1.0)   Q0.7
+        CHECK_PROCEDURE(SOFTSIGN,   '1', 6553600,  127); -- softsign(100.0) Q0.7 - coarse table
+        CHECK_PROCEDURE(SOFTSIGN,   '1', -6553600, -127); -- softsign(-100.0) Q0.7 - coarse table
+        CHECK_PROCEDURE(SOFTSIGN,   '0', 6553600,  253); -- softsign(100.0) Qu0.8 - coarse table
+        CHECK_PROCEDURE(CRELU,      '1',  -1280,     5); -- relu(-(-5.0))
+        CHECK_PROCEDURE(CRELU,      '1',   1280,     0); -- relu(-5.0)
+        CHECK_PROCEDURE(DROPOUT,    '1', 305419896, 18); -- identity - upper byte
+        
+        -- TEST: bias is added before rounding
+        BIAS_ENABLE <= '1';
+        BIAS <= (others => std_logic_vector(to_signed(65536, 4*BYTE_WIDTH))); -- 1.0
+        CHECK_PROCEDURE(TANH,       '1',      0,    97); -- tanh(0.0 + 1.0)     Q0.7
+        CHECK_PROCEDURE(TANH,       '0',      0,   195); -- tanh(0.0 + 1.0)     Qu0.8
+        CHECK_PROCEDURE(TANH,       '1', -65536,     0); -- tanh(-1.0 + 1.0)    Q0.7
+        BIAS <= (others => std_logic_vector(to_signed(-65536, 4*BYTE_WIDTH))); -- -1.0
+        CHECK_PROCEDURE(TANH,       '1',      0,   -97); -- tanh(0.0 - 1.0)     Q0.7
+        BIAS <= (others => std_logic_vector(to_signed(-256, 4*BYTE_WIDTH))); -- -1 ReLU step
+        CHECK_PROCEDURE(CRELU,      '1',  -1280,     6); -- relu(-(-5.0 - 1.0))
+        BIAS <= (others => x"01000000");
+        CHECK_PROCEDURE(DROPOUT,    '1', 305419896, 19); -- identity - upper byte
+        
+        -- TEST: every column gets its own bias
+        for i in 0 to MATRIX_WIDTH-1 loop
+            if i mod 2 = 0 then
+                BIAS(i) <= std_logic_vector(to_signed(65536, 4*BYTE_WIDTH)); -- 1.0
+            else
+                BIAS(i) <= std_logic_vector(to_signed(-65536, 4*BYTE_WIDTH)); -- -1.0
+            end if;
+        end loop;
+        CHECK_COLUMNS_PROCEDURE(TANH, '1',      0,  97, -97); -- tanh(0.0 +/- 1.0)   Q0.7
+        CHECK_COLUMNS_PROCEDURE(TANH, '1',  65536, 123,   0); -- tanh(1.0 +/- 1.0)   Q0.7
+        BIAS_ENABLE <= '0';
+        CHECK_PROCEDURE(DROPOUT,    '1', 305419896, 18); -- bias disabled
+        
         stop_the_clock <= true;
         wait;
     end process STIMULUS;
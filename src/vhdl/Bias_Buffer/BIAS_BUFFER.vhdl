@@ -0,0 +1,160 @@
+-- Copyright 2018 Jonas Fuhrmann. All rights reserved.
+--
+-- This project is dual licensed under GNU General Public License version 3
+-- and a commercial license available on request.
+---------------------------------------------------------------------------
+-- For non commercial use only:
+-- This file is part of tinyTPU.
+-- 
+-- tinyTPU is free software: you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation, either version 3 of the License, or
+-- (at your option) any later version.
+-- 
+-- tinyTPU is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+-- GNU General Public License for more details.
+-- 
+-- You should have received a copy of the GNU General Public License
+-- along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+--! @file BIAS_BUFFER.vhdl
+--! @author Jonas Fuhrmann
+--! @brief This component includes the bias buffer, a buffer used for the biases of neural net layers.
+--! @details The buffer stores bias vectors with one 32 bit bias per column (output neuron), which are written by the master (host system).
+--! The master addresses single biases - the lower LANE_WIDTH bits of the master address select the column, the upper bits the vector.
+--! The activation control reads whole vectors, which are added to the accumulators before the activation.
+
+use WORK.TPU_pack.all;
+library IEEE;
+    use IEEE.std_logic_1164.all;
+    use IEEE.numeric_std.all;
+    use IEEE.math_real.log2;
+    use IEEE.math_real.ceil;
+    
+entity BIAS_BUFFER is
+    generic(
+        MATRIX_WIDTH    : natural := 14;
+        BIAS_DEPTH      : natural := 512 --!< The number of bias vectors.
+    );
+    port(
+        CLK, RESET      : in  std_logic;
+        ENABLE          : in  std_logic;
+        
+        -- Master port
+        MASTER_ADDRESS      : in  BIAS_ADDRESS_TYPE; --!< Master (host) address of a single bias.
+        MASTER_EN           : in  std_logic; --!< Master (host) enable.
+        MASTER_WRITE_EN     : in  std_logic_vector(0 to 3); --!< Master (host) write enable for each byte of the bias.
+        MASTER_WRITE_PORT   : in  WORD_TYPE; --!< Master (host) write port.
+        MASTER_READ_PORT    : out WORD_TYPE; --!< Master (host) read port.
+        -- Port0
+        ADDRESS0        : in  BIAS_ADDRESS_TYPE; --!< Vector address of port 0.
+        EN0             : in  std_logic; --!< Enable of port 0.
+        READ_PORT0      : out WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1) --!< Read port of port 0, one bias for each column.
+    );
+end entity BIAS_BUFFER;
+
+--! @brief The architecture of the bias buffer component.
+architecture BEH of BIAS_BUFFER is
+    constant LANE_WIDTH : natural := natural(ceil(log2(real(MATRIX_WIDTH))));
+
+    signal READ_PORT0_REG0_cs   : WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1) := (others => (others => '0'));
+    signal READ_PORT0_REG0_ns   : WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    signal READ_PORT0_REG1_cs   : WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1) := (others => (others => '0'));
+    signal READ_PORT0_REG1_ns   : WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    
+    signal MASTER_READ_PORT_REG0_cs : WORD_TYPE := (others => '0');
+    signal MASTER_READ_PORT_REG0_ns : WORD_TYPE;
+    signal MASTER_READ_PORT_REG1_cs : WORD_TYPE := (others => '0');
+    signal MASTER_READ_PORT_REG1_ns : WORD_TYPE;
+    
+    -- Column of the master read, delayed like the RAM
+    signal MASTER_LANE_cs : natural range 0 to 2**LANE_WIDTH-1 := 0;
+    signal MASTER_LANE_ns : natural range 0 to 2**LANE_WIDTH-1;
+    
+    signal MASTER_VECTOR    : natural range 0 to 2**(BIAS_ADDRESS_WIDTH-LANE_WIDTH)-1;
+    signal MASTER_LANE      : natural range 0 to 2**LANE_WIDTH-1;
+    
+    signal READ_PORT0_BITS          : std_logic_vector(MATRIX_WIDTH*4*BYTE_WIDTH-1 downto 0);
+    signal MASTER_READ_PORT_BITS    : std_logic_vector(MATRIX_WIDTH*4*BYTE_WIDTH-1 downto 0);
+    
+    type RAM_TYPE is array(0 to BIAS_DEPTH-1) of std_logic_vector(MATRIX_WIDTH*4*BYTE_WIDTH-1 downto 0);
+    shared variable RAM  : RAM_TYPE := (others => (others => '0'));
+    
+    attribute ram_style        : string;
+    attribute ram_style of RAM : variable is "block";
+begin
+    MASTER_VECTOR   <= to_integer(unsigned(MASTER_ADDRESS(BIAS_ADDRESS_WIDTH-1 downto LANE_WIDTH)));
+    MASTER_LANE     <= to_integer(unsigned(MASTER_ADDRESS(LANE_WIDTH-1 downto 0)));
+    MASTER_LANE_ns  <= MASTER_LANE;
+
+    READ_PORT0_REG0_ns  <= BITS_TO_WORD_ARRAY(READ_PORT0_BITS);
+    READ_PORT0_REG1_ns  <= READ_PORT0_REG0_cs;
+    READ_PORT0          <= READ_PORT0_REG1_cs;
+    
+    -- Columns behind MATRIX_WIDTH read as zero
+    MASTER_READ_PORT_REG0_ns    <= BITS_TO_WORD_ARRAY(MASTER_READ_PORT_BITS)(MASTER_LANE_cs) when MASTER_LANE_cs < MATRIX_WIDTH else (others => '0');
+    MASTER_READ_PORT_REG1_ns    <= MASTER_READ_PORT_REG0_cs;
+    MASTER_READ_PORT            <= MASTER_READ_PORT_REG1_cs;
+    
+    PORT0:
+    process(CLK) is
+    begin
+        if CLK'event and CLK = '1' then
+            if EN0 = '1' then
+                --synthesis translate_off
+                if to_integer(unsigned(ADDRESS0)) < BIAS_DEPTH then
+                --synthesis translate_on
+                    READ_PORT0_BITS <= RAM(to_integer(unsigned(ADDRESS0)));
+                --synthesis translate_off
+                end if;
+                --synthesis translate_on
+            end if;
+        end if;
+    end process PORT0;
+    
+    PORT1:
+    process(CLK) is
+    begin
+        if CLK'event and CLK = '1' then
+            if MASTER_EN = '1' then
+                --synthesis translate_off
+                if MASTER_VECTOR < BIAS_DEPTH then
+                --synthesis translate_on
+                    for i in 0 to MATRIX_WIDTH-1 loop
+                        for j in 0 to 3 loop
+                            if MASTER_LANE = i and MASTER_WRITE_EN(j) = '1' then
+                                RAM(MASTER_VECTOR)(i*4*BYTE_WIDTH + (j + 1) * BYTE_WIDTH - 1 downto i*4*BYTE_WIDTH + j * BYTE_WIDTH) := MASTER_WRITE_PORT((j + 1) * BYTE_WIDTH - 1 downto j * BYTE_WIDTH);
+                            end if;
+                        end loop;
+                    end loop;
+                    MASTER_READ_PORT_BITS <= RAM(MASTER_VECTOR);
+                --synthesis translate_off
+                end if;
+                --synthesis translate_on
+                MASTER_LANE_cs <= MASTER_LANE_ns;
+            end if;
+        end if;
+    end process PORT1;
+    
+    SEQ_LOG:
+    process(CLK) is
+    begin
+        if CLK'event and CLK = '1' then
+            if RESET = '1' then
+                READ_PORT0_REG0_cs <= (others => (others => '0'));
+                READ_PORT0_REG1_cs <= (others => (others => '0'));
+                MASTER_READ_PORT_REG0_cs <= (others => '0');
+                MASTER_READ_PORT_REG1_cs <= (others => '0');
+            else
+                if ENABLE = '1' then
+                    READ_PORT0_REG0_cs <= READ_PORT0_REG0_ns;
+                    READ_PORT0_REG1_cs <= READ_PORT0_REG1_ns;
+                    MASTER_READ_PORT_REG0_cs <= MASTER_READ_PORT_REG0_ns;
+                    MASTER_READ_PORT_REG1_cs <= MASTER_READ_PORT_REG1_ns;
+                end if;
+            end if;
+        end if;
+    end process SEQ_LOG;
+end architecture BEH;
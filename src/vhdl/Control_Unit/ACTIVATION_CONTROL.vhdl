@@ -24,6 +24,8 @@
 --! @brief This component includes the control unit for the activation operation.
 --! @details This unit controls the data flow from the accumulaotrs, pipes it through the activation component and stores the results back in the unified buffer.
 --! Instructions will be executed delayed, so a previous matrix multiply can be finished just in time.
+--! If the bias bit of the op code is set, the upper half of the length is the address of a bias vector in the bias buffer.
+--! The vector holds one bias per column and is used for all accumulators of the instruction. It is read from the bias buffer, so it arrives at the activation together with the accumulators.
 
 use WORK.TPU_pack.all;
 library IEEE;
@@ -45,6 +47,9 @@ entity ACTIVATION_CONTROL is
         ACTIVATION_FUNCTION : out ACTIVATION_BIT_TYPE; --!< The type of activation function to be calculated.
         SIGNED_NOT_UNSIGNED : out std_logic; --!< Determines if the input and output is signed or unsigned.
         
+        BIAS_ADDRESS        : out BIAS_ADDRESS_TYPE; --!< Address for the bias buffer.
+        BIAS_ENABLE         : out std_logic; --!< Determines if the bias is added to the input of the activation.
+        
         ACT_TO_BUF_ADDR     : out BUFFER_ADDRESS_TYPE; --!< Address for the unified buffer.
         BUF_WRITE_EN        : out std_logic; --!< Write enable flag for the unified buffer.
         
@@ -60,10 +65,12 @@ architecture BEH of ACTIVATION_CONTROL is
     -- MATRIX_MULTPLY_UNIT: MATRIX_WIDTH+2 clock cycles
     -- REGISTER_FILE: 7 clock cycles
     -- ACTIVATION: 3 clock cycles
+    -- BIAS_BUFFER: 3 clock cycles
 
     type ACCUMULATOR_ADDRESS_ARRAY_TYPE is array(0 to 3+MATRIX_WIDTH+2-1) of ACCUMULATOR_ADDRESS_TYPE;
     type ACTIVATION_BIT_ARRAY_TYPE is array(0 to 3+MATRIX_WIDTH+2+7-1) of ACTIVATION_BIT_TYPE;
     type BUFFER_ADDRESS_ARRAY_TYPE is array(0 to 3+MATRIX_WIDTH+2+7+3-1) of BUFFER_ADDRESS_TYPE;
+    type BIAS_ADDRESS_ARRAY_TYPE is array(0 to 3+MATRIX_WIDTH+2+7-3-1) of BIAS_ADDRESS_TYPE;
 
     component COUNTER is
         generic(
@@ -105,11 +112,25 @@ architecture BEH of ACTIVATION_CONTROL is
     signal ACT_TO_BUF_ADDR_cs : BUFFER_ADDRESS_TYPE := (others => '0');
     signal ACT_TO_BUF_ADDR_ns : BUFFER_ADDRESS_TYPE;
     
+    signal BIAS_ADDRESS_cs : BIAS_ADDRESS_TYPE := (others => '0');
+    signal BIAS_ADDRESS_ns : BIAS_ADDRESS_TYPE;
+    
+    -- The bias address is held for the whole instruction and delayed like the address counters
+    signal BIAS_BASE_cs : BIAS_ADDRESS_TYPE := (others => '0');
+    signal BIAS_BASE_ns : BIAS_ADDRESS_TYPE;
+    signal BIAS_PIPE0_cs : BIAS_ADDRESS_TYPE := (others => '0');
+    signal BIAS_PIPE0_ns : BIAS_ADDRESS_TYPE;
+    signal BIAS_PIPE1_cs : BIAS_ADDRESS_TYPE := (others => '0');
+    signal BIAS_PIPE1_ns : BIAS_ADDRESS_TYPE;
+    
     signal ACTIVATION_FUNCTION_cs : ACTIVATION_BIT_TYPE := (others => '0');
     signal ACTIVATION_FUNCTION_ns : ACTIVATION_BIT_TYPE;
     
     signal SIGNED_NOT_UNSIGNED_cs : std_logic := '0';
     signal SIGNED_NOT_UNSIGNED_ns : std_logic;
+    
+    signal BIAS_ENABLE_cs : std_logic := '0';
+    signal BIAS_ENABLE_ns : std_logic;
 
     signal BUF_WRITE_EN_cs : std_logic := '0';
     signal BUF_WRITE_EN_ns : std_logic;
@@ -130,6 +151,9 @@ architecture BEH of ACTIVATION_CONTROL is
     signal SIGNED_DELAY_cs : std_logic_vector(0 to 2) := (others => '0');
     signal SIGNED_DELAY_ns : std_logic_vector(0 to 2);
     
+    signal BIAS_DELAY_cs : std_logic_vector(0 to 2) := (others => '0');
+    signal BIAS_DELAY_ns : std_logic_vector(0 to 2);
+    
     signal ACTIVATION_PIPE0_cs : ACTIVATION_BIT_TYPE := (others => '0');
     signal ACTIVATION_PIPE0_ns : ACTIVATION_BIT_TYPE;
     
@@ -158,6 +182,12 @@ architecture BEH of ACTIVATION_CONTROL is
     signal S_NOT_U_DELAY_cs     : std_logic_vector(0 to 3+MATRIX_WIDTH+2+7-1) := (others => '0');
     signal S_NOT_U_DELAY_ns     : std_logic_vector(0 to 3+MATRIX_WIDTH+2+7-1);
     
+    signal BIAS_EN_DELAY_cs     : std_logic_vector(0 to 3+MATRIX_WIDTH+2+7-1) := (others => '0');
+    signal BIAS_EN_DELAY_ns     : std_logic_vector(0 to 3+MATRIX_WIDTH+2+7-1);
+    
+    signal BIAS_ADDRESS_DELAY_cs    : BIAS_ADDRESS_ARRAY_TYPE := (others => (others => '0'));
+    signal BIAS_ADDRESS_DELAY_ns    : BIAS_ADDRESS_ARRAY_TYPE;
+    
     signal ACT_TO_BUF_DELAY_cs  : BUFFER_ADDRESS_ARRAY_TYPE := (others => (others => '0'));
     signal ACT_TO_BUF_DELAY_ns  : BUFFER_ADDRESS_ARRAY_TYPE;
     
@@ -168,12 +198,16 @@ begin
     ACC_ADDRESS_DELAY_ns(1 to 3+MATRIX_WIDTH+2-1) <= ACC_ADDRESS_DELAY_cs(0 to 3+MATRIX_WIDTH+2-2);
     ACTIVATION_DELAY_ns(1 to 3+MATRIX_WIDTH+2+7-1) <= ACTIVATION_DELAY_cs(0 to 3+MATRIX_WIDTH+2+7-2);
     S_NOT_U_DELAY_ns(1 to 3+MATRIX_WIDTH+2+7-1) <= S_NOT_U_DELAY_cs(0 to 3+MATRIX_WIDTH+2+7-2);
+    BIAS_EN_DELAY_ns(1 to 3+MATRIX_WIDTH+2+7-1) <= BIAS_EN_DELAY_cs(0 to 3+MATRIX_WIDTH+2+7-2);
+    BIAS_ADDRESS_DELAY_ns(1 to 3+MATRIX_WIDTH+2+7-3-1) <= BIAS_ADDRESS_DELAY_cs(0 to 3+MATRIX_WIDTH+2+7-3-2);
     ACT_TO_BUF_DELAY_ns(1 to 3+MATRIX_WIDTH+2+7+3-1) <= ACT_TO_BUF_DELAY_cs(0 to 3+MATRIX_WIDTH+2+7+3-2);
     WRITE_EN_DELAY_ns(1 to 3+MATRIX_WIDTH+2+7+3-1) <= WRITE_EN_DELAY_cs(0 to 3+MATRIX_WIDTH+2+7+3-2);
     
     ACC_TO_ACT_ADDR <= ACC_ADDRESS_DELAY_cs(3+MATRIX_WIDTH+2-1);
     ACTIVATION_FUNCTION <=ACTIVATION_DELAY_cs(3+MATRIX_WIDTH+2+7-1);
     SIGNED_NOT_UNSIGNED <= S_NOT_U_DELAY_cs(3+MATRIX_WIDTH+2+7-1);
+    BIAS_ENABLE <= BIAS_EN_DELAY_cs(3+MATRIX_WIDTH+2+7-1);
+    BIAS_ADDRESS <= BIAS_ADDRESS_DELAY_cs(3+MATRIX_WIDTH+2+7-3-1);
     ACT_TO_BUF_ADDR <= ACT_TO_BUF_DELAY_cs(3+MATRIX_WIDTH+2+7+3-1);
     BUF_WRITE_EN <= WRITE_EN_DELAY_cs(3+MATRIX_WIDTH+2+7+3-1);
 
@@ -185,7 +219,7 @@ begin
         CLK         => CLK,
         RESET       => LENGTH_RESET,
         ENABLE      => ENABLE,
-        END_VAL     => INSTRUCTION.CALC_LENGTH,
+        END_VAL     => LENGTH_END_VAL,
         LOAD        => LENGTH_LOAD,
         COUNT_EVENT => LENGTH_EVENT
     );
@@ -216,11 +250,20 @@ begin
         COUNT_VAL   => ACT_TO_BUF_ADDR_ns
     );
     
+    BIAS_BASE_ns    <= INSTRUCTION.CALC_LENGTH(LENGTH_WIDTH-1 downto LENGTH_WIDTH-BIAS_ADDRESS_WIDTH) when ADDRESS_LOAD = '1' else BIAS_BASE_cs;
+    BIAS_PIPE0_ns   <= BIAS_BASE_cs;
+    BIAS_PIPE1_ns   <= BIAS_PIPE0_cs;
+    BIAS_ADDRESS_ns <= BIAS_PIPE1_cs;
+    
+    LENGTH_END_VAL <= std_logic_vector(resize(unsigned(INSTRUCTION.CALC_LENGTH(LENGTH_WIDTH-BIAS_ADDRESS_WIDTH-1 downto 0)), LENGTH_WIDTH)) when INSTRUCTION.OP_CODE(6) = '1' else INSTRUCTION.CALC_LENGTH;
+    
     SIGNED_NOT_UNSIGNED_ns <= INSTRUCTION.OP_CODE(4);
+    BIAS_ENABLE_ns <= INSTRUCTION.OP_CODE(6);
     ACTIVATION_FUNCTION_ns <= INSTRUCTION.OP_CODE(3 downto 0);
     
     ACTIVATION_DELAY_ns(0)  <= "0000" when ACTIVATION_FUNCTION_cs = "0000" else ACTIVATION_PIPE2_cs;
     S_NOT_U_DELAY_ns(0)     <= '0' when SIGNED_NOT_UNSIGNED_cs = '0' else SIGNED_DELAY_cs(2);
+    BIAS_EN_DELAY_ns(0)     <= '0' when BIAS_ENABLE_cs = '0' else BIAS_DELAY_cs(2);
     WRITE_EN_DELAY_ns(0)    <= '0' when BUF_WRITE_EN_cs = '0' else BUF_WRITE_EN_DELAY_cs(2);
     
     BUSY <= RUNNING_cs;
@@ -229,12 +272,15 @@ begin
     
     ACC_ADDRESS_DELAY_ns(0) <= ACC_TO_ACT_ADDR_cs;
     ACT_TO_BUF_DELAY_ns(0) <= ACT_TO_BUF_ADDR_cs;
+    BIAS_ADDRESS_DELAY_ns(0) <= BIAS_ADDRESS_cs;
     
     BUF_WRITE_EN_DELAY_ns(0)        <= BUF_WRITE_EN_cs;
     SIGNED_DELAY_ns(0)              <= SIGNED_NOT_UNSIGNED_cs;
+    BIAS_DELAY_ns(0)                <= BIAS_ENABLE_cs;
     ACTIVATION_PIPE0_ns             <= ACTIVATION_FUNCTION_cs;
     BUF_WRITE_EN_DELAY_ns(1 to 2)   <= BUF_WRITE_EN_DELAY_cs(0 to 1);
     SIGNED_DELAY_ns(1 to 2)         <= SIGNED_DELAY_cs(0 to 1);
+    BIAS_DELAY_ns(1 to 2)           <= BIAS_DELAY_cs(0 to 1);
     ACTIVATION_PIPE1_ns             <= ACTIVATION_PIPE0_cs;
     ACTIVATION_PIPE2_ns             <= ACTIVATION_PIPE1_cs;
     
@@ -326,8 +372,13 @@ begin
                 RUNNING_PIPE_cs <= (others => '0');
                 ACC_TO_ACT_ADDR_cs <= (others => '0');
                 ACT_TO_BUF_ADDR_cs <= (others => '0');
+                BIAS_ADDRESS_cs    <= (others => '0');
+                BIAS_BASE_cs       <= (others => '0');
+                BIAS_PIPE0_cs      <= (others => '0');
+                BIAS_PIPE1_cs      <= (others => '0');
                 BUF_WRITE_EN_DELAY_cs   <= (others => '0');
                 SIGNED_DELAY_cs         <= (others => '0');
+                BIAS_DELAY_cs           <= (others => '0');
                 ACTIVATION_PIPE0_cs     <= (others => '0');
                 ACTIVATION_PIPE1_cs     <= (others => '0');
                 ACTIVATION_PIPE2_cs     <= (others => '0');
@@ -335,6 +386,8 @@ begin
                 ACC_ADDRESS_DELAY_cs    <= (others => (others => '0'));
                 ACTIVATION_DELAY_cs     <= (others => (others => '0'));
                 S_NOT_U_DELAY_cs        <= (others => '0');
+                BIAS_EN_DELAY_cs        <= (others => '0');
+                BIAS_ADDRESS_DELAY_cs   <= (others => (others => '0'));
                 ACT_TO_BUF_DELAY_cs     <= (others => (others => '0'));
                 WRITE_EN_DELAY_cs       <= (others => '0');
             else
@@ -344,8 +397,13 @@ begin
                     RUNNING_PIPE_cs <= RUNNING_PIPE_ns;
                     ACC_TO_ACT_ADDR_cs <= ACC_TO_ACT_ADDR_ns;
                     ACT_TO_BUF_ADDR_cs <= ACT_TO_BUF_ADDR_ns;
+                    BIAS_ADDRESS_cs    <= BIAS_ADDRESS_ns;
+                    BIAS_BASE_cs       <= BIAS_BASE_ns;
+                    BIAS_PIPE0_cs      <= BIAS_PIPE0_ns;
+                    BIAS_PIPE1_cs      <= BIAS_PIPE1_ns;
                     BUF_WRITE_EN_DELAY_cs   <= BUF_WRITE_EN_DELAY_ns;
                     SIGNED_DELAY_cs         <= SIGNED_DELAY_ns;
+                    BIAS_DELAY_cs           <= BIAS_DELAY_ns;
                     ACTIVATION_PIPE0_cs     <= ACTIVATION_PIPE0_ns;
                     ACTIVATION_PIPE1_cs     <= ACTIVATION_PIPE1_ns;
                     ACTIVATION_PIPE2_cs     <= ACTIVATION_PIPE2_ns;
@@ -353,6 +411,8 @@ begin
                     ACC_ADDRESS_DELAY_cs    <= ACC_ADDRESS_DELAY_ns;
                     ACTIVATION_DELAY_cs     <= ACTIVATION_DELAY_ns;
                     S_NOT_U_DELAY_cs        <= S_NOT_U_DELAY_ns;
+                    BIAS_EN_DELAY_cs        <= BIAS_EN_DELAY_ns;
+                    BIAS_ADDRESS_DELAY_cs   <= BIAS_ADDRESS_DELAY_ns;
                     ACT_TO_BUF_DELAY_cs     <= ACT_TO_BUF_DELAY_ns;
                     WRITE_EN_DELAY_cs       <= WRITE_EN_DELAY_ns;
                 end if;
@@ -361,10 +421,12 @@ begin
             if ACT_RESET = '1' then
                 ACTIVATION_FUNCTION_cs  <= (others => '0');
                 SIGNED_NOT_UNSIGNED_cs  <= '0';
+                BIAS_ENABLE_cs          <= '0';
             else
                 if ACT_LOAD = '1' then
                     ACTIVATION_FUNCTION_cs  <= ACTIVATION_FUNCTION_ns;
                     SIGNED_NOT_UNSIGNED_cs  <= SIGNED_NOT_UNSIGNED_ns;
+                    BIAS_ENABLE_cs          <= BIAS_ENABLE_ns;
                 end if;
             end if;
         end if;
@@ -39,6 +39,7 @@ entity CONTROL_COORDINATOR is
         INSTRUCTION_EN              :  in std_logic; --!< Enable for instruction.
         
         BUSY                        : out std_logic; --!< One unit is still busy while a new instruction was feeded for this exact unit.
+        RESOURCE_STALL              : out std_logic; --!< A synchronize waits for the resources of the units. Used by the performance counters.
         
         WEIGHT_BUSY                 :  in std_logic; --!< Busy input for the weight control unit.
         WEIGHT_RESOURCE_BUSY        :  in std_logic; --!< Resource busy input for the weight control unit.
@@ -116,6 +117,7 @@ begin
         variable MATRIX_INSTRUCTION_EN_v        : std_logic;
         variable ACTIVATION_INSTRUCTION_EN_v    : std_logic;
         variable INSTRUCTION_RUNNING_v          : std_logic;
+        variable RESOURCE_STALL_v               : std_logic;
         variable SYNCHRONIZE_v                  : std_logic;
     begin
         INSTRUCTION_v       := INSTRUCTION_cs;
@@ -127,6 +129,7 @@ begin
         WEIGHT_RESOURCE_BUSY_v     := WEIGHT_RESOURCE_BUSY;
         MATRIX_RESOURCE_BUSY_v     := MATRIX_RESOURCE_BUSY;
         ACTIVATION_RESOURCE_BUSY_v := ACTIVATION_RESOURCE_BUSY;
+        RESOURCE_STALL_v := '0';
         
         if INSTRUCTION_EN_v = '1' then
             if EN_FLAGS_v(3) = '1' then
@@ -134,6 +137,7 @@ begin
                 or MATRIX_RESOURCE_BUSY_v     = '1'
                 or ACTIVATION_RESOURCE_BUSY_v = '1' then
                     INSTRUCTION_RUNNING_v       := '1';
+                    RESOURCE_STALL_v            := '1';
                     WEIGHT_INSTRUCTION_EN_v     := '0';
                     MATRIX_INSTRUCTION_EN_v     := '0';
                     ACTIVATION_INSTRUCTION_EN_v := '0';
@@ -171,6 +175,7 @@ begin
         end if;
         
         INSTRUCTION_RUNNING         <= INSTRUCTION_RUNNING_v;
+        RESOURCE_STALL              <= RESOURCE_STALL_v;
         WEIGHT_INSTRUCTION_EN       <= WEIGHT_INSTRUCTION_EN_v;
         MATRIX_INSTRUCTION_EN       <= MATRIX_INSTRUCTION_EN_v;
         ACTIVATION_INSTRUCTION_EN   <= ACTIVATION_INSTRUCTION_EN_v;
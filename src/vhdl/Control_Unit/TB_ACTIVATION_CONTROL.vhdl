@@ -40,6 +40,9 @@ architecture BEH of TB_ACTIVATION_CONTROL is
             ACTIVATION_FUNCTION : out ACTIVATION_BIT_TYPE;
             SIGNED_NOT_UNSIGNED : out std_logic;
             
+            BIAS_ADDRESS        : out BIAS_ADDRESS_TYPE;
+            BIAS_ENABLE         : out std_logic;
+            
             ACT_TO_BUF_ADDR     : out BUFFER_ADDRESS_TYPE;
             BUF_WRITE_EN        : out std_logic;
             
@@ -58,11 +61,21 @@ architecture BEH of TB_ACTIVATION_CONTROL is
     signal ACTIVATION_FUNCTION : ACTIVATION_BIT_TYPE;
     signal SIGNED_NOT_UNSIGNED : std_logic;
     
+    signal BIAS_ADDRESS        : BIAS_ADDRESS_TYPE;
+    signal BIAS_ENABLE         : std_logic;
+    
     signal ACT_TO_BUF_ADDR : BUFFER_ADDRESS_TYPE;
     signal BUF_WRITE_EN    : std_logic;
     
     signal BUSY : std_logic;
     
+    -- The bias buffer needs 3 clock cycles to read the bias
+    type BIAS_ADDRESS_ARRAY_TYPE is array(0 to 2) of BIAS_ADDRESS_TYPE;
+    signal BIAS_ADDRESS_DELAY : BIAS_ADDRESS_ARRAY_TYPE := (others => (others => '0'));
+    
+    constant BIAS_BASE      : natural := 16#0123#;
+    constant BIAS_LENGTH    : natural := 7;
+    
     -- for clock gen
     constant clock_period   : time := 10 ns;
     signal stop_the_clock   : boolean;
@@ -77,6 +90,8 @@ begin
         ACC_TO_ACT_ADDR => ACC_TO_ACT_ADDR,
         ACTIVATION_FUNCTION => ACTIVATION_FUNCTION,
         SIGNED_NOT_UNSIGNED => SIGNED_NOT_UNSIGNED,
+        BIAS_ADDRESS => BIAS_ADDRESS,
+        BIAS_ENABLE => BIAS_ENABLE,
         ACT_TO_BUF_ADDR => ACT_TO_BUF_ADDR,
         BUF_WRITE_EN => BUF_WRITE_EN,
         BUSY => BUSY
@@ -105,8 +120,35 @@ begin
         INSTRUCTION_EN <= '1';
         wait until '1'=CLK and CLK'event;
         INSTRUCTION_EN <= '0';
+        wait until '1'=CLK and CLK'event and BUSY = '0';
+        -- Biased activation - the upper half of the length is the bias vector address
+        INSTRUCTION.OP_CODE <= "11000001"; -- biased unsigned ReLU
+        INSTRUCTION.CALC_LENGTH <= std_logic_vector(to_unsigned(BIAS_BASE, BIAS_ADDRESS_WIDTH)) & std_logic_vector(to_unsigned(BIAS_LENGTH, LENGTH_WIDTH-BIAS_ADDRESS_WIDTH));
+        INSTRUCTION.ACC_ADDRESS <= x"0010";
+        INSTRUCTION.BUFFER_ADDRESS <= x"000100";
+        INSTRUCTION_EN <= '1';
+        wait until '1'=CLK and CLK'event;
+        INSTRUCTION_EN <= '0';
+        wait until '1'=CLK and CLK'event and BUSY = '0';
         wait;
     end process STIMULUS;
+    
+    -- The bias vector has to arrive at the activation together with the accumulators and the activation function
+    -- The bias address is held for all accumulators of the instruction
+    CHECK:
+    process is
+        variable BIASES : natural := 0;
+    begin
+        wait until '1'=CLK and CLK'event;
+        BIAS_ADDRESS_DELAY <= BIAS_ADDRESS & BIAS_ADDRESS_DELAY(0 to 1);
+        if BIAS_ENABLE = '1' then
+            assert ACTIVATION_FUNCTION = "0001" report "Bias enabled without the biased activation!" severity error;
+            assert to_integer(unsigned(BIAS_ADDRESS_DELAY(2))) = BIAS_BASE report "Wrong bias address!" severity error;
+            BIASES := BIASES + 1;
+        elsif BIASES /= 0 then
+            assert BIASES = BIAS_LENGTH report "Wrong number of biases!" severity error;
+        end if;
+    end process CHECK;
 
     CLOCK_GEN: 
     process
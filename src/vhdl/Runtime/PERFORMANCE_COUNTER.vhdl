@@ -0,0 +1,114 @@
+-- Copyright 2018 Jonas Fuhrmann. All rights reserved.
+--
+-- This project is dual licensed under GNU General Public License version 3
+-- and a commercial license available on request.
+---------------------------------------------------------------------------
+-- For non commercial use only:
+-- This file is part of tinyTPU.
+-- 
+-- tinyTPU is free software: you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation, either version 3 of the License, or
+-- (at your option) any later version.
+-- 
+-- tinyTPU is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+-- GNU General Public License for more details.
+-- 
+-- You should have received a copy of the GNU General Public License
+-- along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+--! @file PERFORMANCE_COUNTER.vhdl
+--! @author Jonas Fuhrmann
+--! @brief This component includes the counters for performance measurements.
+--! @details Every counter counts the cycles, in which its event is asserted. The counters are cleared and started
+--! like the runtime counter, when a new instruction is feeded. When the TPU signals a synchronization, the counters will stop and hold their values.
+--! The events are listed in TPU_pack (PERF_WEIGHT_BUSY etc.).
+
+use WORK.TPU_pack.all;
+library IEEE;
+    use IEEE.std_logic_1164.all;
+    use IEEE.numeric_std.all;
+
+entity PERFORMANCE_COUNTER is
+    generic(
+        COUNTER_COUNT   : natural := PERF_COUNTER_COUNT
+    );
+    port(
+        CLK, RESET      :  in std_logic;
+        
+        INSTRUCTION_EN  :  in std_logic; --!< Signals that a new Instruction was feeded and starts the counters.
+        SYNCHRONIZE     :  in std_logic; --!< Signals that the calculations are done, stops the counters and holds their values.
+        EVENTS          :  in std_logic_vector(0 to COUNTER_COUNT-1); --!< Events, which increment the respective counter.
+        COUNTER_VAL     : out WORD_ARRAY_TYPE(0 to COUNTER_COUNT-1) --!< The current values of the counters.
+    );
+end entity PERFORMANCE_COUNTER;
+
+--! @brief The architecture of the performance counter.
+architecture BEH of PERFORMANCE_COUNTER is
+    signal COUNTER_cs : WORD_ARRAY_TYPE(0 to COUNTER_COUNT-1) := (others => (others => '0'));
+    signal COUNTER_ns : WORD_ARRAY_TYPE(0 to COUNTER_COUNT-1);
+    
+    signal PIPELINE_cs : WORD_ARRAY_TYPE(0 to COUNTER_COUNT-1) := (others => (others => '0'));
+    signal PIPELINE_ns : WORD_ARRAY_TYPE(0 to COUNTER_COUNT-1);
+    
+    signal STATE_cs : std_logic := '0';
+    signal STATE_ns : std_logic;
+    
+    signal RESET_COUNTER : std_logic;
+begin
+    -- Pipeline for the read multiplexer of the host
+    PIPELINE_ns <= COUNTER_cs;
+    COUNTER_VAL <= PIPELINE_cs;
+    
+    COUNT:
+    process(COUNTER_cs, EVENTS) is
+    begin
+        for i in 0 to COUNTER_COUNT-1 loop
+            if EVENTS(i) = '1' then
+                COUNTER_ns(i) <= std_logic_vector(unsigned(COUNTER_cs(i)) + '1');
+            else
+                COUNTER_ns(i) <= COUNTER_cs(i);
+            end if;
+        end loop;
+    end process COUNT;
+    
+    -- Same states as RUNTIME_COUNTER
+    FSM:
+    process(INSTRUCTION_EN, SYNCHRONIZE, STATE_cs) is
+    begin
+        if SYNCHRONIZE = '1' then
+            STATE_ns <= '0';
+            RESET_COUNTER <= '0';
+        elsif INSTRUCTION_EN = '1' then
+            STATE_ns <= '1';
+            RESET_COUNTER <= not STATE_cs;
+        else
+            STATE_ns <= STATE_cs;
+            RESET_COUNTER <= '0';
+        end if;
+    end process FSM;
+    
+    SEQ_LOG:
+    process(CLK) is
+    begin
+        if CLK'event and CLK = '1' then
+            if RESET = '1' then
+                STATE_cs <= '0';
+                PIPELINE_cs <= (others => (others => '0'));
+            else
+                STATE_cs <= STATE_ns;
+                PIPELINE_cs <= PIPELINE_ns;
+            end if;
+            
+            if RESET = '1' or RESET_COUNTER = '1' then
+                COUNTER_cs <= (others => (others => '0'));
+            else
+                if STATE_cs = '1' then
+                    COUNTER_cs <= COUNTER_ns;
+                end if;
+            end if;
+        end if;
+    end process SEQ_LOG;
+end architecture BEH;
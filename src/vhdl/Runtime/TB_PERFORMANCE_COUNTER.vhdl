@@ -0,0 +1,136 @@
+-- Copyright 2018 Jonas Fuhrmann. All rights reserved.
+--
+-- This project is dual licensed under GNU General Public License version 3
+-- and a commercial license available on request.
+---------------------------------------------------------------------------
+-- For non commercial use only:
+-- This file is part of tinyTPU.
+-- 
+-- tinyTPU is free software: you can redistribute it and/or modify
+-- it under the terms of the GNU General Public License as published by
+-- the Free Software Foundation, either version 3 of the License, or
+-- (at your option) any later version.
+-- 
+-- tinyTPU is distributed in the hope that it will be useful,
+-- but WITHOUT ANY WARRANTY; without even the implied warranty of
+-- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+-- GNU General Public License for more details.
+-- 
+-- You should have received a copy of the GNU General Public License
+-- along with tinyTPU. If not, see <http://www.gnu.org/licenses/>.
+
+use WORK.TPU_pack.all;
+library IEEE;
+    use IEEE.std_logic_1164.all;
+    use IEEE.numeric_std.all;
+
+entity TB_PERFORMANCE_COUNTER is
+end entity TB_PERFORMANCE_COUNTER;
+
+architecture BEH of TB_PERFORMANCE_COUNTER is
+    signal CLK, RESET       : std_logic;
+        
+    signal INSTRUCTION_EN   : std_logic;
+    signal SYNCHRONIZE      : std_logic;
+    signal EVENTS           : std_logic_vector(0 to PERF_COUNTER_COUNT-1);
+    signal COUNTER_VAL      : WORD_ARRAY_TYPE(0 to PERF_COUNTER_COUNT-1);
+    
+    -- for clock gen
+    constant clock_period   : time := 10 ns;
+    signal stop_the_clock   : boolean;
+begin
+    DUT_i : entity WORK.PERFORMANCE_COUNTER(BEH)
+    port map(
+        CLK => CLK,
+        RESET => RESET,
+        INSTRUCTION_EN => INSTRUCTION_EN,
+        SYNCHRONIZE => SYNCHRONIZE,
+        EVENTS => EVENTS,
+        COUNTER_VAL => COUNTER_VAL
+    );
+    
+    STIMULUS:
+    process is
+        procedure CHECK_COUNTER(
+            constant INDEX      : in natural;
+            constant EXPECTED   : in natural
+        ) is
+        begin
+            assert to_integer(unsigned(COUNTER_VAL(INDEX))) = EXPECTED
+                report "Counter " & natural'image(INDEX) & " is " & natural'image(to_integer(unsigned(COUNTER_VAL(INDEX)))) & ", expected " & natural'image(EXPECTED)
+                severity error;
+        end procedure CHECK_COUNTER;
+    begin
+        RESET <= '0';
+        INSTRUCTION_EN <= '0';
+        SYNCHRONIZE <= '0';
+        EVENTS <= (others => '0');
+        wait until CLK='1' and CLK'event;
+        RESET <= '1';
+        wait until CLK='1' and CLK'event;
+        RESET <= '0';
+        -- Events before the first instruction aren't counted
+        EVENTS <= (others => '1');
+        for i in 0 to 3 loop
+            wait until CLK='1' and CLK'event;
+        end loop;
+        EVENTS <= (others => '0');
+        INSTRUCTION_EN <= '1';
+        wait until CLK='1' and CLK'event;
+        INSTRUCTION_EN <= '0';
+        -- Counter i counts i+1 cycles
+        for i in 0 to PERF_COUNTER_COUNT-1 loop
+            EVENTS <= (others => '0');
+            EVENTS(0 to i) <= (others => '1');
+            wait until CLK='1' and CLK'event;
+        end loop;
+        EVENTS <= (others => '0');
+        -- Instructions in between don't clear the counters
+        INSTRUCTION_EN <= '1';
+        wait until CLK='1' and CLK'event;
+        INSTRUCTION_EN <= '0';
+        EVENTS(PERF_STALL) <= '1';
+        for i in 0 to 9 loop
+            wait until CLK='1' and CLK'event;
+        end loop;
+        SYNCHRONIZE <= '1';
+        wait until CLK='1' and CLK'event;
+        SYNCHRONIZE <= '0';
+        -- Stopped counters hold their values
+        for i in 0 to 9 loop
+            wait until CLK='1' and CLK'event;
+        end loop;
+        for i in 0 to PERF_COUNTER_COUNT-1 loop
+            if i = PERF_STALL then
+                -- The synchronize cycle is counted as well
+                CHECK_COUNTER(i, PERF_COUNTER_COUNT-i + 11);
+            else
+                CHECK_COUNTER(i, PERF_COUNTER_COUNT-i);
+            end if;
+        end loop;
+        EVENTS <= (others => '0');
+        -- The next instruction clears the counters
+        INSTRUCTION_EN <= '1';
+        wait until CLK='1' and CLK'event;
+        INSTRUCTION_EN <= '0';
+        for i in 0 to 2 loop
+            wait until CLK='1' and CLK'event;
+        end loop;
+        for i in 0 to PERF_COUNTER_COUNT-1 loop
+            CHECK_COUNTER(i, 0);
+        end loop;
+        
+        stop_the_clock <= true;
+        wait;
+    end process STIMULUS;
+    
+    CLOCK_GEN: 
+    process
+    begin
+        while not stop_the_clock loop
+          CLK <= '0', '1' after clock_period / 2;
+          wait for clock_period;
+        end loop;
+        wait;
+    end process CLOCK_GEN;
+end architecture BEH;
@@ -47,6 +47,12 @@ architecture BEH of TB_TPU_CORE is
             BUFFER_ENABLE       : in  std_logic;
             BUFFER_WRITE_ENABLE : in  std_logic_vector(0 to MATRIX_WIDTH-1);
             
+            BIAS_WRITE_PORT     : in  WORD_TYPE;
+            BIAS_READ_PORT      : out WORD_TYPE;
+            BIAS_ADDRESS        : in  BIAS_ADDRESS_TYPE;
+            BIAS_ENABLE         : in  std_logic;
+            BIAS_WRITE_ENABLE   : in  std_logic_vector(0 to 3);
+            
             INSTRUCTION_PORT    : in  INSTRUCTION_TYPE;
             INSTRUCTION_ENABLE  : in  std_logic;
             
@@ -89,6 +95,11 @@ begin
         BUFFER_ENABLE => '0',
         BUFFER_WRITE_ENABLE => (others => '0'),
         
+        BIAS_WRITE_PORT => (others => '0'),
+        BIAS_ADDRESS => (others => '0'),
+        BIAS_ENABLE => '0',
+        BIAS_WRITE_ENABLE => (others => '0'),
+        
         BUSY => BUSY,
         SYNCHRONIZE => SYNCHRONIZE
     );
@@ -47,7 +47,9 @@ architecture BEH of TB_tinyTPU_AXI is
     signal status_0 : STD_LOGIC_VECTOR ( 31 downto 0 );
     -- for clock gen
     constant clock_period   : time := 10 ns;
-    signal stop_the_clock   : boolean;
+    signal stop_the_clock   : boolean := false;
+    -- Upper bound of the test design, every transfer of the traffic generator should take a few cycles only
+    constant MAX_CYCLES     : natural := 100000;
     
 begin
     DUT_i : DUT
@@ -71,6 +73,23 @@ begin
         wait; 
     end process RESET;
     
+    -- The traffic generator has to finish in time and the protocol checker mustn't report any violations (e.g. of the bursts)
+    CHECK:
+    process is
+        variable CYCLES : natural := 0;
+    begin
+        wait until '1'=clk and clk'event and nres = '1';
+        while done_0 /= '1' loop
+            wait until '1'=clk and clk'event;
+            assert pc_asserted_0 /= '1' report "AXI protocol violation!" severity error;
+            CYCLES := CYCLES + 1;
+            assert CYCLES < MAX_CYCLES report "Traffic generator didn't finish in time!" severity failure;
+        end loop;
+        report "Traffic generator finished after " & natural'image(CYCLES) & " cycles." severity note;
+        stop_the_clock <= true;
+        wait;
+    end process CHECK;
+    
     CLOCK_GEN: 
     process
     begin
@@ -33,13 +33,15 @@ entity TPU is
     generic(
         MATRIX_WIDTH            : natural := 14; --!< The width of the Matrix Multiply Unit and busses.
         WEIGHT_BUFFER_DEPTH     : natural := 32768; --!< The depth of the weight buffer.
-        UNIFIED_BUFFER_DEPTH    : natural := 4096 --!< The depth of the unified buffer.
+        UNIFIED_BUFFER_DEPTH    : natural := 4096; --!< The depth of the unified buffer.
+        BIAS_BUFFER_DEPTH       : natural := 512 --!< The number of bias vectors in the bias buffer.
     );  
     port(   
         CLK, RESET              : in  std_logic;
         ENABLE                  : in  std_logic;
         -- For calculation runtime check
         RUNTIME_COUNT           : out WORD_TYPE; --!< Counts the runtime from the first instruction enable until the synchronize signal.
+        PERF_COUNT              : out WORD_ARRAY_TYPE(0 to PERF_COUNTER_COUNT-1); --!< Performance counters of the same runtime. See TPU_pack for the events.
         -- Splitted instruction input
         LOWER_INSTRUCTION_WORD  : in  WORD_TYPE; --!< The lower word of the instruction.
         MIDDLE_INSTRUCTION_WORD : in  WORD_TYPE; --!< The middle word of the instruction.
@@ -48,6 +50,9 @@ entity TPU is
         -- Instruction buffer flags for interrupts
         INSTRUCTION_EMPTY       : out std_logic; --!< Determines if the FIFO is empty. Used to interrupt the host system.
         INSTRUCTION_FULL        : out std_logic; --!< Determines if the FIFO is full. Used to interrupt the host system.
+        -- For flow control of the host
+        INSTRUCTION_COUNT       : out WORD_TYPE; --!< Counts the instructions, which were read from the FIFO. Wraps around.
+        SYNCHRONIZE_COUNT       : out WORD_TYPE; --!< Counts the finished synchronize instructions. Wraps around.
     
         WEIGHT_WRITE_PORT       : in  BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1); --!< Host write port for the weight buffer
         WEIGHT_ADDRESS          : in  WEIGHT_ADDRESS_TYPE; --!< Host address for the weight buffer.
@@ -59,6 +64,12 @@ entity TPU is
         BUFFER_ADDRESS          : in  BUFFER_ADDRESS_TYPE; --!< Host address for the unified buffer.
         BUFFER_ENABLE           : in  std_logic; --!< Host enable for the unified buffer.
         BUFFER_WRITE_ENABLE     : in  std_logic_vector(0 to MATRIX_WIDTH-1); --!< Host write enable for the unified buffer.
+            
+        BIAS_WRITE_PORT         : in  WORD_TYPE; --!< Host write port for the bias buffer.
+        BIAS_READ_PORT          : out WORD_TYPE; --!< Host read port for the bias buffer.
+        BIAS_ADDRESS            : in  BIAS_ADDRESS_TYPE; --!< Host address for the bias buffer - vector and column of a single bias.
+        BIAS_ENABLE             : in  std_logic; --!< Host enable for the bias buffer.
+        BIAS_WRITE_ENABLE       : in  std_logic_vector(0 to 3); --!< Host write enable for the bias buffer.
         -- Memory synchronization flag for interrupt 
         SYNCHRONIZE             : out std_logic --!< Synchronization interrupt.
     );
@@ -76,6 +87,21 @@ architecture BEH of TPU is
         );
     end component RUNTIME_COUNTER;
     for all : RUNTIME_COUNTER use entity WORK.RUNTIME_COUNTER(BEH);
+    
+    component PERFORMANCE_COUNTER is
+        generic(
+            COUNTER_COUNT   : natural := PERF_COUNTER_COUNT
+        );
+        port(
+            CLK, RESET      :  in std_logic;
+            
+            INSTRUCTION_EN  :  in std_logic;
+            SYNCHRONIZE     :  in std_logic;
+            EVENTS          :  in std_logic_vector(0 to COUNTER_COUNT-1);
+            COUNTER_VAL     : out WORD_ARRAY_TYPE(0 to COUNTER_COUNT-1)
+        );
+    end component PERFORMANCE_COUNTER;
+    for all : PERFORMANCE_COUNTER use entity WORK.PERFORMANCE_COUNTER(BEH);
 
     component INSTRUCTION_FIFO is
         generic(
@@ -105,7 +131,8 @@ architecture BEH of TPU is
         generic(
             MATRIX_WIDTH            : natural := 14;
             WEIGHT_BUFFER_DEPTH     : natural := 32768;
-            UNIFIED_BUFFER_DEPTH    : natural := 4096
+            UNIFIED_BUFFER_DEPTH    : natural := 4096;
+            BIAS_BUFFER_DEPTH       : natural := 512
         );
         port(
             CLK, RESET          : in  std_logic;
@@ -122,11 +149,18 @@ architecture BEH of TPU is
             BUFFER_ENABLE       : in  std_logic;
             BUFFER_WRITE_ENABLE : in  std_logic_vector(0 to MATRIX_WIDTH-1);
             
+            BIAS_WRITE_PORT     : in  WORD_TYPE;
+            BIAS_READ_PORT      : out WORD_TYPE;
+            BIAS_ADDRESS        : in  BIAS_ADDRESS_TYPE;
+            BIAS_ENABLE         : in  std_logic;
+            BIAS_WRITE_ENABLE   : in  std_logic_vector(0 to 3);
+            
             INSTRUCTION_PORT    : in  INSTRUCTION_TYPE;
             INSTRUCTION_ENABLE  : in  std_logic;
             
             BUSY                : out std_logic;
-            SYNCHRONIZE         : out std_logic
+            SYNCHRONIZE         : out std_logic;
+            PERF_EVENTS         : out std_logic_vector(0 to PERF_COUNTER_COUNT-1)
         );
     end component TPU_CORE;
     for all : TPU_CORE use entity WORK.TPU_CORE(BEH);
@@ -134,6 +168,15 @@ architecture BEH of TPU is
     signal INSTRUCTION_ENABLE   : std_logic;
     signal BUSY                 : std_logic;
     signal SYNCHRONIZE_IN       : std_logic;
+    
+    signal CORE_EVENTS          : std_logic_vector(0 to PERF_COUNTER_COUNT-1);
+    signal PERF_EVENTS          : std_logic_vector(0 to PERF_COUNTER_COUNT-1);
+    
+    signal INSTRUCTION_COUNT_cs : WORD_TYPE := (others => '0');
+    signal INSTRUCTION_COUNT_ns : WORD_TYPE;
+    
+    signal SYNCHRONIZE_COUNT_cs : WORD_TYPE := (others => '0');
+    signal SYNCHRONIZE_COUNT_ns : WORD_TYPE;
 begin
     RUNTIME_COUNTER_i : RUNTIME_COUNTER
     port map(
@@ -143,6 +186,16 @@ begin
         SYNCHRONIZE     => SYNCHRONIZE_IN,
         COUNTER_VAL     => RUNTIME_COUNT
     );
+    
+    PERFORMANCE_COUNTER_i : PERFORMANCE_COUNTER
+    port map(
+        CLK             => CLK,
+        RESET           => RESET,
+        INSTRUCTION_EN  => INSTRUCTION_ENABLE,
+        SYNCHRONIZE     => SYNCHRONIZE_IN,
+        EVENTS          => PERF_EVENTS,
+        COUNTER_VAL     => PERF_COUNT
+    );
 
     INSTRUCTION_FIFO_i : INSTRUCTION_FIFO
     port map(
@@ -165,7 +218,8 @@ begin
     generic map(
         MATRIX_WIDTH            => MATRIX_WIDTH,
         WEIGHT_BUFFER_DEPTH     => WEIGHT_BUFFER_DEPTH,
-        UNIFIED_BUFFER_DEPTH    => UNIFIED_BUFFER_DEPTH
+        UNIFIED_BUFFER_DEPTH    => UNIFIED_BUFFER_DEPTH,
+        BIAS_BUFFER_DEPTH       => BIAS_BUFFER_DEPTH
     )
     port map(
         CLK                 => CLK,
@@ -183,15 +237,26 @@ begin
         BUFFER_ENABLE       => BUFFER_ENABLE,
         BUFFER_WRITE_ENABLE => BUFFER_WRITE_ENABLE,
         
+        BIAS_WRITE_PORT     => BIAS_WRITE_PORT,
+        BIAS_READ_PORT      => BIAS_READ_PORT,
+        BIAS_ADDRESS        => BIAS_ADDRESS,
+        BIAS_ENABLE         => BIAS_ENABLE,
+        BIAS_WRITE_ENABLE   => BIAS_WRITE_ENABLE,
+        
         INSTRUCTION_PORT    => INSTRUCTION,
         INSTRUCTION_ENABLE  => INSTRUCTION_ENABLE,
         
         BUSY                => BUSY,
-        SYNCHRONIZE         => SYNCHRONIZE_IN
+        SYNCHRONIZE         => SYNCHRONIZE_IN,
+        PERF_EVENTS         => CORE_EVENTS
     );
     
     SYNCHRONIZE <= SYNCHRONIZE_IN;
     
+    -- An empty FIFO starves the core
+    PERF_EVENTS(0 to PERF_FIFO_EMPTY-1) <= CORE_EVENTS(0 to PERF_FIFO_EMPTY-1);
+    PERF_EVENTS(PERF_FIFO_EMPTY)        <= EMPTY;
+    
     INSTRUCTION_FEED:
     process(EMPTY, BUSY) is
     begin
@@ -201,4 +266,24 @@ begin
             INSTRUCTION_ENABLE <= '0';
         end if;
     end process INSTRUCTION_FEED;
+    
+    INSTRUCTION_COUNT_ns <= std_logic_vector(unsigned(INSTRUCTION_COUNT_cs) + 1) when INSTRUCTION_ENABLE = '1' else INSTRUCTION_COUNT_cs;
+    INSTRUCTION_COUNT <= INSTRUCTION_COUNT_cs;
+    
+    SYNCHRONIZE_COUNT_ns <= std_logic_vector(unsigned(SYNCHRONIZE_COUNT_cs) + 1) when SYNCHRONIZE_IN = '1' else SYNCHRONIZE_COUNT_cs;
+    SYNCHRONIZE_COUNT <= SYNCHRONIZE_COUNT_cs;
+    
+    SEQ_LOG:
+    process(CLK) is
+    begin
+        if CLK'event and CLK = '1' then
+            if RESET = '1' then
+                INSTRUCTION_COUNT_cs <= (others => '0');
+                SYNCHRONIZE_COUNT_cs <= (others => '0');
+            else
+                INSTRUCTION_COUNT_cs <= INSTRUCTION_COUNT_ns;
+                SYNCHRONIZE_COUNT_cs <= SYNCHRONIZE_COUNT_ns;
+            end if;
+        end if;
+    end process SEQ_LOG;
 end architecture BEH;
\ No newline at end of file
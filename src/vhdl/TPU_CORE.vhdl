@@ -33,7 +33,8 @@ entity TPU_CORE is
     generic(
         MATRIX_WIDTH            : natural := 14; --!< The width of the Matrix Multiply Unit and busses.
         WEIGHT_BUFFER_DEPTH     : natural := 32768; --!< The depth of the weight buffer.
-        UNIFIED_BUFFER_DEPTH    : natural := 4096 --!< The depth of the unified buffer.
+        UNIFIED_BUFFER_DEPTH    : natural := 4096; --!< The depth of the unified buffer.
+        BIAS_BUFFER_DEPTH       : natural := 512 --!< The number of bias vectors in the bias buffer.
     );
     port(
         CLK, RESET          : in  std_logic;
@@ -50,11 +51,18 @@ entity TPU_CORE is
         BUFFER_ENABLE       : in  std_logic; --!< Host enable for the unified buffer.
         BUFFER_WRITE_ENABLE : in  std_logic_vector(0 to MATRIX_WIDTH-1); --!< Host write enable for the unified buffer.
         
+        BIAS_WRITE_PORT     : in  WORD_TYPE; --!< Host write port for the bias buffer.
+        BIAS_READ_PORT      : out WORD_TYPE; --!< Host read port for the bias buffer.
+        BIAS_ADDRESS        : in  BIAS_ADDRESS_TYPE; --!< Host address for the bias buffer - vector and column of a single bias.
+        BIAS_ENABLE         : in  std_logic; --!< Host enable for the bias buffer.
+        BIAS_WRITE_ENABLE   : in  std_logic_vector(0 to 3); --!< Host write enable for the bias buffer.
+        
         INSTRUCTION_PORT    : in  INSTRUCTION_TYPE; --!< Write port for instructions.
         INSTRUCTION_ENABLE  : in  std_logic; --!< Write enable for instructions.
         
         BUSY                : out std_logic; --!< The TPU is still busy and can't take any instruction.
-        SYNCHRONIZE         : out std_logic --!< Synchronization interrupt.
+        SYNCHRONIZE         : out std_logic; --!< Synchronization interrupt.
+        PERF_EVENTS         : out std_logic_vector(0 to PERF_COUNTER_COUNT-1) --!< Events of the units for the performance counters. The FIFO empty event is added by the TPU.
     );
 end entity TPU_CORE;
 
@@ -127,6 +135,32 @@ architecture BEH of TPU_CORE is
     signal BUFFER_WRITE_EN1     : std_logic;
     signal BUFFER_WRITE_PORT1   : BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
     
+    component BIAS_BUFFER is
+        generic(
+            MATRIX_WIDTH    : natural := 14;
+            BIAS_DEPTH      : natural := 512
+        );
+        port(
+            CLK, RESET      : in  std_logic;
+            ENABLE          : in  std_logic;
+            
+            -- Master port
+            MASTER_ADDRESS      : in  BIAS_ADDRESS_TYPE;
+            MASTER_EN           : in  std_logic;
+            MASTER_WRITE_EN     : in  std_logic_vector(0 to 3);
+            MASTER_WRITE_PORT   : in  WORD_TYPE;
+            MASTER_READ_PORT    : out WORD_TYPE;
+            -- Port0
+            ADDRESS0        : in  BIAS_ADDRESS_TYPE;
+            EN0             : in  std_logic;
+            READ_PORT0      : out WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1)
+        );
+    end component BIAS_BUFFER;
+    for all : BIAS_BUFFER use entity WORK.BIAS_BUFFER(BEH);
+    
+    signal BIAS_ADDRESS0        : BIAS_ADDRESS_TYPE;
+    signal BIAS_READ_PORT0      : WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+    
     component SYSTOLIC_DATA_SETUP is
         generic(
             MATRIX_WIDTH  : natural := 14
@@ -212,6 +246,9 @@ architecture BEH of TPU_CORE is
             ACTIVATION_FUNCTION : in  ACTIVATION_BIT_TYPE;
             SIGNED_NOT_UNSIGNED : in  std_logic;
             
+            BIAS_ENABLE         : in  std_logic;
+            BIAS                : in  WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
+            
             ACTIVATION_INPUT    : in  WORD_ARRAY_TYPE(0 to MATRIX_WIDTH-1);
             ACTIVATION_OUTPUT   : out BYTE_ARRAY_TYPE(0 to MATRIX_WIDTH-1)
         );
@@ -220,6 +257,7 @@ architecture BEH of TPU_CORE is
     
     signal ACTIVATION_FUNCTION  : ACTIVATION_BIT_TYPE;
     signal ACTIVATION_SIGNED    : std_logic;
+    signal ACTIVATION_BIAS      : std_logic;
         
     component WEIGHT_CONTROL is
         generic(
@@ -303,6 +341,9 @@ architecture BEH of TPU_CORE is
             ACTIVATION_FUNCTION : out ACTIVATION_BIT_TYPE;
             SIGNED_NOT_UNSIGNED : out std_logic;
             
+            BIAS_ADDRESS        : out BIAS_ADDRESS_TYPE;
+            BIAS_ENABLE         : out std_logic;
+            
             ACT_TO_BUF_ADDR     : out BUFFER_ADDRESS_TYPE;
             BUF_WRITE_EN        : out std_logic;
             
@@ -347,6 +388,7 @@ architecture BEH of TPU_CORE is
             INSTRUCTION_EN              :  in std_logic;
             
             BUSY                        : out std_logic;
+            RESOURCE_STALL              : out std_logic;
             
             WEIGHT_BUSY                 :  in std_logic;
             WEIGHT_RESOURCE_BUSY        :  in std_logic;
@@ -372,6 +414,7 @@ architecture BEH of TPU_CORE is
     signal WEIGHT_BUSY              : std_logic;
     signal MATRIX_BUSY              : std_logic;
     signal ACTIVATION_BUSY          : std_logic;
+    signal RESOURCE_STALL           : std_logic;
 begin
     WEIGHT_BUFFER_i : WEIGHT_BUFFER
     generic map(
@@ -424,6 +467,28 @@ begin
         WRITE_PORT1     => BUFFER_WRITE_PORT1
     );
     
+    BIAS_BUFFER_i : BIAS_BUFFER
+    generic map(
+        MATRIX_WIDTH    => MATRIX_WIDTH,
+        BIAS_DEPTH      => BIAS_BUFFER_DEPTH
+    )
+    port map(
+        CLK             => CLK,
+        RESET           => RESET,
+        ENABLE          => ENABLE,
+        
+        -- Master port
+        MASTER_ADDRESS      => BIAS_ADDRESS,
+        MASTER_EN           => BIAS_ENABLE,
+        MASTER_WRITE_EN     => BIAS_WRITE_ENABLE,
+        MASTER_WRITE_PORT   => BIAS_WRITE_PORT,
+        MASTER_READ_PORT    => BIAS_READ_PORT,
+        -- Port0
+        ADDRESS0        => BIAS_ADDRESS0,
+        EN0             => '1',
+        READ_PORT0      => BIAS_READ_PORT0
+    );
+    
     SYSTOLIC_DATA_SETUP_i : SYSTOLIC_DATA_SETUP
     generic map(
         MATRIX_WIDTH
@@ -489,6 +554,9 @@ begin
         ACTIVATION_FUNCTION => ACTIVATION_FUNCTION,
         SIGNED_NOT_UNSIGNED => ACTIVATION_SIGNED,
         
+        BIAS_ENABLE         => ACTIVATION_BIAS,
+        BIAS                => BIAS_READ_PORT0,
+        
         ACTIVATION_INPUT    => REG_READ_PORT,
         ACTIVATION_OUTPUT   => BUFFER_WRITE_PORT1
     );
@@ -559,6 +627,9 @@ begin
         ACTIVATION_FUNCTION => ACTIVATION_FUNCTION,
         SIGNED_NOT_UNSIGNED => ACTIVATION_SIGNED,
         
+        BIAS_ADDRESS        => BIAS_ADDRESS0,
+        BIAS_ENABLE         => ACTIVATION_BIAS,
+        
         ACT_TO_BUF_ADDR     => BUFFER_ADDRESS1,
         BUF_WRITE_EN        => BUFFER_WRITE_EN1,
         
@@ -591,6 +662,7 @@ begin
         INSTRUCTION_EN              => INSTRUCTION_READ,
 
         BUSY                        => INSTRUCTION_BUSY,
+        RESOURCE_STALL              => RESOURCE_STALL,
 
         WEIGHT_BUSY                 => WEIGHT_BUSY,
         WEIGHT_RESOURCE_BUSY        => WEIGHT_RESOURCE_BUSY,
@@ -611,4 +683,15 @@ begin
     );
     
     BUSY <= INSTRUCTION_BUSY;
+    
+    PERF_EVENTS(PERF_WEIGHT_BUSY)               <= WEIGHT_BUSY;
+    PERF_EVENTS(PERF_MATRIX_BUSY)               <= MATRIX_BUSY;
+    PERF_EVENTS(PERF_ACTIVATION_BUSY)           <= ACTIVATION_BUSY;
+    PERF_EVENTS(PERF_STALL)                     <= INSTRUCTION_BUSY;
+    PERF_EVENTS(PERF_RESOURCE_STALL)            <= RESOURCE_STALL;
+    -- The coordinator holds the enables while the core is disabled
+    PERF_EVENTS(PERF_WEIGHT_INSTRUCTIONS)       <= WEIGHT_INSTRUCTION_EN and ENABLE;
+    PERF_EVENTS(PERF_MATRIX_INSTRUCTIONS)       <= MMU_INSTRUCTION_EN and ENABLE;
+    PERF_EVENTS(PERF_ACTIVATION_INSTRUCTIONS)   <= ACTIVATION_INSTRUCTION_EN and ENABLE;
+    PERF_EVENTS(PERF_FIFO_EMPTY)                <= '0';
 end architecture BEH;
\ No newline at end of file
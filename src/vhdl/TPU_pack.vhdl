@@ -62,6 +62,8 @@ package TPU_PACK is
     constant BUFFER_ADDRESS_WIDTH : natural := 24;
     constant ACCUMULATOR_ADDRESS_WIDTH : natural := 16;
     constant WEIGHT_ADDRESS_WIDTH : natural := BUFFER_ADDRESS_WIDTH + ACCUMULATOR_ADDRESS_WIDTH;
+    -- Biased activations split the length into the length (lower half) and the bias vector address (upper half)
+    constant BIAS_ADDRESS_WIDTH : natural := 16;
     constant LENGTH_WIDTH : natural := 32;
     constant OP_CODE_WIDTH : natural := 8;
     constant INSTRUCTION_WIDTH : natural := WEIGHT_ADDRESS_WIDTH + LENGTH_WIDTH + OP_CODE_WIDTH;
@@ -69,6 +71,7 @@ package TPU_PACK is
     subtype BUFFER_ADDRESS_TYPE is std_logic_vector(BUFFER_ADDRESS_WIDTH-1 downto 0);
     subtype ACCUMULATOR_ADDRESS_TYPE is std_logic_vector(ACCUMULATOR_ADDRESS_WIDTH-1 downto 0);
     subtype WEIGHT_ADDRESS_TYPE is std_logic_vector(WEIGHT_ADDRESS_WIDTH-1 downto 0);
+    subtype BIAS_ADDRESS_TYPE is std_logic_vector(BIAS_ADDRESS_WIDTH-1 downto 0);
     subtype LENGTH_TYPE is std_logic_vector(LENGTH_WIDTH-1 downto 0);
     subtype OP_CODE_TYPE is std_logic_vector(OP_CODE_WIDTH-1 downto 0);
     
@@ -92,6 +95,18 @@ package TPU_PACK is
     function BITS_TO_INSTRUCTION(BITVECTOR : std_logic_vector(10*BYTE_WIDTH-1 downto 0)) return INSTRUCTION_TYPE;
     
     function INIT_INSTRUCTION return INSTRUCTION_TYPE;
+    
+    -- Performance counters, which count the events of the units between the first instruction and the synchronize
+    constant PERF_WEIGHT_BUSY           : natural := 0; -- Cycles the weight control unit is busy
+    constant PERF_MATRIX_BUSY           : natural := 1; -- Cycles the matrix multiply control unit is busy
+    constant PERF_ACTIVATION_BUSY       : natural := 2; -- Cycles the activation control unit is busy
+    constant PERF_STALL                 : natural := 3; -- Cycles the control coordinator holds an instruction for a busy unit
+    constant PERF_RESOURCE_STALL        : natural := 4; -- Cycles a synchronize waits for the resources of the units
+    constant PERF_WEIGHT_INSTRUCTIONS   : natural := 5; -- Dispatched read_weights instructions
+    constant PERF_MATRIX_INSTRUCTIONS   : natural := 6; -- Dispatched matrix_multiply instructions
+    constant PERF_ACTIVATION_INSTRUCTIONS : natural := 7; -- Dispatched activate instructions
+    constant PERF_FIFO_EMPTY            : natural := 8; -- Cycles the instruction FIFO is empty
+    constant PERF_COUNTER_COUNT         : natural := 9;
 end TPU_PACK;
 
 package body TPU_PACK is